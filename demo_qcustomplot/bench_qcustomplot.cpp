@@ -0,0 +1,641 @@
+/*
+ * QCustomPlot 渲染基准测试
+ *
+ * 在offscreen平台上把各类绘图对象渲染到离屏缓冲/QImage中，统计重绘耗时、
+ * 堆分配次数与峰值内存，结果以JSON输出，便于不同版本之间做回归对比。
+ *
+ * 用法示例：
+ *   bench_qcustomplot --sizes 1e3,1e4,1e5,1e6 --repeat 10 --output result.json
+ *   bench_qcustomplot --filter "graph|history" --sizes 1e7
+ */
+
+#include "qcustomplot.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSysInfo>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <random>
+
+#include <sys/resource.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define BENCH_TRACK_HEAP 1
+#endif
+
+#ifdef BENCH_TRACK_HEAP
+// 通过替换malloc系列函数统计堆分配（仅glibc），真正的分配仍交给__libc_*完成
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void  __libc_free(void *ptr);
+}
+
+namespace {
+std::atomic<quint64> g_allocCount{0};
+std::atomic<qint64>  g_heapBytes{0};
+std::atomic<qint64>  g_heapPeak{0};
+
+void recordAlloc(void *ptr)
+{
+    if (!ptr)
+        return;
+    ++g_allocCount;
+    const qint64 bytes = g_heapBytes += qint64(malloc_usable_size(ptr));
+    qint64       peak  = g_heapPeak.load(std::memory_order_relaxed);
+    while (bytes > peak && !g_heapPeak.compare_exchange_weak(peak, bytes)) {
+    }
+}
+
+void recordFree(void *ptr)
+{
+    if (ptr)
+        g_heapBytes -= qint64(malloc_usable_size(ptr));
+}
+} // namespace
+
+extern "C" void *malloc(size_t size)
+{
+    void *ptr = __libc_malloc(size);
+    recordAlloc(ptr);
+    return ptr;
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    void *ptr = __libc_calloc(count, size);
+    recordAlloc(ptr);
+    return ptr;
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    const qint64 oldBytes = ptr ? qint64(malloc_usable_size(ptr)) : 0;
+    void        *result   = __libc_realloc(ptr, size);
+    // realloc失败时原内存块仍然有效，只有成功（或size为0释放）时才扣除旧块
+    if (result || size == 0)
+        g_heapBytes -= oldBytes;
+    recordAlloc(result);
+    return result;
+}
+
+extern "C" void *memalign(size_t alignment, size_t size)
+{
+    void *ptr = __libc_memalign(alignment, size);
+    recordAlloc(ptr);
+    return ptr;
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void **result, size_t alignment, size_t size)
+{
+    void *ptr = memalign(alignment, size);
+    if (!ptr)
+        return ENOMEM;
+    *result = ptr;
+    return 0;
+}
+
+extern "C" void free(void *ptr)
+{
+    recordFree(ptr);
+    __libc_free(ptr);
+}
+#endif
+
+namespace {
+
+// 单项测试的统计结果
+struct Timing
+{
+    double minMs    = 0;
+    double medianMs = 0;
+    double meanMs   = 0;
+};
+
+// 测试运行参数
+struct BenchOptions
+{
+    int width  = 1280;
+    int height = 720;
+    int repeat = 10;
+};
+
+// 测试上下文：setup函数向plot中添加数据，并可附加额外的统计字段
+struct BenchContext
+{
+    QCustomPlot *plot = nullptr;
+    qint64       size = 0;
+    QJsonObject  extra;
+};
+
+// 测试用例描述
+struct BenchCase
+{
+    QString                             name;
+    qint64                              maxSize;  // 超过该数据量时跳过
+    QSize                               viewport; // 为空时使用命令行指定的尺寸
+    std::function<void(BenchContext &)> setup;
+};
+
+quint64 allocCount()
+{
+#ifdef BENCH_TRACK_HEAP
+    return g_allocCount.load();
+#else
+    return 0;
+#endif
+}
+
+qint64 heapBytes()
+{
+#ifdef BENCH_TRACK_HEAP
+    return g_heapBytes.load();
+#else
+    return 0;
+#endif
+}
+
+// 把峰值重置为当前值，返回当前堆占用作为基准
+qint64 resetHeapPeak()
+{
+#ifdef BENCH_TRACK_HEAP
+    const qint64 bytes = g_heapBytes.load();
+    g_heapPeak.store(bytes);
+    return bytes;
+#else
+    return 0;
+#endif
+}
+
+qint64 heapPeak()
+{
+#ifdef BENCH_TRACK_HEAP
+    return g_heapPeak.load();
+#else
+    return 0;
+#endif
+}
+
+qint64 maxRssBytes()
+{
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+    return qint64(usage.ru_maxrss) * 1024; // Linux下单位为KB
+}
+
+// 多次执行work并统计耗时，allocations返回平均每次的分配次数
+template <typename Work>
+Timing measure(int repeat, Work &&work, double *allocations = nullptr)
+{
+    QVector<double> times;
+    times.reserve(repeat);
+    const quint64 allocBefore = allocCount();
+    for (int i = 0; i < repeat; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        work(i);
+        times << timer.nsecsElapsed() / 1e6;
+    }
+    if (allocations)
+        *allocations = double(allocCount() - allocBefore) / qMax(1, repeat);
+
+    Timing timing;
+    if (times.isEmpty())
+        return timing;
+    std::sort(times.begin(), times.end());
+    timing.minMs    = times.first();
+    timing.medianMs = times.at(times.size() / 2);
+    double sum      = 0;
+    for (double t : times)
+        sum += t;
+    timing.meanMs = sum / times.size();
+    return timing;
+}
+
+QJsonObject toJson(const Timing &timing)
+{
+    QJsonObject object;
+    object["min_ms"]    = timing.minMs;
+    object["median_ms"] = timing.medianMs;
+    object["mean_ms"]   = timing.meanMs;
+    return object;
+}
+
+// 生成随机游走曲线数据
+QVector<QCPGraphData> randomWalk(qint64 count, quint32 seed)
+{
+    std::mt19937                     engine(seed);
+    std::normal_distribution<double> step(0.0, 1.0);
+    QVector<QCPGraphData>            data(int(count));
+    double                           value = 0;
+    for (int i = 0; i < data.size(); ++i) {
+        value += step(engine);
+        data[i] = QCPGraphData(i, value);
+    }
+    return data;
+}
+
+QCPGraph *addWalkGraph(QCustomPlot *plot, qint64 count, quint32 seed)
+{
+    QCPGraph *graph = plot->addGraph();
+    graph->data()->set(randomWalk(count, seed), true);
+    return graph;
+}
+
+void addScatterCase(QList<BenchCase> &cases, const QString &name, QCPScatterStyle::ScatterShape shape)
+{
+    cases << BenchCase{"scatter_" + name, qint64(1e8), QSize(), [shape](BenchContext &ctx) {
+                           QCPGraph *graph = addWalkGraph(ctx.plot, ctx.size, 2);
+                           graph->setLineStyle(QCPGraph::lsNone);
+                           graph->setScatterStyle(QCPScatterStyle(shape, 5));
+                       }};
+}
+
+void setupErrorBars(BenchContext &ctx, bool adaptiveSampling)
+{
+    QCPGraph *graph = addWalkGraph(ctx.plot, ctx.size, 3);
+    graph->setLineStyle(QCPGraph::lsNone);
+    graph->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, 3));
+
+    QCPErrorBars *errorBars = new QCPErrorBars(ctx.plot->xAxis, ctx.plot->yAxis);
+    errorBars->setDataPlottable(graph);
+    errorBars->setAdaptiveSampling(adaptiveSampling);
+    QVector<double> errors(int(ctx.size));
+    for (int i = 0; i < errors.size(); ++i)
+        errors[i] = 0.5 + (i % 7) * 0.25;
+    errorBars->setData(errors);
+}
+
+// 32条曲线的4K场景，用于对比像素图缓冲与分块并行绘制
+void setupManyGraphs(BenchContext &ctx, bool tiled)
+{
+    const qint64 perGraph = qMax<qint64>(1, ctx.size / 32);
+    for (int g = 0; g < 32; ++g) {
+        QCPGraph *graph = addWalkGraph(ctx.plot, perGraph, quint32(100 + g));
+        graph->setPen(QPen(QColor::fromHsv(g * 360 / 32, 200, 200)));
+    }
+    ctx.plot->setTiledPainting(tiled);
+}
+
+// 数据点较大的用例的上限：Qt5中单个QVector的分配不能超过2GiB，否则qBadAlloc直接终止进程
+template <class DataType>
+qint64 maxVectorSize()
+{
+    return qMin(qint64(1e8), qint64(std::numeric_limits<int>::max() - 64) / qint64(sizeof(DataType)));
+}
+
+QList<BenchCase> createCases()
+{
+    QList<BenchCase> cases;
+
+    cases << BenchCase{"graph_line", qint64(1e8), QSize(), [](BenchContext &ctx) { addWalkGraph(ctx.plot, ctx.size, 1); }};
+
+    addScatterCase(cases, "dot", QCPScatterStyle::ssDot);
+    addScatterCase(cases, "cross", QCPScatterStyle::ssCross);
+    addScatterCase(cases, "circle", QCPScatterStyle::ssCircle);
+    addScatterCase(cases, "disc", QCPScatterStyle::ssDisc);
+    addScatterCase(cases, "square", QCPScatterStyle::ssSquare);
+
+    cases << BenchCase{"curve", maxVectorSize<QCPCurveData>(), QSize(), [](BenchContext &ctx) {
+                           QVector<QCPCurveData> data(int(ctx.size));
+                           for (int i = 0; i < data.size(); ++i) {
+                               const double t = i * 0.01;
+                               data[i]        = QCPCurveData(i, std::sqrt(t + 1) * std::cos(t), std::sqrt(t + 1) * std::sin(t));
+                           }
+                           QCPCurve *curve = new QCPCurve(ctx.plot->xAxis, ctx.plot->yAxis);
+                           curve->data()->set(data, true);
+                       }};
+
+    cases << BenchCase{"bars", qint64(1e8), QSize(), [](BenchContext &ctx) {
+                           QVector<QCPBarsData> data(int(ctx.size));
+                           for (int i = 0; i < data.size(); ++i)
+                               data[i] = QCPBarsData(i, 1 + (i * 7919 % 1000) / 100.0);
+                           QCPBars *bars = new QCPBars(ctx.plot->xAxis, ctx.plot->yAxis);
+                           bars->setWidth(0.8);
+                           bars->setBrush(QColor(80, 140, 220));
+                           bars->data()->set(data, true);
+                       }};
+
+    cases << BenchCase{"colormap", qint64(1e8), QSize(), [](BenchContext &ctx) {
+                           // 数据量n对应约sqrt(n) x sqrt(n)的网格
+                           const int    side     = qMax(2, int(std::sqrt(double(ctx.size))));
+                           QCPColorMap *colorMap = new QCPColorMap(ctx.plot->xAxis, ctx.plot->yAxis);
+                           colorMap->data()->setSize(side, side);
+                           colorMap->data()->setRange(QCPRange(0, side), QCPRange(0, side));
+                           for (int x = 0; x < side; ++x)
+                               for (int y = 0; y < side; ++y)
+                                   colorMap->data()->setCell(x, y, std::sin(x * 0.05) * std::cos(y * 0.05));
+                           colorMap->setGradient(QCPColorGradient::gpJet);
+                           colorMap->rescaleDataRange(true);
+                           ctx.extra["grid"] = side;
+                       }};
+
+    cases << BenchCase{"financial", maxVectorSize<QCPFinancialData>(), QSize(), [](BenchContext &ctx) {
+                           std::mt19937                     engine(4);
+                           std::normal_distribution<double> step(0.0, 1.0);
+                           QVector<QCPFinancialData>        data(int(ctx.size));
+                           double                           close = 100;
+                           for (int i = 0; i < data.size(); ++i) {
+                               const double open = close;
+                               close             = open + step(engine);
+                               const double high = qMax(open, close) + std::fabs(step(engine));
+                               const double low  = qMin(open, close) - std::fabs(step(engine));
+                               data[i]           = QCPFinancialData(i, open, high, low, close);
+                           }
+                           QCPFinancial *financial = new QCPFinancial(ctx.plot->xAxis, ctx.plot->yAxis);
+                           financial->setChartStyle(QCPFinancial::csCandlestick);
+                           financial->setWidth(0.6);
+                           financial->data()->set(data, true);
+                       }};
+
+    cases << BenchCase{"errorbars", qint64(1e8), QSize(), [](BenchContext &ctx) { setupErrorBars(ctx, true); }};
+    cases << BenchCase{"errorbars_nosampling", qint64(1e8), QSize(), [](BenchContext &ctx) { setupErrorBars(ctx, false); }};
+
+    cases << BenchCase{"statbox_outliers", qint64(1e8), QSize(), [](BenchContext &ctx) {
+                           // 10个箱线图平分全部离群点
+                           std::mt19937                     engine(5);
+                           std::normal_distribution<double> spread(0.0, 3.0);
+                           QCPStatisticalBox               *box = new QCPStatisticalBox(ctx.plot->xAxis, ctx.plot->yAxis);
+                           box->setOutlierStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, 4));
+                           const int perBox = int(qMax<qint64>(1, ctx.size / 10));
+                           for (int b = 0; b < 10; ++b) {
+                               QVector<double> outliers(perBox);
+                               for (int i = 0; i < perBox; ++i)
+                                   outliers[i] = spread(engine) + (spread(engine) > 0 ? 6 : -6);
+                               box->addData(b + 1, -4, -1, 0, 1, 4, outliers);
+                           }
+                       }};
+
+    // 每个item都是独立的QObject，数据量过大时没有意义
+    cases << BenchCase{"items", qint64(1e4), QSize(), [](BenchContext &ctx) {
+                           for (qint64 i = 0; i < ctx.size; ++i) {
+                               QCPItemLine *line = new QCPItemLine(ctx.plot);
+                               line->start->setCoords(i, (i % 13) - 6);
+                               line->end->setCoords(i + 0.5, (i % 7) - 3);
+                           }
+                       }};
+
+    cases << BenchCase{"annotations", qint64(1e8), QSize(), [](BenchContext &ctx) {
+                           QCPAnnotations *annotations = new QCPAnnotations(ctx.plot->xAxis, ctx.plot->yAxis);
+                           annotations->addStyle(QPen(QColor(220, 60, 60)));
+                           annotations->addStyle(QPen(QColor(60, 60, 220)), QColor(60, 60, 220, 40));
+                           const int       label = annotations->addLabel("event");
+                           QVector<double> keys(int(ctx.size));
+                           QVector<int>    styles(int(ctx.size));
+                           QVector<int>    labels(int(ctx.size));
+                           for (int i = 0; i < keys.size(); ++i) {
+                               keys[i]   = i;
+                               styles[i] = i % 2;
+                               labels[i] = (i % 100 == 0) ? label : -1;
+                           }
+                           annotations->setData(keys, styles, labels, true);
+                       }};
+
+    cases << BenchCase{"graphs32_pixmap", qint64(1e8), QSize(3840, 2160), [](BenchContext &ctx) { setupManyGraphs(ctx, false); }};
+    cases << BenchCase{"graphs32_tiled", qint64(1e8), QSize(3840, 2160), [](BenchContext &ctx) { setupManyGraphs(ctx, true); }};
+
+    cases << BenchCase{"history", qint64(1e8), QSize(), [](BenchContext &ctx) {
+                           // 模拟10Hz采样的时间戳与量化后的传感器信号
+                           const int       count = int(ctx.size);
+                           QVector<double> keys(count);
+                           QVector<double> values(count);
+                           for (int i = 0; i < count; ++i) {
+                               keys[i]   = 1.7e9 + i * 0.1;
+                               values[i] = std::round((20 + 5 * std::sin(i * 0.001)) * 100) / 100.0;
+                           }
+
+                           QSharedPointer<QCPGraphHistory> history(new QCPGraphHistory);
+                           QElapsedTimer                   timer;
+                           timer.start();
+                           history->add(keys, values);
+                           const double encodeSec = qMax(1e-9, timer.nsecsElapsed() / 1e9);
+                           keys.clear();
+                           values.clear();
+
+                           QVector<QCPGraphData> decoded;
+                           decoded.reserve(history->blockSize());
+                           timer.restart();
+                           for (int i = 0; i < history->blockCount(); ++i) {
+                               decoded.resize(0);
+                               history->decodeBlock(i, &decoded);
+                           }
+                           const double decodeSec = qMax(1e-9, timer.nsecsElapsed() / 1e9);
+
+                           ctx.extra["compression_ratio"]   = history->compressionRatio();
+                           ctx.extra["compressed_bytes"]    = double(history->compressedSize());
+                           ctx.extra["uncompressed_bytes"]  = double(history->uncompressedSize());
+                           ctx.extra["encode_points_per_s"] = count / encodeSec;
+                           ctx.extra["decode_points_per_s"] = count / decodeSec;
+
+                           QCPGraph *graph = ctx.plot->addGraph();
+                           graph->setHistory(history);
+                       }};
+
+    return cases;
+}
+
+QJsonObject runCase(const BenchCase &benchCase, qint64 size, const BenchOptions &options)
+{
+    const QSize   viewport  = benchCase.viewport.isEmpty() ? QSize(options.width, options.height) : benchCase.viewport;
+    const qint64  heapBase  = resetHeapPeak();
+    const quint64 allocBase = allocCount();
+
+    QJsonObject result;
+    result["case"]   = benchCase.name;
+    result["size"]   = double(size);
+    result["width"]  = viewport.width();
+    result["height"] = viewport.height();
+
+    QCustomPlot  plot;
+    BenchContext ctx;
+    ctx.plot = &plot;
+    ctx.size = size;
+    plot.resize(viewport);
+
+    QElapsedTimer setupTimer;
+    setupTimer.start();
+    benchCase.setup(ctx);
+    plot.rescaleAxes();
+    result["setup_ms"] = setupTimer.nsecsElapsed() / 1e6;
+
+    // 首次重绘会建立刻度标签等缓存，不计入统计
+    QElapsedTimer firstTimer;
+    firstTimer.start();
+    plot.replot();
+    result["first_replot_ms"] = firstTimer.nsecsElapsed() / 1e6;
+
+    double replotAllocs = 0;
+    result["replot"]    = toJson(measure(options.repeat, [&](int) { plot.replot(); }, &replotAllocs));
+
+    // 平移坐标轴后重绘，覆盖交互拖动时的刻度与布局更新路径
+    const double step      = plot.xAxis->range().size() * 0.01;
+    double       panAllocs = 0;
+    result["pan"]          = toJson(measure(options.repeat, [&](int i) {
+                               plot.xAxis->moveRange(i % 2 ? -step : step);
+                               plot.replot();
+                           }, &panAllocs));
+
+    // 导出路径：直接绘制到QImage，不经过分层缓冲
+    QImage image(viewport, QImage::Format_ARGB32_Premultiplied);
+    double renderAllocs = 0;
+    result["render_image"] = toJson(measure(options.repeat, [&](int) {
+                                       image.fill(Qt::white);
+                                       QCPPainter painter(&image);
+                                       plot.toPainter(&painter, viewport.width(), viewport.height());
+                                   }, &renderAllocs));
+
+#ifdef BENCH_TRACK_HEAP
+    QJsonObject heap;
+    heap["allocations_total"]  = double(allocCount() - allocBase);
+    heap["allocations_replot"] = replotAllocs;
+    heap["allocations_pan"]    = panAllocs;
+    heap["allocations_render"] = renderAllocs;
+    heap["peak_bytes"]         = double(heapPeak() - heapBase);
+    heap["retained_bytes"]     = double(heapBytes() - heapBase);
+    result["heap"]             = heap;
+#else
+    Q_UNUSED(allocBase)
+    Q_UNUSED(heapBase)
+    result["heap"] = QJsonValue::Null;
+#endif
+    result["max_rss_bytes"] = double(maxRssBytes());
+
+    for (auto it = ctx.extra.constBegin(); it != ctx.extra.constEnd(); ++it)
+        result[it.key()] = it.value();
+    return result;
+}
+
+QList<qint64> parseSizes(const QString &text, bool *ok)
+{
+    QList<qint64> sizes;
+    *ok = true;
+    for (const QString &part : text.split(',', Qt::SkipEmptyParts)) {
+        // 支持1e6这样的科学计数写法
+        bool         valueOk = false;
+        const double value   = part.trimmed().toDouble(&valueOk);
+        if (!valueOk || value < 1 || value > 1e8) {
+            *ok = false;
+            return sizes;
+        }
+        sizes << qint64(value);
+    }
+    return sizes;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 没有显示环境时使用offscreen平台，便于在CI中运行
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("bench_qcustomplot");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("QCustomPlot rendering benchmark");
+    parser.addHelpOption();
+    QCommandLineOption sizesOption("sizes", "Comma separated data sizes, e.g. 1e3,1e4,1e8.", "list", "1e3,1e4,1e5,1e6");
+    QCommandLineOption repeatOption("repeat", "Timed iterations per measurement.", "count", "10");
+    QCommandLineOption widthOption("width", "Viewport width in pixels.", "pixels", "1280");
+    QCommandLineOption heightOption("height", "Viewport height in pixels.", "pixels", "720");
+    QCommandLineOption filterOption("filter", "Regular expression selecting the cases to run.", "regexp", ".*");
+    QCommandLineOption outputOption("output", "Write the JSON report to this file instead of stdout.", "file");
+    QCommandLineOption listOption("list", "List the available cases and exit.");
+    parser.addOptions({sizesOption, repeatOption, widthOption, heightOption, filterOption, outputOption, listOption});
+    parser.process(app);
+
+    const QList<BenchCase> cases = createCases();
+    if (parser.isSet(listOption)) {
+        for (const BenchCase &benchCase : cases)
+            std::printf("%s\n", qPrintable(benchCase.name));
+        return 0;
+    }
+
+    bool                ok    = false;
+    const QList<qint64> sizes = parseSizes(parser.value(sizesOption), &ok);
+    BenchOptions        options;
+    options.repeat = parser.value(repeatOption).toInt();
+    options.width  = parser.value(widthOption).toInt();
+    options.height = parser.value(heightOption).toInt();
+    const QRegularExpression filter(parser.value(filterOption));
+    if (!ok || sizes.isEmpty() || options.repeat < 1 || options.width < 1 || options.height < 1 || !filter.isValid()) {
+        std::fprintf(stderr, "invalid arguments, see --help\n");
+        return 1;
+    }
+
+    QJsonArray results;
+    for (const BenchCase &benchCase : cases) {
+        if (!filter.match(benchCase.name).hasMatch())
+            continue;
+        for (qint64 size : sizes) {
+            if (size > benchCase.maxSize) {
+                std::fprintf(stderr, "%-22s %12lld  skipped\n", qPrintable(benchCase.name), size);
+                continue;
+            }
+            const QJsonObject result = runCase(benchCase, size, options);
+            std::fprintf(stderr, "%-22s %12lld  replot %9.3f ms  render %9.3f ms\n", qPrintable(benchCase.name), size,
+                         result["replot"].toObject()["median_ms"].toDouble(),
+                         result["render_image"].toObject()["median_ms"].toDouble());
+            results.append(result);
+        }
+    }
+
+    QJsonObject meta;
+    meta["qt"]       = qVersion();
+    meta["platform"] = QApplication::platformName();
+    meta["os"]       = QSysInfo::prettyProductName();
+    meta["cpu"]      = QSysInfo::currentCpuArchitecture();
+    meta["threads"]  = QThread::idealThreadCount();
+    meta["width"]    = options.width;
+    meta["height"]   = options.height;
+    meta["repeat"]   = options.repeat;
+#ifdef BENCH_TRACK_HEAP
+    meta["heap_tracking"] = true;
+#else
+    meta["heap_tracking"] = false;
+#endif
+    meta["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+
+    QJsonObject root;
+    root["meta"]    = meta;
+    root["results"] = results;
+    const QByteArray json = QJsonDocument(root).toJson();
+
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::fprintf(stderr, "cannot write %s\n", qPrintable(file.fileName()));
+            return 1;
+        }
+        file.write(json);
+    } else {
+        std::fwrite(json.constData(), 1, size_t(json.size()), stdout);
+    }
+    return 0;
+}
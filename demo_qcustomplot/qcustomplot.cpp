@@ -510,7 +510,9 @@ void QCPPainter::makeNonCosmetic()
   previous frame.
 
   The simplest paint buffer implementation is \ref QCPPaintBufferPixmap which allows regular
-  software rendering via the raster engine. Hardware accelerated rendering via pixel buffers and
+  software rendering via the raster engine. \ref QCPPaintBufferTiledImage also uses the raster
+  engine, but splits the rasterization across multiple threads. It is used if \ref
+  QCustomPlot::setTiledPainting is enabled. Hardware accelerated rendering via pixel buffers and
   frame buffer objects is provided by \ref QCPPaintBufferGlPbuffer and \ref QCPPaintBufferGlFbo.
   They are used automatically if \ref QCustomPlot::setOpenGl is enabled.
 */
@@ -720,6 +722,172 @@ void QCPPaintBufferPixmap::reallocateBuffer()
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPPaintBufferTiledImage
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPPaintBufferTiledImage
+  \brief A paint buffer based on QImage, using multi-threaded software raster rendering
+
+  This paint buffer uses software rendering like \ref QCPPaintBufferPixmap, but distributes the
+  rasterization across a thread pool. It is meant for machines without OpenGL support, e.g.
+  headless render nodes, and is used if \ref QCustomPlot::setTiledPainting is enabled.
+
+  The painter returned by \ref startPainting records the draw calls of the layer into a QPicture.
+  In \ref donePainting, the internal QImage is split into \ref tileCount horizontal tiles and the
+  recording is replayed into every tile concurrently. Each tile wraps its rows of the buffer in a
+  separate QImage, so the tiles are independent paint devices which clip to their own bounds, and
+  no composing step is needed afterwards. The calling thread paints the first tile itself, the
+  remaining tiles are painted by \c QThreadPool::globalInstance().
+
+  The layerables themselves are still drawn only once, in the calling thread. Pixmaps they draw,
+  e.g. cached tick labels, are replayed in worker threads, which requires a platform that supports
+  threaded pixmaps (all raster based platforms, including \c offscreen, do).
+*/
+
+/*! \internal
+
+  Paints one tile of a \ref QCPPaintBufferTiledImage in a worker thread and signals completion via
+  a semaphore.
+*/
+class QCPPaintBufferTileTask : public QRunnable
+{
+public:
+  QCPPaintBufferTileTask(const QCPPaintBufferTiledImage *buffer, uchar *bits, int tileIndex, int tileCount, const QPicture &picture, QSemaphore *done) :
+    mBuffer(buffer),
+    mBits(bits),
+    mTileIndex(tileIndex),
+    mTileCount(tileCount),
+    mPicture(picture),
+    mDone(done)
+  {}
+  
+  virtual void run() Q_DECL_OVERRIDE
+  {
+    mBuffer->paintTile(mBits, mTileIndex, mTileCount, mPicture);
+    mDone->release();
+  }
+  
+protected:
+  const QCPPaintBufferTiledImage *mBuffer;
+  uchar *mBits;
+  int mTileIndex, mTileCount;
+  QPicture mPicture;
+  QSemaphore *mDone;
+};
+
+/*!
+  Creates a tiled image paint buffer instance with the specified \a size and \a devicePixelRatio,
+  if applicable. The buffer is split into \a tileCount horizontal tiles. If \a tileCount is zero
+  or negative, \c QThread::idealThreadCount() tiles are used.
+*/
+QCPPaintBufferTiledImage::QCPPaintBufferTiledImage(const QSize &size, double devicePixelRatio, int tileCount) :
+  QCPAbstractPaintBuffer(size, devicePixelRatio),
+  mTileCount(tileCount > 0 ? tileCount : qMax(1, QThread::idealThreadCount()))
+{
+  QCPPaintBufferTiledImage::reallocateBuffer();
+}
+
+QCPPaintBufferTiledImage::~QCPPaintBufferTiledImage()
+{
+}
+
+/* inherits documentation from base class */
+QCPPainter *QCPPaintBufferTiledImage::startPainting()
+{
+  mRecording = QPicture();
+  QCPPainter *result = new QCPPainter(&mRecording);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+  result->setRenderHint(QPainter::HighQualityAntialiasing);
+#endif
+  return result;
+}
+
+/*! \internal
+
+  Replays the draw calls recorded since \ref startPainting into all tiles of the buffer, using the
+  calling thread and the global thread pool. Returns once all tiles are painted.
+*/
+void QCPPaintBufferTiledImage::donePainting()
+{
+  const int tileCount = qMin(mTileCount, mBuffer.height());
+  if (tileCount < 1)
+    return;
+  uchar *bits = mBuffer.bits(); // detaches once here, so the worker threads only write to the pixel memory
+  QSemaphore done;
+  for (int i=1; i<tileCount; ++i)
+  {
+    // QPicture::play isn't reentrant for shared pictures, so each worker gets its own copy:
+    QPicture tilePicture(mRecording);
+    tilePicture.detach();
+    QThreadPool::globalInstance()->start(new QCPPaintBufferTileTask(this, bits, i, tileCount, tilePicture, &done));
+  }
+  paintTile(bits, 0, tileCount, mRecording);
+  done.acquire(tileCount-1);
+  mRecording = QPicture();
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferTiledImage::draw(QCPPainter *painter) const
+{
+  if (painter && painter->isActive())
+    painter->drawImage(0, 0, mBuffer);
+  else
+    qDebug() << Q_FUNC_INFO << "invalid or inactive painter passed";
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferTiledImage::clear(const QColor &color)
+{
+  mBuffer.fill(color);
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferTiledImage::reallocateBuffer()
+{
+  setInvalidated();
+  if (!qFuzzyCompare(1.0, mDevicePixelRatio))
+  {
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+    mBuffer = QImage(mSize*mDevicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    mBuffer.setDevicePixelRatio(mDevicePixelRatio);
+#else
+    qDebug() << Q_FUNC_INFO << "Device pixel ratios not supported for Qt versions before 5.4";
+    mDevicePixelRatio = 1.0;
+    mBuffer = QImage(mSize, QImage::Format_ARGB32_Premultiplied);
+#endif
+  } else
+  {
+    mBuffer = QImage(mSize, QImage::Format_ARGB32_Premultiplied);
+  }
+}
+
+/*! \internal
+
+  Replays \a picture into the tile with index \a tileIndex out of \a tileCount horizontal tiles.
+  \a bits is the pixel memory of the buffer, obtained by the calling thread before distributing the
+  tiles.
+
+  This method may be called concurrently for different tiles, as long as each call gets its own
+  copy of the picture.
+*/
+void QCPPaintBufferTiledImage::paintTile(uchar *bits, int tileIndex, int tileCount, const QPicture &picture) const
+{
+  const int top = mBuffer.height()*tileIndex/tileCount;
+  const int bottom = mBuffer.height()*(tileIndex+1)/tileCount;
+  if (bottom <= top)
+    return;
+  // wrap the rows of this tile in a separate image, so it is an independent paint device:
+  QImage tile(bits+top*mBuffer.bytesPerLine(), mBuffer.width(), bottom-top, mBuffer.bytesPerLine(), mBuffer.format());
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+  tile.setDevicePixelRatio(mDevicePixelRatio);
+#endif
+  QCPPainter painter(&tile);
+  painter.translate(0, -top/mDevicePixelRatio);
+  painter.drawPicture(0, 0, picture);
+}
+
+
 #ifdef QCP_OPENGL_PBUFFER
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////// QCPPaintBufferGlPbuffer
@@ -1142,19 +1310,38 @@ void QCPLayer::setMode(QCPLayer::LayerMode mode)
 */
 void QCPLayer::draw(QCPPainter *painter)
 {
+  const bool profiling = mParentPlot->profiler()->enabled();
   foreach (QCPLayerable *child, mChildren)
   {
     if (child->realVisibility())
     {
-      painter->save();
-      painter->setClipRect(child->clipRect().translated(0, -1));
-      child->applyDefaultAntialiasingHint(painter);
-      child->draw(painter);
-      painter->restore();
+      if (profiling) // only plottables are recorded individually
+      {
+        QCPAbstractPlottable *plottable = qobject_cast<QCPAbstractPlottable*>(child);
+        QCPProfilerScope drawScope(plottable ? mParentPlot : nullptr, QCPProfiler::phPlottableDraw, plottable ? plottable->name() : QString());
+        drawChild(painter, child);
+      } else
+        drawChild(painter, child);
     }
   }
 }
 
+/*! \internal
+
+  Draws the single layerable \a child of this layer with the provided \a painter, clipped to the
+  child's clip rect.
+
+  \see draw
+*/
+void QCPLayer::drawChild(QCPPainter *painter, QCPLayerable *child)
+{
+  painter->save();
+  painter->setClipRect(child->clipRect().translated(0, -1));
+  child->applyDefaultAntialiasingHint(painter);
+  child->draw(painter);
+  painter->restore();
+}
+
 /*! \internal
 
   Draws the contents of this layer into the paint buffer which is associated with this layer. The
@@ -1397,6 +1584,8 @@ QCPLayerable::~QCPLayerable()
 void QCPLayerable::setVisible(bool on)
 {
   mVisible = on;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -3264,6 +3453,8 @@ void QCPLayoutElement::setMargins(const QMargins &margins)
     mMargins = margins;
     mRect = mOuterRect.adjusted(mMargins.left(), mMargins.top(), -mMargins.right(), -mMargins.bottom());
   }
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -3281,6 +3472,8 @@ void QCPLayoutElement::setMinimumMargins(const QMargins &margins)
   {
     mMinimumMargins = margins;
   }
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -3296,6 +3489,8 @@ void QCPLayoutElement::setMinimumMargins(const QMargins &margins)
 void QCPLayoutElement::setAutoMargins(QCP::MarginSides sides)
 {
   mAutoMargins = sides;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -3378,6 +3573,8 @@ void QCPLayoutElement::setSizeConstraintRect(SizeConstraintRect constraintRect)
     if (mParentLayout)
       mParentLayout->sizeConstraintsChanged();
   }
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -3419,6 +3616,8 @@ void QCPLayoutElement::setMarginGroup(QCP::MarginSides sides, QCPMarginGroup *gr
       }
     }
   }
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -3797,6 +3996,8 @@ void QCPLayout::sizeConstraintsChanged() const
     w->updateGeometry();
   else if (QCPLayout *l = qobject_cast<QCPLayout*>(parent()))
     l->sizeConstraintsChanged();
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*! \internal
@@ -3840,6 +4041,8 @@ void QCPLayout::adoptElement(QCPLayoutElement *el)
     el->layoutChanged();
   } else
     qDebug() << Q_FUNC_INFO << "Null element passed";
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*! \internal
@@ -3862,6 +4065,8 @@ void QCPLayout::releaseElement(QCPLayoutElement *el)
     // Note: Don't initializeParentPlot(0) here, because layout element will stay in same parent plot
   } else
     qDebug() << Q_FUNC_INFO << "Null element passed";
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*! \internal
@@ -4248,6 +4453,8 @@ void QCPLayoutGrid::setColumnStretchFactor(int column, double factor)
       qDebug() << Q_FUNC_INFO << "Invalid stretch factor, must be positive:" << factor;
   } else
     qDebug() << Q_FUNC_INFO << "Invalid column:" << column;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4277,6 +4484,8 @@ void QCPLayoutGrid::setColumnStretchFactors(const QList<double> &factors)
     }
   } else
     qDebug() << Q_FUNC_INFO << "Column count not equal to passed stretch factor count:" << factors;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4301,6 +4510,8 @@ void QCPLayoutGrid::setRowStretchFactor(int row, double factor)
       qDebug() << Q_FUNC_INFO << "Invalid stretch factor, must be positive:" << factor;
   } else
     qDebug() << Q_FUNC_INFO << "Invalid row:" << row;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4330,6 +4541,8 @@ void QCPLayoutGrid::setRowStretchFactors(const QList<double> &factors)
     }
   } else
     qDebug() << Q_FUNC_INFO << "Row count not equal to passed stretch factor count:" << factors;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4340,6 +4553,8 @@ void QCPLayoutGrid::setRowStretchFactors(const QList<double> &factors)
 void QCPLayoutGrid::setColumnSpacing(int pixels)
 {
   mColumnSpacing = pixels;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4350,6 +4565,8 @@ void QCPLayoutGrid::setColumnSpacing(int pixels)
 void QCPLayoutGrid::setRowSpacing(int pixels)
 {
   mRowSpacing = pixels;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4372,6 +4589,8 @@ void QCPLayoutGrid::setRowSpacing(int pixels)
 void QCPLayoutGrid::setWrap(int count)
 {
   mWrap = qMax(0, count);
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4422,6 +4641,8 @@ void QCPLayoutGrid::setFillOrder(FillOrder order, bool rearrange)
     foreach (QCPLayoutElement *tempElement, tempElements)
       addElement(tempElement);
   }
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4455,6 +4676,8 @@ void QCPLayoutGrid::expandTo(int newRowCount, int newColumnCount)
   }
   while (mColumnStretchFactors.size() < newColCount)
     mColumnStretchFactors.append(1);
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4481,6 +4704,8 @@ void QCPLayoutGrid::insertRow(int newIndex)
   for (int col=0; col<columnCount(); ++col)
     newRow.append(nullptr);
   mElements.insert(newIndex, newRow);
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4506,6 +4731,8 @@ void QCPLayoutGrid::insertColumn(int newIndex)
   mColumnStretchFactors.insert(newIndex, 1);
   for (int row=0; row<rowCount(); ++row)
     mElements[row].insert(newIndex, nullptr);
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4742,6 +4969,8 @@ void QCPLayoutGrid::simplify()
         mElements[row].removeAt(col);
     }
   }
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /* inherits documentation from base class */
@@ -4954,6 +5183,8 @@ void QCPLayoutInset::setInsetPlacement(int index, QCPLayoutInset::InsetPlacement
     mInsetPlacement[index] = placement;
   else
     qDebug() << Q_FUNC_INFO << "Invalid element index:" << index;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4970,6 +5201,8 @@ void QCPLayoutInset::setInsetAlignment(int index, Qt::Alignment alignment)
     mInsetAlignment[index] = alignment;
   else
     qDebug() << Q_FUNC_INFO << "Invalid element index:" << index;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -4989,6 +5222,8 @@ void QCPLayoutInset::setInsetRect(int index, const QRectF &rect)
     mInsetRect[index] = rect;
   else
     qDebug() << Q_FUNC_INFO << "Invalid element index:" << index;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /* inherits documentation from base class */
@@ -6116,6 +6351,18 @@ void QCPLabelPainterPrivate::analyzeFontMetrics()
   about the parameters and expected return values.
 */
 
+/* start of documentation of inline functions */
+
+/*! \fn void QCPAxisTicker::invalidateCache()
+  
+  Drops the result remembered by \ref generate, so the next call recalculates the ticks and labels.
+  Call this when state that the ticks depend on changed outside of the ticker's setters.
+  
+  \see setCaching
+*/
+
+/* end of documentation of inline functions */
+
 /*!
   Constructs the ticker and sets reasonable default values. Axis tickers are commonly created
   managed by a QSharedPointer, which then can be passed to QCPAxis::setTicker.
@@ -6123,8 +6370,14 @@ void QCPLabelPainterPrivate::analyzeFontMetrics()
 QCPAxisTicker::QCPAxisTicker() :
   mTickStepStrategy(tssReadability),
   mTickCount(5),
-  mTickOrigin(0)
+  mTickOrigin(0),
+  mCaching(false)
 {
+  mCache.valid = false;
+  mCache.precision = 0;
+  mCache.tickStep = 0;
+  mCache.hasSubTicks = false;
+  mCache.hasTickLabels = false;
 }
 
 QCPAxisTicker::~QCPAxisTicker()
@@ -6139,6 +6392,7 @@ QCPAxisTicker::~QCPAxisTicker()
 void QCPAxisTicker::setTickStepStrategy(QCPAxisTicker::TickStepStrategy strategy)
 {
   mTickStepStrategy = strategy;
+  invalidateCache();
 }
 
 /*!
@@ -6155,6 +6409,7 @@ void QCPAxisTicker::setTickCount(int count)
     mTickCount = count;
   else
     qDebug() << Q_FUNC_INFO << "tick count must be greater than zero:" << count;
+  invalidateCache();
 }
 
 /*!
@@ -6168,6 +6423,29 @@ void QCPAxisTicker::setTickCount(int count)
 void QCPAxisTicker::setTickOrigin(double origin)
 {
   mTickOrigin = origin;
+  invalidateCache();
+}
+
+/*!
+  Sets whether the ticker remembers the result of its last \ref generate call.
+  
+  If enabled, a call with the same range, locale and number format returns the previous ticks and
+  labels without recalculating them. If only the range changed but the tick step stayed the same
+  (e.g. because the axis was panned), the labels of ticks that remain visible are reused, and only
+  the labels of newly visible ticks are created via \ref createLabelVector.
+  
+  The setters of the built-in tickers drop the cache, so QCPAxisTickerDateTime, QCPAxisTickerTime,
+  QCPAxisTickerFixed, QCPAxisTickerPi and QCPAxisTickerLog enable caching in their constructors, as
+  does QCPAxis for its default ticker. It is disabled for QCPAxisTickerText, whose tick map may be
+  modified through \ref QCPAxisTickerText::ticks, and for QCPAxisTicker instances created directly,
+  since direct subclasses may depend on state the cache can't observe. Subclasses of the built-in
+  tickers inherit enabled caching; if their ticks or labels depend on additional state, they must
+  call \ref invalidateCache when that state changes, or disable caching.
+*/
+void QCPAxisTicker::setCaching(bool enabled)
+{
+  mCaching = enabled;
+  invalidateCache();
 }
 
 /*!
@@ -6182,9 +6460,23 @@ void QCPAxisTicker::setTickOrigin(double origin)
   The output parameters \a subTicks and \a tickLabels are optional (set them to \c nullptr if not
   needed) and are respectively filled with sub tick coordinates, and tick label strings belonging
   to \a ticks by index.
+  
+  If \ref setCaching is enabled, the result of the previous call is reused where possible.
 */
 void QCPAxisTicker::generate(const QCPRange &range, const QLocale &locale, QChar formatChar, int precision, QVector<double> &ticks, QVector<double> *subTicks, QVector<QString> *tickLabels)
 {
+  const bool sameFormat = mCaching && mCache.valid && mCache.formatChar == formatChar && mCache.precision == precision && mCache.locale == locale;
+  // unchanged range and configuration, return previous result:
+  if (sameFormat && mCache.range == range && (!subTicks || mCache.hasSubTicks) && (!tickLabels || mCache.hasTickLabels))
+  {
+    ticks = mCache.ticks;
+    if (subTicks)
+      *subTicks = mCache.subTicks;
+    if (tickLabels)
+      *tickLabels = mCache.tickLabels;
+    return;
+  }
+  
   // generate (major) ticks:
   double tickStep = getTickStep(range);
   ticks = createTickVector(tickStep, range);
@@ -6203,9 +6495,30 @@ void QCPAxisTicker::generate(const QCPRange &range, const QLocale &locale, QChar
   
   // finally trim also outliers (no further clipping happens in axis drawing):
   trimTicks(range, ticks, false);
-  // generate labels for visible ticks if requested:
+  // generate labels for visible ticks if requested. If the tick step is unchanged (e.g. the range
+  // was only panned), ticks that were already visible keep their previously formatted labels:
   if (tickLabels)
-    *tickLabels = createLabelVector(ticks, locale, formatChar, precision);
+  {
+    if (sameFormat && mCache.hasTickLabels && mCache.tickStep == tickStep)
+      *tickLabels = createLabelVectorReusingCache(ticks, locale, formatChar, precision);
+    else
+      *tickLabels = createLabelVector(ticks, locale, formatChar, precision);
+  }
+  
+  if (mCaching)
+  {
+    mCache.valid = true;
+    mCache.range = range;
+    mCache.locale = locale;
+    mCache.formatChar = formatChar;
+    mCache.precision = precision;
+    mCache.tickStep = tickStep;
+    mCache.ticks = ticks;
+    mCache.hasSubTicks = subTicks;
+    mCache.subTicks = subTicks ? *subTicks : QVector<double>();
+    mCache.hasTickLabels = tickLabels;
+    mCache.tickLabels = tickLabels ? *tickLabels : QVector<QString>();
+  }
 }
 
 /*! \internal
@@ -6371,6 +6684,46 @@ QVector<QString> QCPAxisTicker::createLabelVector(const QVector<double> &ticks,
   return result;
 }
 
+/*! \internal
+  
+  Returns the tick labels for \a ticks like \ref createLabelVector, but takes the labels of ticks
+  that are also contained in the cached result of the previous \ref generate call from the cache.
+  Only the labels of the remaining ticks are created, by passing them to \ref createLabelVector.
+  
+  The caller must make sure the cached labels were created with the same locale, number format and
+  tick step. Both \a ticks and the cached ticks must be sorted in ascending order.
+*/
+QVector<QString> QCPAxisTicker::createLabelVectorReusingCache(const QVector<double> &ticks, const QLocale &locale, QChar formatChar, int precision)
+{
+  QVector<QString> result(ticks.size());
+  QVector<double> newTicks;
+  QVector<int> newTickIndices;
+  const QVector<double> &cachedTicks = mCache.ticks;
+  int cachedIndex = 0;
+  for (int i=0; i<ticks.size(); ++i)
+  {
+    const double tick = ticks.at(i);
+    while (cachedIndex < cachedTicks.size() && cachedTicks.at(cachedIndex) < tick)
+      ++cachedIndex;
+    if (cachedIndex < cachedTicks.size() && cachedTicks.at(cachedIndex) == tick)
+    {
+      result[i] = mCache.tickLabels.at(cachedIndex);
+    } else
+    {
+      newTicks.append(tick);
+      newTickIndices.append(i);
+    }
+  }
+  
+  if (!newTicks.isEmpty())
+  {
+    const QVector<QString> newLabels = createLabelVector(newTicks, locale, formatChar, precision);
+    for (int i=0; i<newTickIndices.size(); ++i)
+      result[newTickIndices.at(i)] = newLabels.value(i);
+  }
+  return result;
+}
+
 /*! \internal
   
   Removes tick coordinates from \a ticks which lie outside the specified \a range. If \a
@@ -6530,6 +6883,7 @@ QCPAxisTickerDateTime::QCPAxisTickerDateTime() :
   mDateStrategy(dsNone)
 {
   setTickCount(4);
+  setCaching(true);
 }
 
 /*!
@@ -6572,6 +6926,7 @@ QCPAxisTickerDateTime::QCPAxisTickerDateTime() :
 void QCPAxisTickerDateTime::setDateTimeFormat(const QString &format)
 {
   mDateTimeFormat = format;
+  invalidateCache();
 }
 
 /*!
@@ -6590,6 +6945,7 @@ void QCPAxisTickerDateTime::setDateTimeFormat(const QString &format)
 void QCPAxisTickerDateTime::setDateTimeSpec(Qt::TimeSpec spec)
 {
   mDateTimeSpec = spec;
+  invalidateCache();
 }
 
 # if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
@@ -6603,6 +6959,7 @@ void QCPAxisTickerDateTime::setTimeZone(const QTimeZone &zone)
 {
   mTimeZone = zone;
   mDateTimeSpec = Qt::TimeZone;
+  invalidateCache();
 }
 #endif
 
@@ -6886,6 +7243,7 @@ QCPAxisTickerTime::QCPAxisTickerTime() :
   mBiggestUnit(tuHours)
 {
   setTickCount(4);
+  setCaching(true);
   mFieldWidth[tuMilliseconds] = 3;
   mFieldWidth[tuSeconds] = 2;
   mFieldWidth[tuMinutes] = 2;
@@ -6939,6 +7297,7 @@ void QCPAxisTickerTime::setTimeFormat(const QString &format)
       mBiggestUnit = unit;
     }
   }
+  invalidateCache();
 }
 
 /*!
@@ -6951,6 +7310,7 @@ void QCPAxisTickerTime::setTimeFormat(const QString &format)
 void QCPAxisTickerTime::setFieldWidth(QCPAxisTickerTime::TimeUnit unit, int width)
 {
   mFieldWidth[unit] = qMax(width, 1);
+  invalidateCache();
 }
 
 /*! \internal
@@ -7117,6 +7477,7 @@ QCPAxisTickerFixed::QCPAxisTickerFixed() :
   mTickStep(1.0),
   mScaleStrategy(ssNone)
 {
+  setCaching(true);
 }
 
 /*!
@@ -7134,6 +7495,7 @@ void QCPAxisTickerFixed::setTickStep(double step)
     mTickStep = step;
   else
     qDebug() << Q_FUNC_INFO << "tick step must be greater than zero:" << step;
+  invalidateCache();
 }
 
 /*!
@@ -7146,6 +7508,7 @@ void QCPAxisTickerFixed::setTickStep(double step)
 void QCPAxisTickerFixed::setScaleStrategy(QCPAxisTickerFixed::ScaleStrategy strategy)
 {
   mScaleStrategy = strategy;
+  invalidateCache();
 }
 
 /*! \internal
@@ -7220,6 +7583,9 @@ double QCPAxisTickerFixed::getTickStep(const QCPRange &range)
 
   You can access the map directly in order to add, remove or manipulate ticks, as an alternative to
   using the methods provided by QCPAxisTickerText, such as \ref setTicks and \ref addTick.
+  
+  Calling this method drops the result cache of the ticker (see \ref setCaching). If you keep the
+  returned reference and modify the map after the next replot, call \ref invalidateCache yourself.
 */
 
 /* end of documentation of inline functions */
@@ -7436,6 +7802,7 @@ QCPAxisTickerPi::QCPAxisTickerPi() :
   mPiTickStep(0)
 {
   setTickCount(4);
+  setCaching(true);
 }
 
 /*!
@@ -7448,6 +7815,7 @@ QCPAxisTickerPi::QCPAxisTickerPi() :
 void QCPAxisTickerPi::setPiSymbol(QString symbol)
 {
   mPiSymbol = symbol;
+  invalidateCache();
 }
 
 /*!
@@ -7459,6 +7827,7 @@ void QCPAxisTickerPi::setPiSymbol(QString symbol)
 void QCPAxisTickerPi::setPiValue(double pi)
 {
   mPiValue = pi;
+  invalidateCache();
 }
 
 /*!
@@ -7472,6 +7841,7 @@ void QCPAxisTickerPi::setPiValue(double pi)
 void QCPAxisTickerPi::setPeriodicity(int multiplesOfPi)
 {
   mPeriodicity = qAbs(multiplesOfPi);
+  invalidateCache();
 }
 
 /*!
@@ -7481,6 +7851,7 @@ void QCPAxisTickerPi::setPeriodicity(int multiplesOfPi)
 void QCPAxisTickerPi::setFractionStyle(QCPAxisTickerPi::FractionStyle style)
 {
   mFractionStyle = style;
+  invalidateCache();
 }
 
 /*! \internal
@@ -7730,6 +8101,7 @@ QCPAxisTickerLog::QCPAxisTickerLog() :
   mSubTickCount(8), // generates 10 intervals
   mLogBaseLnInv(1.0/qLn(mLogBase))
 {
+  setCaching(true);
 }
 
 /*!
@@ -7744,6 +8116,7 @@ void QCPAxisTickerLog::setLogBase(double base)
     mLogBaseLnInv = 1.0/qLn(mLogBase);
   } else
     qDebug() << Q_FUNC_INFO << "log base has to be greater than zero:" << base;
+  invalidateCache();
 }
 
 /*!
@@ -7762,6 +8135,7 @@ void QCPAxisTickerLog::setSubTickCount(int subTicks)
     mSubTickCount = subTicks;
   else
     qDebug() << Q_FUNC_INFO << "sub tick count can't be negative:" << subTicks;
+  invalidateCache();
 }
 
 /*! \internal
@@ -8240,11 +8614,13 @@ QCPAxis::QCPAxis(QCPAxisRect *parent, AxisType type) :
   mTicker(new QCPAxisTicker),
   mCachedMarginValid(false),
   mCachedMargin(0),
+  mAxisGroup(nullptr),
   mDragging(false)
 {
   setParent(parent);
   mGrid->setVisible(false);
   setAntialiased(false);
+  mTicker->setCaching(true); // the plain default ticker only depends on its own setters
   setLayer(mParentPlot->currentLayer()); // it's actually on that layer already, but we want it in front of the grid, so we place it on there again
   
   if (type == atTop)
@@ -8268,6 +8644,8 @@ QCPAxis::QCPAxis(QCPAxisRect *parent, AxisType type) :
 
 QCPAxis::~QCPAxis()
 {
+  if (mAxisGroup)
+    mAxisGroup->removeChild(this);
   delete mAxisPainter;
   delete mGrid; // delete grid here instead of via parent ~QObject for better defined deletion order
 }
@@ -8402,6 +8780,8 @@ void QCPAxis::setRange(const QCPRange &range)
   }
   emit rangeChanged(mRange);
   emit rangeChanged(mRange, oldRange);
+  if (mAxisGroup)
+    mAxisGroup->axisRangeChanged(this);
 }
 
 /*!
@@ -8474,6 +8854,8 @@ void QCPAxis::setRange(double lower, double upper)
   }
   emit rangeChanged(mRange);
   emit rangeChanged(mRange, oldRange);
+  if (mAxisGroup)
+    mAxisGroup->axisRangeChanged(this);
 }
 
 /*!
@@ -8517,6 +8899,8 @@ void QCPAxis::setRangeLower(double lower)
   }
   emit rangeChanged(mRange);
   emit rangeChanged(mRange, oldRange);
+  if (mAxisGroup)
+    mAxisGroup->axisRangeChanged(this);
 }
 
 /*!
@@ -8539,6 +8923,8 @@ void QCPAxis::setRangeUpper(double upper)
   }
   emit rangeChanged(mRange);
   emit rangeChanged(mRange, oldRange);
+  if (mAxisGroup)
+    mAxisGroup->axisRangeChanged(this);
 }
 
 /*!
@@ -8577,6 +8963,27 @@ void QCPAxis::setTicker(QSharedPointer<QCPAxisTicker> ticker)
   // no need to invalidate margin cache here because produced tick labels are checked for changes in setupTickVector
 }
 
+/*!
+  Makes this axis a member of the axis \a group, or removes it from its current group if \a group
+  is \c nullptr.
+
+  All axes of a group share one range and one ticker: the axis immediately takes over the current
+  range and ticker of the group (or, if it's the first member, the group adopts the range of the
+  axis, and its ticker if no ticker was set with QCPAxisGroup::setTicker), and any later range
+  change of a member is forwarded to the other members. See \ref QCPAxisGroup for details.
+*/
+void QCPAxis::setAxisGroup(QCPAxisGroup *group)
+{
+  if (mAxisGroup == group)
+    return;
+  
+  if (mAxisGroup)
+    mAxisGroup->removeChild(this);
+  mAxisGroup = group;
+  if (mAxisGroup)
+    mAxisGroup->addChild(this);
+}
+
 /*!
   Sets whether tick marks are displayed.
 
@@ -9126,6 +9533,8 @@ void QCPAxis::moveRange(double diff)
   }
   emit rangeChanged(mRange);
   emit rangeChanged(mRange, oldRange);
+  if (mAxisGroup)
+    mAxisGroup->axisRangeChanged(this);
 }
 
 /*!
@@ -9175,6 +9584,8 @@ void QCPAxis::scaleRange(double factor, double center)
   }
   emit rangeChanged(mRange);
   emit rangeChanged(mRange, oldRange);
+  if (mAxisGroup)
+    mAxisGroup->axisRangeChanged(this);
 }
 
 /*!
@@ -9467,6 +9878,22 @@ QCPAxis::AxisType QCPAxis::marginSideToAxisType(QCP::MarginSide side)
   return atLeft;
 }
 
+/*!
+  Transforms an axis type to the logically corresponding margin side. (QCPAxis::atLeft to
+  QCP::msLeft, QCPAxis::atRight to QCP::msRight, etc.)
+*/
+QCP::MarginSide QCPAxis::axisTypeToMarginSide(AxisType type)
+{
+  switch (type)
+  {
+    case atLeft: return QCP::msLeft;
+    case atRight: return QCP::msRight;
+    case atTop: return QCP::msTop;
+    case atBottom: return QCP::msBottom;
+  }
+  return QCP::msLeft;
+}
+
 /*!
   Returns the axis type that describes the opposite axis of an axis with the specified \a type.
 */
@@ -10031,6 +10458,7 @@ void QCPAxisPainterPrivate::draw(QCPPainter *painter)
     int distanceToAxis = margin;
     if (tickLabelSide == QCPAxis::lsInside)
       distanceToAxis = -(qMax(tickLengthIn, subTickLengthIn)+tickLabelPadding);
+    QCPProfilerScope tickLabelScope(mParentPlot, QCPProfiler::phTickLabels, label);
     for (int i=0; i<maxLabelIndex; ++i)
       placeTickLabel(painter, tickPositions.at(i), distanceToAxis, tickLabels.at(i), &tickLabelsSize);
     if (tickLabelSide == QCPAxis::lsOutside)
@@ -10545,6 +10973,269 @@ void QCPAxisPainterPrivate::getMaxTickLabelSize(const QFont &font, const QString
   if (finalSize.height() > tickLabelsSize->height())
     tickLabelsSize->setHeight(finalSize.height());
 }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPAxisGroup
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPAxisGroup
+  \brief Keeps the ranges of multiple axes synchronized, possibly across several QCustomPlot instances.
+  
+  A typical use case is a dashboard of vertically stacked plots whose key axes should pan and zoom
+  together. Connecting the \ref QCPAxis::rangeChanged signal of every axis to \ref
+  QCPAxis::setRange of every other axis causes a quadratic number of signal emissions and a separate
+  replot per plot on every pan. An axis group instead owns a single range: when the range of a
+  member axis changes, the group applies it once to each other member (each member emits its \ref
+  QCPAxis::rangeChanged signal once) and emits its own \ref rangeChanged signal.
+  
+  Axes are added to a group with \ref QCPAxis::setAxisGroup. Unlike most QCustomPlot objects, an
+  axis group isn't owned by a plot, since its members may belong to different plots. To lift the
+  synchronization, call \ref clear or delete the group.
+  
+  If \ref setAutoReplot is enabled (the default), a range change schedules one replot batch for all
+  plots that contain member axes. The batch runs in the next event loop iteration, replots each plot
+  once and queues the widget repaints, so Qt can repaint all plots in a single pass.
+  
+  All members share one ticker instance, so the ticks are computed only once per group and range
+  change: The group enables caching on its ticker (see QCPAxisTicker::setCaching), and members with
+  identical range and number format reuse the memoized result. Unless a ticker is installed with
+  \ref setTicker, the group adopts the ticker of its first member. Every axis that joins the group
+  takes over the group's ticker. To change the ticker of members, call \ref setTicker on the group
+  rather than QCPAxis::setTicker on a single member.
+*/
+
+/* start of documentation of inline functions */
+
+/*! \fn QList<QCPAxis*> QCPAxisGroup::axes() const
+  
+  Returns the axes that are members of this axis group.
+*/
+
+/*! \fn bool QCPAxisGroup::isEmpty() const
+  
+  Returns whether this axis group has no member axes.
+*/
+
+/*! \fn QSharedPointer<QCPAxisTicker> QCPAxisGroup::ticker() const
+  
+  Returns the ticker shared by all member axes, or a null pointer if the group never had a member
+  and no ticker was set.
+  
+  \see setTicker
+*/
+
+/* end of documentation of inline functions */
+/* start of documentation of signals */
+
+/*! \fn void QCPAxisGroup::rangeChanged(const QCPRange &newRange, const QCPRange &oldRange)
+  
+  This signal is emitted once per range change of the group, after the new range was applied to
+  all member axes.
+*/
+
+/* end of documentation of signals */
+
+/*!
+  Creates a new, empty axis group.
+*/
+QCPAxisGroup::QCPAxisGroup(QObject *parent) :
+  QObject(parent),
+  mRange(0, 5),
+  mAutoReplot(true),
+  mUpdating(false),
+  mReplotQueued(false)
+{
+}
+
+QCPAxisGroup::~QCPAxisGroup()
+{
+  clear();
+}
+
+/*!
+  Sets the range of all member axes to \a range.
+  
+  This slot may also be connected to signals of other objects that should drive the group, e.g. a
+  scroll bar.
+*/
+void QCPAxisGroup::setRange(const QCPRange &range)
+{
+  const QCPRange oldRange = mRange;
+  mRange = range;
+  mUpdating = true;
+  foreach (QCPAxis *axis, mAxes)
+    axis->setRange(mRange);
+  mUpdating = false;
+  if (mRange != oldRange)
+  {
+    emit rangeChanged(mRange, oldRange);
+    if (mAutoReplot)
+      queueReplot();
+  }
+}
+
+/*!
+  Sets whether a range change of the group automatically schedules a replot of all plots that
+  contain member axes.
+  
+  \see queueReplot
+*/
+void QCPAxisGroup::setAutoReplot(bool enabled)
+{
+  mAutoReplot = enabled;
+}
+
+/*!
+  Returns the plots that contain member axes of this group, each plot only once.
+*/
+QList<QCustomPlot*> QCPAxisGroup::plots() const
+{
+  QList<QCustomPlot*> result;
+  foreach (QCPAxis *axis, mAxes)
+  {
+    if (axis->parentPlot() && !result.contains(axis->parentPlot()))
+      result.append(axis->parentPlot());
+  }
+  return result;
+}
+
+/*!
+  Removes all axes from this group. The axes keep their current range, but are no longer
+  synchronized.
+*/
+void QCPAxisGroup::clear()
+{
+  // make all axes remove themselves from this group:
+  const QList<QCPAxis*> axes = mAxes;
+  for (int i=axes.size()-1; i>=0; --i)
+    axes.at(i)->setAxisGroup(nullptr); // removes itself from mAxes via removeChild
+}
+
+/*!
+  Sets the ticker shared by all member axes to \a ticker, installs it on all current members and
+  enables its result caching (see QCPAxisTicker::setCaching). Axes that join the group later take
+  over \a ticker, too.
+  
+  Since the group enables caching, subclasses of QCPAxisTicker whose ticks depend on state other
+  than their setters must call QCPAxisTicker::invalidateCache when that state changes.
+*/
+void QCPAxisGroup::setTicker(QSharedPointer<QCPAxisTicker> ticker)
+{
+  if (!ticker)
+  {
+    qDebug() << Q_FUNC_INFO << "can not set nullptr as axis ticker";
+    return;
+  }
+  mTicker = ticker;
+  mTicker->setCaching(true);
+  foreach (QCPAxis *axis, mAxes)
+    axis->setTicker(mTicker);
+}
+
+/*!
+  Schedules a replot of all plots that contain member axes. Multiple calls during the same event
+  loop iteration result in a single replot batch.
+  
+  \see setAutoReplot
+*/
+void QCPAxisGroup::queueReplot()
+{
+  if (mReplotQueued)
+    return;
+  mReplotQueued = true;
+  QTimer::singleShot(0, this, SLOT(replotMembers()));
+}
+
+/*! \internal
+  
+  Adds \a axis to the internal list of member axes and synchronizes its range and ticker with the
+  group. If the group has no ticker yet, it adopts the ticker of \a axis.
+  
+  This function does not modify the axis group property of \a axis.
+*/
+void QCPAxisGroup::addChild(QCPAxis *axis)
+{
+  if (mAxes.contains(axis))
+  {
+    qDebug() << Q_FUNC_INFO << "axis is already member of this group" << reinterpret_cast<quintptr>(axis);
+    return;
+  }
+  
+  if (mAxes.isEmpty())
+  {
+    mRange = axis->range();
+  } else
+  {
+    mUpdating = true;
+    axis->setRange(mRange);
+    mUpdating = false;
+  }
+  if (mTicker)
+  {
+    axis->setTicker(mTicker);
+  } else
+  {
+    mTicker = axis->ticker();
+    mTicker->setCaching(true);
+  }
+  mAxes.append(axis);
+}
+
+/*! \internal
+  
+  Removes \a axis from the internal list of member axes.
+  
+  This function does not modify the axis group property of \a axis.
+*/
+void QCPAxisGroup::removeChild(QCPAxis *axis)
+{
+  if (!mAxes.removeOne(axis))
+    qDebug() << Q_FUNC_INFO << "axis is not member of this group" << reinterpret_cast<quintptr>(axis);
+}
+
+/*! \internal
+  
+  Called by member \a axis after its range has changed. Applies the new range to all other member
+  axes. Range changes of members caused by this propagation are ignored, so each member emits its
+  range signals exactly once.
+*/
+void QCPAxisGroup::axisRangeChanged(QCPAxis *axis)
+{
+  if (mUpdating)
+    return;
+  
+  const QCPRange oldRange = mRange;
+  mRange = axis->range();
+  mUpdating = true;
+  foreach (QCPAxis *member, mAxes)
+  {
+    if (member != axis)
+      member->setRange(mRange);
+  }
+  mUpdating = false;
+  emit rangeChanged(mRange, oldRange);
+  if (mAutoReplot)
+    queueReplot();
+}
+
+/*! \internal
+  
+  Performs the replot batch scheduled by \ref queueReplot. Each plot is replotted once and its
+  widget repaint is queued, so all member plots appear updated in the same paint pass. Plots that
+  already have their own queued replot pending in this event loop iteration are left to it, so no
+  plot is replotted twice.
+*/
+void QCPAxisGroup::replotMembers()
+{
+  mReplotQueued = false;
+  foreach (QCustomPlot *plot, plots())
+  {
+    if (!plot->mReplotQueued)
+      plot->replot(QCustomPlot::rpQueuedRefresh);
+  }
+}
+
 /* end of 'src/axis/axis.cpp' */
 
 
@@ -11452,6 +12143,8 @@ QCPAbstractPlottable::~QCPAbstractPlottable()
 void QCPAbstractPlottable::setName(const QString &name)
 {
   mName = name;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -13264,6 +13957,374 @@ QCP::Interaction QCPAbstractItem::selectionCategory() const
 /* end of 'src/item.cpp' */
 
 
+/* including file 'src/framearena.cpp'      */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPFrameArena
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPFrameArena
+  \brief Owns the scratch buffer pools that plottables use for per-replot temporaries
+  
+  Each QCustomPlot has one frame arena, accessible via \ref QCustomPlot::frameArena. Plottables
+  borrow their temporary buffers (optimized data, line and scatter pixel coordinates) from the
+  pools of the arena, e.g. \ref pointPool, using \ref QCPScratchBuffer handles. Because released
+  buffers keep their capacity, steady-state replots of data with unchanged size don't allocate.
+  
+  At the end of every replot, \ref QCustomPlot::replot calls \ref endFrame, which moves the
+  allocation counters of the pools to \ref bytesAllocatedLastFrame and \ref allocationsLastFrame.
+  These can be used to verify that replots run allocation-free. If a very large data set was
+  displayed once, the retained memory (see \ref bytesReserved) can be given back with \ref
+  releaseMemory.
+*/
+
+/*!
+  Creates a frame arena with empty pools.
+*/
+QCPFrameArena::QCPFrameArena() :
+  mGraphDataPool(new QCPScratchPool<QCPGraphData>),
+  mBytesAllocatedLastFrame(0),
+  mAllocationsLastFrame(0),
+  mFrameCount(0)
+{
+}
+
+QCPFrameArena::~QCPFrameArena()
+{
+  delete mGraphDataPool;
+}
+
+/*!
+  Returns the number of bytes currently retained by the buffers of all pools of this arena.
+*/
+qint64 QCPFrameArena::bytesReserved() const
+{
+  return mPointPool.bytesReserved() + mGraphDataPool->bytesReserved();
+}
+
+/*!
+  Finishes the current frame: The bytes and number of allocations that the pools needed since the
+  last call are made available via \ref bytesAllocatedLastFrame and \ref allocationsLastFrame, and
+  the pool counters are reset.
+  
+  This is called by \ref QCustomPlot::replot after all layers were drawn.
+*/
+void QCPFrameArena::endFrame()
+{
+  mBytesAllocatedLastFrame = mPointPool.bytesAllocated() + mGraphDataPool->bytesAllocated();
+  mAllocationsLastFrame = mPointPool.allocations() + mGraphDataPool->allocations();
+  mPointPool.resetCounters();
+  mGraphDataPool->resetCounters();
+  ++mFrameCount;
+}
+
+/*!
+  Frees the memory of all currently unused buffers in the pools of this arena.
+  
+  \see QCPScratchPool::releaseMemory
+*/
+void QCPFrameArena::releaseMemory()
+{
+  mPointPool.releaseMemory();
+  mGraphDataPool->releaseMemory();
+}
+/* end of 'src/framearena.cpp' */
+
+
+/* including file 'src/profiler.cpp'        */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPProfiler
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPProfiler
+  \brief Records per-phase timings of replots
+  
+  Each QCustomPlot has a profiler, accessible via \ref QCustomPlot::profiler. It is disabled by
+  default. Once enabled with \ref setEnabled, every replot records timing events for the phases
+  defined in \ref Phase: the layout update, tick generation and tick label painting per axis, and
+  drawing and data preparation per plottable. The compositing of the paint buffers onto the widget
+  is recorded when the widget is repainted.
+  
+  Events are stored in a fixed-size ring buffer of \ref capacity entries, so the most recent
+  replots are always available without unbounded memory growth. Recording doesn't allocate and
+  doesn't take locks: Each slot is guarded by a sequence number, so \ref events may be called from
+  a different thread than the one replotting, and slots that are overwritten while being read are
+  skipped.
+  
+  The recorded events can be summed per phase with \ref phaseTimes, shown directly on the plot
+  with \ref setOverlayVisible, or written to a Chrome trace-event JSON file with \ref
+  exportChromeTrace, which can be opened in chrome://tracing or Perfetto.
+  
+  Custom code can contribute own events with \ref record, or more conveniently with a \ref
+  QCPProfilerScope instance.
+*/
+
+/*!
+  Creates a disabled profiler whose ring buffer can hold \a capacity events.
+*/
+QCPProfiler::QCPProfiler(int capacity) :
+  mEnabled(false),
+  mOverlayVisible(false),
+  mCapacity(qMax(16, capacity)),
+  mSlots(new Slot[qMax(16, capacity)]),
+  mWriteCount(0),
+  mFrame(0)
+{
+  for (int i=0; i<mCapacity; ++i)
+    mSlots[i].sequence.store(0, std::memory_order_relaxed);
+  mClock.start();
+}
+
+QCPProfiler::~QCPProfiler()
+{
+  delete[] mSlots;
+}
+
+/*!
+  Sets whether replots record timing events. A disabled profiler costs one branch per
+  instrumented phase.
+*/
+void QCPProfiler::setEnabled(bool enabled)
+{
+  mEnabled = enabled;
+}
+
+/*!
+  Sets whether the per-phase times of the most recent replot are drawn on top of the plot, in the
+  top left corner of the viewport. The overlay is only updated while the profiler is enabled.
+  
+  \see drawOverlay
+*/
+void QCPProfiler::setOverlayVisible(bool visible)
+{
+  mOverlayVisible = visible;
+}
+
+/*!
+  Starts a new frame. Events recorded afterwards are associated with the new frame number, see
+  \ref frame. This is called by \ref QCustomPlot::replot.
+*/
+void QCPProfiler::beginFrame()
+{
+  ++mFrame;
+}
+
+/*!
+  Records an event of \a phase which started at \a startNs and ended at \a endNs (both as returned
+  by \ref timestamp). Only the first \ref maxLabelLength characters of \a label are stored.
+  
+  Recording must only happen from one thread at a time, usually the GUI thread.
+*/
+void QCPProfiler::record(Phase phase, qint64 startNs, qint64 endNs, const QString &label)
+{
+  if (!mEnabled)
+    return;
+  const qint64 writeCount = mWriteCount.load(std::memory_order_relaxed);
+  Slot &slot = mSlots[writeCount % mCapacity];
+  slot.sequence.store(2*writeCount+1, std::memory_order_relaxed); // mark slot as being written
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.event.phase = phase;
+  slot.event.frame = mFrame;
+  slot.event.startNs = startNs;
+  slot.event.durationNs = endNs-startNs;
+  slot.event.labelLength = qMin(int(label.size()), int(maxLabelLength));
+  std::copy(label.constData(), label.constData()+slot.event.labelLength, slot.event.label);
+  slot.sequence.store(2*writeCount+2, std::memory_order_release);
+  mWriteCount.store(writeCount+1, std::memory_order_release);
+}
+
+/*!
+  Returns a snapshot of the events currently held in the ring buffer, in the order they were
+  recorded.
+*/
+QVector<QCPProfiler::Event> QCPProfiler::events() const
+{
+  QVector<Event> result;
+  const qint64 writeCount = mWriteCount.load(std::memory_order_acquire);
+  const qint64 first = qMax(qint64(0), writeCount-mCapacity);
+  result.reserve(int(writeCount-first));
+  for (qint64 i=first; i<writeCount; ++i)
+  {
+    const Slot &slot = mSlots[i % mCapacity];
+    const qint64 sequenceBefore = slot.sequence.load(std::memory_order_acquire);
+    if (sequenceBefore != 2*i+2) // slot was already overwritten by a newer event
+      continue;
+    Event event = slot.event;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) == sequenceBefore) // discard events that were overwritten while copying
+      result.append(event);
+  }
+  return result;
+}
+
+/*!
+  Returns the total time in milliseconds spent in each phase during \a frame. The returned vector
+  is indexed by \ref Phase and has \ref phaseCount entries. Since phases may be nested, the totals
+  of nested phases are also contained in the totals of their enclosing phases.
+*/
+QVector<double> QCPProfiler::phaseTimes(qint64 frame) const
+{
+  QVector<double> result(phaseCount, 0.0);
+  // scan the ring buffer directly instead of copying a snapshot via events(), since this runs on every repaint with visible overlay:
+  const qint64 writeCount = mWriteCount.load(std::memory_order_acquire);
+  for (qint64 i=writeCount-1; i>=qMax(qint64(0), writeCount-mCapacity); --i)
+  {
+    const Slot &slot = mSlots[i % mCapacity];
+    const qint64 sequenceBefore = slot.sequence.load(std::memory_order_acquire);
+    if (sequenceBefore != 2*i+2)
+      continue;
+    const qint64 eventFrame = slot.event.frame;
+    const Phase phase = slot.event.phase;
+    const qint64 durationNs = slot.event.durationNs;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequenceBefore)
+      continue;
+    if (eventFrame < frame) // events are recorded in frame order, so older events can't belong to frame
+      break;
+    if (eventFrame == frame)
+      result[phase] += durationNs*1e-6;
+  }
+  return result;
+}
+
+/*!
+  Writes all events currently held in the ring buffer to \a fileName, in the Chrome trace-event
+  JSON format ("complete" events with microsecond timestamps). The file can be loaded in
+  chrome://tracing or https://ui.perfetto.dev to inspect individual replots.
+  
+  Returns true on success.
+*/
+bool QCPProfiler::exportChromeTrace(const QString &fileName) const
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+  QJsonArray traceEvents;
+  foreach (const Event &event, events())
+  {
+    const QString label = event.labelString();
+    QJsonObject traceEvent;
+    traceEvent.insert(QLatin1String("name"), label.isEmpty() ? phaseName(event.phase) : phaseName(event.phase)+QLatin1String(": ")+label);
+    traceEvent.insert(QLatin1String("cat"), phaseName(event.phase));
+    traceEvent.insert(QLatin1String("ph"), QLatin1String("X"));
+    traceEvent.insert(QLatin1String("ts"), event.startNs*1e-3);
+    traceEvent.insert(QLatin1String("dur"), event.durationNs*1e-3);
+    traceEvent.insert(QLatin1String("pid"), 1);
+    traceEvent.insert(QLatin1String("tid"), 1);
+    QJsonObject args;
+    args.insert(QLatin1String("frame"), double(event.frame));
+    traceEvent.insert(QLatin1String("args"), args);
+    traceEvents.append(traceEvent);
+  }
+  QJsonObject root;
+  root.insert(QLatin1String("traceEvents"), traceEvents);
+  root.insert(QLatin1String("displayTimeUnit"), QLatin1String("ms"));
+  
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    qDebug() << Q_FUNC_INFO << "couldn't open file for writing:" << fileName;
+    return false;
+  }
+  return file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) >= 0;
+#else
+  Q_UNUSED(fileName)
+  qDebug() << Q_FUNC_INFO << "Chrome trace export requires Qt 5";
+  return false;
+#endif
+}
+
+/*!
+  Draws a small box with the per-phase times of the current frame (see \ref phaseTimes) into the
+  top left corner of \a rect. The rasterization time shown is the plottable draw time without the
+  data preparation.
+  
+  This is called by \ref QCustomPlot::paintEvent if \ref setOverlayVisible is enabled.
+*/
+void QCPProfiler::drawOverlay(QCPPainter *painter, const QRect &rect) const
+{
+  const QVector<double> times = phaseTimes(mFrame);
+  QStringList lines;
+  lines << QString(QLatin1String("frame %1: %2 ms")).arg(mFrame).arg(times.at(phReplot), 0, 'f', 2);
+  lines << QString(QLatin1String("layout %1 ms (ticks %2 ms)")).arg(times.at(phLayout), 0, 'f', 2).arg(times.at(phAxisTicks), 0, 'f', 2);
+  lines << QString(QLatin1String("tick labels %1 ms")).arg(times.at(phTickLabels), 0, 'f', 2);
+  lines << QString(QLatin1String("data prep %1 ms")).arg(times.at(phDataPreparation), 0, 'f', 2);
+  lines << QString(QLatin1String("rasterization %1 ms")).arg(times.at(phPlottableDraw)-times.at(phDataPreparation), 0, 'f', 2);
+  lines << QString(QLatin1String("compositing %1 ms")).arg(times.at(phCompositing), 0, 'f', 2);
+  const QString text = lines.join(QLatin1String("\n"));
+  
+  painter->save();
+  painter->setFont(QFont(QLatin1String("monospace"), 8));
+  painter->setRenderHint(QPainter::Antialiasing, false);
+  const QRect textRect = painter->fontMetrics().boundingRect(rect.adjusted(6, 6, -6, -6), Qt::AlignLeft|Qt::AlignTop, text);
+  painter->setPen(Qt::NoPen);
+  painter->setBrush(QColor(0, 0, 0, 160));
+  painter->drawRect(textRect.adjusted(-4, -4, 4, 4));
+  painter->setPen(Qt::white);
+  painter->drawText(textRect, Qt::AlignLeft|Qt::AlignTop, text);
+  painter->restore();
+}
+
+/*!
+  Discards all recorded events.
+*/
+void QCPProfiler::clear()
+{
+  for (int i=0; i<mCapacity; ++i)
+    mSlots[i].sequence.store(0, std::memory_order_relaxed);
+  mWriteCount.store(0, std::memory_order_release);
+}
+
+/*!
+  Returns a short human readable name of \a phase, as used in the overlay and trace export.
+*/
+QString QCPProfiler::phaseName(Phase phase)
+{
+  switch (phase)
+  {
+    case phReplot: return QLatin1String("replot");
+    case phLayout: return QLatin1String("layout");
+    case phAxisTicks: return QLatin1String("axis ticks");
+    case phTickLabels: return QLatin1String("tick labels");
+    case phPlottableDraw: return QLatin1String("plottable draw");
+    case phDataPreparation: return QLatin1String("data preparation");
+    case phCompositing: return QLatin1String("compositing");
+  }
+  return QString();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPProfilerScope
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPProfilerScope
+  \brief Records a profiler event for the lifetime of the scope
+  
+  Creating an instance takes a timestamp from the profiler of \a parentPlot (\ref
+  QCustomPlot::profiler), and the destructor records an event of the given phase and label. If the
+  profiler is disabled (or \a parentPlot is \c nullptr), the scope does nothing.
+*/
+
+QCPProfilerScope::QCPProfilerScope(QCustomPlot *parentPlot, QCPProfiler::Phase phase, const QString &label) :
+  mProfiler(parentPlot && parentPlot->profiler()->enabled() ? parentPlot->profiler() : nullptr),
+  mPhase(phase),
+  mStartNs(0)
+{
+  if (mProfiler)
+  {
+    mLabel = label;
+    mStartNs = mProfiler->timestamp();
+  }
+}
+
+QCPProfilerScope::~QCPProfilerScope()
+{
+  if (mProfiler)
+    mProfiler->record(mPhase, mStartNs, mProfiler->timestamp(), mLabel);
+}
+/* end of 'src/profiler.cpp' */
+
+
 /* including file 'src/core.cpp'             */
 /* modified 2022-11-06T12:45:56, size 127625 */
 
@@ -13618,6 +14679,10 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
   mSelectionRectMode(QCP::srmNone),
   mSelectionRect(nullptr),
   mOpenGl(false),
+  mTiledPainting(false),
+  mPaintTileCount(0),
+  mProgressiveRefineDelay(150),
+  mLayoutCaching(true),
   mMouseHasMoved(false),
   mMouseEventLayerable(nullptr),
   mMouseSignalLayerable(nullptr),
@@ -13625,6 +14690,12 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
   mReplotQueued(false),
   mReplotTime(0),
   mReplotTimeAverage(0),
+  mFrameArena(new QCPFrameArena),
+  mProfiler(new QCPProfiler),
+  mCoarseRendering(false),
+  mProgressiveRefineTimer(new QTimer(this)),
+  mLayoutValid(false),
+  mLayoutSkipCount(0),
   mOpenGlMultisamples(16),
   mOpenGlAntialiasedElementsBackup(QCP::aeNone),
   mOpenGlCacheLabelsBackup(true)
@@ -13645,6 +14716,8 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
   
   mOpenGlAntialiasedElementsBackup = mAntialiasedElements;
   mOpenGlCacheLabelsBackup = mPlottingHints.testFlag(QCP::phCacheLabels);
+  mProgressiveRefineTimer->setSingleShot(true);
+  connect(mProgressiveRefineTimer, SIGNAL(timeout()), this, SLOT(endCoarseRendering()));
   // create initial layers:
   mLayers.append(new QCPLayer(this, QLatin1String("background")));
   mLayers.append(new QCPLayer(this, QLatin1String("grid")));
@@ -13706,6 +14779,11 @@ QCustomPlot::~QCustomPlot()
   mCurrentLayer = nullptr;
   qDeleteAll(mLayers); // don't use removeLayer, because it would prevent the last layer to be removed
   mLayers.clear();
+  
+  delete mFrameArena;
+  mFrameArena = nullptr;
+  delete mProfiler;
+  mProfiler = nullptr;
 }
 
 /*!
@@ -13916,6 +14994,41 @@ void QCustomPlot::setNoAntialiasingOnDrag(bool enabled)
   mNoAntialiasingOnDrag = enabled;
 }
 
+/*!
+  Sets how long, in milliseconds, range dragging and zooming must be idle before the plot is
+  replotted in full detail, if the plotting hint \ref QCP::phProgressiveRendering is set.
+
+  While the interaction is ongoing, graphs only draw a subset of their visible data, so the frame
+  time stays bounded regardless of the data size.
+
+  \see setPlottingHints, coarseRendering
+*/
+void QCustomPlot::setProgressiveRefineDelay(int msec)
+{
+  mProgressiveRefineDelay = qMax(0, msec);
+}
+
+/*!
+  Sets whether the margin and layout phases of a replot are skipped when nothing that affects the
+  layout has changed since the previous replot.
+
+  The layout is recalculated whenever the viewport is resized, layout elements are added, removed
+  or reconfigured, legend or text element contents change, or an axis needs a different margin
+  (e.g. because its tick labels changed). Panning a plot with unchanged tick label widths therefore
+  doesn't cause any layout work. \ref layoutSkipCount returns how many replots skipped the layout
+  so far.
+
+  If you implement your own layout elements whose size hints depend on state the plot can't
+  observe, call \ref invalidateLayout when that state changes, or disable layout caching.
+
+  \see invalidateLayout
+*/
+void QCustomPlot::setLayoutCaching(bool enabled)
+{
+  mLayoutCaching = enabled;
+  mLayoutValid = false;
+}
+
 /*!
   Sets the plotting hints for this QCustomPlot instance as an \a or combination of QCP::PlottingHint.
   
@@ -14101,6 +15214,28 @@ void QCustomPlot::setOpenGl(bool enabled, int multisampling)
 #endif
 }
 
+/*!
+  Enables multi-threaded software rendering, for increased plotting performance on systems where
+  OpenGL isn't available, e.g. headless render nodes.
+
+  If \a enabled is set to true, the layers are rasterized with \ref QCPPaintBufferTiledImage
+  paint buffers. Each layer is recorded once and then replayed concurrently into \a tileCount
+  horizontal tiles of the buffer. If \a tileCount is zero or negative, \c
+  QThread::idealThreadCount() tiles are used.
+
+  If OpenGL is enabled (\ref setOpenGl), it takes precedence over tiled painting.
+
+  \see QCPPaintBufferTiledImage
+*/
+void QCustomPlot::setTiledPainting(bool enabled, int tileCount)
+{
+  mTiledPainting = enabled;
+  mPaintTileCount = tileCount;
+  // recreate all paint buffers:
+  mPaintBuffers.clear();
+  setupPaintBuffers();
+}
+
 /*!
   Sets the viewport of this QCustomPlot. Usually users of QCustomPlot don't need to change the
   viewport manually.
@@ -14122,6 +15257,7 @@ void QCustomPlot::setViewport(const QRect &rect)
   mViewport = rect;
   if (mPlotLayout)
     mPlotLayout->setOuterRect(mViewport);
+  mLayoutValid = false;
 }
 
 /*!
@@ -15131,6 +16267,8 @@ void QCustomPlot::replot(QCustomPlot::RefreshPriority refreshPriority)
     return;
   mReplotting = true;
   mReplotQueued = false;
+  mProfiler->beginFrame();
+  QCPProfilerScope replotScope(this, QCPProfiler::phReplot);
   emit beforeReplot();
   
 # if QT_VERSION < QT_VERSION_CHECK(4, 8, 0)
@@ -15141,13 +16279,17 @@ void QCustomPlot::replot(QCustomPlot::RefreshPriority refreshPriority)
   replotTimer.start();
 # endif
   
-  updateLayout();
+  {
+    QCPProfilerScope layoutScope(this, QCPProfiler::phLayout);
+    updateLayout();
+  }
   // draw all layered objects (grid, axes, plottables, items, legend,...) into their buffers:
   setupPaintBuffers();
   foreach (QCPLayer *layer, mLayers)
     layer->drawToPaintBuffer();
   foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
     buffer->setInvalidated(false);
+  mFrameArena->endFrame();
   
   if ((refreshPriority == rpRefreshHint && mPlottingHints.testFlag(QCP::phImmediateRefresh)) || refreshPriority==rpImmediateRefresh)
     repaint();
@@ -15179,6 +16321,23 @@ double QCustomPlot::replotTime(bool average) const
   return average ? mReplotTimeAverage : mReplotTime;
 }
 
+/*! \fn void QCustomPlot::invalidateLayout()
+
+  Marks the cached layout as outdated, so the next \ref replot performs the full margin and layout
+  phases again. Layout elements and axes call this internally whenever their size requirements
+  change.
+
+  \see setLayoutCaching
+*/
+
+/*! \fn int QCustomPlot::layoutSkipCount() const
+
+  Returns how many replots have reused the cached layout instead of recalculating margins and
+  element positions.
+
+  \see setLayoutCaching
+*/
+
 /*!
   Rescales the axes such that all plottables (like graphs) in the plot are fully visible.
   
@@ -15494,8 +16653,13 @@ void QCustomPlot::paintEvent(QPaintEvent *event)
     if (mBackgroundBrush.style() != Qt::NoBrush)
       painter.fillRect(mViewport, mBackgroundBrush);
     drawBackground(&painter);
-    foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
-      buffer->draw(&painter);
+    {
+      QCPProfilerScope compositingScope(this, QCPProfiler::phCompositing);
+      foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
+        buffer->draw(&painter);
+    }
+    if (mProfiler->overlayVisible())
+      mProfiler->drawOverlay(&painter, mViewport);
   }
 }
 
@@ -15766,14 +16930,25 @@ void QCustomPlot::draw(QCPPainter *painter)
   QCPLayoutElement::update on the main plot layout.
 
   Here, the layout elements calculate their positions and margins, and prepare for the following
-  draw call.
+  draw call. If \ref setLayoutCaching is enabled and the layout wasn't invalidated since the last
+  call, only the preparation phase is performed.
 */
 void QCustomPlot::updateLayout()
 {
-  // run through layout phases:
+  // run through layout phases. The preparation phase always runs, because it's where axes generate
+  // their ticks and report margin changes; the remaining phases are skipped if nothing invalidated
+  // the layout since the last pass:
   mPlotLayout->update(QCPLayoutElement::upPreparation);
-  mPlotLayout->update(QCPLayoutElement::upMargins);
-  mPlotLayout->update(QCPLayoutElement::upLayout);
+  if (mLayoutCaching && mLayoutValid)
+  {
+    ++mLayoutSkipCount;
+  } else
+  {
+    mPlotLayout->update(QCPLayoutElement::upMargins);
+    mPlotLayout->update(QCPLayoutElement::upLayout);
+    // setting margins and rects during the layout pass invalidates, but the result is current now:
+    mLayoutValid = true;
+  }
 
   emit afterLayout();
 }
@@ -15878,8 +17053,8 @@ void QCustomPlot::setupPaintBuffers()
 
   This method is used by \ref setupPaintBuffers when it needs to create new paint buffers.
 
-  Depending on the current setting of \ref setOpenGl, and the current Qt version, different
-  backends (subclasses of \ref QCPAbstractPaintBuffer) are created, initialized with the proper
+  Depending on the current setting of \ref setOpenGl and \ref setTiledPainting, and the current
+  Qt version, different backends (subclasses of \ref QCPAbstractPaintBuffer) are created, initialized with the proper
   size and device pixel ratio, and returned.
 */
 QCPAbstractPaintBuffer *QCustomPlot::createPaintBuffer()
@@ -15894,7 +17069,9 @@ QCPAbstractPaintBuffer *QCustomPlot::createPaintBuffer()
     qDebug() << Q_FUNC_INFO << "OpenGL enabled even though no support for it compiled in, this shouldn't have happened. Falling back to pixmap paint buffer.";
     return new QCPPaintBufferPixmap(viewport().size(), mBufferDevicePixelRatio);
 #endif
-  } else
+  } else if (mTiledPainting)
+    return new QCPPaintBufferTiledImage(viewport().size(), mBufferDevicePixelRatio, mPaintTileCount);
+  else
     return new QCPPaintBufferPixmap(viewport().size(), mBufferDevicePixelRatio);
 }
 
@@ -16146,6 +17323,36 @@ void QCustomPlot::processRectZoom(QRect rect, QMouseEvent *event)
   replot(rpQueuedReplot); // always replot to make selection rect disappear
 }
 
+/*! \internal
+
+  Called by interactions that change axis ranges in quick succession, like range dragging and
+  wheel zooming. If the plotting hint \ref QCP::phProgressiveRendering is set, this switches the
+  plot to coarse rendering (see \ref coarseRendering) and (re)starts the timer which ends it after
+  \ref setProgressiveRefineDelay milliseconds without further interaction.
+
+  \see endCoarseRendering
+*/
+void QCustomPlot::beginCoarseRendering()
+{
+  if (!mPlottingHints.testFlag(QCP::phProgressiveRendering))
+    return;
+  mCoarseRendering = true;
+  mProgressiveRefineTimer->start(mProgressiveRefineDelay);
+}
+
+/*! \internal
+
+  Ends coarse rendering started by \ref beginCoarseRendering and replots the plot in full detail.
+*/
+void QCustomPlot::endCoarseRendering()
+{
+  mProgressiveRefineTimer->stop();
+  if (!mCoarseRendering)
+    return;
+  mCoarseRendering = false;
+  replot(rpQueuedReplot);
+}
+
 /*! \internal
 
   This method is called when a simple left mouse click was detected on the QCustomPlot surface.
@@ -17722,6 +18929,8 @@ QCPAxis *QCPAxisRect::addAxis(QCPAxis::AxisType type, QCPAxis *axis)
     newAxis->setUpperEnding(QCPLineEnding(QCPLineEnding::esHalfBar, 6, 10, invert));
   }
   mAxes[type].append(newAxis);
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
   
   // reset convenience axis pointers on parent QCustomPlot if they are unset:
   if (mParentPlot && mParentPlot->axisRectCount() > 0 && mParentPlot->axisRect(0) == this)
@@ -17780,7 +18989,10 @@ bool QCPAxisRect::removeAxis(QCPAxis *axis)
         it.value()[1]->setOffset(axis->offset());
       mAxes[it.key()].removeOne(axis);
       if (qobject_cast<QCustomPlot*>(parentPlot())) // make sure this isn't called from QObject dtor when QCustomPlot is already destructed (happens when the axis rect is not in any layout and thus QObject-child of QCustomPlot)
+      {
         parentPlot()->axisRemoved(axis);
+        parentPlot()->invalidateLayout();
+      }
       delete axis;
       return true;
     }
@@ -17997,7 +19209,17 @@ void QCPAxisRect::update(UpdatePhase phase)
     case upPreparation:
     {
       foreach (QCPAxis *axis, axes())
+      {
+        QCPProfilerScope tickScope(mParentPlot, QCPProfiler::phAxisTicks, axis->label());
         axis->setupTickVectors();
+        // margins of axes on manual sides are never calculated, so their cache stays invalid:
+        if (axis->visible() && !axis->mCachedMarginValid && mParentPlot)
+        {
+          const QCP::MarginSide side = QCPAxis::axisTypeToMarginSide(axis->axisType());
+          if (mAutoMargins.testFlag(side))
+            mParentPlot->invalidateLayout();
+        }
+      }
       break;
     }
     case upLayout:
@@ -18625,6 +19847,7 @@ void QCPAxisRect::mouseMoveEvent(QMouseEvent *event, const QPointF &startPos)
     {
       if (mParentPlot->noAntialiasingOnDrag())
         mParentPlot->setNotAntialiasedElements(QCP::aeAll);
+      mParentPlot->beginCoarseRendering();
       mParentPlot->replot(QCustomPlot::rpQueuedReplot);
     }
     
@@ -18697,6 +19920,7 @@ void QCPAxisRect::wheelEvent(QWheelEvent *event)
             axis->scaleRange(factor, axis->pixelToCoord(pos.y()));
         }
       }
+      mParentPlot->beginCoarseRendering();
       mParentPlot->replot();
     }
   }
@@ -18771,6 +19995,8 @@ QCPAbstractLegendItem::QCPAbstractLegendItem(QCPLegend *parent) :
 void QCPAbstractLegendItem::setFont(const QFont &font)
 {
   mFont = font;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -18792,6 +20018,8 @@ void QCPAbstractLegendItem::setTextColor(const QColor &color)
 void QCPAbstractLegendItem::setSelectedFont(const QFont &font)
 {
   mSelectedFont = font;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -18834,6 +20062,8 @@ void QCPAbstractLegendItem::setSelected(bool selected)
     mSelected = selected;
     emit selectionChanged(mSelected);
   }
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /* inherits documentation from base class */
@@ -19156,6 +20386,8 @@ void QCPLegend::setFont(const QFont &font)
     if (item(i))
       item(i)->setFont(mFont);
   }
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -19184,6 +20416,8 @@ void QCPLegend::setTextColor(const QColor &color)
 void QCPLegend::setIconSize(const QSize &size)
 {
   mIconSize = size;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*! \overload
@@ -19192,6 +20426,8 @@ void QCPLegend::setIconSize(int width, int height)
 {
   mIconSize.setWidth(width);
   mIconSize.setHeight(height);
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -19202,6 +20438,8 @@ void QCPLegend::setIconSize(int width, int height)
 void QCPLegend::setIconTextPadding(int padding)
 {
   mIconTextPadding = padding;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -19278,6 +20516,8 @@ void QCPLegend::setSelectedParts(const SelectableParts &selected)
     mSelectedParts = newSelected;
     emit selectionChanged(mSelectedParts);
   }
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -19327,6 +20567,8 @@ void QCPLegend::setSelectedFont(const QFont &font)
     if (item(i))
       item(i)->setSelectedFont(font);
   }
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -19797,6 +21039,8 @@ QCPTextElement::QCPTextElement(QCustomPlot *parentPlot, const QString &text, con
 void QCPTextElement::setText(const QString &text)
 {
   mText = text;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -19822,6 +21066,8 @@ void QCPTextElement::setText(const QString &text)
 void QCPTextElement::setTextFlags(int flags)
 {
   mTextFlags = flags;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -19832,6 +21078,8 @@ void QCPTextElement::setTextFlags(int flags)
 void QCPTextElement::setFont(const QFont &font)
 {
   mFont = font;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -19852,6 +21100,8 @@ void QCPTextElement::setTextColor(const QColor &color)
 void QCPTextElement::setSelectedFont(const QFont &font)
 {
   mSelectedFont = font;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -19893,6 +21143,8 @@ void QCPTextElement::setSelected(bool selected)
     mSelected = selected;
     emit selectionChanged(mSelected);
   }
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /* inherits documentation from base class */
@@ -20231,6 +21483,8 @@ void QCPColorScale::setType(QCPAxis::AxisType type)
     connect(mColorAxis.data(), SIGNAL(rangeChanged(QCPRange)), this, SLOT(setDataRange(QCPRange)));
     connect(mColorAxis.data(), SIGNAL(scaleTypeChanged(QCPAxis::ScaleType)), this, SLOT(setDataScaleType(QCPAxis::ScaleType)));
     mAxisRect.data()->setRangeDragAxes(QList<QCPAxis*>() << mColorAxis.data());
+    if (mParentPlot)
+      mParentPlot->invalidateLayout();
   }
 }
 
@@ -20326,6 +21580,8 @@ void QCPColorScale::setLabel(const QString &str)
 void QCPColorScale::setBarWidth(int width)
 {
   mBarWidth = width;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -20812,327 +22068,1018 @@ QCPGraphData::QCPGraphData(double key, double value) :
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-//////////////////// QCPGraph
+//////////////////// QCPGraphHistory
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-/*! \class QCPGraph
-  \brief A plottable representing a graph in a plot.
-
-  \image html QCPGraph.png
-  
-  Usually you create new graphs by calling QCustomPlot::addGraph. The resulting instance can be
-  accessed via QCustomPlot::graph.
-
-  To plot data, assign it with the \ref setData or \ref addData functions. Alternatively, you can
-  also access and modify the data via the \ref data method, which returns a pointer to the internal
-  \ref QCPGraphDataContainer.
-  
-  Graphs are used to display single-valued data. Single-valued means that there should only be one
-  data point per unique key coordinate. In other words, the graph can't have \a loops. If you do
-  want to plot non-single-valued curves, rather use the QCPCurve plottable.
+/*! \class QCPGraphHistory
+  \brief Compressed, append-only storage for long time series displayed by a QCPGraph
   
-  Gaps in the graph line can be created by adding data points with NaN as value
-  (<tt>qQNaN()</tt> or <tt>std::numeric_limits<double>::quiet_NaN()</tt>) in between the two data points that shall be
-  separated.
+  A \ref QCPGraphDataContainer stores every data point as two raw doubles. For long-running
+  recordings (e.g. weeks of telemetry sampled at several Hz) this quickly becomes the dominating
+  memory cost of a plot, even though only a tiny fraction of the points is ever visible at full
+  resolution. QCPGraphHistory stores the same points losslessly compressed, typically using a
+  small fraction of the memory.
   
-  \section qcpgraph-appearance Changing the appearance
+  Data points are appended in ascending key order with \ref add. They are collected in an
+  uncompressed tail block, which is compressed once it reaches \ref setBlockSize points. The
+  compression follows the scheme known from time series databases ("Gorilla"):
   
-  The appearance of the graph is mainly determined by the line style, scatter style, brush and pen
-  of the graph (\ref setLineStyle, \ref setScatterStyle, \ref setBrush, \ref setPen).
+  \li Keys are encoded as delta-of-delta of their IEEE 754 bit patterns. Regularly sampled keys
+  therefore cost one to nine bits per point.
+  \li Values are XOR-ed with the previous value, and only the meaningful bits of the result are
+  stored. Constant or slowly changing signals cost one to a few bits per point.
   
-  \subsection filling Filling under or between graphs
+  Every block keeps a \ref BlockHeader with its key range, first and last value and the position of
+  its minimum and maximum value. Ranges for axis rescaling are computed from the headers, only
+  blocks at the boundary of the requested range are decoded.
   
-  QCPGraph knows two types of fills: Normal graph fills towards the zero-value-line parallel to
-  the key axis of the graph, and fills between two graphs, called channel fills. To enable a fill,
-  just set a brush with \ref setBrush which is neither Qt::NoBrush nor fully transparent.
+  To display a history, pass it to \ref QCPGraph::setHistory. The graph then decodes only the
+  blocks intersecting the visible key range. Blocks that are narrower than a pixel are not decoded
+  at all, the graph draws their envelope from the block header instead.
   
-  By default, a normal fill towards the zero-value-line will be drawn. To set up a channel fill
-  between this graph and another one, call \ref setChannelFillGraph with the other graph as
-  parameter.
-
-  \see QCustomPlot::addGraph, QCustomPlot::graph
+  Multiple graphs may share one history via the QSharedPointer.
 */
 
-/* start of documentation of inline functions */
-
-/*! \fn QSharedPointer<QCPGraphDataContainer> QCPGraph::data() const
+/*! \struct QCPGraphHistory::BlockHeader
+  \brief Summary of one block of data points in a QCPGraphHistory
   
-  Returns a shared pointer to the internal data storage of type \ref QCPGraphDataContainer. You may
-  use it to directly manipulate the data, which may be more convenient and faster than using the
-  regular \ref setData or \ref addData methods.
+  \see QCPGraphHistory::blockHeader
 */
 
-/* end of documentation of inline functions */
+/* start of documentation of inline functions */
 
-/*!
-  Constructs a graph which uses \a keyAxis as its key axis ("x") and \a valueAxis as its value
-  axis ("y"). \a keyAxis and \a valueAxis must reside in the same QCustomPlot instance and not have
-  the same orientation. If either of these restrictions is violated, a corresponding message is
-  printed to the debug output (qDebug), the construction is not aborted, though.
-  
-  The created QCPGraph is automatically registered with the QCustomPlot instance inferred from \a
-  keyAxis. This QCustomPlot instance takes ownership of the QCPGraph, so do not delete it manually
-  but use QCustomPlot::removePlottable() instead.
+/*! \fn int QCPGraphHistory::blockCount() const
   
-  To directly create a graph inside a plot, you can also use the simpler QCustomPlot::addGraph function.
+  Returns the number of blocks, including the uncompressed tail block if it holds any data points.
 */
-QCPGraph::QCPGraph(QCPAxis *keyAxis, QCPAxis *valueAxis) :
-  QCPAbstractPlottable1D<QCPGraphData>(keyAxis, valueAxis),
-  mLineStyle{},
-  mScatterSkip{},
-  mAdaptiveSampling{}
-{
-  // special handling for QCPGraphs to maintain the simple graph interface:
-  mParentPlot->registerGraph(this);
 
-  setPen(QPen(Qt::blue, 0));
-  setBrush(Qt::NoBrush);
+/*! \fn quint64 QCPGraphHistory::revision() const
   
-  setLineStyle(lsLine);
-  setScatterSkip(0);
-  setChannelFillGraph(nullptr);
-  setAdaptiveSampling(true);
-}
-
-QCPGraph::~QCPGraph()
-{
-}
+  Returns a counter that is incremented whenever the stored data changes. QCPGraph uses it to
+  detect whether its decoded view of the history is still up to date.
+*/
 
-/*! \overload
-  
-  Replaces the current data container with the provided \a data container.
-  
-  Since a QSharedPointer is used, multiple QCPGraphs may share the same data container safely.
-  Modifying the data in the container will then affect all graphs that share the container. Sharing
-  can be achieved by simply exchanging the data containers wrapped in shared pointers:
-  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpgraph-datasharing-1
+/*! \fn qint64 QCPGraphHistory::uncompressedSize() const
   
-  If you do not wish to share containers, but create a copy from an existing container, rather use
-  the \ref QCPDataContainer<DataType>::set method on the graph's data container directly:
-  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpgraph-datasharing-2
+  Returns the number of bytes the stored data points would occupy in a \ref QCPGraphDataContainer.
   
-  \see addData
+  \see compressedSize, compressionRatio
 */
-void QCPGraph::setData(QSharedPointer<QCPGraphDataContainer> data)
-{
-  mDataContainer = data;
-}
 
-/*! \overload
-  
-  Replaces the current data with the provided points in \a keys and \a values. The provided
-  vectors should have equal length. Else, the number of added points will be the size of the
-  smallest vector.
-  
-  If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
-  can set \a alreadySorted to true, to improve performance by saving a sorting run.
+/* end of documentation of inline functions */
+
+/*!
+  Constructs an empty history which compresses data points in blocks of \a blockSize points.
   
-  \see addData
+  \see setBlockSize
 */
-void QCPGraph::setData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted)
+QCPGraphHistory::QCPGraphHistory(int blockSize) :
+  mBlockSize(qMax(2, blockSize)),
+  mTailHeader(),
+  mSize(0),
+  mRevision(0)
 {
-  mDataContainer->clear();
-  addData(keys, values, alreadySorted);
 }
 
 /*!
-  Sets how the single data points are connected in the plot. For scatter-only plots, set \a ls to
-  \ref lsNone and \ref setScatterStyle to the desired scatter style.
-  
-  \see setScatterStyle
+  Returns the header of the block with the given \a index. The uncompressed tail block, if
+  present, has the index \ref blockCount - 1.
 */
-void QCPGraph::setLineStyle(LineStyle ls)
+QCPGraphHistory::BlockHeader QCPGraphHistory::blockHeader(int index) const
 {
-  mLineStyle = ls;
+  if (index >= 0 && index < mHeaders.size())
+    return mHeaders.at(index);
+  else if (index == mHeaders.size() && !mTail.isEmpty())
+    return mTailHeader;
+  qDebug() << Q_FUNC_INFO << "Invalid block index:" << index;
+  return BlockHeader();
 }
 
 /*!
-  Sets the visual appearance of single data points in the plot. If set to \ref QCPScatterStyle::ssNone, no scatter points
-  are drawn (e.g. for line-only-plots with appropriate line style).
+  Returns the number of bytes occupied by the stored data, including block headers and the
+  uncompressed tail block.
   
-  \see QCPScatterStyle, setLineStyle
+  \see uncompressedSize, compressionRatio
 */
-void QCPGraph::setScatterStyle(const QCPScatterStyle &style)
+qint64 QCPGraphHistory::compressedSize() const
 {
-  mScatterStyle = style;
+  qint64 result = qint64(mTail.size())*qint64(sizeof(QCPGraphData)) + qint64(blockCount())*qint64(sizeof(BlockHeader));
+  for (int i=0; i<mBlockData.size(); ++i)
+    result += mBlockData.at(i).size();
+  return result;
 }
 
 /*!
-  If scatters are displayed (scatter style not \ref QCPScatterStyle::ssNone), \a skip number of
-  scatter points are skipped/not drawn after every drawn scatter point.
-
-  This can be used to make the data appear sparser while for example still having a smooth line,
-  and to improve performance for very high density plots.
-
-  If \a skip is set to 0 (default), all scatter points are drawn.
-
-  \see setScatterStyle
+  Returns the ratio between the size the stored data would have in a \ref QCPGraphDataContainer
+  and the size it actually occupies, or zero if the history is empty.
+  
+  \see compressedSize, uncompressedSize
 */
-void QCPGraph::setScatterSkip(int skip)
+double QCPGraphHistory::compressionRatio() const
 {
-  mScatterSkip = qMax(0, skip);
+  const qint64 compressed = compressedSize();
+  return compressed > 0 ? double(uncompressedSize())/double(compressed) : 0;
 }
 
 /*!
-  Sets the target graph for filling the area between this graph and \a targetGraph with the current
-  brush (\ref setBrush).
+  Sets the number of data points that are compressed together in one block.
   
-  When \a targetGraph is set to 0, a normal graph fill to the zero-value-line will be shown. To
-  disable any filling, set the brush to Qt::NoBrush.
-
-  \see setBrush
+  Larger blocks compress slightly better, smaller blocks reduce the number of points that need to
+  be decoded when only a short key range is visible. The default of 1024 points is a good
+  compromise for most cases.
+  
+  If the history already contains data, it is recompressed with the new block size.
 */
-void QCPGraph::setChannelFillGraph(QCPGraph *targetGraph)
+void QCPGraphHistory::setBlockSize(int size)
 {
-  // prevent setting channel target to this graph itself:
-  if (targetGraph == this)
+  if (size < 2)
   {
-    qDebug() << Q_FUNC_INFO << "targetGraph is this graph itself";
-    mChannelFillGraph = nullptr;
+    qDebug() << Q_FUNC_INFO << "Block size must be at least 2:" << size;
     return;
   }
-  // prevent setting channel target to a graph not in the plot:
-  if (targetGraph && targetGraph->mParentPlot != mParentPlot)
-  {
-    qDebug() << Q_FUNC_INFO << "targetGraph not in same plot";
-    mChannelFillGraph = nullptr;
+  if (size == mBlockSize)
     return;
-  }
   
-  mChannelFillGraph = targetGraph;
+  QVector<QCPGraphData> data;
+  data.reserve(mSize);
+  for (int i=0; i<blockCount(); ++i)
+    decodeBlock(i, &data);
+  clear();
+  mBlockSize = size;
+  for (int i=0; i<data.size(); ++i)
+    add(data.at(i).key, data.at(i).value);
 }
 
-/*!
-  Sets whether adaptive sampling shall be used when plotting this graph. QCustomPlot's adaptive
-  sampling technique can drastically improve the replot performance for graphs with a larger number
-  of points (e.g. above 10,000), without notably changing the appearance of the graph.
-  
-  By default, adaptive sampling is enabled. Even if enabled, QCustomPlot decides whether adaptive
-  sampling shall actually be used on a per-graph basis. So leaving adaptive sampling enabled has no
-  disadvantage in almost all cases.
-  
-  \image html adaptive-sampling-line.png "A line plot of 500,000 points without and with adaptive sampling"
-  
-  As can be seen, line plots experience no visual degradation from adaptive sampling. Outliers are
-  reproduced reliably, as well as the overall shape of the data set. The replot time reduces
-  dramatically though. This allows QCustomPlot to display large amounts of data in realtime.
-  
-  \image html adaptive-sampling-scatter.png "A scatter plot of 100,000 points without and with adaptive sampling"
-  
-  Care must be taken when using high-density scatter plots in combination with adaptive sampling.
-  The adaptive sampling algorithm treats scatter plots more carefully than line plots which still
-  gives a significant reduction of replot times, but not quite as much as for line plots. This is
-  because scatter plots inherently need more data points to be preserved in order to still resemble
-  the original, non-adaptive-sampling plot. As shown above, the results still aren't quite
-  identical, as banding occurs for the outer data points. This is in fact intentional, such that
-  the boundaries of the data cloud stay visible to the viewer. How strong the banding appears,
-  depends on the point density, i.e. the number of points in the plot.
+/*! \overload
   
-  For some situations with scatter plots it might thus be desirable to manually turn adaptive
-  sampling off. For example, when saving the plot to disk. This can be achieved by setting \a
-  enabled to false before issuing a command like \ref QCustomPlot::savePng, and setting \a enabled
-  back to true afterwards.
+  Appends the data point \a key and \a value. The \a key must not be smaller than the key of the
+  last data point in the history, otherwise the point is rejected and a message is printed to the
+  debug output. Values may be NaN, to create gaps in the graph line.
 */
-void QCPGraph::setAdaptiveSampling(bool enabled)
+void QCPGraphHistory::add(double key, double value)
 {
-  mAdaptiveSampling = enabled;
+  if (qIsNaN(key) || (!mTail.isEmpty() && key < mTail.last().key) || (mTail.isEmpty() && !mHeaders.isEmpty() && key < mHeaders.last().keyUpper))
+  {
+    qDebug() << Q_FUNC_INFO << "Data points must be added in ascending key order, ignoring key" << key;
+    return;
+  }
+  if (mTail.isEmpty())
+    mTail.reserve(mBlockSize);
+  includeInHeader(mTailHeader, key, value);
+  mTail.append(QCPGraphData(key, value));
+  ++mSize;
+  ++mRevision;
+  if (mTail.size() >= mBlockSize)
+    sealTail();
 }
 
 /*! \overload
   
-  Adds the provided points in \a keys and \a values to the current data. The provided vectors
-  should have equal length. Else, the number of added points will be the size of the smallest
-  vector.
-  
-  If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
-  can set \a alreadySorted to true, to improve performance by saving a sorting run.
-  
-  Alternatively, you can also access and modify the data directly via the \ref data method, which
-  returns a pointer to the internal data container.
+  Appends the data points given by \a keys and \a values. The provided vectors should have equal
+  length. Else, the number of added points will be the size of the smallest vector. The keys must
+  be sorted in ascending order, and the first key must not be smaller than the key of the last data
+  point in the history.
 */
-void QCPGraph::addData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted)
+void QCPGraphHistory::add(const QVector<double> &keys, const QVector<double> &values)
 {
   if (keys.size() != values.size())
     qDebug() << Q_FUNC_INFO << "keys and values have different sizes:" << keys.size() << values.size();
   const int n = qMin(keys.size(), values.size());
-  QVector<QCPGraphData> tempData(n);
-  QVector<QCPGraphData>::iterator it = tempData.begin();
-  const QVector<QCPGraphData>::iterator itEnd = tempData.end();
-  int i = 0;
-  while (it != itEnd)
-  {
-    it->key = keys[i];
-    it->value = values[i];
-    ++it;
-    ++i;
-  }
-  mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+  for (int i=0; i<n; ++i)
+    add(keys.at(i), values.at(i));
 }
 
-/*! \overload
-  
-  Adds the provided data point as \a key and \a value to the current data.
-  
-  Alternatively, you can also access and modify the data directly via the \ref data method, which
-  returns a pointer to the internal data container.
+/*!
+  Removes all data points from the history.
 */
-void QCPGraph::addData(double key, double value)
+void QCPGraphHistory::clear()
 {
-  mDataContainer->add(QCPGraphData(key, value));
+  mHeaders.clear();
+  mBlockData.clear();
+  mTail.clear();
+  mTailHeader = BlockHeader();
+  mSize = 0;
+  ++mRevision;
 }
 
 /*!
-  Implements a selectTest specific to this plottable's point geometry.
-
-  If \a details is not 0, it will be set to a \ref QCPDataSelection, describing the closest data
-  point to \a pos.
+  Returns the range spanned by the keys of the stored data points. If \a signDomain is not \ref
+  QCP::sdBoth, only keys of the respective sign are considered. \a foundRange indicates whether
+  the returned range is valid.
   
-  \seebaseclassmethod \ref QCPAbstractPlottable::selectTest
+  Only the single block that contains the sign change of the keys, if any, needs to be decoded.
 */
-double QCPGraph::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
+QCPRange QCPGraphHistory::keyRange(bool &foundRange, QCP::SignDomain signDomain) const
 {
-  if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
-    return -1;
-  if (!mKeyAxis || !mValueAxis)
-    return -1;
+  foundRange = false;
+  QCPRange range;
+  const int count = blockCount();
+  if (count == 0)
+    return range;
+  if (signDomain == QCP::sdBoth)
+  {
+    foundRange = true;
+    return QCPRange(blockHeader(0).keyLower, blockHeader(count-1).keyUpper);
+  }
   
-  if (mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()) || mParentPlot->interactions().testFlag(QCP::iSelectPlottablesBeyondAxisRect))
+  QVector<QCPGraphData> data;
+  for (int i=0; i<count; ++i)
   {
-    QCPGraphDataContainer::const_iterator closestDataPoint = mDataContainer->constEnd();
-    double result = pointDistance(pos, closestDataPoint);
-    if (details)
+    const BlockHeader header = blockHeader(i);
+    if ((signDomain == QCP::sdPositive && header.keyLower > 0) || (signDomain == QCP::sdNegative && header.keyUpper < 0))
     {
-      int pointIndex = int(closestDataPoint-mDataContainer->constBegin());
-      details->setValue(QCPDataSelection(QCPDataRange(pointIndex, pointIndex+1)));
+      expandRange(range, foundRange, header.keyLower, header.keyUpper);
+    } else if ((signDomain == QCP::sdPositive && header.keyUpper > 0) || (signDomain == QCP::sdNegative && header.keyLower < 0))
+    {
+      // block contains keys of both signs, look at its individual data points:
+      data.resize(0);
+      decodeBlock(i, &data);
+      for (int k=0; k<data.size(); ++k)
+      {
+        const double key = data.at(k).key;
+        if ((signDomain == QCP::sdPositive && key > 0) || (signDomain == QCP::sdNegative && key < 0))
+          expandRange(range, foundRange, key, key);
+      }
     }
-    return result;
-  } else
-    return -1;
+  }
+  return range;
 }
 
-/* inherits documentation from base class */
-QCPRange QCPGraph::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
+/*!
+  Returns the range spanned by the values of the stored data points. If \a signDomain is not \ref
+  QCP::sdBoth, only values of the respective sign are considered. If \a inKeyRange has both lower
+  and upper bound set to zero (is equal to <tt>QCPRange()</tt>), all data points are considered,
+  otherwise only those whose key lies within \a inKeyRange. \a foundRange indicates whether the
+  returned range is valid.
+  
+  The range is taken from the block headers wherever possible. Only blocks at the boundary of \a
+  inKeyRange and blocks whose values straddle the sign boundary are decoded.
+*/
+QCPRange QCPGraphHistory::valueRange(bool &foundRange, QCP::SignDomain signDomain, const QCPRange &inKeyRange) const
 {
-  return mDataContainer->keyRange(foundRange, inSignDomain);
+  foundRange = false;
+  QCPRange range;
+  const bool restrictKeyRange = inKeyRange != QCPRange();
+  const int count = blockCount();
+  int first = restrictKeyRange ? findBlock(inKeyRange.lower) : 0;
+  
+  QVector<QCPGraphData> data;
+  for (int i=first; i<count; ++i)
+  {
+    const BlockHeader header = blockHeader(i);
+    if (restrictKeyRange && header.keyLower > inKeyRange.upper)
+      break;
+    if (qIsNaN(header.minValue))
+      continue; // block only contains NaN values
+    if ((signDomain == QCP::sdPositive && header.maxValue <= 0) || (signDomain == QCP::sdNegative && header.minValue >= 0))
+      continue; // no value in this block has the requested sign
+    
+    const bool blockInKeyRange = !restrictKeyRange || (header.keyLower >= inKeyRange.lower && header.keyUpper <= inKeyRange.upper);
+    const bool blockInSignDomain = signDomain == QCP::sdBoth || (signDomain == QCP::sdPositive && header.minValue > 0) || (signDomain == QCP::sdNegative && header.maxValue < 0);
+    if (blockInKeyRange && blockInSignDomain)
+    {
+      expandRange(range, foundRange, header.minValue, header.maxValue);
+    } else
+    {
+      data.resize(0);
+      decodeBlock(i, &data);
+      for (int k=0; k<data.size(); ++k)
+      {
+        const QCPGraphData &point = data.at(k);
+        if (qIsNaN(point.value) || (restrictKeyRange && (point.key < inKeyRange.lower || point.key > inKeyRange.upper)))
+          continue;
+        if (signDomain == QCP::sdBoth || (signDomain == QCP::sdPositive && point.value > 0) || (signDomain == QCP::sdNegative && point.value < 0))
+          expandRange(range, foundRange, point.value, point.value);
+      }
+    }
+  }
+  return range;
 }
 
-/* inherits documentation from base class */
-QCPRange QCPGraph::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
+/*!
+  Returns the index of the first block whose last key is equal to or greater than \a key, or \ref
+  blockCount if there is no such block.
+*/
+int QCPGraphHistory::findBlock(double key) const
 {
-  return mDataContainer->valueRange(foundRange, inSignDomain, inKeyRange);
+  int lower = 0;
+  int upper = blockCount();
+  while (lower < upper)
+  {
+    const int middle = lower + (upper-lower)/2;
+    if ((middle < mHeaders.size() ? mHeaders.at(middle).keyUpper : mTailHeader.keyUpper) < key)
+      lower = middle+1;
+    else
+      upper = middle;
+  }
+  return lower;
 }
 
-/* inherits documentation from base class */
-void QCPGraph::draw(QCPPainter *painter)
-{
-  if (!mKeyAxis || !mValueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
-  if (mKeyAxis.data()->range().size() <= 0 || mDataContainer->isEmpty()) return;
-  if (mLineStyle == lsNone && mScatterStyle.isNone()) return;
-  
-  QVector<QPointF> lines, scatters; // line and (if necessary) scatter pixel coordinates will be stored here while iterating over segments
+/*!
+  Decodes the block with the given \a index and appends its data points to \a data.
   
-  // loop over and draw segments of unselected/selected data:
-  QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
+  \see decode, blockHeader
+*/
+void QCPGraphHistory::decodeBlock(int index, QVector<QCPGraphData> *data) const
+{
+  if (index == mHeaders.size() && !mTail.isEmpty())
+  {
+    *data << mTail;
+    return;
+  }
+  if (index < 0 || index >= mHeaders.size())
+  {
+    qDebug() << Q_FUNC_INFO << "Invalid block index:" << index;
+    return;
+  }
+  
+  const int count = mHeaders.at(index).count;
+  const int offset = data->size();
+  data->resize(offset+count);
+  QCPGraphData *out = data->data()+offset;
+  
+  BitReader reader(mBlockData.at(index));
+  quint64 keyBits = reader.read(64);
+  quint64 valueBits = reader.read(64);
+  quint64 delta = 0;
+  int leading = 0, trailing = 0;
+  memcpy(&out[0].key, &keyBits, sizeof(double));
+  memcpy(&out[0].value, &valueBits, sizeof(double));
+  for (int i=1; i<count; ++i)
+  {
+    // key, delta-of-delta with variable length prefix:
+    qint64 deltaOfDelta;
+    if (!reader.readBit())
+      deltaOfDelta = 0;
+    else if (!reader.readBit())
+      deltaOfDelta = qint64(reader.read(7))-63;
+    else if (!reader.readBit())
+      deltaOfDelta = qint64(reader.read(9))-255;
+    else if (!reader.readBit())
+      deltaOfDelta = qint64(reader.read(12))-2047;
+    else
+      deltaOfDelta = qint64(reader.read(64));
+    delta += quint64(deltaOfDelta);
+    keyBits += delta;
+    // value, XOR with previous value:
+    if (reader.readBit())
+    {
+      if (reader.readBit())
+      {
+        leading = int(reader.read(5));
+        trailing = 64-leading-(int(reader.read(6))+1);
+      }
+      valueBits ^= reader.read(64-leading-trailing) << trailing;
+    }
+    memcpy(&out[i].key, &keyBits, sizeof(double));
+    memcpy(&out[i].value, &valueBits, sizeof(double));
+  }
+}
+
+/*!
+  Decodes all blocks that intersect \a keyRange and appends their data points to \a data. Since
+  whole blocks are decoded, \a data may contain points slightly outside of \a keyRange.
+  
+  \see decodeBlock
+*/
+void QCPGraphHistory::decode(QVector<QCPGraphData> *data, const QCPRange &keyRange) const
+{
+  const int count = blockCount();
+  for (int i=findBlock(keyRange.lower); i<count; ++i)
+  {
+    if ((i < mHeaders.size() ? mHeaders.at(i).keyLower : mTailHeader.keyLower) > keyRange.upper)
+      break;
+    decodeBlock(i, data);
+  }
+}
+
+/*! \internal
+  
+  Compresses the tail block and appends it to the sealed blocks.
+*/
+void QCPGraphHistory::sealTail()
+{
+  mBlockData.append(encodeBlock(mTail));
+  mHeaders.append(mTailHeader);
+  mTail.resize(0);
+  mTailHeader = BlockHeader();
+}
+
+/*! \internal
+  
+  Returns the compressed bit stream of \a data. The first data point is stored raw, every
+  following key as the delta-of-delta of the key bit patterns and every following value as the
+  XOR with the previous value bit pattern. See \ref decodeBlock for the inverse.
+*/
+QByteArray QCPGraphHistory::encodeBlock(const QVector<QCPGraphData> &data) const
+{
+  QByteArray result;
+  result.reserve(data.size()*4);
+  BitWriter writer(&result);
+  quint64 previousKeyBits = 0, previousValueBits = 0, previousDelta = 0;
+  int previousLeading = -1, previousTrailing = 0;
+  for (int i=0; i<data.size(); ++i)
+  {
+    quint64 keyBits, valueBits;
+    memcpy(&keyBits, &data.at(i).key, sizeof(double));
+    memcpy(&valueBits, &data.at(i).value, sizeof(double));
+    if (i == 0)
+    {
+      writer.write(keyBits, 64);
+      writer.write(valueBits, 64);
+    } else
+    {
+      const quint64 delta = keyBits-previousKeyBits;
+      const qint64 deltaOfDelta = qint64(delta-previousDelta);
+      if (deltaOfDelta == 0)
+        writer.write(0, 1);
+      else if (deltaOfDelta >= -63 && deltaOfDelta <= 64)
+      {
+        writer.write(0x2, 2);
+        writer.write(quint64(deltaOfDelta+63), 7);
+      } else if (deltaOfDelta >= -255 && deltaOfDelta <= 256)
+      {
+        writer.write(0x6, 3);
+        writer.write(quint64(deltaOfDelta+255), 9);
+      } else if (deltaOfDelta >= -2047 && deltaOfDelta <= 2048)
+      {
+        writer.write(0xE, 4);
+        writer.write(quint64(deltaOfDelta+2047), 12);
+      } else
+      {
+        writer.write(0xF, 4);
+        writer.write(quint64(deltaOfDelta), 64);
+      }
+      previousDelta = delta;
+      
+      const quint64 xorBits = valueBits^previousValueBits;
+      if (xorBits == 0)
+        writer.write(0, 1);
+      else
+      {
+        const int leading = qMin(31, leadingZeroBits(xorBits)); // leading zero count is stored in 5 bits
+        const int trailing = trailingZeroBits(xorBits);
+        if (previousLeading >= 0 && leading >= previousLeading && trailing >= previousTrailing)
+        {
+          // meaningful bits fit into the window of the previous value:
+          writer.write(0x2, 2);
+          writer.write(xorBits >> previousTrailing, 64-previousLeading-previousTrailing);
+        } else
+        {
+          const int length = 64-leading-trailing;
+          writer.write(0x3, 2);
+          writer.write(quint64(leading), 5);
+          writer.write(quint64(length-1), 6);
+          writer.write(xorBits >> trailing, length);
+          previousLeading = leading;
+          previousTrailing = trailing;
+        }
+      }
+    }
+    previousKeyBits = keyBits;
+    previousValueBits = valueBits;
+  }
+  result.squeeze();
+  return result;
+}
+
+/*! \internal
+  
+  Updates \a header to include the data point \a key and \a value, which must have a key equal to
+  or larger than all points already included.
+*/
+void QCPGraphHistory::includeInHeader(BlockHeader &header, double key, double value)
+{
+  if (header.count == 0)
+  {
+    header.keyLower = key;
+    header.firstValue = value;
+    header.minKey = key;
+    header.maxKey = key;
+    header.minValue = qQNaN();
+    header.maxValue = qQNaN();
+  }
+  header.keyUpper = key;
+  header.lastValue = value;
+  if (!qIsNaN(value))
+  {
+    if (qIsNaN(header.minValue) || value < header.minValue)
+    {
+      header.minValue = value;
+      header.minKey = key;
+    }
+    if (qIsNaN(header.maxValue) || value > header.maxValue)
+    {
+      header.maxValue = value;
+      header.maxKey = key;
+    }
+  }
+  ++header.count;
+}
+
+/*! \internal
+  
+  Expands \a range to include \a lower and \a upper. If \a foundRange is false, \a range is set to
+  span exactly \a lower to \a upper and \a foundRange is set to true.
+*/
+void QCPGraphHistory::expandRange(QCPRange &range, bool &foundRange, double lower, double upper)
+{
+  if (!foundRange)
+  {
+    range = QCPRange(lower, upper);
+    foundRange = true;
+  } else
+  {
+    if (lower < range.lower)
+      range.lower = lower;
+    if (upper > range.upper)
+      range.upper = upper;
+  }
+}
+
+/*! \internal
+  
+  Returns the number of leading zero bits of \a x, which must not be zero.
+*/
+int QCPGraphHistory::leadingZeroBits(quint64 x)
+{
+  int result = 0;
+  for (int shift=32; shift>0; shift/=2)
+  {
+    if ((x >> (64-shift)) == 0)
+    {
+      result += shift;
+      x <<= shift;
+    }
+  }
+  return result;
+}
+
+/*! \internal
+  
+  Returns the number of trailing zero bits of \a x, which must not be zero.
+*/
+int QCPGraphHistory::trailingZeroBits(quint64 x)
+{
+  int result = 0;
+  for (int shift=32; shift>0; shift/=2)
+  {
+    if ((x & ((quint64(1) << shift)-1)) == 0)
+    {
+      result += shift;
+      x >>= shift;
+    }
+  }
+  return result;
+}
+
+/*! \internal
+  
+  Creates a bit writer that appends to \a data, most significant bit first.
+*/
+QCPGraphHistory::BitWriter::BitWriter(QByteArray *data) :
+  mData(data),
+  mFreeBits(0)
+{
+}
+
+/*! \internal
+  
+  Appends the \a count (1 to 64) least significant bits of \a bits.
+*/
+void QCPGraphHistory::BitWriter::write(quint64 bits, int count)
+{
+  while (count > 0)
+  {
+    if (mFreeBits == 0)
+    {
+      mData->append(char(0));
+      mFreeBits = 8;
+    }
+    const int n = qMin(mFreeBits, count);
+    const uint chunk = uint(bits >> (count-n)) & ((1u << n)-1);
+    uchar *last = reinterpret_cast<uchar*>(mData->data())+mData->size()-1;
+    *last = uchar(*last | (chunk << (mFreeBits-n)));
+    mFreeBits -= n;
+    count -= n;
+  }
+}
+
+/*! \internal
+  
+  Creates a bit reader that reads \a data, most significant bit first. \a data must outlive the
+  reader.
+*/
+QCPGraphHistory::BitReader::BitReader(const QByteArray &data) :
+  mData(reinterpret_cast<const uchar*>(data.constData())),
+  mByte(0),
+  mBit(0)
+{
+}
+
+/*! \internal
+  
+  Reads the next \a count (1 to 64) bits and returns them in the least significant bits of the
+  result.
+*/
+quint64 QCPGraphHistory::BitReader::read(int count)
+{
+  quint64 result = 0;
+  while (count > 0)
+  {
+    const int available = 8-mBit;
+    const int n = qMin(available, count);
+    result = (result << n) | ((uint(mData[mByte]) >> (available-n)) & ((1u << n)-1));
+    mBit += n;
+    count -= n;
+    if (mBit == 8)
+    {
+      mBit = 0;
+      ++mByte;
+    }
+  }
+  return result;
+}
+
+/*! \internal
+  
+  Reads the next single bit.
+*/
+bool QCPGraphHistory::BitReader::readBit()
+{
+  const bool result = (mData[mByte] >> (7-mBit)) & 1;
+  if (++mBit == 8)
+  {
+    mBit = 0;
+    ++mByte;
+  }
+  return result;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPGraph
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPGraph
+  \brief A plottable representing a graph in a plot.
+
+  \image html QCPGraph.png
+  
+  Usually you create new graphs by calling QCustomPlot::addGraph. The resulting instance can be
+  accessed via QCustomPlot::graph.
+
+  To plot data, assign it with the \ref setData or \ref addData functions. Alternatively, you can
+  also access and modify the data via the \ref data method, which returns a pointer to the internal
+  \ref QCPGraphDataContainer.
+  
+  Graphs are used to display single-valued data. Single-valued means that there should only be one
+  data point per unique key coordinate. In other words, the graph can't have \a loops. If you do
+  want to plot non-single-valued curves, rather use the QCPCurve plottable.
+  
+  Gaps in the graph line can be created by adding data points with NaN as value
+  (<tt>qQNaN()</tt> or <tt>std::numeric_limits<double>::quiet_NaN()</tt>) in between the two data points that shall be
+  separated.
+  
+  For long-running recordings that would occupy too much memory as raw data points, the graph can
+  display a compressed \ref QCPGraphHistory instead, see \ref setHistory.
+  
+  \section qcpgraph-appearance Changing the appearance
+  
+  The appearance of the graph is mainly determined by the line style, scatter style, brush and pen
+  of the graph (\ref setLineStyle, \ref setScatterStyle, \ref setBrush, \ref setPen).
+  
+  \subsection filling Filling under or between graphs
+  
+  QCPGraph knows two types of fills: Normal graph fills towards the zero-value-line parallel to
+  the key axis of the graph, and fills between two graphs, called channel fills. To enable a fill,
+  just set a brush with \ref setBrush which is neither Qt::NoBrush nor fully transparent.
+  
+  By default, a normal fill towards the zero-value-line will be drawn. To set up a channel fill
+  between this graph and another one, call \ref setChannelFillGraph with the other graph as
+  parameter.
+
+  \see QCustomPlot::addGraph, QCustomPlot::graph
+*/
+
+/* start of documentation of inline functions */
+
+/*! \fn QSharedPointer<QCPGraphDataContainer> QCPGraph::data() const
+  
+  Returns a shared pointer to the internal data storage of type \ref QCPGraphDataContainer. You may
+  use it to directly manipulate the data, which may be more convenient and faster than using the
+  regular \ref setData or \ref addData methods.
+*/
+
+/* end of documentation of inline functions */
+
+/*!
+  Constructs a graph which uses \a keyAxis as its key axis ("x") and \a valueAxis as its value
+  axis ("y"). \a keyAxis and \a valueAxis must reside in the same QCustomPlot instance and not have
+  the same orientation. If either of these restrictions is violated, a corresponding message is
+  printed to the debug output (qDebug), the construction is not aborted, though.
+  
+  The created QCPGraph is automatically registered with the QCustomPlot instance inferred from \a
+  keyAxis. This QCustomPlot instance takes ownership of the QCPGraph, so do not delete it manually
+  but use QCustomPlot::removePlottable() instead.
+  
+  To directly create a graph inside a plot, you can also use the simpler QCustomPlot::addGraph function.
+*/
+QCPGraph::QCPGraph(QCPAxis *keyAxis, QCPAxis *valueAxis) :
+  QCPAbstractPlottable1D<QCPGraphData>(keyAxis, valueAxis),
+  mLineStyle{},
+  mScatterSkip{},
+  mAdaptiveSampling{},
+  mChannelFillLinesValid(false),
+  mHistoryViewValid(false),
+  mHistoryViewRevision(0),
+  mHistoryViewPixels(0)
+{
+  // special handling for QCPGraphs to maintain the simple graph interface:
+  mParentPlot->registerGraph(this);
+
+  setPen(QPen(Qt::blue, 0));
+  setBrush(Qt::NoBrush);
+  
+  setLineStyle(lsLine);
+  setScatterSkip(0);
+  setChannelFillGraph(nullptr);
+  setAdaptiveSampling(true);
+}
+
+QCPGraph::~QCPGraph()
+{
+}
+
+/*! \overload
+  
+  Replaces the current data container with the provided \a data container.
+  
+  Since a QSharedPointer is used, multiple QCPGraphs may share the same data container safely.
+  Modifying the data in the container will then affect all graphs that share the container. Sharing
+  can be achieved by simply exchanging the data containers wrapped in shared pointers:
+  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpgraph-datasharing-1
+  
+  If you do not wish to share containers, but create a copy from an existing container, rather use
+  the \ref QCPDataContainer<DataType>::set method on the graph's data container directly:
+  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpgraph-datasharing-2
+  
+  \see addData
+*/
+void QCPGraph::setData(QSharedPointer<QCPGraphDataContainer> data)
+{
+  mDataContainer = data;
+}
+
+/*! \overload
+  
+  Replaces the current data with the provided points in \a keys and \a values. The provided
+  vectors should have equal length. Else, the number of added points will be the size of the
+  smallest vector.
+  
+  If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
+  can set \a alreadySorted to true, to improve performance by saving a sorting run.
+  
+  \see addData
+*/
+void QCPGraph::setData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted)
+{
+  mDataContainer->clear();
+  addData(keys, values, alreadySorted);
+}
+
+/*!
+  Makes this graph display the compressed data points of \a history. Pass a null pointer to return
+  to displaying the regular data container.
+  
+  While a history is set, the data container returned by \ref data is a view that the graph fills
+  with the blocks of the history intersecting the visible key range, each time the key range or the
+  history changes. Blocks narrower than one pixel are not decoded, the view only contains the first,
+  last, minimum and maximum data point of those blocks, taken from the block header. Modifications
+  to the data container are therefore overwritten with the next replot, and data selections refer
+  to the points of the current view.
+  
+  Key and value ranges (e.g. for \ref rescaleAxes) are computed from the entire history.
+  
+  \see QCPGraphHistory::add
+*/
+void QCPGraph::setHistory(QSharedPointer<QCPGraphHistory> history)
+{
+  if (mHistory || history) // don't modify a container the user may share with other graphs
+    mDataContainer = QSharedPointer<QCPGraphDataContainer>(new QCPGraphDataContainer);
+  mHistory = history;
+  mHistoryViewValid = false;
+}
+
+/*!
+  Sets how the single data points are connected in the plot. For scatter-only plots, set \a ls to
+  \ref lsNone and \ref setScatterStyle to the desired scatter style.
+  
+  \see setScatterStyle
+*/
+void QCPGraph::setLineStyle(LineStyle ls)
+{
+  mLineStyle = ls;
+}
+
+/*!
+  Sets the visual appearance of single data points in the plot. If set to \ref QCPScatterStyle::ssNone, no scatter points
+  are drawn (e.g. for line-only-plots with appropriate line style).
+  
+  \see QCPScatterStyle, setLineStyle
+*/
+void QCPGraph::setScatterStyle(const QCPScatterStyle &style)
+{
+  mScatterStyle = style;
+}
+
+/*!
+  If scatters are displayed (scatter style not \ref QCPScatterStyle::ssNone), \a skip number of
+  scatter points are skipped/not drawn after every drawn scatter point.
+
+  This can be used to make the data appear sparser while for example still having a smooth line,
+  and to improve performance for very high density plots.
+
+  If \a skip is set to 0 (default), all scatter points are drawn.
+
+  \see setScatterStyle
+*/
+void QCPGraph::setScatterSkip(int skip)
+{
+  mScatterSkip = qMax(0, skip);
+}
+
+/*!
+  Sets the target graph for filling the area between this graph and \a targetGraph with the current
+  brush (\ref setBrush).
+  
+  When \a targetGraph is set to 0, a normal graph fill to the zero-value-line will be shown. To
+  disable any filling, set the brush to Qt::NoBrush.
+
+  \see setBrush
+*/
+void QCPGraph::setChannelFillGraph(QCPGraph *targetGraph)
+{
+  // prevent setting channel target to this graph itself:
+  if (targetGraph == this)
+  {
+    qDebug() << Q_FUNC_INFO << "targetGraph is this graph itself";
+    mChannelFillGraph = nullptr;
+    return;
+  }
+  // prevent setting channel target to a graph not in the plot:
+  if (targetGraph && targetGraph->mParentPlot != mParentPlot)
+  {
+    qDebug() << Q_FUNC_INFO << "targetGraph not in same plot";
+    mChannelFillGraph = nullptr;
+    return;
+  }
+  
+  mChannelFillGraph = targetGraph;
+}
+
+/*!
+  Sets whether adaptive sampling shall be used when plotting this graph. QCustomPlot's adaptive
+  sampling technique can drastically improve the replot performance for graphs with a larger number
+  of points (e.g. above 10,000), without notably changing the appearance of the graph.
+  
+  By default, adaptive sampling is enabled. Even if enabled, QCustomPlot decides whether adaptive
+  sampling shall actually be used on a per-graph basis. So leaving adaptive sampling enabled has no
+  disadvantage in almost all cases.
+  
+  \image html adaptive-sampling-line.png "A line plot of 500,000 points without and with adaptive sampling"
+  
+  As can be seen, line plots experience no visual degradation from adaptive sampling. Outliers are
+  reproduced reliably, as well as the overall shape of the data set. The replot time reduces
+  dramatically though. This allows QCustomPlot to display large amounts of data in realtime.
+  
+  \image html adaptive-sampling-scatter.png "A scatter plot of 100,000 points without and with adaptive sampling"
+  
+  Care must be taken when using high-density scatter plots in combination with adaptive sampling.
+  The adaptive sampling algorithm treats scatter plots more carefully than line plots which still
+  gives a significant reduction of replot times, but not quite as much as for line plots. This is
+  because scatter plots inherently need more data points to be preserved in order to still resemble
+  the original, non-adaptive-sampling plot. As shown above, the results still aren't quite
+  identical, as banding occurs for the outer data points. This is in fact intentional, such that
+  the boundaries of the data cloud stay visible to the viewer. How strong the banding appears,
+  depends on the point density, i.e. the number of points in the plot.
+  
+  For some situations with scatter plots it might thus be desirable to manually turn adaptive
+  sampling off. For example, when saving the plot to disk. This can be achieved by setting \a
+  enabled to false before issuing a command like \ref QCustomPlot::savePng, and setting \a enabled
+  back to true afterwards.
+*/
+void QCPGraph::setAdaptiveSampling(bool enabled)
+{
+  mAdaptiveSampling = enabled;
+}
+
+/*! \overload
+  
+  Adds the provided points in \a keys and \a values to the current data. The provided vectors
+  should have equal length. Else, the number of added points will be the size of the smallest
+  vector.
+  
+  If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
+  can set \a alreadySorted to true, to improve performance by saving a sorting run.
+  
+  Alternatively, you can also access and modify the data directly via the \ref data method, which
+  returns a pointer to the internal data container.
+*/
+void QCPGraph::addData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted)
+{
+  if (keys.size() != values.size())
+    qDebug() << Q_FUNC_INFO << "keys and values have different sizes:" << keys.size() << values.size();
+  const int n = qMin(keys.size(), values.size());
+  QVector<QCPGraphData> tempData(n);
+  QVector<QCPGraphData>::iterator it = tempData.begin();
+  const QVector<QCPGraphData>::iterator itEnd = tempData.end();
+  int i = 0;
+  while (it != itEnd)
+  {
+    it->key = keys[i];
+    it->value = values[i];
+    ++it;
+    ++i;
+  }
+  mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+}
+
+/*! \overload
+  
+  Adds the provided data point as \a key and \a value to the current data.
+  
+  Alternatively, you can also access and modify the data directly via the \ref data method, which
+  returns a pointer to the internal data container.
+*/
+void QCPGraph::addData(double key, double value)
+{
+  mDataContainer->add(QCPGraphData(key, value));
+}
+
+/*!
+  Implements a selectTest specific to this plottable's point geometry.
+
+  If \a details is not 0, it will be set to a \ref QCPDataSelection, describing the closest data
+  point to \a pos.
+  
+  \seebaseclassmethod \ref QCPAbstractPlottable::selectTest
+*/
+double QCPGraph::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
+{
+  if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
+    return -1;
+  if (!mKeyAxis || !mValueAxis)
+    return -1;
+  
+  if (mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()) || mParentPlot->interactions().testFlag(QCP::iSelectPlottablesBeyondAxisRect))
+  {
+    QCPGraphDataContainer::const_iterator closestDataPoint = mDataContainer->constEnd();
+    double result = pointDistance(pos, closestDataPoint);
+    if (details)
+    {
+      int pointIndex = int(closestDataPoint-mDataContainer->constBegin());
+      details->setValue(QCPDataSelection(QCPDataRange(pointIndex, pointIndex+1)));
+    }
+    return result;
+  } else
+    return -1;
+}
+
+/* inherits documentation from base class */
+QCPRange QCPGraph::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
+{
+  if (mHistory)
+    return mHistory->keyRange(foundRange, inSignDomain);
+  return mDataContainer->keyRange(foundRange, inSignDomain);
+}
+
+/* inherits documentation from base class */
+QCPRange QCPGraph::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
+{
+  if (mHistory)
+    return mHistory->valueRange(foundRange, inSignDomain, inKeyRange);
+  return mDataContainer->valueRange(foundRange, inSignDomain, inKeyRange);
+}
+
+/* inherits documentation from base class */
+void QCPGraph::draw(QCPPainter *painter)
+{
+  if (!mKeyAxis || !mValueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
+  if (mHistory)
+    updateHistoryView();
+  if (mChannelFillGraph && mChannelFillGraph.data()->mHistory)
+    mChannelFillGraph.data()->updateHistoryView(); // target graph may be drawn after this one
+  if (mKeyAxis.data()->range().size() <= 0 || mDataContainer->isEmpty()) return;
+  if (mLineStyle == lsNone && mScatterStyle.isNone()) return;
+  
+  // line and (if necessary) scatter pixel coordinates will be stored here while iterating over segments:
+  QCPScratchPool<QPointF> *pointPool = mParentPlot ? mParentPlot->frameArena()->pointPool() : nullptr;
+  QCPScratchBuffer<QPointF> lines(pointPool), scatters(pointPool);
+  mChannelFillLinesValid = false; // channel fill target lines are fetched at most once per draw, see drawFill
+  
+  // loop over and draw segments of unselected/selected data:
+  QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
   getDataSegments(selectedSegments, unselectedSegments);
   allSegments << unselectedSegments << selectedSegments;
   for (int i=0; i<allSegments.size(); ++i)
@@ -21140,7 +23087,10 @@ void QCPGraph::draw(QCPPainter *painter)
     bool isSelectedSegment = i >= unselectedSegments.size();
     // get line pixel points appropriate to line style:
     QCPDataRange lineDataRange = isSelectedSegment ? allSegments.at(i) : allSegments.at(i).adjusted(-1, 1); // unselected segments extend lines to bordering selected data point (safe to exceed total data bounds in first/last segment, getLines takes care)
-    getLines(&lines, lineDataRange);
+    {
+      QCPProfilerScope dataScope(mParentPlot, QCPProfiler::phDataPreparation, mName);
+      getLines(lines.data(), lineDataRange);
+    }
     
     // check data validity if flag set:
 #ifdef QCUSTOMPLOT_CHECK_DATA
@@ -21158,7 +23108,7 @@ void QCPGraph::draw(QCPPainter *painter)
     else
       painter->setBrush(mBrush);
     painter->setPen(Qt::NoPen);
-    drawFill(painter, &lines);
+    drawFill(painter, lines.data());
     
     // draw line:
     if (mLineStyle != lsNone)
@@ -21169,9 +23119,9 @@ void QCPGraph::draw(QCPPainter *painter)
         painter->setPen(mPen);
       painter->setBrush(Qt::NoBrush);
       if (mLineStyle == lsImpulse)
-        drawImpulsePlot(painter, lines);
+        drawImpulsePlot(painter, *lines);
       else
-        drawLinePlot(painter, lines); // also step plots can be drawn as a line plot
+        drawLinePlot(painter, *lines); // also step plots can be drawn as a line plot
     }
     
     // draw scatters:
@@ -21180,11 +23130,16 @@ void QCPGraph::draw(QCPPainter *painter)
       finalScatterStyle = mSelectionDecorator->getFinalScatterStyle(mScatterStyle);
     if (!finalScatterStyle.isNone())
     {
-      getScatters(&scatters, allSegments.at(i));
-      drawScatterPlot(painter, scatters, finalScatterStyle);
+      {
+        QCPProfilerScope dataScope(mParentPlot, QCPProfiler::phDataPreparation, mName);
+        getScatters(scatters.data(), allSegments.at(i));
+      }
+      drawScatterPlot(painter, *scatters, finalScatterStyle);
     }
   }
   
+  mChannelFillLinesValid = false; // target graph may change before next draw, don't reuse its lines
+  
   // draw other selection decoration that isn't just line/scatter pens and brushes:
   if (mSelectionDecorator)
     mSelectionDecorator->drawDecoration(painter, selection());
@@ -21256,21 +23211,24 @@ void QCPGraph::getLines(QVector<QPointF> *lines, const QCPDataRange &dataRange)
     return;
   }
   
-  QVector<QCPGraphData> lineData;
+  QCPScratchBuffer<QCPGraphData> lineData(mParentPlot ? mParentPlot->frameArena()->graphDataPool() : nullptr);
   if (mLineStyle != lsNone)
-    getOptimizedLineData(&lineData, begin, end);
+  {
+    if (!(mParentPlot && mParentPlot->coarseRendering() && getCoarseData(lineData.data(), begin, end)))
+      getOptimizedLineData(lineData.data(), begin, end);
+  }
   
   if (mKeyAxis->rangeReversed() != (mKeyAxis->orientation() == Qt::Vertical)) // make sure key pixels are sorted ascending in lineData (significantly simplifies following processing)
-    std::reverse(lineData.begin(), lineData.end());
+    std::reverse(lineData->begin(), lineData->end());
 
   switch (mLineStyle)
   {
     case lsNone: lines->clear(); break;
-    case lsLine: *lines = dataToLines(lineData); break;
-    case lsStepLeft: *lines = dataToStepLeftLines(lineData); break;
-    case lsStepRight: *lines = dataToStepRightLines(lineData); break;
-    case lsStepCenter: *lines = dataToStepCenterLines(lineData); break;
-    case lsImpulse: *lines = dataToImpulseLines(lineData); break;
+    case lsLine: dataToLines(*lineData, lines); break;
+    case lsStepLeft: dataToStepLeftLines(*lineData, lines); break;
+    case lsStepRight: dataToStepRightLines(*lineData, lines); break;
+    case lsStepCenter: dataToStepCenterLines(*lineData, lines); break;
+    case lsImpulse: dataToImpulseLines(*lineData, lines); break;
   }
 }
 
@@ -21301,31 +23259,33 @@ void QCPGraph::getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataR
     return;
   }
   
-  QVector<QCPGraphData> data;
-  getOptimizedScatterData(&data, begin, end);
+  QCPScratchBuffer<QCPGraphData> data(mParentPlot ? mParentPlot->frameArena()->graphDataPool() : nullptr);
+  if (!(mParentPlot && mParentPlot->coarseRendering() && getCoarseData(data.data(), begin, end)))
+    getOptimizedScatterData(data.data(), begin, end);
   
   if (mKeyAxis->rangeReversed() != (mKeyAxis->orientation() == Qt::Vertical)) // make sure key pixels are sorted ascending in data (significantly simplifies following processing)
-    std::reverse(data.begin(), data.end());
+    std::reverse(data->begin(), data->end());
   
-  scatters->resize(data.size());
+  scatters->resize(data->size());
+  QPointF *result = scatters->data();
   if (keyAxis->orientation() == Qt::Vertical)
   {
-    for (int i=0; i<data.size(); ++i)
+    for (int i=0; i<data->size(); ++i)
     {
-      if (!qIsNaN(data.at(i).value))
+      if (!qIsNaN(data->at(i).value))
       {
-        (*scatters)[i].setX(valueAxis->coordToPixel(data.at(i).value));
-        (*scatters)[i].setY(keyAxis->coordToPixel(data.at(i).key));
+        result[i].setX(valueAxis->coordToPixel(data->at(i).value));
+        result[i].setY(keyAxis->coordToPixel(data->at(i).key));
       }
     }
   } else
   {
-    for (int i=0; i<data.size(); ++i)
+    for (int i=0; i<data->size(); ++i)
     {
-      if (!qIsNaN(data.at(i).value))
+      if (!qIsNaN(data->at(i).value))
       {
-        (*scatters)[i].setX(keyAxis->coordToPixel(data.at(i).key));
-        (*scatters)[i].setY(valueAxis->coordToPixel(data.at(i).value));
+        result[i].setX(keyAxis->coordToPixel(data->at(i).key));
+        result[i].setY(valueAxis->coordToPixel(data->at(i).value));
       }
     }
   }
@@ -21344,11 +23304,23 @@ void QCPGraph::getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataR
 QVector<QPointF> QCPGraph::dataToLines(const QVector<QCPGraphData> &data) const
 {
   QVector<QPointF> result;
+  dataToLines(data, &result);
+  return result;
+}
+
+/*! \internal \overload
+
+  Writes the pixel coordinate points to \a lines instead of returning a new vector, so the
+  storage of \a lines (e.g. a \ref QCPScratchBuffer) can be reused across replots.
+*/
+void QCPGraph::dataToLines(const QVector<QCPGraphData> &data, QVector<QPointF> *lines) const
+{
   QCPAxis *keyAxis = mKeyAxis.data();
   QCPAxis *valueAxis = mValueAxis.data();
-  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return result; }
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; lines->clear(); return; }
 
-  result.resize(data.size());
+  lines->resize(data.size());
+  QPointF *result = lines->data();
   
   // transform data points to pixels:
   if (keyAxis->orientation() == Qt::Vertical)
@@ -21366,7 +23338,6 @@ QVector<QPointF> QCPGraph::dataToLines(const QVector<QCPGraphData> &data) const
       result[i].setY(valueAxis->coordToPixel(data.at(i).value));
     }
   }
-  return result;
 }
 
 /*! \internal
@@ -21382,11 +23353,23 @@ QVector<QPointF> QCPGraph::dataToLines(const QVector<QCPGraphData> &data) const
 QVector<QPointF> QCPGraph::dataToStepLeftLines(const QVector<QCPGraphData> &data) const
 {
   QVector<QPointF> result;
+  dataToStepLeftLines(data, &result);
+  return result;
+}
+
+/*! \internal \overload
+
+  Writes the pixel coordinate points to \a lines instead of returning a new vector, so the
+  storage of \a lines (e.g. a \ref QCPScratchBuffer) can be reused across replots.
+*/
+void QCPGraph::dataToStepLeftLines(const QVector<QCPGraphData> &data, QVector<QPointF> *lines) const
+{
   QCPAxis *keyAxis = mKeyAxis.data();
   QCPAxis *valueAxis = mValueAxis.data();
-  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return result; }
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; lines->clear(); return; }
   
-  result.resize(data.size()*2);
+  lines->resize(data.size()*2);
+  QPointF *result = lines->data();
   
   // calculate steps from data and transform to pixel coordinates:
   if (keyAxis->orientation() == Qt::Vertical)
@@ -21414,7 +23397,6 @@ QVector<QPointF> QCPGraph::dataToStepLeftLines(const QVector<QCPGraphData> &data
       result[i*2+1].setY(lastValue);
     }
   }
-  return result;
 }
 
 /*! \internal
@@ -21430,11 +23412,23 @@ QVector<QPointF> QCPGraph::dataToStepLeftLines(const QVector<QCPGraphData> &data
 QVector<QPointF> QCPGraph::dataToStepRightLines(const QVector<QCPGraphData> &data) const
 {
   QVector<QPointF> result;
-  QCPAxis *keyAxis = mKeyAxis.data();
+  dataToStepRightLines(data, &result);
+  return result;
+}
+
+/*! \internal \overload
+
+  Writes the pixel coordinate points to \a lines instead of returning a new vector, so the
+  storage of \a lines (e.g. a \ref QCPScratchBuffer) can be reused across replots.
+*/
+void QCPGraph::dataToStepRightLines(const QVector<QCPGraphData> &data, QVector<QPointF> *lines) const
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
   QCPAxis *valueAxis = mValueAxis.data();
-  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return result; }
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; lines->clear(); return; }
   
-  result.resize(data.size()*2);
+  lines->resize(data.size()*2);
+  QPointF *result = lines->data();
   
   // calculate steps from data and transform to pixel coordinates:
   if (keyAxis->orientation() == Qt::Vertical)
@@ -21462,7 +23456,6 @@ QVector<QPointF> QCPGraph::dataToStepRightLines(const QVector<QCPGraphData> &dat
       result[i*2+1].setY(value);
     }
   }
-  return result;
 }
 
 /*! \internal
@@ -21478,11 +23471,23 @@ QVector<QPointF> QCPGraph::dataToStepRightLines(const QVector<QCPGraphData> &dat
 QVector<QPointF> QCPGraph::dataToStepCenterLines(const QVector<QCPGraphData> &data) const
 {
   QVector<QPointF> result;
+  dataToStepCenterLines(data, &result);
+  return result;
+}
+
+/*! \internal \overload
+
+  Writes the pixel coordinate points to \a lines instead of returning a new vector, so the
+  storage of \a lines (e.g. a \ref QCPScratchBuffer) can be reused across replots.
+*/
+void QCPGraph::dataToStepCenterLines(const QVector<QCPGraphData> &data, QVector<QPointF> *lines) const
+{
   QCPAxis *keyAxis = mKeyAxis.data();
   QCPAxis *valueAxis = mValueAxis.data();
-  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return result; }
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; lines->clear(); return; }
   
-  result.resize(data.size()*2);
+  lines->resize(data.size()*2);
+  QPointF *result = lines->data();
   
   // calculate steps from data and transform to pixel coordinates:
   if (keyAxis->orientation() == Qt::Vertical)
@@ -21522,7 +23527,6 @@ QVector<QPointF> QCPGraph::dataToStepCenterLines(const QVector<QCPGraphData> &da
     result[data.size()*2-1].setX(lastKey);
     result[data.size()*2-1].setY(lastValue);
   }
-  return result;
 }
 
 /*! \internal
@@ -21538,11 +23542,23 @@ QVector<QPointF> QCPGraph::dataToStepCenterLines(const QVector<QCPGraphData> &da
 QVector<QPointF> QCPGraph::dataToImpulseLines(const QVector<QCPGraphData> &data) const
 {
   QVector<QPointF> result;
+  dataToImpulseLines(data, &result);
+  return result;
+}
+
+/*! \internal \overload
+
+  Writes the pixel coordinate points to \a lines instead of returning a new vector, so the
+  storage of \a lines (e.g. a \ref QCPScratchBuffer) can be reused across replots.
+*/
+void QCPGraph::dataToImpulseLines(const QVector<QCPGraphData> &data, QVector<QPointF> *lines) const
+{
   QCPAxis *keyAxis = mKeyAxis.data();
   QCPAxis *valueAxis = mValueAxis.data();
-  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return result; }
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; lines->clear(); return; }
   
-  result.resize(data.size()*2);
+  lines->resize(data.size()*2);
+  QPointF *result = lines->data();
   
   // transform data points to pixels:
   if (keyAxis->orientation() == Qt::Vertical)
@@ -21582,21 +23598,23 @@ QVector<QPointF> QCPGraph::dataToImpulseLines(const QVector<QCPGraphData> &data)
       }
     }
   }
-  return result;
 }
 
 /*! \internal
   
   Draws the fill of the graph using the specified \a painter, with the currently set brush.
   
-  Depending on whether a normal fill or a channel fill (\ref setChannelFillGraph) is needed, \ref
-  getFillPolygon or \ref getChannelFillPolygon are used to find the according fill polygons.
+  The fill is built in a single streaming pass over the (adaptively sampled) pixel points of \a
+  lines: Each non-NaN run of points is found with \ref getNextNonNanSegment and immediately turned
+  into a fill polygon, so no intermediate segment lists are created. In the channel fill case (\ref
+  setChannelFillGraph), the non-NaN runs of both graphs are walked in parallel, and for every pair
+  that overlaps in key coordinates the polygon is assembled directly from the two point runs via
+  \ref appendChannelFillSegment.
   
-  In order to handle NaN Data points correctly (the fill needs to be split into disjoint areas),
-  this method first determines a list of non-NaN segments with \ref getNonNanSegments, on which to
-  operate. In the channel fill case, \ref getOverlappingSegments is used to consolidate the non-NaN
-  segments of the two involved graphs, before passing the overlapping pairs to \ref
-  getChannelFillPolygon.
+  The polygon storage (and the line points of the channel fill target graph) are kept in members
+  of this graph and reused across segments and replots, so steady-state replots don't allocate for
+  the fill. The lines of the target graph are only fetched once per \ref draw call, even if this
+  graph is split into multiple selection segments.
   
   Pass the points of this graph's line as \a lines, in pixel coordinates.
 
@@ -21606,25 +23624,86 @@ void QCPGraph::drawFill(QCPPainter *painter, QVector<QPointF> *lines) const
 {
   if (mLineStyle == lsImpulse) return; // fill doesn't make sense for impulse plot
   if (painter->brush().style() == Qt::NoBrush || painter->brush().color().alpha() == 0) return;
+  if (!lines || lines->size() < 2) return;
   
   applyFillAntialiasingHint(painter);
-  const QVector<QCPDataRange> segments = getNonNanSegments(lines, keyAxis()->orientation());
+  const Qt::Orientation keyOrientation = keyAxis()->orientation();
   if (!mChannelFillGraph)
   {
     // draw base fill under graph, fill goes all the way to the zero-value-line:
-    foreach (QCPDataRange segment, segments)
-      painter->drawPolygon(getFillPolygon(lines, segment));
+    int index = 0;
+    QCPDataRange segment;
+    while (getNextNonNanSegment(lines, keyOrientation, index, segment))
+    {
+      if (segment.size() < 2)
+        continue;
+      mFillPolygon.clear(); // keeps capacity, so polygon storage is reused
+      appendFillPolygon(&mFillPolygon, lines, segment);
+      painter->drawPolygon(mFillPolygon);
+    }
   } else
   {
     // draw fill between this graph and mChannelFillGraph:
-    QVector<QPointF> otherLines;
-    mChannelFillGraph->getLines(&otherLines, QCPDataRange(0, mChannelFillGraph->dataCount()));
-    if (!otherLines.isEmpty())
+    if (!mChannelFillGraph.data()->mKeyAxis) { qDebug() << Q_FUNC_INFO << "channel fill target key axis invalid"; return; }
+    if (mChannelFillGraph.data()->mKeyAxis.data()->orientation() != keyOrientation)
+      return; // don't have same axis orientation, can't fill that (Note: if keyAxis fits, valueAxis will fit too, because it's always orthogonal to keyAxis)
+    if (!mChannelFillLinesValid)
     {
-      QVector<QCPDataRange> otherSegments = getNonNanSegments(&otherLines, mChannelFillGraph->keyAxis()->orientation());
-      QVector<QPair<QCPDataRange, QCPDataRange> > segmentPairs = getOverlappingSegments(segments, lines, otherSegments, &otherLines);
-      for (int i=0; i<segmentPairs.size(); ++i)
-        painter->drawPolygon(getChannelFillPolygon(lines, segmentPairs.at(i).first, &otherLines, segmentPairs.at(i).second));
+      mChannelFillGraph->getLines(&mChannelFillLines, QCPDataRange(0, mChannelFillGraph->dataCount()));
+      mChannelFillLinesValid = true;
+    }
+    const QVector<QPointF> *otherLines = &mChannelFillLines;
+    if (otherLines->size() < 2)
+      return;
+    
+    // walk the non-NaN segments of both graphs in parallel (both are sorted ascending by key pixel):
+    const bool verticalKey = keyOrientation == Qt::Vertical;
+    int thisIndex = 0, otherIndex = 0;
+    QCPDataRange thisSegment, otherSegment;
+    bool haveThis = getNextNonNanSegment(lines, keyOrientation, thisIndex, thisSegment);
+    bool haveOther = getNextNonNanSegment(otherLines, keyOrientation, otherIndex, otherSegment);
+    while (haveThis && haveOther)
+    {
+      if (thisSegment.size() < 2) // segments with fewer than two points won't have a fill anyhow
+      {
+        haveThis = getNextNonNanSegment(lines, keyOrientation, thisIndex, thisSegment);
+        continue;
+      }
+      if (otherSegment.size() < 2)
+      {
+        haveOther = getNextNonNanSegment(otherLines, keyOrientation, otherIndex, otherSegment);
+        continue;
+      }
+      const QPointF &thisFirst = lines->at(thisSegment.begin());
+      const QPointF &thisLast = lines->at(thisSegment.end()-1);
+      const QPointF &otherFirst = otherLines->at(otherSegment.begin());
+      const QPointF &otherLast = otherLines->at(otherSegment.end()-1);
+      const double thisLower = verticalKey ? thisFirst.y() : thisFirst.x();
+      const double thisUpper = verticalKey ? thisLast.y() : thisLast.x();
+      const double otherLower = verticalKey ? otherFirst.y() : otherFirst.x();
+      const double otherUpper = verticalKey ? otherLast.y() : otherLast.x();
+      
+      int bPrecedence;
+      if (segmentsIntersect(thisLower, thisUpper, otherLower, otherUpper, bPrecedence))
+      {
+        const double lowerKey = qMax(thisLower, otherLower);
+        const double upperKey = qMin(thisUpper, otherUpper);
+        mFillPolygon.clear();
+        if (appendChannelFillSegment(&mFillPolygon, lines, thisSegment, lowerKey, upperKey))
+        {
+          const int otherStart = mFillPolygon.size();
+          if (appendChannelFillSegment(&mFillPolygon, otherLines, otherSegment, lowerKey, upperKey))
+          {
+            std::reverse(mFillPolygon.begin()+otherStart, mFillPolygon.end()); // other graph runs backwards, otherwise the polygon will be twisted
+            painter->drawPolygon(mFillPolygon);
+          }
+        }
+      }
+      
+      if (bPrecedence <= 0) // otherSegment doesn't reach as far as thisSegment, so continue with next otherSegment, keeping current thisSegment
+        haveOther = getNextNonNanSegment(otherLines, keyOrientation, otherIndex, otherSegment);
+      else // otherSegment reaches further than thisSegment, so continue with next thisSegment, keeping current otherSegment
+        haveThis = getNextNonNanSegment(lines, keyOrientation, thisIndex, thisSegment);
     }
   }
 }
@@ -21773,6 +23852,40 @@ void QCPGraph::getOptimizedLineData(QVector<QCPGraphData> *lineData, const QCPGr
   }
 }
 
+/*! \internal
+
+  Used instead of \ref getOptimizedLineData and \ref getOptimizedScatterData while the parent plot
+  renders coarsely during an interaction (see \ref QCP::phProgressiveRendering).
+
+  Picks every n-th data point in the range [\a begin, \a end), with n chosen such that at most two
+  points per pixel along the key axis remain, plus the last point. Unlike adaptive sampling, the
+  skipped points are never touched, so the cost only depends on the pixel size of the plot and not
+  on the number of data points. The result is stored in \a data.
+
+  Returns false and leaves \a data untouched if the range has few enough points that no decimation
+  is necessary.
+*/
+bool QCPGraph::getCoarseData(QVector<QCPGraphData> *data, QCPGraphDataContainer::const_iterator begin, QCPGraphDataContainer::const_iterator end) const
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  if (!data || !keyAxis || begin == end) return false;
+  
+  const int dataCount = int(end-begin);
+  const double keyPixelSpan = qAbs(keyAxis->coordToPixel(begin->key)-keyAxis->coordToPixel((end-1)->key));
+  const int maxCount = int(qMin(2*keyPixelSpan+2, double(dataCount)));
+  if (maxCount < 1 || dataCount <= maxCount)
+    return false;
+  
+  const int stride = (dataCount+maxCount-1)/maxCount;
+  data->clear();
+  data->reserve(dataCount/stride+2);
+  for (int i=0; i<dataCount; i+=stride)
+    data->append(*(begin+i));
+  if ((dataCount-1)%stride != 0)
+    data->append(*(end-1));
+  return true;
+}
+
 /*! \internal
 
   Returns via \a scatterData the data points that need to be visualized for this graph when
@@ -21985,6 +24098,61 @@ void QCPGraph::getVisibleDataBounds(QCPGraphDataContainer::const_iterator &begin
   }
 }
 
+/*! \internal
+  
+  Fills the data container with the part of the history (\ref setHistory) needed to draw the
+  current key range. Blocks intersecting the visible key range, and one block on either side so
+  the line continues to the border of the axis rect, are decoded. Blocks narrower than a pixel are
+  represented by the first, last, minimum and maximum data point stored in their block header,
+  which is what adaptive sampling would reduce them to anyway.
+  
+  The view is only rebuilt if the key range, the pixel extent of the key axis or the history has
+  changed since the last call.
+*/
+void QCPGraph::updateHistoryView()
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  if (!keyAxis || !mHistory) return;
+  const QCPRange range = keyAxis->range();
+  const double pixels = qAbs(keyAxis->coordToPixel(range.upper)-keyAxis->coordToPixel(range.lower));
+  if (mHistoryViewValid && mHistoryViewRevision == mHistory->revision() && mHistoryViewRange == range && mHistoryViewPixels == pixels)
+    return;
+  
+  QVector<QCPGraphData> data;
+  const int blockCount = mHistory->blockCount();
+  for (int i=qMax(0, mHistory->findBlock(range.lower)-1); i<blockCount; ++i)
+  {
+    const QCPGraphHistory::BlockHeader header = mHistory->blockHeader(i);
+    const double blockPixels = qAbs(keyAxis->coordToPixel(header.keyUpper)-keyAxis->coordToPixel(header.keyLower));
+    if (blockPixels < 1.0 && header.count > 4)
+    {
+      data.append(QCPGraphData(header.keyLower, header.firstValue));
+      if (!qIsNaN(header.minValue))
+      {
+        if (header.minKey <= header.maxKey)
+        {
+          data.append(QCPGraphData(header.minKey, header.minValue));
+          data.append(QCPGraphData(header.maxKey, header.maxValue));
+        } else
+        {
+          data.append(QCPGraphData(header.maxKey, header.maxValue));
+          data.append(QCPGraphData(header.minKey, header.minValue));
+        }
+      }
+      data.append(QCPGraphData(header.keyUpper, header.lastValue));
+    } else
+      mHistory->decodeBlock(i, &data);
+    if (header.keyLower > range.upper)
+      break; // this was the first block beyond the visible range
+  }
+  mDataContainer->set(data, true);
+  
+  mHistoryViewValid = true;
+  mHistoryViewRevision = mHistory->revision();
+  mHistoryViewRange = range;
+  mHistoryViewPixels = pixels;
+}
+
 /*!  \internal
   
   This method goes through the passed points in \a lineData and returns a list of the segments
@@ -22339,6 +24507,109 @@ const QPolygonF QCPGraph::getChannelFillPolygon(const QVector<QPointF> *thisData
   return QPolygonF(thisSegmentData);
 }
 
+/*! \internal
+  
+  Streaming counterpart of \ref getNonNanSegments: Starting at \a index, finds the next run of
+  points in \a lineData which doesn't contain NaN values and returns it in \a segment. \a index is
+  advanced past the found segment, so repeated calls iterate over all non-NaN segments without
+  building a segment list.
+  
+  \a keyOrientation defines whether the \a x or \a y member of the passed QPointF is used to check
+  for NaN, like in \ref getNonNanSegments.
+  
+  Returns false if there are no further non-NaN segments.
+  
+  \see drawFill
+*/
+bool QCPGraph::getNextNonNanSegment(const QVector<QPointF> *lineData, Qt::Orientation keyOrientation, int &index, QCPDataRange &segment) const
+{
+  const int n = lineData->size();
+  const bool checkY = keyOrientation == Qt::Horizontal;
+  while (index < n && qIsNaN(checkY ? lineData->at(index).y() : lineData->at(index).x())) // seek next non-NaN data point
+    ++index;
+  if (index >= n)
+    return false;
+  segment.setBegin(index++);
+  while (index < n && !qIsNaN(checkY ? lineData->at(index).y() : lineData->at(index).x())) // seek next NaN data point or end of data
+    ++index;
+  segment.setEnd(index++);
+  return true;
+}
+
+/*! \internal
+  
+  Appends the polygon needed for drawing a normal fill of \a segment between this graph and the
+  key axis to \a polygon. This is the allocation-free counterpart of \ref getFillPolygon, meant to
+  be used with a reused polygon buffer.
+  
+  \see drawFill, getFillBasePoint
+*/
+void QCPGraph::appendFillPolygon(QPolygonF *polygon, const QVector<QPointF> *lineData, QCPDataRange segment) const
+{
+  if (segment.size() < 2)
+    return;
+  polygon->reserve(polygon->size()+segment.size()+2);
+  polygon->append(getFillBasePoint(lineData->at(segment.begin())));
+  for (int i=segment.begin(); i<segment.end(); ++i)
+    polygon->append(lineData->at(i));
+  polygon->append(getFillBasePoint(lineData->at(segment.end()-1)));
+}
+
+/*! \internal
+  
+  Appends the points of \a segment of \a lineData (pixel coordinates, sorted ascending by key
+  pixel) to \a polygon, cropped to the key pixel interval from \a lowerKey to \a upperKey. The
+  first and last appended points are linearly interpolated to lie exactly on \a lowerKey and \a
+  upperKey, respectively, like the cropping in \ref getChannelFillPolygon. The crop boundaries are
+  found with binary searches instead of linear scans.
+  
+  Returns false if the segment doesn't provide enough points for the interpolation, in which case
+  no channel fill polygon can be formed.
+  
+  \see drawFill
+*/
+bool QCPGraph::appendChannelFillSegment(QPolygonF *polygon, const QVector<QPointF> *lineData, QCPDataRange segment, double lowerKey, double upperKey) const
+{
+  if (segment.size() < 2)
+    return false;
+  const bool verticalKey = mKeyAxis->orientation() == Qt::Vertical;
+  QVector<QPointF>::const_iterator begin = lineData->constBegin()+segment.begin();
+  QVector<QPointF>::const_iterator end = lineData->constBegin()+segment.end();
+  
+  // first point with key above lowerKey, and first point with key not below upperKey:
+  QVector<QPointF>::const_iterator lowIt, highIt;
+  if (verticalKey)
+  {
+    lowIt = std::upper_bound(begin, end, lowerKey, [](double key, const QPointF &p) { return key < p.y(); });
+    highIt = std::lower_bound(lowIt, end, upperKey, [](const QPointF &p, double key) { return p.y() < key; });
+  } else
+  {
+    lowIt = std::upper_bound(begin, end, lowerKey, [](double key, const QPointF &p) { return key < p.x(); });
+    highIt = std::lower_bound(lowIt, end, upperKey, [](const QPointF &p, double key) { return p.x() < key; });
+  }
+  if (lowIt == begin || highIt == end)
+    return false; // key range of segment doesn't enclose requested interval
+  
+  // interpolates the point between a and b at the given key pixel (slope 0 for equal keys, e.g. in step plots):
+  auto interpolate = [verticalKey](const QPointF &a, const QPointF &b, double key) -> QPointF
+  {
+    const double aKey = verticalKey ? a.y() : a.x();
+    const double bKey = verticalKey ? b.y() : b.x();
+    const double aValue = verticalKey ? a.x() : a.y();
+    const double bValue = verticalKey ? b.x() : b.y();
+    const double slope = qFuzzyCompare(aKey, bKey) ? 0 : (bValue-aValue)/(bKey-aKey);
+    const double value = aValue+slope*(key-aKey);
+    return verticalKey ? QPointF(value, key) : QPointF(key, value);
+  };
+  
+  polygon->reserve(polygon->size()+int(highIt-lowIt)+2);
+  polygon->append(interpolate(*(lowIt-1), *lowIt, lowerKey));
+  for (QVector<QPointF>::const_iterator it=lowIt; it!=highIt; ++it)
+    polygon->append(*it);
+  polygon->append(interpolate(*(highIt-1), *highIt, upperKey));
+  return true;
+}
+
 /*! \internal
   
   Finds the smallest index of \a data, whose points x value is just above \a x. Assumes x values in
@@ -22452,13 +24723,13 @@ double QCPGraph::pointDistance(const QPointF &pixelPoint, QCPGraphDataContainer:
   if (mLineStyle != lsNone)
   {
     // line displayed, calculate distance to line segments:
-    QVector<QPointF> lineData;
-    getLines(&lineData, QCPDataRange(0, dataCount())); // don't limit data range further since with sharp data spikes, line segments may be closer to test point than segments with closer key coordinate
+    QCPScratchBuffer<QPointF> lineData(mParentPlot ? mParentPlot->frameArena()->pointPool() : nullptr);
+    getLines(lineData.data(), QCPDataRange(0, dataCount())); // don't limit data range further since with sharp data spikes, line segments may be closer to test point than segments with closer key coordinate
     QCPVector2D p(pixelPoint);
     const int step = mLineStyle==lsImpulse ? 2 : 1; // impulse plot differs from other line styles in that the lineData points are only pairwise connected
-    for (int i=0; i<lineData.size()-1; i+=step)
+    for (int i=0; i<lineData->size()-1; i+=step)
     {
-      const double currentDistSqr = p.distanceSquaredToLine(lineData.at(i), lineData.at(i+1));
+      const double currentDistSqr = p.distanceSquaredToLine(lineData->at(i), lineData->at(i+1));
       if (currentDistSqr < minDistSqr)
         minDistSqr = currentDistSqr;
     }
@@ -22907,8 +25178,9 @@ void QCPCurve::draw(QCPPainter *painter)
 {
   if (mDataContainer->isEmpty()) return;
   
-  // allocate line vector:
-  QVector<QPointF> lines, scatters;
+  // borrow line and scatter vectors from the frame arena, so their storage is reused across replots:
+  QCPScratchPool<QPointF> *pointPool = mParentPlot ? mParentPlot->frameArena()->pointPool() : nullptr;
+  QCPScratchBuffer<QPointF> lines(pointPool), scatters(pointPool);
   
   // loop over and draw segments of unselected/selected data:
   QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
@@ -22924,7 +25196,10 @@ void QCPCurve::draw(QCPPainter *painter)
       finalCurvePen = mSelectionDecorator->pen();
     
     QCPDataRange lineDataRange = isSelectedSegment ? allSegments.at(i) : allSegments.at(i).adjusted(-1, 1); // unselected segments extend lines to bordering selected data point (safe to exceed total data bounds in first/last segment, getCurveLines takes care)
-    getCurveLines(&lines, lineDataRange, finalCurvePen.widthF());
+    {
+      QCPProfilerScope dataScope(mParentPlot, QCPProfiler::phDataPreparation, mName);
+      getCurveLines(lines.data(), lineDataRange, finalCurvePen.widthF());
+    }
     
     // check data validity if flag set:
   #ifdef QCUSTOMPLOT_CHECK_DATA
@@ -22944,14 +25219,14 @@ void QCPCurve::draw(QCPPainter *painter)
       painter->setBrush(mBrush);
     painter->setPen(Qt::NoPen);
     if (painter->brush().style() != Qt::NoBrush && painter->brush().color().alpha() != 0)
-      painter->drawPolygon(QPolygonF(lines));
+      painter->drawPolygon(lines->constData(), lines->size());
     
     // draw curve line:
     if (mLineStyle != lsNone)
     {
       painter->setPen(finalCurvePen);
       painter->setBrush(Qt::NoBrush);
-      drawCurveLine(painter, lines);
+      drawCurveLine(painter, *lines);
     }
     
     // draw scatters:
@@ -22960,8 +25235,11 @@ void QCPCurve::draw(QCPPainter *painter)
       finalScatterStyle = mSelectionDecorator->getFinalScatterStyle(mScatterStyle);
     if (!finalScatterStyle.isNone())
     {
-      getScatters(&scatters, allSegments.at(i), finalScatterStyle.size());
-      drawScatterPlot(painter, scatters, finalScatterStyle);
+      {
+        QCPProfilerScope dataScope(mParentPlot, QCPProfiler::phDataPreparation, mName);
+        getScatters(scatters.data(), allSegments.at(i), finalScatterStyle.size());
+      }
+      drawScatterPlot(painter, *scatters, finalScatterStyle);
     }
   }
   
@@ -24878,7 +27156,9 @@ void QCPBars::draw(QCPPainter *painter)
         painter->setPen(mPen);
       }
       applyDefaultAntialiasingHint(painter);
-      painter->drawPolygon(getBarRect(it->key, it->value));
+      const QRectF barRect = getBarRect(it->key, it->value);
+      const QPointF barPolygon[5] = {barRect.topLeft(), barRect.topRight(), barRect.bottomRight(), barRect.bottomLeft(), barRect.topLeft()}; // same points as QPolygonF(barRect), without allocating a polygon per bar
+      painter->drawPolygon(barPolygon, 5);
     }
   }
   
@@ -25334,6 +27614,10 @@ QCPStatisticalBox::QCPStatisticalBox(QCPAxis *keyAxis, QCPAxis *valueAxis) :
   mMedianPen(Qt::black, 3, Qt::SolidLine, Qt::FlatCap),
   mOutlierStyle(QCPScatterStyle::ssCircle, Qt::blue, 6)
 {
+  mOutlierSprite.shape = QCPScatterStyle::ssNone;
+  mOutlierSprite.size = 0;
+  mOutlierSprite.antialiased = false;
+  mOutlierSprite.devicePixelRatio = 1;
   setPen(QPen(Qt::black));
   setBrush(Qt::NoBrush);
 }
@@ -25707,10 +27991,101 @@ void QCPStatisticalBox::drawStatisticalBox(QCPPainter *painter, QCPStatisticalBo
   painter->setPen(mWhiskerBarPen);
   painter->drawLines(getWhiskerBarLines(it));
   // draw outliers:
+  drawOutliers(painter, it, outlierStyle);
+}
+
+/*! \internal
+
+  Draws the outliers of the statistical box given by \a it with \a outlierStyle. Called by \ref
+  drawStatisticalBox.
+
+  Outliers outside the clip rect are skipped, as are outliers that land on the same pixel as the
+  previously drawn one. When painting to a pixel buffer, the outlier shape is rendered once into a
+  sprite pixmap (see \ref updateOutlierSprite) which is then blitted for every outlier, instead of
+  rasterizing the scatter shape again for each of them.
+*/
+void QCPStatisticalBox::drawOutliers(QCPPainter *painter, QCPStatisticalBoxDataContainer::const_iterator it, const QCPScatterStyle &outlierStyle) const
+{
+  if (it->outliers.isEmpty() || outlierStyle.isNone())
+    return;
   applyScattersAntialiasingHint(painter);
   outlierStyle.applyTo(painter, mPen);
+  const bool useSprite = updateOutlierSprite(painter, outlierStyle);
+  const double margin = outlierStyle.size()*0.5+painter->pen().widthF()+1;
+  const QRectF visibleRect = QRectF(clipRect()).adjusted(-margin, -margin, margin, margin);
+  QPoint lastPixel(-1, -1);
+  bool havePixel = false;
   for (int i=0; i<it->outliers.size(); ++i)
-    outlierStyle.drawShape(painter, coordsToPixels(it->key, it->outliers.at(i)));
+  {
+    const QPointF outlierPixel = coordsToPixels(it->key, it->outliers.at(i));
+    if (!visibleRect.contains(outlierPixel))
+      continue;
+    const QPoint roundedPixel = outlierPixel.toPoint();
+    if (havePixel && roundedPixel == lastPixel)
+      continue;
+    lastPixel = roundedPixel;
+    havePixel = true;
+    if (useSprite)
+      painter->drawPixmap(outlierPixel-mOutlierSprite.offset, mOutlierSprite.pixmap);
+    else
+      outlierStyle.drawShape(painter, outlierPixel);
+  }
+}
+
+/*! \internal
+
+  Makes sure the outlier sprite pixmap matches \a outlierStyle and the pen, brush and antialiasing
+  state currently set on \a painter, re-rendering it if necessary.
+
+  Returns false if outliers can't be drawn as sprites and should be drawn with \ref
+  QCPScatterStyle::drawShape instead. This is the case for vectorized and uncached (export)
+  painting, as well as for pixmap and custom scatter shapes.
+
+  \see drawOutliers
+*/
+bool QCPStatisticalBox::updateOutlierSprite(QCPPainter *painter, const QCPScatterStyle &outlierStyle) const
+{
+  if (painter->modes().testFlag(QCPPainter::pmVectorized) || painter->modes().testFlag(QCPPainter::pmNoCaching))
+    return false;
+  if (outlierStyle.shape() == QCPScatterStyle::ssPixmap || outlierStyle.shape() == QCPScatterStyle::ssCustom)
+    return false;
+  
+  const double devicePixelRatio = mParentPlot ? mParentPlot->bufferDevicePixelRatio() : 1.0;
+  if (!mOutlierSprite.pixmap.isNull() &&
+      mOutlierSprite.shape == outlierStyle.shape() &&
+      qFuzzyCompare(mOutlierSprite.size, outlierStyle.size()) &&
+      mOutlierSprite.pen == painter->pen() &&
+      mOutlierSprite.brush == painter->brush() &&
+      mOutlierSprite.antialiased == painter->antialiasing() &&
+      qFuzzyCompare(mOutlierSprite.devicePixelRatio, devicePixelRatio))
+    return true;
+  
+  // render the shape centered in a pixmap large enough to hold it including the pen width:
+  const int extent = qCeil(outlierStyle.size()+painter->pen().widthF())+2;
+  if (!qFuzzyCompare(1.0, devicePixelRatio))
+  {
+    mOutlierSprite.pixmap = QPixmap(QSize(extent, extent)*devicePixelRatio);
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+    mOutlierSprite.pixmap.setDevicePixelRatio(devicePixelRatio);
+#endif
+  } else
+    mOutlierSprite.pixmap = QPixmap(extent, extent);
+  mOutlierSprite.pixmap.fill(Qt::transparent);
+  mOutlierSprite.offset = QPointF(extent*0.5, extent*0.5);
+  QCPPainter spritePainter(&mOutlierSprite.pixmap);
+  spritePainter.setAntialiasing(painter->antialiasing());
+  spritePainter.setPen(painter->pen());
+  spritePainter.setBrush(painter->brush());
+  outlierStyle.drawShape(&spritePainter, mOutlierSprite.offset);
+  spritePainter.end();
+  
+  mOutlierSprite.shape = outlierStyle.shape();
+  mOutlierSprite.size = outlierStyle.size();
+  mOutlierSprite.pen = painter->pen();
+  mOutlierSprite.brush = painter->brush();
+  mOutlierSprite.antialiased = painter->antialiasing();
+  mOutlierSprite.devicePixelRatio = devicePixelRatio;
+  return true;
 }
 
 /*!  \internal
@@ -26919,912 +29294,2965 @@ void QCPColorMap::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
 /* end of 'src/plottables/plottable-colormap.cpp' */
 
 
-/* including file 'src/plottables/plottable-financial.cpp' */
-/* modified 2022-11-06T12:45:57, size 42914                */
+/* including file 'src/plottables/plottable-tiledcolormap.cpp' */
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-//////////////////// QCPFinancialData
+//////////////////// QCPColorMapTileStore
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-/*! \class QCPFinancialData
-  \brief Holds the data of one single data point for QCPFinancial.
+/*! \class QCPColorMapTileStore
+  \brief File backed, multi-resolution storage of two-dimensional data for QCPTiledColorMap
   
-  The stored data is:
-  \li \a key: coordinate on the key axis of this data point (this is the \a mainKey and the \a sortKey)
-  \li \a open: The opening value at the data point (this is the \a mainValue)
-  \li \a high: The high/maximum value at the data point
-  \li \a low: The low/minimum value at the data point
-  \li \a close: The closing value at the data point
+  QCPColorMapData keeps the entire grid in memory, which becomes impractical for grids with
+  billions of cells. QCPColorMapTileStore keeps the grid in a file that is memory-mapped, so only
+  the parts that are actually accessed occupy physical memory.
   
-  The container for storing multiple data points is \ref QCPFinancialDataContainer. It is a typedef
-  for \ref QCPDataContainer with \ref QCPFinancialData as the DataType template parameter. See the
-  documentation there for an explanation regarding the data type's generic methods.
+  The grid is split into square tiles of \ref tileSize x \ref tileSize cells. Besides the full
+  resolution (level 0), the file contains a pyramid of downsampled levels, each with half the
+  resolution of the previous one in both dimensions, down to a level that fits into a single tile.
+  This allows QCPTiledColorMap to display any part of the grid at any zoom level by reading only
+  a few tiles.
   
-  \see QCPFinancialDataContainer
-*/
-
-/* start documentation of inline functions */
-
-/*! \fn double QCPFinancialData::sortKey() const
+  Like in QCPColorMapData, cells are centered on the coordinates: the first cell lies at the lower
+  bound of \ref keyRange and \ref valueRange, the last cell at the upper bound.
   
-  Returns the \a key member of this data point.
+  To create a store, call \ref create, fill the full resolution level with \ref setCell or \ref
+  setRow, and call \ref buildLevels to compute the downsampled levels and the data bounds. Since
+  rows can be written one at a time, the grid never has to be in memory as a whole. Existing files
+  are opened read-only with \ref open.
   
-  For a general explanation of what this method is good for in the context of the data container,
-  see the documentation of \ref QCPDataContainer.
+  Cells are stored as single precision floats in native byte order. Cells that were never written
+  are zero. The file is mapped as a whole, so very large grids require a 64 bit process.
 */
 
-/*! \fn static QCPFinancialData QCPFinancialData::fromSortKey(double sortKey)
-  
-  Returns a data point with the specified \a sortKey. All other members are set to zero.
-  
-  For a general explanation of what this method is good for in the context of the data container,
-  see the documentation of \ref QCPDataContainer.
-*/
+/* start of documentation of inline functions */
 
-/*! \fn static static bool QCPFinancialData::sortKeyIsMainKey()
-  
-  Since the member \a key is both the data point key coordinate and the data ordering parameter,
-  this method returns true.
+/*! \fn int QCPColorMapTileStore::levelKeySize(int level) const
   
-  For a general explanation of what this method is good for in the context of the data container,
-  see the documentation of \ref QCPDataContainer.
+  Returns the number of cells in key direction at the given resolution \a level.
 */
 
-/*! \fn double QCPFinancialData::mainKey() const
-  
-  Returns the \a key member of this data point.
+/*! \fn int QCPColorMapTileStore::keyTileCount(int level) const
   
-  For a general explanation of what this method is good for in the context of the data container,
-  see the documentation of \ref QCPDataContainer.
+  Returns the number of tiles in key direction at the given resolution \a level.
 */
 
-/*! \fn double QCPFinancialData::mainValue() const
-  
-  Returns the \a open member of this data point.
-  
-  For a general explanation of what this method is good for in the context of the data container,
-  see the documentation of \ref QCPDataContainer.
-*/
+/* end of documentation of inline functions */
 
-/*! \fn QCPRange QCPFinancialData::valueRange() const
-  
-  Returns a QCPRange spanning from the \a low to the \a high value of this data point.
-  
-  For a general explanation of what this method is good for in the context of the data container,
-  see the documentation of \ref QCPDataContainer.
+/*!
+  Creates a store that is not associated with a file yet. Call \ref create or \ref open.
 */
+QCPColorMapTileStore::QCPColorMapTileStore() :
+  mMap(nullptr),
+  mWritable(false)
+{
+  memset(&mHeader, 0, sizeof(mHeader));
+}
 
-/* end documentation of inline functions */
+QCPColorMapTileStore::~QCPColorMapTileStore()
+{
+  close();
+}
 
 /*!
-  Constructs a data point with key and all values set to zero.
+  Creates the file \a fileName (replacing an existing file) for a grid of \a keySize x \a valueSize
+  cells spanning \a keyRange and \a valueRange, split into tiles of \a tileSize x \a tileSize cells,
+  and maps it writable.
+  
+  Returns false if the sizes exceed the supported limits (2^30 cells per dimension) or the file
+  couldn't be created or mapped.
+  
+  \see setRow, buildLevels
 */
-QCPFinancialData::QCPFinancialData() :
-  key(0),
-  open(0),
-  high(0),
-  low(0),
-  close(0)
+bool QCPColorMapTileStore::create(const QString &fileName, int keySize, int valueSize, const QCPRange &keyRange, const QCPRange &valueRange, int tileSize)
 {
+  close();
+  if (!validSizes(keySize, valueSize, tileSize))
+  {
+    qDebug() << Q_FUNC_INFO << "Invalid grid or tile size:" << keySize << valueSize << tileSize;
+    return false;
+  }
+  memset(&mHeader, 0, sizeof(mHeader));
+  memcpy(mHeader.magic, "QCPT", 4);
+  mHeader.version = 1;
+  mHeader.keySize = keySize;
+  mHeader.valueSize = valueSize;
+  mHeader.tileSize = tileSize;
+  mHeader.levelCount = 1;
+  while (levelKeySize(mHeader.levelCount-1) > tileSize || levelValueSize(mHeader.levelCount-1) > tileSize)
+    ++mHeader.levelCount;
+  mHeader.keyLower = keyRange.lower;
+  mHeader.keyUpper = keyRange.upper;
+  mHeader.valueLower = valueRange.lower;
+  mHeader.valueUpper = valueRange.upper;
+  updateLevelOffsets();
+  
+  mFile.setFileName(fileName);
+  if (!mFile.open(QIODevice::ReadWrite | QIODevice::Truncate) || !mFile.resize(mLevelOffsets.last()))
+  {
+    qDebug() << Q_FUNC_INFO << "Couldn't create file" << fileName << mFile.errorString();
+    close();
+    return false;
+  }
+  mMap = mFile.map(0, mLevelOffsets.last());
+  if (!mMap)
+  {
+    qDebug() << Q_FUNC_INFO << "Couldn't map file" << fileName << mFile.errorString();
+    close();
+    return false;
+  }
+  mWritable = true;
+  memcpy(mMap, &mHeader, sizeof(mHeader));
+  return true;
 }
 
 /*!
-  Constructs a data point with the specified \a key and OHLC values.
+  Opens the existing store file \a fileName read-only. Returns false if the file couldn't be
+  opened, isn't a valid store file or couldn't be mapped.
 */
-QCPFinancialData::QCPFinancialData(double key, double open, double high, double low, double close) :
-  key(key),
-  open(open),
-  high(high),
-  low(low),
-  close(close)
+bool QCPColorMapTileStore::open(const QString &fileName)
 {
+  close();
+  mFile.setFileName(fileName);
+  if (!mFile.open(QIODevice::ReadOnly) || mFile.read(reinterpret_cast<char*>(&mHeader), sizeof(mHeader)) != qint64(sizeof(mHeader)))
+  {
+    qDebug() << Q_FUNC_INFO << "Couldn't read file" << fileName << mFile.errorString();
+    close();
+    return false;
+  }
+  if (memcmp(mHeader.magic, "QCPT", 4) != 0 || mHeader.version != 1 || !validSizes(mHeader.keySize, mHeader.valueSize, mHeader.tileSize) || mHeader.levelCount < 1 || mHeader.levelCount > 31)
+  {
+    qDebug() << Q_FUNC_INFO << "Not a valid tile store file:" << fileName;
+    close();
+    return false;
+  }
+  updateLevelOffsets();
+  if (mFile.size() < mLevelOffsets.last())
+  {
+    qDebug() << Q_FUNC_INFO << "Tile store file is truncated:" << fileName;
+    close();
+    return false;
+  }
+  mMap = mFile.map(0, mLevelOffsets.last());
+  if (!mMap)
+  {
+    qDebug() << Q_FUNC_INFO << "Couldn't map file" << fileName << mFile.errorString();
+    close();
+    return false;
+  }
+  return true;
 }
 
-
-////////////////////////////////////////////////////////////////////////////////////////////////////
-//////////////////// QCPFinancial
-////////////////////////////////////////////////////////////////////////////////////////////////////
-
-/*! \class QCPFinancial
-  \brief A plottable representing a financial stock chart
-
-  \image html QCPFinancial.png
-
-  This plottable represents time series data binned to certain intervals, mainly used for stock
-  charts. The two common representations OHLC (Open-High-Low-Close) bars and Candlesticks can be
-  set via \ref setChartStyle.
-
-  The data is passed via \ref setData as a set of open/high/low/close values at certain keys
-  (typically times). This means the data must be already binned appropriately. If data is only
-  available as a series of values (e.g. \a price against \a time), you can use the static
-  convenience function \ref timeSeriesToOhlc to generate binned OHLC-data which can then be passed
-  to \ref setData.
-
-  The width of the OHLC bars/candlesticks can be controlled with \ref setWidth and \ref
-  setWidthType. A typical choice is to set the width type to \ref wtPlotCoords (the default) and
-  the width to (or slightly less than) one time bin interval width.
-
-  \section qcpfinancial-appearance Changing the appearance
-
-  Charts can be either single- or two-colored (\ref setTwoColored). If set to be single-colored,
-  lines are drawn with the plottable's pen (\ref setPen) and fills with the brush (\ref setBrush).
-
-  If set to two-colored, positive changes of the value during an interval (\a close >= \a open) are
-  represented with a different pen and brush than negative changes (\a close < \a open). These can
-  be configured with \ref setPenPositive, \ref setPenNegative, \ref setBrushPositive, and \ref
-  setBrushNegative. In two-colored mode, the normal plottable pen/brush is ignored. Upon selection
-  however, the normal selected pen/brush (provided by the \ref selectionDecorator) is used,
-  irrespective of whether the chart is single- or two-colored.
-
-  \section qcpfinancial-usage Usage
-
-  Like all data representing objects in QCustomPlot, the QCPFinancial is a plottable
-  (QCPAbstractPlottable). So the plottable-interface of QCustomPlot applies
-  (QCustomPlot::plottable, QCustomPlot::removePlottable, etc.)
-
-  Usually, you first create an instance:
-
-  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpfinancial-creation-1
-  which registers it with the QCustomPlot instance of the passed axes. Note that this QCustomPlot
-  instance takes ownership of the plottable, so do not delete it manually but use
-  QCustomPlot::removePlottable() instead. The newly created plottable can be modified, e.g.:
-
-  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpfinancial-creation-2
-  Here we have used the static helper method \ref timeSeriesToOhlc, to turn a time-price data
-  series into a 24-hour binned open-high-low-close data series as QCPFinancial uses.
-*/
-
-/* start of documentation of inline functions */
-
-/*! \fn QCPFinancialDataContainer *QCPFinancial::data() const
-  
-  Returns a pointer to the internal data storage of type \ref QCPFinancialDataContainer. You may
-  use it to directly manipulate the data, which may be more convenient and faster than using the
-  regular \ref setData or \ref addData methods, in certain situations.
+/*!
+  Unmaps and closes the file. Plottables using this store must not draw while it is closed.
 */
-
-/* end of documentation of inline functions */
+void QCPColorMapTileStore::close()
+{
+  if (mMap)
+    mFile.unmap(mMap);
+  mMap = nullptr;
+  mWritable = false;
+  if (mFile.isOpen())
+    mFile.close();
+}
 
 /*!
-  Constructs a financial chart which uses \a keyAxis as its key axis ("x") and \a valueAxis as its value
-  axis ("y"). \a keyAxis and \a valueAxis must reside in the same QCustomPlot instance and not have
-  the same orientation. If either of these restrictions is violated, a corresponding message is
-  printed to the debug output (qDebug), the construction is not aborted, though.
-  
-  The created QCPFinancial is automatically registered with the QCustomPlot instance inferred from \a
-  keyAxis. This QCustomPlot instance takes ownership of the QCPFinancial, so do not delete it manually
-  but use QCustomPlot::removePlottable() instead.
+  Sets the full resolution cell at \a keyIndex and \a valueIndex to \a z. The store must have been
+  created with \ref create. Call \ref buildLevels after all cells are written.
 */
-QCPFinancial::QCPFinancial(QCPAxis *keyAxis, QCPAxis *valueAxis) :
-  QCPAbstractPlottable1D<QCPFinancialData>(keyAxis, valueAxis),
-  mChartStyle(csCandlestick),
-  mWidth(0.5),
-  mWidthType(wtPlotCoords),
-  mTwoColored(true),
-  mBrushPositive(QBrush(QColor(50, 160, 0))),
-  mBrushNegative(QBrush(QColor(180, 0, 15))),
-  mPenPositive(QPen(QColor(40, 150, 0))),
-  mPenNegative(QPen(QColor(170, 5, 5)))
+void QCPColorMapTileStore::setCell(int keyIndex, int valueIndex, double z)
 {
-  mSelectionDecorator->setBrush(QBrush(QColor(160, 160, 255)));
+  if (!mWritable)
+  {
+    qDebug() << Q_FUNC_INFO << "Store isn't writable";
+    return;
+  }
+  if (keyIndex < 0 || keyIndex >= mHeader.keySize || valueIndex < 0 || valueIndex >= mHeader.valueSize)
+  {
+    qDebug() << Q_FUNC_INFO << "Index out of bounds:" << keyIndex << valueIndex;
+    return;
+  }
+  *cell(0, keyIndex, valueIndex) = float(z);
 }
 
-QCPFinancial::~QCPFinancial()
+/*!
+  Sets the full resolution row at \a valueIndex to the \ref keySize values pointed to by \a z. The
+  store must have been created with \ref create. Call \ref buildLevels after all rows are written.
+*/
+void QCPColorMapTileStore::setRow(int valueIndex, const double *z)
 {
+  if (!mWritable)
+  {
+    qDebug() << Q_FUNC_INFO << "Store isn't writable";
+    return;
+  }
+  if (valueIndex < 0 || valueIndex >= mHeader.valueSize)
+  {
+    qDebug() << Q_FUNC_INFO << "Index out of bounds:" << valueIndex;
+    return;
+  }
+  const int tileSize = mHeader.tileSize;
+  for (int keyStart=0; keyStart<mHeader.keySize; keyStart+=tileSize)
+  {
+    float *target = cell(0, keyStart, valueIndex);
+    const int count = qMin(tileSize, mHeader.keySize-keyStart);
+    for (int i=0; i<count; ++i)
+      target[i] = float(z[keyStart+i]);
+  }
 }
 
-/*! \overload
-  
-  Replaces the current data container with the provided \a data container.
-  
-  Since a QSharedPointer is used, multiple QCPFinancials may share the same data container safely.
-  Modifying the data in the container will then affect all financials that share the container.
-  Sharing can be achieved by simply exchanging the data containers wrapped in shared pointers:
-  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpfinancial-datasharing-1
-  
-  If you do not wish to share containers, but create a copy from an existing container, rather use
-  the \ref QCPDataContainer<DataType>::set method on the financial's data container directly:
-  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpfinancial-datasharing-2
+/*!
+  Computes the data bounds and all downsampled levels from the full resolution level. Each cell of
+  a downsampled level is the average of the up to four corresponding cells of the next finer level,
+  ignoring NaN cells.
   
-  \see addData, timeSeriesToOhlc
+  Returns false if the store isn't writable.
 */
-void QCPFinancial::setData(QSharedPointer<QCPFinancialDataContainer> data)
+bool QCPColorMapTileStore::buildLevels()
 {
-  mDataContainer = data;
-}
-
-/*! \overload
+  if (!mWritable)
+  {
+    qDebug() << Q_FUNC_INFO << "Store isn't writable";
+    return false;
+  }
   
-  Replaces the current data with the provided points in \a keys, \a open, \a high, \a low and \a
-  close. The provided vectors should have equal length. Else, the number of added points will be
-  the size of the smallest vector.
+  // data bounds of the full resolution level:
+  bool haveBounds = false;
+  double lower = 0, upper = 0;
+  const int tileSize = mHeader.tileSize;
+  for (int valueIndex=0; valueIndex<mHeader.valueSize; ++valueIndex)
+  {
+    for (int keyStart=0; keyStart<mHeader.keySize; keyStart+=tileSize)
+    {
+      const float *source = cell(0, keyStart, valueIndex);
+      const int count = qMin(tileSize, mHeader.keySize-keyStart);
+      for (int i=0; i<count; ++i)
+      {
+        const double z = source[i];
+        if (qIsNaN(z))
+          continue;
+        if (!haveBounds)
+        {
+          lower = upper = z;
+          haveBounds = true;
+        } else if (z < lower)
+          lower = z;
+        else if (z > upper)
+          upper = z;
+      }
+    }
+  }
+  mHeader.dataLower = lower;
+  mHeader.dataUpper = upper;
   
-  If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
-  can set \a alreadySorted to true, to improve performance by saving a sorting run.
+  // downsampled levels:
+  for (int level=1; level<mHeader.levelCount; ++level)
+  {
+    const int sourceKeySize = levelKeySize(level-1);
+    const int sourceValueSize = levelValueSize(level-1);
+    for (int valueIndex=0; valueIndex<levelValueSize(level); ++valueIndex)
+    {
+      for (int keyIndex=0; keyIndex<levelKeySize(level); ++keyIndex)
+      {
+        double sum = 0;
+        int count = 0;
+        for (int dv=0; dv<2; ++dv)
+        {
+          const int sourceValue = valueIndex*2+dv;
+          if (sourceValue >= sourceValueSize)
+            break;
+          for (int dk=0; dk<2; ++dk)
+          {
+            const int sourceKey = keyIndex*2+dk;
+            if (sourceKey >= sourceKeySize)
+              break;
+            const float z = *cell(level-1, sourceKey, sourceValue);
+            if (!qIsNaN(z))
+            {
+              sum += z;
+              ++count;
+            }
+          }
+        }
+        *cell(level, keyIndex, valueIndex) = count > 0 ? float(sum/count) : std::numeric_limits<float>::quiet_NaN();
+      }
+    }
+  }
   
-  \see addData, timeSeriesToOhlc
-*/
-void QCPFinancial::setData(const QVector<double> &keys, const QVector<double> &open, const QVector<double> &high, const QVector<double> &low, const QVector<double> &close, bool alreadySorted)
-{
-  mDataContainer->clear();
-  addData(keys, open, high, low, close, alreadySorted);
+  memcpy(mMap, &mHeader, sizeof(mHeader));
+  return true;
 }
 
 /*!
-  Sets which representation style shall be used to display the OHLC data.
+  Returns a pointer to the cells of the tile at \a keyTile and \a valueTile of the given resolution
+  \a level, or \c nullptr if the store isn't open or the tile doesn't exist.
+  
+  The cells are stored row by row with increasing value index, each row holding \ref tileSize
+  cells with increasing key index. Tiles at the upper key and value border may only be partially
+  used, see \ref levelKeySize and \ref levelValueSize.
 */
-void QCPFinancial::setChartStyle(QCPFinancial::ChartStyle style)
+const float *QCPColorMapTileStore::tile(int level, int keyTile, int valueTile) const
 {
-  mChartStyle = style;
+  if (!mMap || level < 0 || level >= mHeader.levelCount || keyTile < 0 || keyTile >= keyTileCount(level) || valueTile < 0 || valueTile >= valueTileCount(level))
+    return nullptr;
+  const qint64 tileBytes = qint64(mHeader.tileSize)*qint64(mHeader.tileSize)*qint64(sizeof(float));
+  return reinterpret_cast<const float*>(mMap + mLevelOffsets.at(level) + (qint64(valueTile)*keyTileCount(level) + keyTile)*tileBytes);
 }
 
 /*!
-  Sets the width of the individual bars/candlesticks to \a width in plot key coordinates.
+  Returns an image of the used part of the tile at \a keyTile and \a valueTile of the given
+  resolution \a level, colorized with \a gradient for the data range \a dataRange. The first image
+  line holds the cells with the highest value index. If \a logarithmic is true, the data range is
+  mapped logarithmically.
   
-  A typical choice is to set it to (or slightly less than) one bin interval width.
+  This method only reads the store, so it may be called from multiple threads at once, as long as
+  the store isn't written or closed at the same time.
 */
-void QCPFinancial::setWidth(double width)
+QImage QCPColorMapTileStore::colorizeTile(int level, int keyTile, int valueTile, QCPColorGradient gradient, const QCPRange &dataRange, bool logarithmic) const
 {
-  mWidth = width;
+  const float *data = tile(level, keyTile, valueTile);
+  if (!data)
+    return QImage();
+  const int tileSize = mHeader.tileSize;
+  const int width = qMin(tileSize, levelKeySize(level)-keyTile*tileSize);
+  const int height = qMin(tileSize, levelValueSize(level)-valueTile*tileSize);
+  QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+  QVector<double> row(width);
+  for (int y=0; y<height; ++y)
+  {
+    const float *source = data + y*tileSize;
+    for (int x=0; x<width; ++x)
+      row[x] = source[x];
+    gradient.colorize(row.constData(), dataRange, reinterpret_cast<QRgb*>(image.scanLine(height-1-y)), width, 1, logarithmic);
+  }
+  return image;
 }
 
 /*!
-  Sets how the width of the financial bars is defined. See the documentation of \ref WidthType for
-  an explanation of the possible values for \a widthType.
-
-  The default value is \ref wtPlotCoords.
-
-  \see setWidth
+  Returns the distance between the centers of two neighbouring cells in key direction, in key
+  coordinates.
 */
-void QCPFinancial::setWidthType(QCPFinancial::WidthType widthType)
+double QCPColorMapTileStore::cellWidth() const
 {
-  mWidthType = widthType;
+  return mHeader.keySize > 1 ? (mHeader.keyUpper-mHeader.keyLower)/double(mHeader.keySize-1) : 1.0;
 }
 
 /*!
-  Sets whether this chart shall contrast positive from negative trends per data point by using two
-  separate colors to draw the respective bars/candlesticks.
-  
-  If \a twoColored is false, the normal plottable's pen and brush are used (\ref setPen, \ref
-  setBrush).
-  
-  \see setPenPositive, setPenNegative, setBrushPositive, setBrushNegative
+  Returns the distance between the centers of two neighbouring cells in value direction, in value
+  coordinates.
 */
-void QCPFinancial::setTwoColored(bool twoColored)
+double QCPColorMapTileStore::cellHeight() const
 {
-  mTwoColored = twoColored;
+  return mHeader.valueSize > 1 ? (mHeader.valueUpper-mHeader.valueLower)/double(mHeader.valueSize-1) : 1.0;
 }
 
-/*!
-  If \ref setTwoColored is set to true, this function controls the brush that is used to draw fills
-  of data points with a positive trend (i.e. bars/candlesticks with close >= open).
-  
-  If \a twoColored is false, the normal plottable's pen and brush are used (\ref setPen, \ref
-  setBrush).
+/*! \internal
   
-  \see setBrushNegative, setPenPositive, setPenNegative
+  Returns whether a grid of \a keySize x \a valueSize cells split into tiles of \a tileSize x \a
+  tileSize cells can be stored. The grid size is limited to 2^30 cells per dimension, so the
+  rounding in \ref levelKeySize and \ref levelValueSize can't overflow for any of the up to 31
+  levels, and the tile count per dimension is limited to 2^24, the range of the tile indices in
+  QCPTiledColorMap's tile keys.
 */
-void QCPFinancial::setBrushPositive(const QBrush &brush)
+bool QCPColorMapTileStore::validSizes(int keySize, int valueSize, int tileSize)
 {
-  mBrushPositive = brush;
+  const int maxGridSize = 1 << 30;
+  const int maxTileSize = 1 << 15;
+  const qint64 maxTileCount = 1 << 24;
+  if (keySize < 1 || valueSize < 1 || tileSize < 1 || keySize > maxGridSize || valueSize > maxGridSize || tileSize > maxTileSize)
+    return false;
+  return (qint64(keySize)+tileSize-1)/tileSize <= maxTileCount && (qint64(valueSize)+tileSize-1)/tileSize <= maxTileCount;
 }
 
-/*!
-  If \ref setTwoColored is set to true, this function controls the brush that is used to draw fills
-  of data points with a negative trend (i.e. bars/candlesticks with close < open).
-  
-  If \a twoColored is false, the normal plottable's pen and brush are used (\ref setPen, \ref
-  setBrush).
+/*! \internal
   
-  \see setBrushPositive, setPenNegative, setPenPositive
+  Calculates the file offsets of the resolution levels from the header. The last entry is the
+  total file size.
 */
-void QCPFinancial::setBrushNegative(const QBrush &brush)
+void QCPColorMapTileStore::updateLevelOffsets()
 {
-  mBrushNegative = brush;
+  const qint64 tileBytes = qint64(mHeader.tileSize)*qint64(mHeader.tileSize)*qint64(sizeof(float));
+  mLevelOffsets.resize(mHeader.levelCount+1);
+  mLevelOffsets[0] = sizeof(FileHeader);
+  for (int level=0; level<mHeader.levelCount; ++level)
+    mLevelOffsets[level+1] = mLevelOffsets.at(level) + qint64(keyTileCount(level))*qint64(valueTileCount(level))*tileBytes;
 }
 
-/*!
-  If \ref setTwoColored is set to true, this function controls the pen that is used to draw
-  outlines of data points with a positive trend (i.e. bars/candlesticks with close >= open).
-  
-  If \a twoColored is false, the normal plottable's pen and brush are used (\ref setPen, \ref
-  setBrush).
+/*! \internal
   
-  \see setPenNegative, setBrushPositive, setBrushNegative
+  Returns a pointer to the cell at \a keyIndex and \a valueIndex of the given resolution \a level.
+  Cells of the same tile row follow each other in memory.
 */
-void QCPFinancial::setPenPositive(const QPen &pen)
+float *QCPColorMapTileStore::cell(int level, int keyIndex, int valueIndex) const
 {
-  mPenPositive = pen;
+  const int tileSize = mHeader.tileSize;
+  const qint64 tileIndex = qint64(valueIndex/tileSize)*keyTileCount(level) + keyIndex/tileSize;
+  const qint64 cellIndex = tileIndex*tileSize*tileSize + qint64(valueIndex%tileSize)*tileSize + keyIndex%tileSize;
+  return reinterpret_cast<float*>(mMap + mLevelOffsets.at(level)) + cellIndex;
 }
 
-/*!
-  If \ref setTwoColored is set to true, this function controls the pen that is used to draw
-  outlines of data points with a negative trend (i.e. bars/candlesticks with close < open).
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPTiledColorMap
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPTiledColorMap
+  \brief A plottable representing a very large two-dimensional map, loaded tile by tile
   
-  If \a twoColored is false, the normal plottable's pen and brush are used (\ref setPen, \ref
-  setBrush).
+  QCPColorMap colorizes its entire data grid into one image and scales it to the axis rect, which
+  requires the grid and the image to fit into memory. QCPTiledColorMap displays the data of a \ref
+  QCPColorMapTileStore instead, which holds the grid in a memory-mapped file at several
+  resolutions:
   
-  \see setPenPositive, setBrushNegative, setBrushPositive
+  \li Only the tiles intersecting the visible key and value range are used, at the resolution
+  level that provides roughly one to two cells per pixel.
+  \li Colorized tiles are kept in an LRU cache (see \ref setTileCacheSize), so panning and zooming
+  back and forth doesn't colorize tiles again.
+  \li Missing tiles are loaded and colorized in a background thread. Until a tile arrives, the
+  closest coarser tile in the cache is drawn in its place. If there is none, the tile area is
+  filled with the brush of the plottable (\ref setBrush), if set. A replot is queued when tiles
+  arrive.
+  
+  When exporting (e.g. \ref QCustomPlot::savePng or \ref QCustomPlot::savePdf), missing tiles are
+  loaded synchronously, so the output is complete.
+  
+  Colorization uses \ref QCPColorGradient, with the data range and scale type set via \ref
+  setDataRange and \ref setDataScaleType, like QCPColorMap. Changing them clears the tile cache.
 */
-void QCPFinancial::setPenNegative(const QPen &pen)
-{
-  mPenNegative = pen;
-}
 
-/*! \overload
-  
-  Adds the provided points in \a keys, \a open, \a high, \a low and \a close to the current data.
-  The provided vectors should have equal length. Else, the number of added points will be the size
-  of the smallest vector.
+/* start of documentation of inline functions */
+
+/*! \fn QSharedPointer<QCPColorMapTileStore> QCPTiledColorMap::tileStore() const
   
-  If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
-  can set \a alreadySorted to true, to improve performance by saving a sorting run.
+  Returns the store this map displays.
+*/
+
+/* end of documentation of inline functions */
+
+/* start of documentation of signals */
+
+/*! \fn void QCPTiledColorMap::dataRangeChanged(const QCPRange &newRange);
   
-  Alternatively, you can also access and modify the data directly via the \ref data method, which
-  returns a pointer to the internal data container.
+  This signal is emitted when the data range changes.
   
-  \see timeSeriesToOhlc
+  \see setDataRange
 */
-void QCPFinancial::addData(const QVector<double> &keys, const QVector<double> &open, const QVector<double> &high, const QVector<double> &low, const QVector<double> &close, bool alreadySorted)
+
+/*! \fn void QCPTiledColorMap::dataScaleTypeChanged(QCPAxis::ScaleType scaleType);
+  
+  This signal is emitted when the data scale type changes.
+  
+  \see setDataScaleType
+*/
+
+/*! \fn void QCPTiledColorMap::gradientChanged(const QCPColorGradient &newGradient);
+  
+  This signal is emitted when the gradient changes.
+  
+  \see setGradient
+*/
+
+/* end of documentation of signals */
+
+/*! \internal
+  
+  Colorizes one tile of a \ref QCPColorMapTileStore in a worker thread and passes the resulting
+  image to the \ref QCPTiledColorMap via a queued call. If the map sets the \a cancelled flag before
+  the task starts (because the tile left the visible area), the task returns without work.
+*/
+class QCPTiledColorMapTileTask : public QRunnable
 {
-  if (keys.size() != open.size() || open.size() != high.size() || high.size() != low.size() || low.size() != close.size() || close.size() != keys.size())
-    qDebug() << Q_FUNC_INFO << "keys, open, high, low, close have different sizes:" << keys.size() << open.size() << high.size() << low.size() << close.size();
-  const int n = qMin(keys.size(), qMin(open.size(), qMin(high.size(), qMin(low.size(), close.size()))));
-  QVector<QCPFinancialData> tempData(n);
-  QVector<QCPFinancialData>::iterator it = tempData.begin();
-  const QVector<QCPFinancialData>::iterator itEnd = tempData.end();
-  int i = 0;
-  while (it != itEnd)
+public:
+  QCPTiledColorMapTileTask(QCPTiledColorMap *target, const QSharedPointer<QAtomicInt> &cancelled, const QSharedPointer<QCPColorMapTileStore> &store, int generation,
+                           int level, int keyTile, int valueTile, const QCPColorGradient &gradient, const QCPRange &dataRange, bool logarithmic) :
+    mTarget(target),
+    mCancelled(cancelled),
+    mStore(store),
+    mGeneration(generation),
+    mLevel(level),
+    mKeyTile(keyTile),
+    mValueTile(valueTile),
+    mGradient(gradient),
+    mDataRange(dataRange),
+    mLogarithmic(logarithmic)
+  {}
+  
+  virtual void run() Q_DECL_OVERRIDE
   {
-    it->key = keys[i];
-    it->open = open[i];
-    it->high = high[i];
-    it->low = low[i];
-    it->close = close[i];
-    ++it;
-    ++i;
+    if (mCancelled->loadAcquire())
+      return;
+    const QImage image = mStore->colorizeTile(mLevel, mKeyTile, mValueTile, mGradient, mDataRange, mLogarithmic);
+    QMetaObject::invokeMethod(mTarget, "tileLoaded", Qt::QueuedConnection, Q_ARG(int, mGeneration), Q_ARG(int, mLevel),
+                              Q_ARG(int, mKeyTile), Q_ARG(int, mValueTile), Q_ARG(QImage, image));
   }
-  mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
-}
+  
+protected:
+  QCPTiledColorMap *mTarget; // outlives the task, its destructor waits for all tasks to finish
+  QSharedPointer<QAtomicInt> mCancelled;
+  QSharedPointer<QCPColorMapTileStore> mStore;
+  int mGeneration, mLevel, mKeyTile, mValueTile;
+  QCPColorGradient mGradient;
+  QCPRange mDataRange;
+  bool mLogarithmic;
+};
 
-/*! \overload
+/*!
+  Constructs a tiled color map with the key axis \a keyAxis and the value axis \a valueAxis.
   
-  Adds the provided data point as \a key, \a open, \a high, \a low and \a close to the current
-  data.
+  The created QCPTiledColorMap is automatically registered with the QCustomPlot instance inferred
+  from \a keyAxis. This QCustomPlot instance takes ownership of the QCPTiledColorMap, so do not
+  delete it manually but use QCustomPlot::removePlottable() instead.
   
-  Alternatively, you can also access and modify the data directly via the \ref data method, which
-  returns a pointer to the internal data container.
+  Assign the data to display with \ref setTileStore.
+*/
+QCPTiledColorMap::QCPTiledColorMap(QCPAxis *keyAxis, QCPAxis *valueAxis) :
+  QCPAbstractPlottable(keyAxis, valueAxis),
+  mDataScaleType(QCPAxis::stLinear),
+  mGradient(QCPColorGradient::gpCold),
+  mInterpolate(true),
+  mGeneration(0)
+{
+  mTileCache.setMaxCost(256);
+}
+
+QCPTiledColorMap::~QCPTiledColorMap()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+  mLoaderPool.clear();
+#endif
+  mLoaderPool.waitForDone(); // tasks hold a pointer to this map
+}
+
+/*!
+  Sets the store whose data this map displays. The store must be open. Multiple maps may display
+  the same store, e.g. with different gradients.
   
-  \see timeSeriesToOhlc
+  \see rescaleDataRange
 */
-void QCPFinancial::addData(double key, double open, double high, double low, double close)
+void QCPTiledColorMap::setTileStore(QSharedPointer<QCPColorMapTileStore> store)
 {
-  mDataContainer->add(QCPFinancialData(key, open, high, low, close));
+  mTileStore = store;
+  clearTileCache();
 }
 
 /*!
-  \copydoc QCPPlottableInterface1D::selectTestRect
+  Sets the data range of this color map to \a dataRange. The data range defines which data values
+  are mapped to the color gradient, like \ref QCPColorMap::setDataRange.
+  
+  \see setDataScaleType, setGradient, rescaleDataRange
 */
-QCPDataSelection QCPFinancial::selectTestRect(const QRectF &rect, bool onlySelectable) const
+void QCPTiledColorMap::setDataRange(const QCPRange &dataRange)
 {
-  QCPDataSelection result;
-  if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
-    return result;
-  if (!mKeyAxis || !mValueAxis)
-    return result;
+  if (!QCPRange::validRange(dataRange)) return;
+  if (mDataRange.lower != dataRange.lower || mDataRange.upper != dataRange.upper)
+  {
+    if (mDataScaleType == QCPAxis::stLogarithmic)
+      mDataRange = dataRange.sanitizedForLogScale();
+    else
+      mDataRange = dataRange.sanitizedForLinScale();
+    clearTileCache();
+    emit dataRangeChanged(mDataRange);
+  }
+}
+
+/*!
+  Sets whether the data is correlated with the color gradient linearly or logarithmically.
   
-  QCPFinancialDataContainer::const_iterator visibleBegin, visibleEnd;
-  getVisibleDataBounds(visibleBegin, visibleEnd);
+  \see setDataRange, setGradient
+*/
+void QCPTiledColorMap::setDataScaleType(QCPAxis::ScaleType scaleType)
+{
+  if (mDataScaleType != scaleType)
+  {
+    mDataScaleType = scaleType;
+    clearTileCache();
+    emit dataScaleTypeChanged(mDataScaleType);
+    if (mDataScaleType == QCPAxis::stLogarithmic)
+      setDataRange(mDataRange.sanitizedForLogScale());
+  }
+}
+
+/*!
+  Sets the color gradient that is used to represent the data.
   
-  for (QCPFinancialDataContainer::const_iterator it=visibleBegin; it!=visibleEnd; ++it)
+  \see setDataRange, setDataScaleType
+*/
+void QCPTiledColorMap::setGradient(const QCPColorGradient &gradient)
+{
+  if (mGradient != gradient)
   {
-    if (rect.intersects(selectionHitBox(it)))
-      result.addDataRange(QCPDataRange(int(it-mDataContainer->constBegin()), int(it-mDataContainer->constBegin()+1)), false);
+    mGradient = gradient;
+    clearTileCache();
+    emit gradientChanged(mGradient);
   }
-  result.simplify();
-  return result;
 }
 
 /*!
-  Implements a selectTest specific to this plottable's point geometry.
+  Sets whether tiles are drawn with smooth interpolation when they are scaled, or with the cells
+  drawn as sharp rectangles.
+*/
+void QCPTiledColorMap::setInterpolate(bool enabled)
+{
+  mInterpolate = enabled;
+}
 
-  If \a details is not 0, it will be set to a \ref QCPDataSelection, describing the closest data
-  point to \a pos.
+/*!
+  Sets the maximum number of colorized tiles that are kept in memory. With the default tile size
+  of 256, each tile occupies 256 kB. If more tiles are visible at once, the cache grows to hold
+  twice the visible tiles.
+*/
+void QCPTiledColorMap::setTileCacheSize(int tiles)
+{
+  mTileCache.setMaxCost(qMax(1, tiles));
+}
+
+/*!
+  Sets the data range to the data bounds of the tile store, see \ref
+  QCPColorMapTileStore::buildLevels.
   
-  \seebaseclassmethod \ref QCPAbstractPlottable::selectTest
+  \see setDataRange
 */
-double QCPFinancial::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
+void QCPTiledColorMap::rescaleDataRange()
+{
+  if (mTileStore && mTileStore->isOpen())
+    setDataRange(mTileStore->dataBounds());
+}
+
+/*!
+  Discards all colorized tiles, including tiles that are currently being loaded. This is done
+  automatically when the store, the gradient, the data range or the data scale type changes.
+*/
+void QCPTiledColorMap::clearTileCache()
+{
+  mTileCache.clear();
+  cancelPendingTiles(QSet<quint64>());
+  ++mGeneration; // results of tasks still running are discarded
+}
+
+/* inherits documentation from base class */
+double QCPTiledColorMap::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
 {
   Q_UNUSED(details)
-  if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
+  if ((onlySelectable && mSelectable == QCP::stNone) || !mTileStore || !mTileStore->isOpen())
     return -1;
   if (!mKeyAxis || !mValueAxis)
     return -1;
   
   if (mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()) || mParentPlot->interactions().testFlag(QCP::iSelectPlottablesBeyondAxisRect))
   {
-    // get visible data range:
-    QCPFinancialDataContainer::const_iterator visibleBegin, visibleEnd;
-    QCPFinancialDataContainer::const_iterator closestDataPoint = mDataContainer->constEnd();
-    getVisibleDataBounds(visibleBegin, visibleEnd);
-    // perform select test according to configured style:
-    double result = -1;
-    switch (mChartStyle)
-    {
-      case QCPFinancial::csOhlc:
-        result = ohlcSelectTest(pos, visibleBegin, visibleEnd, closestDataPoint); break;
-      case QCPFinancial::csCandlestick:
-        result = candlestickSelectTest(pos, visibleBegin, visibleEnd, closestDataPoint); break;
-    }
-    if (details)
+    double posKey, posValue;
+    pixelsToCoords(pos, posKey, posValue);
+    if (mTileStore->keyRange().contains(posKey) && mTileStore->valueRange().contains(posValue))
     {
-      int pointIndex = int(closestDataPoint-mDataContainer->constBegin());
-      details->setValue(QCPDataSelection(QCPDataRange(pointIndex, pointIndex+1)));
+      if (details)
+        details->setValue(QCPDataSelection(QCPDataRange(0, 1)));
+      return mParentPlot->selectionTolerance()*0.99;
     }
-    return result;
   }
-  
   return -1;
 }
 
 /* inherits documentation from base class */
-QCPRange QCPFinancial::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
+QCPRange QCPTiledColorMap::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
 {
-  QCPRange range = mDataContainer->keyRange(foundRange, inSignDomain);
-  // determine exact range by including width of bars/flags:
-  if (foundRange)
+  if (!mTileStore || !mTileStore->isOpen())
   {
-    if (inSignDomain != QCP::sdPositive || range.lower-mWidth*0.5 > 0)
-      range.lower -= mWidth*0.5;
-    if (inSignDomain != QCP::sdNegative || range.upper+mWidth*0.5 < 0)
-      range.upper += mWidth*0.5;
+    foundRange = false;
+    return QCPRange();
   }
-  return range;
+  foundRange = true;
+  QCPRange result = mTileStore->keyRange();
+  result.normalize();
+  if (inSignDomain == QCP::sdPositive)
+  {
+    if (result.lower <= 0 && result.upper > 0)
+      result.lower = result.upper*1e-3;
+    else if (result.lower <= 0 && result.upper <= 0)
+      foundRange = false;
+  } else if (inSignDomain == QCP::sdNegative)
+  {
+    if (result.upper >= 0 && result.lower < 0)
+      result.upper = result.lower*1e-3;
+    else if (result.upper >= 0 && result.lower >= 0)
+      foundRange = false;
+  }
+  return result;
 }
 
 /* inherits documentation from base class */
-QCPRange QCPFinancial::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
+QCPRange QCPTiledColorMap::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
 {
-  return mDataContainer->valueRange(foundRange, inSignDomain, inKeyRange);
+  if (!mTileStore || !mTileStore->isOpen())
+  {
+    foundRange = false;
+    return QCPRange();
+  }
+  if (inKeyRange != QCPRange())
+  {
+    QCPRange keyRange = mTileStore->keyRange();
+    keyRange.normalize();
+    if (keyRange.upper < inKeyRange.lower || keyRange.lower > inKeyRange.upper)
+    {
+      foundRange = false;
+      return QCPRange();
+    }
+  }
+  
+  foundRange = true;
+  QCPRange result = mTileStore->valueRange();
+  result.normalize();
+  if (inSignDomain == QCP::sdPositive)
+  {
+    if (result.lower <= 0 && result.upper > 0)
+      result.lower = result.upper*1e-3;
+    else if (result.lower <= 0 && result.upper <= 0)
+      foundRange = false;
+  } else if (inSignDomain == QCP::sdNegative)
+  {
+    if (result.upper >= 0 && result.lower < 0)
+      result.upper = result.lower*1e-3;
+    else if (result.upper >= 0 && result.lower >= 0)
+      foundRange = false;
+  }
+  return result;
 }
 
-/*!
-  A convenience function that converts time series data (\a value against \a time) to OHLC binned
-  data points. The return value can then be passed on to \ref QCPFinancialDataContainer::set(const
-  QCPFinancialDataContainer&).
+/* inherits documentation from base class */
+void QCPTiledColorMap::draw(QCPPainter *painter)
+{
+  if (!mTileStore || !mTileStore->isOpen()) return;
+  if (!mKeyAxis || !mValueAxis) return;
+  applyDefaultAntialiasingHint(painter);
   
-  The size of the bins can be controlled with \a timeBinSize in the same units as \a time is given.
-  For example, if the unit of \a time is seconds and single OHLC/Candlesticks should span an hour
-  each, set \a timeBinSize to 3600.
+  // when exporting, there is no later replot that could show asynchronously loaded tiles:
+  const bool synchronous = painter->modes().testFlag(QCPPainter::pmVectorized) || painter->modes().testFlag(QCPPainter::pmNoCaching);
+  const int level = levelForView();
+  const int levelCount = mTileStore->levelCount();
+  int keyTileLower, keyTileUpper, valueTileLower, valueTileUpper;
+  visibleTiles(level, keyTileLower, keyTileUpper, valueTileLower, valueTileUpper);
+  if (keyTileLower > keyTileUpper || valueTileLower > valueTileUpper)
+    return;
+  const int visibleTileCount = (keyTileUpper-keyTileLower+1)*(valueTileUpper-valueTileLower+1);
+  if (mTileCache.maxCost() < 2*visibleTileCount)
+    mTileCache.setMaxCost(2*visibleTileCount);
   
-  \a timeBinOffset allows to control precisely at what \a time coordinate a bin should start. The
-  value passed as \a timeBinOffset doesn't need to be in the range encompassed by the \a time keys.
-  It merely defines the mathematical offset/phase of the bins that will be used to process the
-  data.
-*/
-QCPFinancialDataContainer QCPFinancial::timeSeriesToOhlc(const QVector<double> &time, const QVector<double> &value, double timeBinSize, double timeBinOffset)
-{
-  QCPFinancialDataContainer data;
-  int count = qMin(time.size(), value.size());
-  if (count == 0)
-    return QCPFinancialDataContainer();
+  const bool smoothBackup = painter->renderHints().testFlag(QPainter::SmoothPixmapTransform);
+  painter->setRenderHint(QPainter::SmoothPixmapTransform, mInterpolate);
   
-  QCPFinancialData currentBinData(0, value.first(), value.first(), value.first(), value.first());
-  int currentBinIndex = qFloor((time.first()-timeBinOffset)/timeBinSize+0.5);
-  for (int i=0; i<count; ++i)
+  // first pass, request missing tiles and draw placeholders for them:
+  QSet<quint64> drawnPlaceholders;
+  QSet<quint64> requestedTiles;
+  for (int valueTile=valueTileLower; valueTile<=valueTileUpper; ++valueTile)
   {
-    int index = qFloor((time.at(i)-timeBinOffset)/timeBinSize+0.5);
-    if (currentBinIndex == index) // data point still in current bin, extend high/low:
+    for (int keyTile=keyTileLower; keyTile<=keyTileUpper; ++keyTile)
     {
-      if (value.at(i) < currentBinData.low) currentBinData.low = value.at(i);
-      if (value.at(i) > currentBinData.high) currentBinData.high = value.at(i);
-      if (i == count-1) // last data point is in current bin, finalize bin:
+      const quint64 key = tileKey(level, keyTile, valueTile);
+      if (mTileCache.contains(key))
+        continue;
+      if (synchronous)
       {
-        currentBinData.close = value.at(i);
-        currentBinData.key = timeBinOffset+(index)*timeBinSize;
-        data.add(currentBinData);
+        mTileCache.insert(key, new QImage(mTileStore->colorizeTile(level, keyTile, valueTile, mGradient, mDataRange, mDataScaleType == QCPAxis::stLogarithmic)));
+        continue;
+      }
+      requestTile(level, keyTile, valueTile);
+      requestedTiles.insert(key);
+      
+      bool placeholderFound = false;
+      for (int parentLevel=level+1; parentLevel<levelCount && !placeholderFound; ++parentLevel)
+      {
+        const int shift = parentLevel-level;
+        const quint64 parentKey = tileKey(parentLevel, keyTile >> shift, valueTile >> shift);
+        if (QImage *parentImage = mTileCache.object(parentKey))
+        {
+          if (!drawnPlaceholders.contains(parentKey))
+          {
+            drawTile(painter, *parentImage, parentLevel, keyTile >> shift, valueTile >> shift);
+            drawnPlaceholders.insert(parentKey);
+          }
+          placeholderFound = true;
+        }
+      }
+      if (!placeholderFound)
+      {
+        if (level < levelCount-1) // the coarsest level is cheap to load and serves as placeholder from then on
+        {
+          const int shift = levelCount-1-level;
+          requestTile(levelCount-1, keyTile >> shift, valueTile >> shift);
+          requestedTiles.insert(tileKey(levelCount-1, keyTile >> shift, valueTile >> shift));
+        }
+        if (mBrush.style() != Qt::NoBrush)
+        {
+          const QRectF coordRect = tileCoordRect(level, keyTile, valueTile);
+          QPolygonF polygon;
+          polygon << coordsToPixels(coordRect.left(), coordRect.top())
+                  << coordsToPixels(coordRect.right(), coordRect.top())
+                  << coordsToPixels(coordRect.right(), coordRect.bottom())
+                  << coordsToPixels(coordRect.left(), coordRect.bottom());
+          painter->setPen(Qt::NoPen);
+          painter->setBrush(mBrush);
+          painter->drawPolygon(polygon);
+        }
       }
-    } else // data point not anymore in current bin, set close of old and open of new bin, and add old to map:
-    {
-      // finalize current bin:
-      currentBinData.close = value.at(i-1);
-      currentBinData.key = timeBinOffset+(index-1)*timeBinSize;
-      data.add(currentBinData);
-      // start next bin:
-      currentBinIndex = index;
-      currentBinData.open = value.at(i);
-      currentBinData.high = value.at(i);
-      currentBinData.low = value.at(i);
     }
   }
   
-  return data;
-}
-
-/* inherits documentation from base class */
-void QCPFinancial::draw(QCPPainter *painter)
-{
-  // get visible data range:
-  QCPFinancialDataContainer::const_iterator visibleBegin, visibleEnd;
-  getVisibleDataBounds(visibleBegin, visibleEnd);
+  // tiles queued by previous replots that are no longer needed (e.g. after panning or zooming past
+  // them) would otherwise delay the visible ones:
+  if (!synchronous)
+    cancelPendingTiles(requestedTiles);
   
-  // loop over and draw segments of unselected/selected data:
-  QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
-  getDataSegments(selectedSegments, unselectedSegments);
-  allSegments << unselectedSegments << selectedSegments;
-  for (int i=0; i<allSegments.size(); ++i)
+  // second pass, draw the available tiles on top of the placeholders:
+  for (int valueTile=valueTileLower; valueTile<=valueTileUpper; ++valueTile)
   {
-    bool isSelectedSegment = i >= unselectedSegments.size();
-    QCPFinancialDataContainer::const_iterator begin = visibleBegin;
-    QCPFinancialDataContainer::const_iterator end = visibleEnd;
-    mDataContainer->limitIteratorsToDataRange(begin, end, allSegments.at(i));
-    if (begin == end)
-      continue;
-    
-    // draw data segment according to configured style:
-    switch (mChartStyle)
+    for (int keyTile=keyTileLower; keyTile<=keyTileUpper; ++keyTile)
     {
-      case QCPFinancial::csOhlc:
-        drawOhlcPlot(painter, begin, end, isSelectedSegment); break;
-      case QCPFinancial::csCandlestick:
-        drawCandlestickPlot(painter, begin, end, isSelectedSegment); break;
+      if (QImage *image = mTileCache.object(tileKey(level, keyTile, valueTile)))
+        drawTile(painter, *image, level, keyTile, valueTile);
     }
   }
   
-  // draw other selection decoration that isn't just line/scatter pens and brushes:
-  if (mSelectionDecorator)
-    mSelectionDecorator->drawDecoration(painter, selection());
+  painter->setRenderHint(QPainter::SmoothPixmapTransform, smoothBackup);
 }
 
 /* inherits documentation from base class */
-void QCPFinancial::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
+void QCPTiledColorMap::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
 {
-  painter->setAntialiasing(false); // legend icon especially of csCandlestick looks better without antialiasing
-  if (mChartStyle == csOhlc)
-  {
-    if (mTwoColored)
-    {
-      // draw upper left half icon with positive color:
-      painter->setBrush(mBrushPositive);
-      painter->setPen(mPenPositive);
-      painter->setClipRegion(QRegion(QPolygon() << rect.bottomLeft().toPoint() << rect.topRight().toPoint() << rect.topLeft().toPoint()));
-      painter->drawLine(QLineF(0, rect.height()*0.5, rect.width(), rect.height()*0.5).translated(rect.topLeft()));
-      painter->drawLine(QLineF(rect.width()*0.2, rect.height()*0.3, rect.width()*0.2, rect.height()*0.5).translated(rect.topLeft()));
-      painter->drawLine(QLineF(rect.width()*0.8, rect.height()*0.5, rect.width()*0.8, rect.height()*0.7).translated(rect.topLeft()));
-      // draw bottom right half icon with negative color:
-      painter->setBrush(mBrushNegative);
-      painter->setPen(mPenNegative);
-      painter->setClipRegion(QRegion(QPolygon() << rect.bottomLeft().toPoint() << rect.topRight().toPoint() << rect.bottomRight().toPoint()));
-      painter->drawLine(QLineF(0, rect.height()*0.5, rect.width(), rect.height()*0.5).translated(rect.topLeft()));
-      painter->drawLine(QLineF(rect.width()*0.2, rect.height()*0.3, rect.width()*0.2, rect.height()*0.5).translated(rect.topLeft()));
-      painter->drawLine(QLineF(rect.width()*0.8, rect.height()*0.5, rect.width()*0.8, rect.height()*0.7).translated(rect.topLeft()));
-    } else
-    {
-      painter->setBrush(mBrush);
-      painter->setPen(mPen);
-      painter->drawLine(QLineF(0, rect.height()*0.5, rect.width(), rect.height()*0.5).translated(rect.topLeft()));
-      painter->drawLine(QLineF(rect.width()*0.2, rect.height()*0.3, rect.width()*0.2, rect.height()*0.5).translated(rect.topLeft()));
-      painter->drawLine(QLineF(rect.width()*0.8, rect.height()*0.5, rect.width()*0.8, rect.height()*0.7).translated(rect.topLeft()));
-    }
-  } else if (mChartStyle == csCandlestick)
-  {
-    if (mTwoColored)
-    {
-      // draw upper left half icon with positive color:
-      painter->setBrush(mBrushPositive);
-      painter->setPen(mPenPositive);
-      painter->setClipRegion(QRegion(QPolygon() << rect.bottomLeft().toPoint() << rect.topRight().toPoint() << rect.topLeft().toPoint()));
-      painter->drawLine(QLineF(0, rect.height()*0.5, rect.width()*0.25, rect.height()*0.5).translated(rect.topLeft()));
-      painter->drawLine(QLineF(rect.width()*0.75, rect.height()*0.5, rect.width(), rect.height()*0.5).translated(rect.topLeft()));
-      painter->drawRect(QRectF(rect.width()*0.25, rect.height()*0.25, rect.width()*0.5, rect.height()*0.5).translated(rect.topLeft()));
-      // draw bottom right half icon with negative color:
-      painter->setBrush(mBrushNegative);
-      painter->setPen(mPenNegative);
-      painter->setClipRegion(QRegion(QPolygon() << rect.bottomLeft().toPoint() << rect.topRight().toPoint() << rect.bottomRight().toPoint()));
-      painter->drawLine(QLineF(0, rect.height()*0.5, rect.width()*0.25, rect.height()*0.5).translated(rect.topLeft()));
-      painter->drawLine(QLineF(rect.width()*0.75, rect.height()*0.5, rect.width(), rect.height()*0.5).translated(rect.topLeft()));
-      painter->drawRect(QRectF(rect.width()*0.25, rect.height()*0.25, rect.width()*0.5, rect.height()*0.5).translated(rect.topLeft()));
-    } else
-    {
-      painter->setBrush(mBrush);
-      painter->setPen(mPen);
-      painter->drawLine(QLineF(0, rect.height()*0.5, rect.width()*0.25, rect.height()*0.5).translated(rect.topLeft()));
-      painter->drawLine(QLineF(rect.width()*0.75, rect.height()*0.5, rect.width(), rect.height()*0.5).translated(rect.topLeft()));
-      painter->drawRect(QRectF(rect.width()*0.25, rect.height()*0.25, rect.width()*0.5, rect.height()*0.5).translated(rect.topLeft()));
-    }
-  }
+  applyDefaultAntialiasingHint(painter);
+  QCPColorGradient gradient = mGradient;
+  QLinearGradient fill(rect.left(), 0, rect.right(), 0);
+  for (int i=0; i<=4; ++i)
+    fill.setColorAt(i/4.0, QColor::fromRgba(gradient.color(i/4.0, QCPRange(0, 1))));
+  painter->fillRect(rect, QBrush(fill));
 }
 
 /*! \internal
   
-  Draws the data from \a begin to \a end-1 as OHLC bars with the provided \a painter.
-
-  This method is a helper function for \ref draw. It is used when the chart style is \ref csOhlc.
+  Returns the resolution level that provides at least one but less than two cells per pixel for
+  the current axis ranges, or the coarsest level if even that has more cells per pixel. While the
+  parent plot renders coarsely (see \ref QCustomPlot::setProgressiveRefineDelay), the next coarser
+  level is used.
 */
-void QCPFinancial::drawOhlcPlot(QCPPainter *painter, const QCPFinancialDataContainer::const_iterator &begin, const QCPFinancialDataContainer::const_iterator &end, bool isSelected)
+int QCPTiledColorMap::levelForView() const
 {
-  QCPAxis *keyAxis = mKeyAxis.data();
-  QCPAxis *valueAxis = mValueAxis.data();
-  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
+  const QCPAxis *keyAxis = mKeyAxis.data();
+  const QCPAxis *valueAxis = mValueAxis.data();
+  const double keyPixels = qAbs(keyAxis->coordToPixel(keyAxis->range().upper)-keyAxis->coordToPixel(keyAxis->range().lower));
+  const double valuePixels = qAbs(valueAxis->coordToPixel(valueAxis->range().upper)-valueAxis->coordToPixel(valueAxis->range().lower));
+  const double keyCells = qAbs(keyAxis->range().size()/mTileStore->cellWidth());
+  const double valueCells = qAbs(valueAxis->range().size()/mTileStore->cellHeight());
+  double cellsPerPixel = qMax(keyPixels > 0 ? keyCells/keyPixels : 0.0, valuePixels > 0 ? valueCells/valuePixels : 0.0);
   
-  if (keyAxis->orientation() == Qt::Horizontal)
-  {
-    for (QCPFinancialDataContainer::const_iterator it = begin; it != end; ++it)
-    {
-      if (isSelected && mSelectionDecorator)
-        mSelectionDecorator->applyPen(painter);
-      else if (mTwoColored)
-        painter->setPen(it->close >= it->open ? mPenPositive : mPenNegative);
-      else
-        painter->setPen(mPen);
-      double keyPixel = keyAxis->coordToPixel(it->key);
-      double openPixel = valueAxis->coordToPixel(it->open);
-      double closePixel = valueAxis->coordToPixel(it->close);
-      // draw backbone:
-      painter->drawLine(QPointF(keyPixel, valueAxis->coordToPixel(it->high)), QPointF(keyPixel, valueAxis->coordToPixel(it->low)));
-      // draw open:
-      double pixelWidth = getPixelWidth(it->key, keyPixel); // sign of this makes sure open/close are on correct sides
-      painter->drawLine(QPointF(keyPixel-pixelWidth, openPixel), QPointF(keyPixel, openPixel));
-      // draw close:
-      painter->drawLine(QPointF(keyPixel, closePixel), QPointF(keyPixel+pixelWidth, closePixel));
-    }
-  } else
+  int level = 0;
+  while (level < mTileStore->levelCount()-1 && cellsPerPixel >= 2.0)
   {
-    for (QCPFinancialDataContainer::const_iterator it = begin; it != end; ++it)
-    {
-      if (isSelected && mSelectionDecorator)
-        mSelectionDecorator->applyPen(painter);
-      else if (mTwoColored)
-        painter->setPen(it->close >= it->open ? mPenPositive : mPenNegative);
-      else
-        painter->setPen(mPen);
-      double keyPixel = keyAxis->coordToPixel(it->key);
-      double openPixel = valueAxis->coordToPixel(it->open);
-      double closePixel = valueAxis->coordToPixel(it->close);
-      // draw backbone:
-      painter->drawLine(QPointF(valueAxis->coordToPixel(it->high), keyPixel), QPointF(valueAxis->coordToPixel(it->low), keyPixel));
-      // draw open:
-      double pixelWidth = getPixelWidth(it->key, keyPixel); // sign of this makes sure open/close are on correct sides
-      painter->drawLine(QPointF(openPixel, keyPixel-pixelWidth), QPointF(openPixel, keyPixel));
-      // draw close:
-      painter->drawLine(QPointF(closePixel, keyPixel), QPointF(closePixel, keyPixel+pixelWidth));
-    }
+    cellsPerPixel /= 2.0;
+    ++level;
   }
+  if (mParentPlot && mParentPlot->coarseRendering() && level < mTileStore->levelCount()-1)
+    ++level;
+  return level;
 }
 
 /*! \internal
   
-  Draws the data from \a begin to \a end-1 as Candlesticks with the provided \a painter.
+  Sets the tile index ranges (inclusive) of the given resolution \a level that intersect the
+  visible key and value range. If no tile is visible, the lower index is larger than the upper one.
+*/
+void QCPTiledColorMap::visibleTiles(int level, int &keyTileLower, int &keyTileUpper, int &valueTileLower, int &valueTileUpper) const
+{
+  const double tileCells = double(mTileStore->tileSize())*double(1 << level); // full resolution cells per tile
+  const QCPRange keyRange = mKeyAxis.data()->range();
+  const QCPRange valueRange = mValueAxis.data()->range();
+  // cell index space is shifted by half a cell, since cells are centered on their coordinate:
+  const double keyIndexA = (keyRange.lower-mTileStore->keyRange().lower)/mTileStore->cellWidth()+0.5;
+  const double keyIndexB = (keyRange.upper-mTileStore->keyRange().lower)/mTileStore->cellWidth()+0.5;
+  const double valueIndexA = (valueRange.lower-mTileStore->valueRange().lower)/mTileStore->cellHeight()+0.5;
+  const double valueIndexB = (valueRange.upper-mTileStore->valueRange().lower)/mTileStore->cellHeight()+0.5;
+  const double keyTiles = mTileStore->keyTileCount(level);
+  const double valueTiles = mTileStore->valueTileCount(level);
+  keyTileLower = int(qBound(0.0, std::floor(qMin(keyIndexA, keyIndexB)/tileCells), keyTiles));
+  keyTileUpper = int(qBound(-1.0, std::floor(qMax(keyIndexA, keyIndexB)/tileCells), keyTiles-1));
+  valueTileLower = int(qBound(0.0, std::floor(qMin(valueIndexA, valueIndexB)/tileCells), valueTiles));
+  valueTileUpper = int(qBound(-1.0, std::floor(qMax(valueIndexA, valueIndexB)/tileCells), valueTiles-1));
+}
 
-  This method is a helper function for \ref draw. It is used when the chart style is \ref csCandlestick.
+/*! \internal
+  
+  Starts loading the tile at \a keyTile and \a valueTile of the given resolution \a level in a
+  background thread, unless it is already cached or being loaded.
+  
+  \see tileLoaded
 */
-void QCPFinancial::drawCandlestickPlot(QCPPainter *painter, const QCPFinancialDataContainer::const_iterator &begin, const QCPFinancialDataContainer::const_iterator &end, bool isSelected)
+void QCPTiledColorMap::requestTile(int level, int keyTile, int valueTile)
 {
-  QCPAxis *keyAxis = mKeyAxis.data();
-  QCPAxis *valueAxis = mValueAxis.data();
-  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
+  const quint64 key = tileKey(level, keyTile, valueTile);
+  if (mPendingTiles.contains(key) || mTileCache.contains(key))
+    return;
+  QSharedPointer<QAtomicInt> cancelled(new QAtomicInt(0));
+  mPendingTiles.insert(key, cancelled);
+  mLoaderPool.start(new QCPTiledColorMapTileTask(this, cancelled, mTileStore, mGeneration, level, keyTile, valueTile, mGradient, mDataRange, mDataScaleType == QCPAxis::stLogarithmic));
+}
+
+/*! \internal
   
-  if (keyAxis->orientation() == Qt::Horizontal)
+  Cancels all tiles requested with \ref requestTile that haven't been loaded yet and aren't
+  contained in \a keep. Tasks that haven't started yet return without colorizing their tile.
+*/
+void QCPTiledColorMap::cancelPendingTiles(const QSet<quint64> &keep)
+{
+  QHash<quint64, QSharedPointer<QAtomicInt> >::iterator it = mPendingTiles.begin();
+  while (it != mPendingTiles.end())
   {
-    for (QCPFinancialDataContainer::const_iterator it = begin; it != end; ++it)
+    if (keep.contains(it.key()))
     {
-      if (isSelected && mSelectionDecorator)
-      {
-        mSelectionDecorator->applyPen(painter);
-        mSelectionDecorator->applyBrush(painter);
-      } else if (mTwoColored)
-      {
-        painter->setPen(it->close >= it->open ? mPenPositive : mPenNegative);
-        painter->setBrush(it->close >= it->open ? mBrushPositive : mBrushNegative);
-      } else
-      {
-        painter->setPen(mPen);
-        painter->setBrush(mBrush);
-      }
-      double keyPixel = keyAxis->coordToPixel(it->key);
-      double openPixel = valueAxis->coordToPixel(it->open);
-      double closePixel = valueAxis->coordToPixel(it->close);
-      // draw high:
-      painter->drawLine(QPointF(keyPixel, valueAxis->coordToPixel(it->high)), QPointF(keyPixel, valueAxis->coordToPixel(qMax(it->open, it->close))));
-      // draw low:
-      painter->drawLine(QPointF(keyPixel, valueAxis->coordToPixel(it->low)), QPointF(keyPixel, valueAxis->coordToPixel(qMin(it->open, it->close))));
-      // draw open-close box:
-      double pixelWidth = getPixelWidth(it->key, keyPixel);
-      painter->drawRect(QRectF(QPointF(keyPixel-pixelWidth, closePixel), QPointF(keyPixel+pixelWidth, openPixel)));
-    }
-  } else // keyAxis->orientation() == Qt::Vertical
-  {
-    for (QCPFinancialDataContainer::const_iterator it = begin; it != end; ++it)
+      ++it;
+    } else
     {
-      if (isSelected && mSelectionDecorator)
-      {
-        mSelectionDecorator->applyPen(painter);
-        mSelectionDecorator->applyBrush(painter);
-      } else if (mTwoColored)
-      {
-        painter->setPen(it->close >= it->open ? mPenPositive : mPenNegative);
-        painter->setBrush(it->close >= it->open ? mBrushPositive : mBrushNegative);
-      } else
-      {
-        painter->setPen(mPen);
-        painter->setBrush(mBrush);
-      }
-      double keyPixel = keyAxis->coordToPixel(it->key);
-      double openPixel = valueAxis->coordToPixel(it->open);
-      double closePixel = valueAxis->coordToPixel(it->close);
-      // draw high:
-      painter->drawLine(QPointF(valueAxis->coordToPixel(it->high), keyPixel), QPointF(valueAxis->coordToPixel(qMax(it->open, it->close)), keyPixel));
-      // draw low:
-      painter->drawLine(QPointF(valueAxis->coordToPixel(it->low), keyPixel), QPointF(valueAxis->coordToPixel(qMin(it->open, it->close)), keyPixel));
-      // draw open-close box:
-      double pixelWidth = getPixelWidth(it->key, keyPixel);
-      painter->drawRect(QRectF(QPointF(closePixel, keyPixel-pixelWidth), QPointF(openPixel, keyPixel+pixelWidth)));
+      it.value()->storeRelease(1);
+      it = mPendingTiles.erase(it);
     }
   }
 }
 
 /*! \internal
+  
+  Draws \a image, the colorized tile at \a keyTile and \a valueTile of the given resolution \a
+  level, to its position in the axis rect. The image is mapped with a transformation, which takes
+  care of reversed axis ranges and vertical key axes.
+*/
+void QCPTiledColorMap::drawTile(QCPPainter *painter, const QImage &image, int level, int keyTile, int valueTile) const
+{
+  if (image.isNull())
+    return;
+  const QRectF coordRect = tileCoordRect(level, keyTile, valueTile);
+  // the first image line holds the highest values, so the image origin is at the upper value bound:
+  const QPointF origin = coordsToPixels(coordRect.left(), coordRect.bottom());
+  const QPointF keyEnd = coordsToPixels(coordRect.right(), coordRect.bottom());
+  const QPointF valueEnd = coordsToPixels(coordRect.left(), coordRect.top());
+  const QTransform transform((keyEnd.x()-origin.x())/image.width(), (keyEnd.y()-origin.y())/image.width(),
+                             (valueEnd.x()-origin.x())/image.height(), (valueEnd.y()-origin.y())/image.height(),
+                             origin.x(), origin.y());
+  painter->save();
+  painter->setTransform(transform, true);
+  painter->drawImage(QPointF(0, 0), image);
+  painter->restore();
+}
 
-  This function is used to determine the width of the bar at coordinate \a key, according to the
-  specified width (\ref setWidth) and width type (\ref setWidthType). Provide the pixel position of
-  \a key in \a keyPixel (because usually this was already calculated via \ref QCPAxis::coordToPixel
-  when this function is called).
+/*! \internal
+  
+  Returns the area covered by the tile at \a keyTile and \a valueTile of the given resolution \a
+  level in plot coordinates. The rect's x coordinates are keys and its y coordinates are values,
+  with \c top being the lower and \c bottom the upper value bound.
+*/
+QRectF QCPTiledColorMap::tileCoordRect(int level, int keyTile, int valueTile) const
+{
+  const int tileSize = mTileStore->tileSize();
+  const double scale = double(1 << level);
+  const int width = qMin(tileSize, mTileStore->levelKeySize(level)-keyTile*tileSize);
+  const int height = qMin(tileSize, mTileStore->levelValueSize(level)-valueTile*tileSize);
+  const double left = mTileStore->keyRange().lower + (keyTile*tileSize*scale-0.5)*mTileStore->cellWidth();
+  const double top = mTileStore->valueRange().lower + (valueTile*tileSize*scale-0.5)*mTileStore->cellHeight();
+  return QRectF(left, top, width*scale*mTileStore->cellWidth(), height*scale*mTileStore->cellHeight());
+}
 
-  It returns the number of pixels the bar extends to higher keys, relative to the \a key
-  coordinate. So with a non-reversed horizontal axis, the return value is positive. With a reversed
-  horizontal axis, the return value is negative. This is important so the open/close flags on the
-  \ref csOhlc bar are drawn to the correct side.
+/*! \internal
+  
+  Receives the colorized \a image of a tile loaded by \ref requestTile, adds it to the tile cache
+  and queues a replot. Results of a previous \a generation (i.e. from before the gradient, data
+  range or store changed) are discarded.
 */
-double QCPFinancial::getPixelWidth(double key, double keyPixel) const
+void QCPTiledColorMap::tileLoaded(int generation, int level, int keyTile, int valueTile, const QImage &image)
 {
-  double result = 0;
-  switch (mWidthType)
-  {
-    case wtAbsolute:
-    {
-      if (mKeyAxis)
-        result = mWidth*0.5*mKeyAxis.data()->pixelOrientation();
-      break;
-    }
+  if (generation != mGeneration)
+    return;
+  const quint64 key = tileKey(level, keyTile, valueTile);
+  mPendingTiles.remove(key);
+  mTileCache.insert(key, new QImage(image));
+  if (mParentPlot)
+    mParentPlot->replot(QCustomPlot::rpQueuedReplot);
+}
+/* end of 'src/plottables/plottable-tiledcolormap.cpp' */
+
+
+/* including file 'src/plottables/plottable-financial.cpp' */
+/* modified 2022-11-06T12:45:57, size 42914                */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPFinancialData
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPFinancialData
+  \brief Holds the data of one single data point for QCPFinancial.
+  
+  The stored data is:
+  \li \a key: coordinate on the key axis of this data point (this is the \a mainKey and the \a sortKey)
+  \li \a open: The opening value at the data point (this is the \a mainValue)
+  \li \a high: The high/maximum value at the data point
+  \li \a low: The low/minimum value at the data point
+  \li \a close: The closing value at the data point
+  
+  The container for storing multiple data points is \ref QCPFinancialDataContainer. It is a typedef
+  for \ref QCPDataContainer with \ref QCPFinancialData as the DataType template parameter. See the
+  documentation there for an explanation regarding the data type's generic methods.
+  
+  \see QCPFinancialDataContainer
+*/
+
+/* start documentation of inline functions */
+
+/*! \fn double QCPFinancialData::sortKey() const
+  
+  Returns the \a key member of this data point.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/*! \fn static QCPFinancialData QCPFinancialData::fromSortKey(double sortKey)
+  
+  Returns a data point with the specified \a sortKey. All other members are set to zero.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/*! \fn static static bool QCPFinancialData::sortKeyIsMainKey()
+  
+  Since the member \a key is both the data point key coordinate and the data ordering parameter,
+  this method returns true.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/*! \fn double QCPFinancialData::mainKey() const
+  
+  Returns the \a key member of this data point.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/*! \fn double QCPFinancialData::mainValue() const
+  
+  Returns the \a open member of this data point.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/*! \fn QCPRange QCPFinancialData::valueRange() const
+  
+  Returns a QCPRange spanning from the \a low to the \a high value of this data point.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/* end documentation of inline functions */
+
+/*!
+  Constructs a data point with key and all values set to zero.
+*/
+QCPFinancialData::QCPFinancialData() :
+  key(0),
+  open(0),
+  high(0),
+  low(0),
+  close(0)
+{
+}
+
+/*!
+  Constructs a data point with the specified \a key and OHLC values.
+*/
+QCPFinancialData::QCPFinancialData(double key, double open, double high, double low, double close) :
+  key(key),
+  open(open),
+  high(high),
+  low(low),
+  close(close)
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPFinancial
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPFinancial
+  \brief A plottable representing a financial stock chart
+
+  \image html QCPFinancial.png
+
+  This plottable represents time series data binned to certain intervals, mainly used for stock
+  charts. The two common representations OHLC (Open-High-Low-Close) bars and Candlesticks can be
+  set via \ref setChartStyle.
+
+  The data is passed via \ref setData as a set of open/high/low/close values at certain keys
+  (typically times). This means the data must be already binned appropriately. If data is only
+  available as a series of values (e.g. \a price against \a time), you can use the static
+  convenience function \ref timeSeriesToOhlc to generate binned OHLC-data which can then be passed
+  to \ref setData.
+
+  The width of the OHLC bars/candlesticks can be controlled with \ref setWidth and \ref
+  setWidthType. A typical choice is to set the width type to \ref wtPlotCoords (the default) and
+  the width to (or slightly less than) one time bin interval width.
+
+  \section qcpfinancial-appearance Changing the appearance
+
+  Charts can be either single- or two-colored (\ref setTwoColored). If set to be single-colored,
+  lines are drawn with the plottable's pen (\ref setPen) and fills with the brush (\ref setBrush).
+
+  If set to two-colored, positive changes of the value during an interval (\a close >= \a open) are
+  represented with a different pen and brush than negative changes (\a close < \a open). These can
+  be configured with \ref setPenPositive, \ref setPenNegative, \ref setBrushPositive, and \ref
+  setBrushNegative. In two-colored mode, the normal plottable pen/brush is ignored. Upon selection
+  however, the normal selected pen/brush (provided by the \ref selectionDecorator) is used,
+  irrespective of whether the chart is single- or two-colored.
+
+  \section qcpfinancial-usage Usage
+
+  Like all data representing objects in QCustomPlot, the QCPFinancial is a plottable
+  (QCPAbstractPlottable). So the plottable-interface of QCustomPlot applies
+  (QCustomPlot::plottable, QCustomPlot::removePlottable, etc.)
+
+  Usually, you first create an instance:
+
+  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpfinancial-creation-1
+  which registers it with the QCustomPlot instance of the passed axes. Note that this QCustomPlot
+  instance takes ownership of the plottable, so do not delete it manually but use
+  QCustomPlot::removePlottable() instead. The newly created plottable can be modified, e.g.:
+
+  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpfinancial-creation-2
+  Here we have used the static helper method \ref timeSeriesToOhlc, to turn a time-price data
+  series into a 24-hour binned open-high-low-close data series as QCPFinancial uses.
+*/
+
+/* start of documentation of inline functions */
+
+/*! \fn QCPFinancialDataContainer *QCPFinancial::data() const
+  
+  Returns a pointer to the internal data storage of type \ref QCPFinancialDataContainer. You may
+  use it to directly manipulate the data, which may be more convenient and faster than using the
+  regular \ref setData or \ref addData methods, in certain situations.
+*/
+
+/* end of documentation of inline functions */
+
+/*!
+  Constructs a financial chart which uses \a keyAxis as its key axis ("x") and \a valueAxis as its value
+  axis ("y"). \a keyAxis and \a valueAxis must reside in the same QCustomPlot instance and not have
+  the same orientation. If either of these restrictions is violated, a corresponding message is
+  printed to the debug output (qDebug), the construction is not aborted, though.
+  
+  The created QCPFinancial is automatically registered with the QCustomPlot instance inferred from \a
+  keyAxis. This QCustomPlot instance takes ownership of the QCPFinancial, so do not delete it manually
+  but use QCustomPlot::removePlottable() instead.
+*/
+QCPFinancial::QCPFinancial(QCPAxis *keyAxis, QCPAxis *valueAxis) :
+  QCPAbstractPlottable1D<QCPFinancialData>(keyAxis, valueAxis),
+  mChartStyle(csCandlestick),
+  mWidth(0.5),
+  mWidthType(wtPlotCoords),
+  mTwoColored(true),
+  mBrushPositive(QBrush(QColor(50, 160, 0))),
+  mBrushNegative(QBrush(QColor(180, 0, 15))),
+  mPenPositive(QPen(QColor(40, 150, 0))),
+  mPenNegative(QPen(QColor(170, 5, 5)))
+{
+  mSelectionDecorator->setBrush(QBrush(QColor(160, 160, 255)));
+}
+
+QCPFinancial::~QCPFinancial()
+{
+}
+
+/*! \overload
+  
+  Replaces the current data container with the provided \a data container.
+  
+  Since a QSharedPointer is used, multiple QCPFinancials may share the same data container safely.
+  Modifying the data in the container will then affect all financials that share the container.
+  Sharing can be achieved by simply exchanging the data containers wrapped in shared pointers:
+  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpfinancial-datasharing-1
+  
+  If you do not wish to share containers, but create a copy from an existing container, rather use
+  the \ref QCPDataContainer<DataType>::set method on the financial's data container directly:
+  \snippet documentation/doc-code-snippets/mainwindow.cpp qcpfinancial-datasharing-2
+  
+  \see addData, timeSeriesToOhlc
+*/
+void QCPFinancial::setData(QSharedPointer<QCPFinancialDataContainer> data)
+{
+  mDataContainer = data;
+}
+
+/*! \overload
+  
+  Replaces the current data with the provided points in \a keys, \a open, \a high, \a low and \a
+  close. The provided vectors should have equal length. Else, the number of added points will be
+  the size of the smallest vector.
+  
+  If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
+  can set \a alreadySorted to true, to improve performance by saving a sorting run.
+  
+  \see addData, timeSeriesToOhlc
+*/
+void QCPFinancial::setData(const QVector<double> &keys, const QVector<double> &open, const QVector<double> &high, const QVector<double> &low, const QVector<double> &close, bool alreadySorted)
+{
+  mDataContainer->clear();
+  addData(keys, open, high, low, close, alreadySorted);
+}
+
+/*!
+  Sets which representation style shall be used to display the OHLC data.
+*/
+void QCPFinancial::setChartStyle(QCPFinancial::ChartStyle style)
+{
+  mChartStyle = style;
+}
+
+/*!
+  Sets the width of the individual bars/candlesticks to \a width in plot key coordinates.
+  
+  A typical choice is to set it to (or slightly less than) one bin interval width.
+*/
+void QCPFinancial::setWidth(double width)
+{
+  mWidth = width;
+}
+
+/*!
+  Sets how the width of the financial bars is defined. See the documentation of \ref WidthType for
+  an explanation of the possible values for \a widthType.
+
+  The default value is \ref wtPlotCoords.
+
+  \see setWidth
+*/
+void QCPFinancial::setWidthType(QCPFinancial::WidthType widthType)
+{
+  mWidthType = widthType;
+}
+
+/*!
+  Sets whether this chart shall contrast positive from negative trends per data point by using two
+  separate colors to draw the respective bars/candlesticks.
+  
+  If \a twoColored is false, the normal plottable's pen and brush are used (\ref setPen, \ref
+  setBrush).
+  
+  \see setPenPositive, setPenNegative, setBrushPositive, setBrushNegative
+*/
+void QCPFinancial::setTwoColored(bool twoColored)
+{
+  mTwoColored = twoColored;
+}
+
+/*!
+  If \ref setTwoColored is set to true, this function controls the brush that is used to draw fills
+  of data points with a positive trend (i.e. bars/candlesticks with close >= open).
+  
+  If \a twoColored is false, the normal plottable's pen and brush are used (\ref setPen, \ref
+  setBrush).
+  
+  \see setBrushNegative, setPenPositive, setPenNegative
+*/
+void QCPFinancial::setBrushPositive(const QBrush &brush)
+{
+  mBrushPositive = brush;
+}
+
+/*!
+  If \ref setTwoColored is set to true, this function controls the brush that is used to draw fills
+  of data points with a negative trend (i.e. bars/candlesticks with close < open).
+  
+  If \a twoColored is false, the normal plottable's pen and brush are used (\ref setPen, \ref
+  setBrush).
+  
+  \see setBrushPositive, setPenNegative, setPenPositive
+*/
+void QCPFinancial::setBrushNegative(const QBrush &brush)
+{
+  mBrushNegative = brush;
+}
+
+/*!
+  If \ref setTwoColored is set to true, this function controls the pen that is used to draw
+  outlines of data points with a positive trend (i.e. bars/candlesticks with close >= open).
+  
+  If \a twoColored is false, the normal plottable's pen and brush are used (\ref setPen, \ref
+  setBrush).
+  
+  \see setPenNegative, setBrushPositive, setBrushNegative
+*/
+void QCPFinancial::setPenPositive(const QPen &pen)
+{
+  mPenPositive = pen;
+}
+
+/*!
+  If \ref setTwoColored is set to true, this function controls the pen that is used to draw
+  outlines of data points with a negative trend (i.e. bars/candlesticks with close < open).
+  
+  If \a twoColored is false, the normal plottable's pen and brush are used (\ref setPen, \ref
+  setBrush).
+  
+  \see setPenPositive, setBrushNegative, setBrushPositive
+*/
+void QCPFinancial::setPenNegative(const QPen &pen)
+{
+  mPenNegative = pen;
+}
+
+/*! \overload
+  
+  Adds the provided points in \a keys, \a open, \a high, \a low and \a close to the current data.
+  The provided vectors should have equal length. Else, the number of added points will be the size
+  of the smallest vector.
+  
+  If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
+  can set \a alreadySorted to true, to improve performance by saving a sorting run.
+  
+  Alternatively, you can also access and modify the data directly via the \ref data method, which
+  returns a pointer to the internal data container.
+  
+  \see timeSeriesToOhlc
+*/
+void QCPFinancial::addData(const QVector<double> &keys, const QVector<double> &open, const QVector<double> &high, const QVector<double> &low, const QVector<double> &close, bool alreadySorted)
+{
+  if (keys.size() != open.size() || open.size() != high.size() || high.size() != low.size() || low.size() != close.size() || close.size() != keys.size())
+    qDebug() << Q_FUNC_INFO << "keys, open, high, low, close have different sizes:" << keys.size() << open.size() << high.size() << low.size() << close.size();
+  const int n = qMin(keys.size(), qMin(open.size(), qMin(high.size(), qMin(low.size(), close.size()))));
+  QVector<QCPFinancialData> tempData(n);
+  QVector<QCPFinancialData>::iterator it = tempData.begin();
+  const QVector<QCPFinancialData>::iterator itEnd = tempData.end();
+  int i = 0;
+  while (it != itEnd)
+  {
+    it->key = keys[i];
+    it->open = open[i];
+    it->high = high[i];
+    it->low = low[i];
+    it->close = close[i];
+    ++it;
+    ++i;
+  }
+  mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
+}
+
+/*! \overload
+  
+  Adds the provided data point as \a key, \a open, \a high, \a low and \a close to the current
+  data.
+  
+  Alternatively, you can also access and modify the data directly via the \ref data method, which
+  returns a pointer to the internal data container.
+  
+  \see timeSeriesToOhlc
+*/
+void QCPFinancial::addData(double key, double open, double high, double low, double close)
+{
+  mDataContainer->add(QCPFinancialData(key, open, high, low, close));
+}
+
+/*!
+  \copydoc QCPPlottableInterface1D::selectTestRect
+*/
+QCPDataSelection QCPFinancial::selectTestRect(const QRectF &rect, bool onlySelectable) const
+{
+  QCPDataSelection result;
+  if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
+    return result;
+  if (!mKeyAxis || !mValueAxis)
+    return result;
+  
+  QCPFinancialDataContainer::const_iterator visibleBegin, visibleEnd;
+  getVisibleDataBounds(visibleBegin, visibleEnd);
+  
+  for (QCPFinancialDataContainer::const_iterator it=visibleBegin; it!=visibleEnd; ++it)
+  {
+    if (rect.intersects(selectionHitBox(it)))
+      result.addDataRange(QCPDataRange(int(it-mDataContainer->constBegin()), int(it-mDataContainer->constBegin()+1)), false);
+  }
+  result.simplify();
+  return result;
+}
+
+/*!
+  Implements a selectTest specific to this plottable's point geometry.
+
+  If \a details is not 0, it will be set to a \ref QCPDataSelection, describing the closest data
+  point to \a pos.
+  
+  \seebaseclassmethod \ref QCPAbstractPlottable::selectTest
+*/
+double QCPFinancial::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
+{
+  Q_UNUSED(details)
+  if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
+    return -1;
+  if (!mKeyAxis || !mValueAxis)
+    return -1;
+  
+  if (mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()) || mParentPlot->interactions().testFlag(QCP::iSelectPlottablesBeyondAxisRect))
+  {
+    // get visible data range:
+    QCPFinancialDataContainer::const_iterator visibleBegin, visibleEnd;
+    QCPFinancialDataContainer::const_iterator closestDataPoint = mDataContainer->constEnd();
+    getVisibleDataBounds(visibleBegin, visibleEnd);
+    // perform select test according to configured style:
+    double result = -1;
+    switch (mChartStyle)
+    {
+      case QCPFinancial::csOhlc:
+        result = ohlcSelectTest(pos, visibleBegin, visibleEnd, closestDataPoint); break;
+      case QCPFinancial::csCandlestick:
+        result = candlestickSelectTest(pos, visibleBegin, visibleEnd, closestDataPoint); break;
+    }
+    if (details)
+    {
+      int pointIndex = int(closestDataPoint-mDataContainer->constBegin());
+      details->setValue(QCPDataSelection(QCPDataRange(pointIndex, pointIndex+1)));
+    }
+    return result;
+  }
+  
+  return -1;
+}
+
+/* inherits documentation from base class */
+QCPRange QCPFinancial::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
+{
+  QCPRange range = mDataContainer->keyRange(foundRange, inSignDomain);
+  // determine exact range by including width of bars/flags:
+  if (foundRange)
+  {
+    if (inSignDomain != QCP::sdPositive || range.lower-mWidth*0.5 > 0)
+      range.lower -= mWidth*0.5;
+    if (inSignDomain != QCP::sdNegative || range.upper+mWidth*0.5 < 0)
+      range.upper += mWidth*0.5;
+  }
+  return range;
+}
+
+/* inherits documentation from base class */
+QCPRange QCPFinancial::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
+{
+  return mDataContainer->valueRange(foundRange, inSignDomain, inKeyRange);
+}
+
+/*!
+  A convenience function that converts time series data (\a value against \a time) to OHLC binned
+  data points. The return value can then be passed on to \ref QCPFinancialDataContainer::set(const
+  QCPFinancialDataContainer&).
+  
+  The size of the bins can be controlled with \a timeBinSize in the same units as \a time is given.
+  For example, if the unit of \a time is seconds and single OHLC/Candlesticks should span an hour
+  each, set \a timeBinSize to 3600.
+  
+  \a timeBinOffset allows to control precisely at what \a time coordinate a bin should start. The
+  value passed as \a timeBinOffset doesn't need to be in the range encompassed by the \a time keys.
+  It merely defines the mathematical offset/phase of the bins that will be used to process the
+  data.
+*/
+QCPFinancialDataContainer QCPFinancial::timeSeriesToOhlc(const QVector<double> &time, const QVector<double> &value, double timeBinSize, double timeBinOffset)
+{
+  QCPFinancialDataContainer data;
+  int count = qMin(time.size(), value.size());
+  if (count == 0)
+    return QCPFinancialDataContainer();
+  
+  QCPFinancialData currentBinData(0, value.first(), value.first(), value.first(), value.first());
+  int currentBinIndex = qFloor((time.first()-timeBinOffset)/timeBinSize+0.5);
+  for (int i=0; i<count; ++i)
+  {
+    int index = qFloor((time.at(i)-timeBinOffset)/timeBinSize+0.5);
+    if (currentBinIndex == index) // data point still in current bin, extend high/low:
+    {
+      if (value.at(i) < currentBinData.low) currentBinData.low = value.at(i);
+      if (value.at(i) > currentBinData.high) currentBinData.high = value.at(i);
+      if (i == count-1) // last data point is in current bin, finalize bin:
+      {
+        currentBinData.close = value.at(i);
+        currentBinData.key = timeBinOffset+(index)*timeBinSize;
+        data.add(currentBinData);
+      }
+    } else // data point not anymore in current bin, set close of old and open of new bin, and add old to map:
+    {
+      // finalize current bin:
+      currentBinData.close = value.at(i-1);
+      currentBinData.key = timeBinOffset+(index-1)*timeBinSize;
+      data.add(currentBinData);
+      // start next bin:
+      currentBinIndex = index;
+      currentBinData.open = value.at(i);
+      currentBinData.high = value.at(i);
+      currentBinData.low = value.at(i);
+    }
+  }
+  
+  return data;
+}
+
+/* inherits documentation from base class */
+void QCPFinancial::draw(QCPPainter *painter)
+{
+  // get visible data range:
+  QCPFinancialDataContainer::const_iterator visibleBegin, visibleEnd;
+  getVisibleDataBounds(visibleBegin, visibleEnd);
+  
+  // loop over and draw segments of unselected/selected data:
+  QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
+  getDataSegments(selectedSegments, unselectedSegments);
+  allSegments << unselectedSegments << selectedSegments;
+  for (int i=0; i<allSegments.size(); ++i)
+  {
+    bool isSelectedSegment = i >= unselectedSegments.size();
+    QCPFinancialDataContainer::const_iterator begin = visibleBegin;
+    QCPFinancialDataContainer::const_iterator end = visibleEnd;
+    mDataContainer->limitIteratorsToDataRange(begin, end, allSegments.at(i));
+    if (begin == end)
+      continue;
+    
+    // draw data segment according to configured style:
+    switch (mChartStyle)
+    {
+      case QCPFinancial::csOhlc:
+        drawOhlcPlot(painter, begin, end, isSelectedSegment); break;
+      case QCPFinancial::csCandlestick:
+        drawCandlestickPlot(painter, begin, end, isSelectedSegment); break;
+    }
+  }
+  
+  // draw other selection decoration that isn't just line/scatter pens and brushes:
+  if (mSelectionDecorator)
+    mSelectionDecorator->drawDecoration(painter, selection());
+}
+
+/* inherits documentation from base class */
+void QCPFinancial::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
+{
+  painter->setAntialiasing(false); // legend icon especially of csCandlestick looks better without antialiasing
+  if (mChartStyle == csOhlc)
+  {
+    if (mTwoColored)
+    {
+      // draw upper left half icon with positive color:
+      painter->setBrush(mBrushPositive);
+      painter->setPen(mPenPositive);
+      painter->setClipRegion(QRegion(QPolygon() << rect.bottomLeft().toPoint() << rect.topRight().toPoint() << rect.topLeft().toPoint()));
+      painter->drawLine(QLineF(0, rect.height()*0.5, rect.width(), rect.height()*0.5).translated(rect.topLeft()));
+      painter->drawLine(QLineF(rect.width()*0.2, rect.height()*0.3, rect.width()*0.2, rect.height()*0.5).translated(rect.topLeft()));
+      painter->drawLine(QLineF(rect.width()*0.8, rect.height()*0.5, rect.width()*0.8, rect.height()*0.7).translated(rect.topLeft()));
+      // draw bottom right half icon with negative color:
+      painter->setBrush(mBrushNegative);
+      painter->setPen(mPenNegative);
+      painter->setClipRegion(QRegion(QPolygon() << rect.bottomLeft().toPoint() << rect.topRight().toPoint() << rect.bottomRight().toPoint()));
+      painter->drawLine(QLineF(0, rect.height()*0.5, rect.width(), rect.height()*0.5).translated(rect.topLeft()));
+      painter->drawLine(QLineF(rect.width()*0.2, rect.height()*0.3, rect.width()*0.2, rect.height()*0.5).translated(rect.topLeft()));
+      painter->drawLine(QLineF(rect.width()*0.8, rect.height()*0.5, rect.width()*0.8, rect.height()*0.7).translated(rect.topLeft()));
+    } else
+    {
+      painter->setBrush(mBrush);
+      painter->setPen(mPen);
+      painter->drawLine(QLineF(0, rect.height()*0.5, rect.width(), rect.height()*0.5).translated(rect.topLeft()));
+      painter->drawLine(QLineF(rect.width()*0.2, rect.height()*0.3, rect.width()*0.2, rect.height()*0.5).translated(rect.topLeft()));
+      painter->drawLine(QLineF(rect.width()*0.8, rect.height()*0.5, rect.width()*0.8, rect.height()*0.7).translated(rect.topLeft()));
+    }
+  } else if (mChartStyle == csCandlestick)
+  {
+    if (mTwoColored)
+    {
+      // draw upper left half icon with positive color:
+      painter->setBrush(mBrushPositive);
+      painter->setPen(mPenPositive);
+      painter->setClipRegion(QRegion(QPolygon() << rect.bottomLeft().toPoint() << rect.topRight().toPoint() << rect.topLeft().toPoint()));
+      painter->drawLine(QLineF(0, rect.height()*0.5, rect.width()*0.25, rect.height()*0.5).translated(rect.topLeft()));
+      painter->drawLine(QLineF(rect.width()*0.75, rect.height()*0.5, rect.width(), rect.height()*0.5).translated(rect.topLeft()));
+      painter->drawRect(QRectF(rect.width()*0.25, rect.height()*0.25, rect.width()*0.5, rect.height()*0.5).translated(rect.topLeft()));
+      // draw bottom right half icon with negative color:
+      painter->setBrush(mBrushNegative);
+      painter->setPen(mPenNegative);
+      painter->setClipRegion(QRegion(QPolygon() << rect.bottomLeft().toPoint() << rect.topRight().toPoint() << rect.bottomRight().toPoint()));
+      painter->drawLine(QLineF(0, rect.height()*0.5, rect.width()*0.25, rect.height()*0.5).translated(rect.topLeft()));
+      painter->drawLine(QLineF(rect.width()*0.75, rect.height()*0.5, rect.width(), rect.height()*0.5).translated(rect.topLeft()));
+      painter->drawRect(QRectF(rect.width()*0.25, rect.height()*0.25, rect.width()*0.5, rect.height()*0.5).translated(rect.topLeft()));
+    } else
+    {
+      painter->setBrush(mBrush);
+      painter->setPen(mPen);
+      painter->drawLine(QLineF(0, rect.height()*0.5, rect.width()*0.25, rect.height()*0.5).translated(rect.topLeft()));
+      painter->drawLine(QLineF(rect.width()*0.75, rect.height()*0.5, rect.width(), rect.height()*0.5).translated(rect.topLeft()));
+      painter->drawRect(QRectF(rect.width()*0.25, rect.height()*0.25, rect.width()*0.5, rect.height()*0.5).translated(rect.topLeft()));
+    }
+  }
+}
+
+/*! \internal
+  
+  Draws the data from \a begin to \a end-1 as OHLC bars with the provided \a painter.
+
+  This method is a helper function for \ref draw. It is used when the chart style is \ref csOhlc.
+*/
+void QCPFinancial::drawOhlcPlot(QCPPainter *painter, const QCPFinancialDataContainer::const_iterator &begin, const QCPFinancialDataContainer::const_iterator &end, bool isSelected)
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
+  
+  if (keyAxis->orientation() == Qt::Horizontal)
+  {
+    for (QCPFinancialDataContainer::const_iterator it = begin; it != end; ++it)
+    {
+      if (isSelected && mSelectionDecorator)
+        mSelectionDecorator->applyPen(painter);
+      else if (mTwoColored)
+        painter->setPen(it->close >= it->open ? mPenPositive : mPenNegative);
+      else
+        painter->setPen(mPen);
+      double keyPixel = keyAxis->coordToPixel(it->key);
+      double openPixel = valueAxis->coordToPixel(it->open);
+      double closePixel = valueAxis->coordToPixel(it->close);
+      // draw backbone:
+      painter->drawLine(QPointF(keyPixel, valueAxis->coordToPixel(it->high)), QPointF(keyPixel, valueAxis->coordToPixel(it->low)));
+      // draw open:
+      double pixelWidth = getPixelWidth(it->key, keyPixel); // sign of this makes sure open/close are on correct sides
+      painter->drawLine(QPointF(keyPixel-pixelWidth, openPixel), QPointF(keyPixel, openPixel));
+      // draw close:
+      painter->drawLine(QPointF(keyPixel, closePixel), QPointF(keyPixel+pixelWidth, closePixel));
+    }
+  } else
+  {
+    for (QCPFinancialDataContainer::const_iterator it = begin; it != end; ++it)
+    {
+      if (isSelected && mSelectionDecorator)
+        mSelectionDecorator->applyPen(painter);
+      else if (mTwoColored)
+        painter->setPen(it->close >= it->open ? mPenPositive : mPenNegative);
+      else
+        painter->setPen(mPen);
+      double keyPixel = keyAxis->coordToPixel(it->key);
+      double openPixel = valueAxis->coordToPixel(it->open);
+      double closePixel = valueAxis->coordToPixel(it->close);
+      // draw backbone:
+      painter->drawLine(QPointF(valueAxis->coordToPixel(it->high), keyPixel), QPointF(valueAxis->coordToPixel(it->low), keyPixel));
+      // draw open:
+      double pixelWidth = getPixelWidth(it->key, keyPixel); // sign of this makes sure open/close are on correct sides
+      painter->drawLine(QPointF(openPixel, keyPixel-pixelWidth), QPointF(openPixel, keyPixel));
+      // draw close:
+      painter->drawLine(QPointF(closePixel, keyPixel), QPointF(closePixel, keyPixel+pixelWidth));
+    }
+  }
+}
+
+/*! \internal
+  
+  Draws the data from \a begin to \a end-1 as Candlesticks with the provided \a painter.
+
+  This method is a helper function for \ref draw. It is used when the chart style is \ref csCandlestick.
+*/
+void QCPFinancial::drawCandlestickPlot(QCPPainter *painter, const QCPFinancialDataContainer::const_iterator &begin, const QCPFinancialDataContainer::const_iterator &end, bool isSelected)
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
+  
+  if (keyAxis->orientation() == Qt::Horizontal)
+  {
+    for (QCPFinancialDataContainer::const_iterator it = begin; it != end; ++it)
+    {
+      if (isSelected && mSelectionDecorator)
+      {
+        mSelectionDecorator->applyPen(painter);
+        mSelectionDecorator->applyBrush(painter);
+      } else if (mTwoColored)
+      {
+        painter->setPen(it->close >= it->open ? mPenPositive : mPenNegative);
+        painter->setBrush(it->close >= it->open ? mBrushPositive : mBrushNegative);
+      } else
+      {
+        painter->setPen(mPen);
+        painter->setBrush(mBrush);
+      }
+      double keyPixel = keyAxis->coordToPixel(it->key);
+      double openPixel = valueAxis->coordToPixel(it->open);
+      double closePixel = valueAxis->coordToPixel(it->close);
+      // draw high:
+      painter->drawLine(QPointF(keyPixel, valueAxis->coordToPixel(it->high)), QPointF(keyPixel, valueAxis->coordToPixel(qMax(it->open, it->close))));
+      // draw low:
+      painter->drawLine(QPointF(keyPixel, valueAxis->coordToPixel(it->low)), QPointF(keyPixel, valueAxis->coordToPixel(qMin(it->open, it->close))));
+      // draw open-close box:
+      double pixelWidth = getPixelWidth(it->key, keyPixel);
+      painter->drawRect(QRectF(QPointF(keyPixel-pixelWidth, closePixel), QPointF(keyPixel+pixelWidth, openPixel)));
+    }
+  } else // keyAxis->orientation() == Qt::Vertical
+  {
+    for (QCPFinancialDataContainer::const_iterator it = begin; it != end; ++it)
+    {
+      if (isSelected && mSelectionDecorator)
+      {
+        mSelectionDecorator->applyPen(painter);
+        mSelectionDecorator->applyBrush(painter);
+      } else if (mTwoColored)
+      {
+        painter->setPen(it->close >= it->open ? mPenPositive : mPenNegative);
+        painter->setBrush(it->close >= it->open ? mBrushPositive : mBrushNegative);
+      } else
+      {
+        painter->setPen(mPen);
+        painter->setBrush(mBrush);
+      }
+      double keyPixel = keyAxis->coordToPixel(it->key);
+      double openPixel = valueAxis->coordToPixel(it->open);
+      double closePixel = valueAxis->coordToPixel(it->close);
+      // draw high:
+      painter->drawLine(QPointF(valueAxis->coordToPixel(it->high), keyPixel), QPointF(valueAxis->coordToPixel(qMax(it->open, it->close)), keyPixel));
+      // draw low:
+      painter->drawLine(QPointF(valueAxis->coordToPixel(it->low), keyPixel), QPointF(valueAxis->coordToPixel(qMin(it->open, it->close)), keyPixel));
+      // draw open-close box:
+      double pixelWidth = getPixelWidth(it->key, keyPixel);
+      painter->drawRect(QRectF(QPointF(closePixel, keyPixel-pixelWidth), QPointF(openPixel, keyPixel+pixelWidth)));
+    }
+  }
+}
+
+/*! \internal
+
+  This function is used to determine the width of the bar at coordinate \a key, according to the
+  specified width (\ref setWidth) and width type (\ref setWidthType). Provide the pixel position of
+  \a key in \a keyPixel (because usually this was already calculated via \ref QCPAxis::coordToPixel
+  when this function is called).
+
+  It returns the number of pixels the bar extends to higher keys, relative to the \a key
+  coordinate. So with a non-reversed horizontal axis, the return value is positive. With a reversed
+  horizontal axis, the return value is negative. This is important so the open/close flags on the
+  \ref csOhlc bar are drawn to the correct side.
+*/
+double QCPFinancial::getPixelWidth(double key, double keyPixel) const
+{
+  double result = 0;
+  switch (mWidthType)
+  {
+    case wtAbsolute:
+    {
+      if (mKeyAxis)
+        result = mWidth*0.5*mKeyAxis.data()->pixelOrientation();
+      break;
+    }
     case wtAxisRectRatio:
     {
-      if (mKeyAxis && mKeyAxis.data()->axisRect())
+      if (mKeyAxis && mKeyAxis.data()->axisRect())
+      {
+        if (mKeyAxis.data()->orientation() == Qt::Horizontal)
+          result = mKeyAxis.data()->axisRect()->width()*mWidth*0.5*mKeyAxis.data()->pixelOrientation();
+        else
+          result = mKeyAxis.data()->axisRect()->height()*mWidth*0.5*mKeyAxis.data()->pixelOrientation();
+      } else
+        qDebug() << Q_FUNC_INFO << "No key axis or axis rect defined";
+      break;
+    }
+    case wtPlotCoords:
+    {
+      if (mKeyAxis)
+        result = mKeyAxis.data()->coordToPixel(key+mWidth*0.5)-keyPixel;
+      else
+        qDebug() << Q_FUNC_INFO << "No key axis defined";
+      break;
+    }
+  }
+  return result;
+}
+
+/*! \internal
+
+  This method is a helper function for \ref selectTest. It is used to test for selection when the
+  chart style is \ref csOhlc. It only tests against the data points between \a begin and \a end.
+  
+  Like \ref selectTest, this method returns the shortest distance of \a pos to the graphical
+  representation of the plottable, and \a closestDataPoint will point to the respective data point.
+*/
+double QCPFinancial::ohlcSelectTest(const QPointF &pos, const QCPFinancialDataContainer::const_iterator &begin, const QCPFinancialDataContainer::const_iterator &end, QCPFinancialDataContainer::const_iterator &closestDataPoint) const
+{
+  closestDataPoint = mDataContainer->constEnd();
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return -1; }
+
+  double minDistSqr = (std::numeric_limits<double>::max)();
+  if (keyAxis->orientation() == Qt::Horizontal)
+  {
+    for (QCPFinancialDataContainer::const_iterator it=begin; it!=end; ++it)
+    {
+      double keyPixel = keyAxis->coordToPixel(it->key);
+      // calculate distance to backbone:
+      double currentDistSqr = QCPVector2D(pos).distanceSquaredToLine(QCPVector2D(keyPixel, valueAxis->coordToPixel(it->high)), QCPVector2D(keyPixel, valueAxis->coordToPixel(it->low)));
+      if (currentDistSqr < minDistSqr)
+      {
+        minDistSqr = currentDistSqr;
+        closestDataPoint = it;
+      }
+    }
+  } else // keyAxis->orientation() == Qt::Vertical
+  {
+    for (QCPFinancialDataContainer::const_iterator it=begin; it!=end; ++it)
+    {
+      double keyPixel = keyAxis->coordToPixel(it->key);
+      // calculate distance to backbone:
+      double currentDistSqr = QCPVector2D(pos).distanceSquaredToLine(QCPVector2D(valueAxis->coordToPixel(it->high), keyPixel), QCPVector2D(valueAxis->coordToPixel(it->low), keyPixel));
+      if (currentDistSqr < minDistSqr)
+      {
+        minDistSqr = currentDistSqr;
+        closestDataPoint = it;
+      }
+    }
+  }
+  return qSqrt(minDistSqr);
+}
+
+/*! \internal
+  
+  This method is a helper function for \ref selectTest. It is used to test for selection when the
+  chart style is \ref csCandlestick. It only tests against the data points between \a begin and \a
+  end.
+  
+  Like \ref selectTest, this method returns the shortest distance of \a pos to the graphical
+  representation of the plottable, and \a closestDataPoint will point to the respective data point.
+*/
+double QCPFinancial::candlestickSelectTest(const QPointF &pos, const QCPFinancialDataContainer::const_iterator &begin, const QCPFinancialDataContainer::const_iterator &end, QCPFinancialDataContainer::const_iterator &closestDataPoint) const
+{
+  closestDataPoint = mDataContainer->constEnd();
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return -1; }
+
+  double minDistSqr = (std::numeric_limits<double>::max)();
+  if (keyAxis->orientation() == Qt::Horizontal)
+  {
+    for (QCPFinancialDataContainer::const_iterator it=begin; it!=end; ++it)
+    {
+      double currentDistSqr;
+      // determine whether pos is in open-close-box:
+      QCPRange boxKeyRange(it->key-mWidth*0.5, it->key+mWidth*0.5);
+      QCPRange boxValueRange(it->close, it->open);
+      double posKey, posValue;
+      pixelsToCoords(pos, posKey, posValue);
+      if (boxKeyRange.contains(posKey) && boxValueRange.contains(posValue)) // is in open-close-box
+      {
+        currentDistSqr = mParentPlot->selectionTolerance()*0.99 * mParentPlot->selectionTolerance()*0.99;
+      } else
+      {
+        // calculate distance to high/low lines:
+        double keyPixel = keyAxis->coordToPixel(it->key);
+        double highLineDistSqr = QCPVector2D(pos).distanceSquaredToLine(QCPVector2D(keyPixel, valueAxis->coordToPixel(it->high)), QCPVector2D(keyPixel, valueAxis->coordToPixel(qMax(it->open, it->close))));
+        double lowLineDistSqr = QCPVector2D(pos).distanceSquaredToLine(QCPVector2D(keyPixel, valueAxis->coordToPixel(it->low)), QCPVector2D(keyPixel, valueAxis->coordToPixel(qMin(it->open, it->close))));
+        currentDistSqr = qMin(highLineDistSqr, lowLineDistSqr);
+      }
+      if (currentDistSqr < minDistSqr)
+      {
+        minDistSqr = currentDistSqr;
+        closestDataPoint = it;
+      }
+    }
+  } else // keyAxis->orientation() == Qt::Vertical
+  {
+    for (QCPFinancialDataContainer::const_iterator it=begin; it!=end; ++it)
+    {
+      double currentDistSqr;
+      // determine whether pos is in open-close-box:
+      QCPRange boxKeyRange(it->key-mWidth*0.5, it->key+mWidth*0.5);
+      QCPRange boxValueRange(it->close, it->open);
+      double posKey, posValue;
+      pixelsToCoords(pos, posKey, posValue);
+      if (boxKeyRange.contains(posKey) && boxValueRange.contains(posValue)) // is in open-close-box
+      {
+        currentDistSqr = mParentPlot->selectionTolerance()*0.99 * mParentPlot->selectionTolerance()*0.99;
+      } else
+      {
+        // calculate distance to high/low lines:
+        double keyPixel = keyAxis->coordToPixel(it->key);
+        double highLineDistSqr = QCPVector2D(pos).distanceSquaredToLine(QCPVector2D(valueAxis->coordToPixel(it->high), keyPixel), QCPVector2D(valueAxis->coordToPixel(qMax(it->open, it->close)), keyPixel));
+        double lowLineDistSqr = QCPVector2D(pos).distanceSquaredToLine(QCPVector2D(valueAxis->coordToPixel(it->low), keyPixel), QCPVector2D(valueAxis->coordToPixel(qMin(it->open, it->close)), keyPixel));
+        currentDistSqr = qMin(highLineDistSqr, lowLineDistSqr);
+      }
+      if (currentDistSqr < minDistSqr)
+      {
+        minDistSqr = currentDistSqr;
+        closestDataPoint = it;
+      }
+    }
+  }
+  return qSqrt(minDistSqr);
+}
+
+/*! \internal
+  
+  called by the drawing methods to determine which data (key) range is visible at the current key
+  axis range setting, so only that needs to be processed.
+  
+  \a begin returns an iterator to the lowest data point that needs to be taken into account when
+  plotting. Note that in order to get a clean plot all the way to the edge of the axis rect, \a
+  begin may still be just outside the visible range.
+  
+  \a end returns the iterator just above the highest data point that needs to be taken into
+  account. Same as before, \a end may also lie just outside of the visible range
+  
+  if the plottable contains no data, both \a begin and \a end point to \c constEnd.
+*/
+void QCPFinancial::getVisibleDataBounds(QCPFinancialDataContainer::const_iterator &begin, QCPFinancialDataContainer::const_iterator &end) const
+{
+  if (!mKeyAxis)
+  {
+    qDebug() << Q_FUNC_INFO << "invalid key axis";
+    begin = mDataContainer->constEnd();
+    end = mDataContainer->constEnd();
+    return;
+  }
+  begin = mDataContainer->findBegin(mKeyAxis.data()->range().lower-mWidth*0.5); // subtract half width of ohlc/candlestick to include partially visible data points
+  end = mDataContainer->findEnd(mKeyAxis.data()->range().upper+mWidth*0.5); // add half width of ohlc/candlestick to include partially visible data points
+}
+
+/*!  \internal
+
+  Returns the hit box in pixel coordinates that will be used for data selection with the selection
+  rect (\ref selectTestRect), of the data point given by \a it.
+*/
+QRectF QCPFinancial::selectionHitBox(QCPFinancialDataContainer::const_iterator it) const
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return {}; }
+  
+  double keyPixel = keyAxis->coordToPixel(it->key);
+  double highPixel = valueAxis->coordToPixel(it->high);
+  double lowPixel = valueAxis->coordToPixel(it->low);
+  double keyWidthPixels = keyPixel-keyAxis->coordToPixel(it->key-mWidth*0.5);
+  if (keyAxis->orientation() == Qt::Horizontal)
+    return QRectF(keyPixel-keyWidthPixels, highPixel, keyWidthPixels*2, lowPixel-highPixel).normalized();
+  else
+    return QRectF(highPixel, keyPixel-keyWidthPixels, lowPixel-highPixel, keyWidthPixels*2).normalized();
+}
+/* end of 'src/plottables/plottable-financial.cpp' */
+
+
+/* including file 'src/plottables/plottable-errorbar.cpp' */
+/* modified 2022-11-06T12:45:56, size 37679               */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPErrorBarsData
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPErrorBarsData
+  \brief Holds the data of one single error bar for QCPErrorBars.
+
+  The stored data is:
+  \li \a errorMinus: how much the error bar extends towards negative coordinates from the data
+  point position
+  \li \a errorPlus: how much the error bar extends towards positive coordinates from the data point
+  position
+
+  The container for storing the error bar information is \ref QCPErrorBarsDataContainer. It is a
+  typedef for <tt>QVector<\ref QCPErrorBarsData></tt>.
+
+  \see QCPErrorBarsDataContainer
+*/
+
+/*!
+  Constructs an error bar with errors set to zero.
+*/
+QCPErrorBarsData::QCPErrorBarsData() :
+  errorMinus(0),
+  errorPlus(0)
+{
+}
+
+/*!
+  Constructs an error bar with equal \a error in both negative and positive direction.
+*/
+QCPErrorBarsData::QCPErrorBarsData(double error) :
+  errorMinus(error),
+  errorPlus(error)
+{
+}
+
+/*!
+  Constructs an error bar with negative and positive errors set to \a errorMinus and \a errorPlus,
+  respectively.
+*/
+QCPErrorBarsData::QCPErrorBarsData(double errorMinus, double errorPlus) :
+  errorMinus(errorMinus),
+  errorPlus(errorPlus)
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPErrorBars
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPErrorBars
+  \brief A plottable that adds a set of error bars to other plottables.
+
+  \image html QCPErrorBars.png
+
+  The \ref QCPErrorBars plottable can be attached to other one-dimensional plottables (e.g. \ref
+  QCPGraph, \ref QCPCurve, \ref QCPBars, etc.) and equips them with error bars.
+
+  Use \ref setDataPlottable to define for which plottable the \ref QCPErrorBars shall display the
+  error bars. The orientation of the error bars can be controlled with \ref setErrorType.
+
+  By using \ref setData, you can supply the actual error data, either as symmetric error or
+  plus/minus asymmetric errors. \ref QCPErrorBars only stores the error data. The absolute
+  key/value position of each error bar will be adopted from the configured data plottable. The
+  error data of the \ref QCPErrorBars are associated one-to-one via their index to the data points
+  of the data plottable. You can directly access and manipulate the error bar data via \ref data.
+
+  Set either of the plus/minus errors to NaN (<tt>qQNaN()</tt> or
+  <tt>std::numeric_limits<double>::quiet_NaN()</tt>) to not show the respective error bar on the data point at
+  that index.
+
+  \section qcperrorbars-appearance Changing the appearance
+
+  The appearance of the error bars is defined by the pen (\ref setPen), and the width of the
+  whiskers (\ref setWhiskerWidth). Further, the error bar backbones may leave a gap around the data
+  point center to prevent that error bars are drawn too close to or even through scatter points.
+  This gap size can be controlled via \ref setSymbolGap.
+*/
+
+/* start of documentation of inline functions */
+
+/*! \fn QSharedPointer<QCPErrorBarsDataContainer> QCPErrorBars::data() const
+
+  Returns a shared pointer to the internal data storage of type \ref QCPErrorBarsDataContainer. You
+  may use it to directly manipulate the error values, which may be more convenient and faster than
+  using the regular \ref setData methods.
+*/
+
+/* end of documentation of inline functions */
+
+/*!
+  Constructs an error bars plottable which uses \a keyAxis as its key axis ("x") and \a valueAxis as its value
+  axis ("y"). \a keyAxis and \a valueAxis must reside in the same QCustomPlot instance and not have
+  the same orientation. If either of these restrictions is violated, a corresponding message is
+  printed to the debug output (qDebug), the construction is not aborted, though.
+
+  It is also important that the \a keyAxis and \a valueAxis are the same for the error bars
+  plottable and the data plottable that the error bars shall be drawn on (\ref setDataPlottable).
+
+  The created \ref QCPErrorBars is automatically registered with the QCustomPlot instance inferred
+  from \a keyAxis. This QCustomPlot instance takes ownership of the \ref QCPErrorBars, so do not
+  delete it manually but use \ref QCustomPlot::removePlottable() instead.
+*/
+QCPErrorBars::QCPErrorBars(QCPAxis *keyAxis, QCPAxis *valueAxis) :
+  QCPAbstractPlottable(keyAxis, valueAxis),
+  mDataContainer(new QVector<QCPErrorBarsData>),
+  mErrorType(etValueError),
+  mWhiskerWidth(9),
+  mSymbolGap(10),
+  mAdaptiveSampling(true)
+{
+  setPen(QPen(Qt::black, 0));
+  setBrush(Qt::NoBrush);
+}
+
+QCPErrorBars::~QCPErrorBars()
+{
+}
+
+/*! \overload
+
+  Replaces the current data container with the provided \a data container.
+
+  Since a QSharedPointer is used, multiple \ref QCPErrorBars instances may share the same data
+  container safely. Modifying the data in the container will then affect all \ref QCPErrorBars
+  instances that share the container. Sharing can be achieved by simply exchanging the data
+  containers wrapped in shared pointers:
+  \snippet documentation/doc-code-snippets/mainwindow.cpp qcperrorbars-datasharing-1
+
+  If you do not wish to share containers, but create a copy from an existing container, assign the
+  data containers directly:
+  \snippet documentation/doc-code-snippets/mainwindow.cpp qcperrorbars-datasharing-2
+  (This uses different notation compared with other plottables, because the \ref QCPErrorBars
+  uses a \c QVector<QCPErrorBarsData> as its data container, instead of a \ref QCPDataContainer.)
+
+  \see addData
+*/
+void QCPErrorBars::setData(QSharedPointer<QCPErrorBarsDataContainer> data)
+{
+  mDataContainer = data;
+}
+
+/*! \overload
+
+  Sets symmetrical error values as specified in \a error. The errors will be associated one-to-one
+  by the data point index to the associated data plottable (\ref setDataPlottable).
+
+  You can directly access and manipulate the error bar data via \ref data.
+
+  \see addData
+*/
+void QCPErrorBars::setData(const QVector<double> &error)
+{
+  mDataContainer->clear();
+  addData(error);
+}
+
+/*! \overload
+
+  Sets asymmetrical errors as specified in \a errorMinus and \a errorPlus. The errors will be
+  associated one-to-one by the data point index to the associated data plottable (\ref
+  setDataPlottable).
+
+  You can directly access and manipulate the error bar data via \ref data.
+
+  \see addData
+*/
+void QCPErrorBars::setData(const QVector<double> &errorMinus, const QVector<double> &errorPlus)
+{
+  mDataContainer->clear();
+  addData(errorMinus, errorPlus);
+}
+
+/*!
+  Sets the data plottable to which the error bars will be applied. The error values specified e.g.
+  via \ref setData will be associated one-to-one by the data point index to the data points of \a
+  plottable. This means that the error bars will adopt the key/value coordinates of the data point
+  with the same index.
+
+  The passed \a plottable must be a one-dimensional plottable, i.e. it must implement the \ref
+  QCPPlottableInterface1D. Further, it must not be a \ref QCPErrorBars instance itself. If either
+  of these restrictions is violated, a corresponding qDebug output is generated, and the data
+  plottable of this \ref QCPErrorBars instance is set to zero.
+
+  For proper display, care must also be taken that the key and value axes of the \a plottable match
+  those configured for this \ref QCPErrorBars instance.
+*/
+void QCPErrorBars::setDataPlottable(QCPAbstractPlottable *plottable)
+{
+  if (plottable && qobject_cast<QCPErrorBars*>(plottable))
+  {
+    mDataPlottable = nullptr;
+    qDebug() << Q_FUNC_INFO << "can't set another QCPErrorBars instance as data plottable";
+    return;
+  }
+  if (plottable && !plottable->interface1D())
+  {
+    mDataPlottable = nullptr;
+    qDebug() << Q_FUNC_INFO << "passed plottable doesn't implement 1d interface, can't associate with QCPErrorBars";
+    return;
+  }
+  
+  mDataPlottable = plottable;
+}
+
+/*!
+  Sets in which orientation the error bars shall appear on the data points. If your data needs both
+  error dimensions, create two \ref QCPErrorBars with different \a type.
+*/
+void QCPErrorBars::setErrorType(ErrorType type)
+{
+  mErrorType = type;
+}
+
+/*!
+  Sets the width of the whiskers (the short bars at the end of the actual error bar backbones) to
+  \a pixels.
+*/
+void QCPErrorBars::setWhiskerWidth(double pixels)
+{
+  mWhiskerWidth = pixels;
+}
+
+/*!
+  Sets the gap diameter around the data points that will be left out when drawing the error bar
+  backbones. This gap prevents that error bars are drawn too close to or even through scatter
+  points.
+*/
+void QCPErrorBars::setSymbolGap(double pixels)
+{
+  mSymbolGap = pixels;
+}
+
+/*!
+  Sets whether adaptive sampling shall be used when drawing the error bars. This can drastically
+  improve the replot performance when a large number of error bars is visible at once.
+
+  With adaptive sampling, error bars whose total extent along the error axis is smaller than one
+  pixel are not drawn, since they would be hidden behind the data point anyway. If there are more
+  than twice as many visible error bars as pixels along the orthogonal axis (the same factor
+  QCPGraph uses for its adaptive sampling), consecutive error bars that fall into the same pixel
+  column are merged into a single bar spanning all of them. The symbol gap (\ref setSymbolGap) is
+  not applied to merged bars.
+
+  Adaptive sampling is only used if the data plottable is sorted by its main key (see \ref
+  QCPPlottableInterface1D::sortKeyIsMainKey). By default, adaptive sampling is enabled.
+*/
+void QCPErrorBars::setAdaptiveSampling(bool enabled)
+{
+  mAdaptiveSampling = enabled;
+}
+
+/*! \overload
+
+  Adds symmetrical error values as specified in \a error. The errors will be associated one-to-one
+  by the data point index to the associated data plottable (\ref setDataPlottable).
+
+  You can directly access and manipulate the error bar data via \ref data.
+
+  \see setData
+*/
+void QCPErrorBars::addData(const QVector<double> &error)
+{
+  addData(error, error);
+}
+
+/*! \overload
+
+  Adds asymmetrical errors as specified in \a errorMinus and \a errorPlus. The errors will be
+  associated one-to-one by the data point index to the associated data plottable (\ref
+  setDataPlottable).
+
+  You can directly access and manipulate the error bar data via \ref data.
+
+  \see setData
+*/
+void QCPErrorBars::addData(const QVector<double> &errorMinus, const QVector<double> &errorPlus)
+{
+  if (errorMinus.size() != errorPlus.size())
+    qDebug() << Q_FUNC_INFO << "minus and plus error vectors have different sizes:" << errorMinus.size() << errorPlus.size();
+  const int n = qMin(errorMinus.size(), errorPlus.size());
+  mDataContainer->reserve(n);
+  for (int i=0; i<n; ++i)
+    mDataContainer->append(QCPErrorBarsData(errorMinus.at(i), errorPlus.at(i)));
+}
+
+/*! \overload
+
+  Adds a single symmetrical error bar as specified in \a error. The errors will be associated
+  one-to-one by the data point index to the associated data plottable (\ref setDataPlottable).
+
+  You can directly access and manipulate the error bar data via \ref data.
+
+  \see setData
+*/
+void QCPErrorBars::addData(double error)
+{
+  mDataContainer->append(QCPErrorBarsData(error));
+}
+
+/*! \overload
+
+  Adds a single asymmetrical error bar as specified in \a errorMinus and \a errorPlus. The errors
+  will be associated one-to-one by the data point index to the associated data plottable (\ref
+  setDataPlottable).
+
+  You can directly access and manipulate the error bar data via \ref data.
+
+  \see setData
+*/
+void QCPErrorBars::addData(double errorMinus, double errorPlus)
+{
+  mDataContainer->append(QCPErrorBarsData(errorMinus, errorPlus));
+}
+
+/* inherits documentation from base class */
+int QCPErrorBars::dataCount() const
+{
+  return mDataContainer->size();
+}
+
+/* inherits documentation from base class */
+double QCPErrorBars::dataMainKey(int index) const
+{
+  if (mDataPlottable)
+    return mDataPlottable->interface1D()->dataMainKey(index);
+  else
+    qDebug() << Q_FUNC_INFO << "no data plottable set";
+  return 0;
+}
+
+/* inherits documentation from base class */
+double QCPErrorBars::dataSortKey(int index) const
+{
+  if (mDataPlottable)
+    return mDataPlottable->interface1D()->dataSortKey(index);
+  else
+    qDebug() << Q_FUNC_INFO << "no data plottable set";
+  return 0;
+}
+
+/* inherits documentation from base class */
+double QCPErrorBars::dataMainValue(int index) const
+{
+  if (mDataPlottable)
+    return mDataPlottable->interface1D()->dataMainValue(index);
+  else
+    qDebug() << Q_FUNC_INFO << "no data plottable set";
+  return 0;
+}
+
+/* inherits documentation from base class */
+QCPRange QCPErrorBars::dataValueRange(int index) const
+{
+  if (mDataPlottable)
+  {
+    const double value = mDataPlottable->interface1D()->dataMainValue(index);
+    if (index >= 0 && index < mDataContainer->size() && mErrorType == etValueError)
+      return {value-mDataContainer->at(index).errorMinus, value+mDataContainer->at(index).errorPlus};
+    else
+      return {value, value};
+  } else
+  {
+    qDebug() << Q_FUNC_INFO << "no data plottable set";
+    return {};
+  }
+}
+
+/* inherits documentation from base class */
+QPointF QCPErrorBars::dataPixelPosition(int index) const
+{
+  if (mDataPlottable)
+    return mDataPlottable->interface1D()->dataPixelPosition(index);
+  else
+    qDebug() << Q_FUNC_INFO << "no data plottable set";
+  return {};
+}
+
+/* inherits documentation from base class */
+bool QCPErrorBars::sortKeyIsMainKey() const
+{
+  if (mDataPlottable)
+  {
+    return mDataPlottable->interface1D()->sortKeyIsMainKey();
+  } else
+  {
+    qDebug() << Q_FUNC_INFO << "no data plottable set";
+    return true;
+  }
+}
+
+/*!
+  \copydoc QCPPlottableInterface1D::selectTestRect
+*/
+QCPDataSelection QCPErrorBars::selectTestRect(const QRectF &rect, bool onlySelectable) const
+{
+  QCPDataSelection result;
+  if (!mDataPlottable)
+    return result;
+  if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
+    return result;
+  if (!mKeyAxis || !mValueAxis)
+    return result;
+  
+  QCPErrorBarsDataContainer::const_iterator visibleBegin, visibleEnd;
+  getVisibleDataBounds(visibleBegin, visibleEnd, QCPDataRange(0, dataCount()));
+  
+  QVector<QLineF> backbones, whiskers;
+  for (QCPErrorBarsDataContainer::const_iterator it=visibleBegin; it!=visibleEnd; ++it)
+  {
+    backbones.clear();
+    whiskers.clear();
+    getErrorBarLines(it, backbones, whiskers);
+    foreach (const QLineF &backbone, backbones)
+    {
+      if (rectIntersectsLine(rect, backbone))
+      {
+        result.addDataRange(QCPDataRange(int(it-mDataContainer->constBegin()), int(it-mDataContainer->constBegin()+1)), false);
+        break;
+      }
+    }
+  }
+  result.simplify();
+  return result;
+}
+
+/* inherits documentation from base class */
+int QCPErrorBars::findBegin(double sortKey, bool expandedRange) const
+{
+  if (mDataPlottable)
+  {
+    if (mDataContainer->isEmpty())
+      return 0;
+    int beginIndex = mDataPlottable->interface1D()->findBegin(sortKey, expandedRange);
+    if (beginIndex >= mDataContainer->size())
+      beginIndex = mDataContainer->size()-1;
+    return beginIndex;
+  } else
+    qDebug() << Q_FUNC_INFO << "no data plottable set";
+  return 0;
+}
+
+/* inherits documentation from base class */
+int QCPErrorBars::findEnd(double sortKey, bool expandedRange) const
+{
+  if (mDataPlottable)
+  {
+    if (mDataContainer->isEmpty())
+      return 0;
+    int endIndex = mDataPlottable->interface1D()->findEnd(sortKey, expandedRange);
+    if (endIndex > mDataContainer->size())
+      endIndex = mDataContainer->size();
+    return endIndex;
+  } else
+    qDebug() << Q_FUNC_INFO << "no data plottable set";
+  return 0;
+}
+
+/*!
+  Implements a selectTest specific to this plottable's point geometry.
+
+  If \a details is not 0, it will be set to a \ref QCPDataSelection, describing the closest data
+  point to \a pos.
+  
+  \seebaseclassmethod \ref QCPAbstractPlottable::selectTest
+*/
+double QCPErrorBars::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
+{
+  if (!mDataPlottable) return -1;
+  
+  if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
+    return -1;
+  if (!mKeyAxis || !mValueAxis)
+    return -1;
+  
+  if (mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()) || mParentPlot->interactions().testFlag(QCP::iSelectPlottablesBeyondAxisRect))
+  {
+    QCPErrorBarsDataContainer::const_iterator closestDataPoint = mDataContainer->constEnd();
+    double result = pointDistance(pos, closestDataPoint);
+    if (details)
+    {
+      int pointIndex = int(closestDataPoint-mDataContainer->constBegin());
+      details->setValue(QCPDataSelection(QCPDataRange(pointIndex, pointIndex+1)));
+    }
+    return result;
+  } else
+    return -1;
+}
+
+/* inherits documentation from base class */
+void QCPErrorBars::draw(QCPPainter *painter)
+{
+  if (!mDataPlottable) return;
+  if (!mKeyAxis || !mValueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
+  if (mKeyAxis.data()->range().size() <= 0 || mDataContainer->isEmpty()) return;
+  
+  // if the sort key isn't the main key, we must check the visibility for each data point/error bar individually
+  // (getVisibleDataBounds applies range restriction, but otherwise can only return full data range):
+  bool checkPointVisibility = !mDataPlottable->interface1D()->sortKeyIsMainKey();
+      
+    // check data validity if flag set:
+#ifdef QCUSTOMPLOT_CHECK_DATA
+  QCPErrorBarsDataContainer::const_iterator it;
+  for (it = mDataContainer->constBegin(); it != mDataContainer->constEnd(); ++it)
+  {
+    if (QCP::isInvalidData(it->errorMinus, it->errorPlus))
+      qDebug() << Q_FUNC_INFO << "Data point at index" << it-mDataContainer->constBegin() << "invalid." << "Plottable name:" << name();
+  }
+#endif
+  
+  applyDefaultAntialiasingHint(painter);
+  painter->setBrush(Qt::NoBrush);
+  // loop over and draw segments of unselected/selected data:
+  QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
+  getDataSegments(selectedSegments, unselectedSegments);
+  allSegments << unselectedSegments << selectedSegments;
+  for (int i=0; i<allSegments.size(); ++i)
+  {
+    QCPErrorBarsDataContainer::const_iterator begin, end;
+    getVisibleDataBounds(begin, end, allSegments.at(i));
+    if (begin == end)
+      continue;
+    
+    bool isSelectedSegment = i >= unselectedSegments.size();
+    if (isSelectedSegment && mSelectionDecorator)
+      mSelectionDecorator->applyPen(painter);
+    else
+      painter->setPen(mPen);
+    if (painter->pen().capStyle() == Qt::SquareCap)
+    {
+      QPen capFixPen(painter->pen());
+      capFixPen.setCapStyle(Qt::FlatCap);
+      painter->setPen(capFixPen);
+    }
+    // line buffers are members so their capacity is reused across segments and replots:
+    mBackboneLines.resize(0);
+    mWhiskerLines.resize(0);
+    if (mAdaptiveSampling && !checkPointVisibility)
+    {
+      getOptimizedErrorBarLines(begin, end, mBackboneLines, mWhiskerLines);
+    } else
+    {
+      for (QCPErrorBarsDataContainer::const_iterator it=begin; it!=end; ++it)
+      {
+        if (!checkPointVisibility || errorBarVisible(int(it-mDataContainer->constBegin())))
+          getErrorBarLines(it, mBackboneLines, mWhiskerLines);
+      }
+    }
+    painter->drawLines(mBackboneLines);
+    painter->drawLines(mWhiskerLines);
+  }
+  
+  // draw other selection decoration that isn't just line/scatter pens and brushes:
+  if (mSelectionDecorator)
+    mSelectionDecorator->drawDecoration(painter, selection());
+}
+
+/* inherits documentation from base class */
+void QCPErrorBars::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
+{
+  applyDefaultAntialiasingHint(painter);
+  painter->setPen(mPen);
+  if (mErrorType == etValueError && mValueAxis && mValueAxis->orientation() == Qt::Vertical)
+  {
+    painter->drawLine(QLineF(rect.center().x(), rect.top()+2, rect.center().x(), rect.bottom()-1));
+    painter->drawLine(QLineF(rect.center().x()-4, rect.top()+2, rect.center().x()+4, rect.top()+2));
+    painter->drawLine(QLineF(rect.center().x()-4, rect.bottom()-1, rect.center().x()+4, rect.bottom()-1));
+  } else
+  {
+    painter->drawLine(QLineF(rect.left()+2, rect.center().y(), rect.right()-2, rect.center().y()));
+    painter->drawLine(QLineF(rect.left()+2, rect.center().y()-4, rect.left()+2, rect.center().y()+4));
+    painter->drawLine(QLineF(rect.right()-2, rect.center().y()-4, rect.right()-2, rect.center().y()+4));
+  }
+}
+
+/* inherits documentation from base class */
+QCPRange QCPErrorBars::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
+{
+  if (!mDataPlottable)
+  {
+    foundRange = false;
+    return {};
+  }
+  
+  QCPRange range;
+  bool haveLower = false;
+  bool haveUpper = false;
+  QCPErrorBarsDataContainer::const_iterator it;
+  for (it = mDataContainer->constBegin(); it != mDataContainer->constEnd(); ++it)
+  {
+    if (mErrorType == etValueError)
+    {
+      // error bar doesn't extend in key dimension (except whisker but we ignore that here), so only use data point center
+      const double current = mDataPlottable->interface1D()->dataMainKey(int(it-mDataContainer->constBegin()));
+      if (qIsNaN(current)) continue;
+      if (inSignDomain == QCP::sdBoth || (inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
+      {
+        if (current < range.lower || !haveLower)
+        {
+          range.lower = current;
+          haveLower = true;
+        }
+        if (current > range.upper || !haveUpper)
+        {
+          range.upper = current;
+          haveUpper = true;
+        }
+      }
+    } else // mErrorType == etKeyError
+    {
+      const double dataKey = mDataPlottable->interface1D()->dataMainKey(int(it-mDataContainer->constBegin()));
+      if (qIsNaN(dataKey)) continue;
+      // plus error:
+      double current = dataKey + (qIsNaN(it->errorPlus) ? 0 : it->errorPlus);
+      if (inSignDomain == QCP::sdBoth || (inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
+      {
+        if (current > range.upper || !haveUpper)
+        {
+          range.upper = current;
+          haveUpper = true;
+        }
+      }
+      // minus error:
+      current = dataKey - (qIsNaN(it->errorMinus) ? 0 : it->errorMinus);
+      if (inSignDomain == QCP::sdBoth || (inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
+      {
+        if (current < range.lower || !haveLower)
+        {
+          range.lower = current;
+          haveLower = true;
+        }
+      }
+    }
+  }
+  
+  if (haveUpper && !haveLower)
+  {
+    range.lower = range.upper;
+    haveLower = true;
+  } else if (haveLower && !haveUpper)
+  {
+    range.upper = range.lower;
+    haveUpper = true;
+  }
+  
+  foundRange = haveLower && haveUpper;
+  return range;
+}
+
+/* inherits documentation from base class */
+QCPRange QCPErrorBars::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
+{
+  if (!mDataPlottable)
+  {
+    foundRange = false;
+    return {};
+  }
+  
+  QCPRange range;
+  const bool restrictKeyRange = inKeyRange != QCPRange();
+  bool haveLower = false;
+  bool haveUpper = false;
+  QCPErrorBarsDataContainer::const_iterator itBegin = mDataContainer->constBegin();
+  QCPErrorBarsDataContainer::const_iterator itEnd = mDataContainer->constEnd();
+  if (mDataPlottable->interface1D()->sortKeyIsMainKey() && restrictKeyRange)
+  {
+    itBegin = mDataContainer->constBegin()+findBegin(inKeyRange.lower, false);
+    itEnd = mDataContainer->constBegin()+findEnd(inKeyRange.upper, false);
+  }
+  for (QCPErrorBarsDataContainer::const_iterator it = itBegin; it != itEnd; ++it)
+  {
+    if (restrictKeyRange)
+    {
+      const double dataKey = mDataPlottable->interface1D()->dataMainKey(int(it-mDataContainer->constBegin()));
+      if (dataKey < inKeyRange.lower || dataKey > inKeyRange.upper)
+        continue;
+    }
+    if (mErrorType == etValueError)
+    {
+      const double dataValue = mDataPlottable->interface1D()->dataMainValue(int(it-mDataContainer->constBegin()));
+      if (qIsNaN(dataValue)) continue;
+      // plus error:
+      double current = dataValue + (qIsNaN(it->errorPlus) ? 0 : it->errorPlus);
+      if (inSignDomain == QCP::sdBoth || (inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
+      {
+        if (current > range.upper || !haveUpper)
+        {
+          range.upper = current;
+          haveUpper = true;
+        }
+      }
+      // minus error:
+      current = dataValue - (qIsNaN(it->errorMinus) ? 0 : it->errorMinus);
+      if (inSignDomain == QCP::sdBoth || (inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
+      {
+        if (current < range.lower || !haveLower)
+        {
+          range.lower = current;
+          haveLower = true;
+        }
+      }
+    } else // mErrorType == etKeyError
+    {
+      // error bar doesn't extend in value dimension (except whisker but we ignore that here), so only use data point center
+      const double current = mDataPlottable->interface1D()->dataMainValue(int(it-mDataContainer->constBegin()));
+      if (qIsNaN(current)) continue;
+      if (inSignDomain == QCP::sdBoth || (inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
       {
-        if (mKeyAxis.data()->orientation() == Qt::Horizontal)
-          result = mKeyAxis.data()->axisRect()->width()*mWidth*0.5*mKeyAxis.data()->pixelOrientation();
-        else
-          result = mKeyAxis.data()->axisRect()->height()*mWidth*0.5*mKeyAxis.data()->pixelOrientation();
-      } else
-        qDebug() << Q_FUNC_INFO << "No key axis or axis rect defined";
-      break;
+        if (current < range.lower || !haveLower)
+        {
+          range.lower = current;
+          haveLower = true;
+        }
+        if (current > range.upper || !haveUpper)
+        {
+          range.upper = current;
+          haveUpper = true;
+        }
+      }
     }
-    case wtPlotCoords:
+  }
+  
+  if (haveUpper && !haveLower)
+  {
+    range.lower = range.upper;
+    haveLower = true;
+  } else if (haveLower && !haveUpper)
+  {
+    range.upper = range.lower;
+    haveUpper = true;
+  }
+  
+  foundRange = haveLower && haveUpper;
+  return range;
+}
+
+/*! \internal
+
+  Calculates the lines that make up the error bar belonging to the data point \a it.
+
+  The resulting lines are added to \a backbones and \a whiskers. The vectors are not cleared, so
+  calling this method with different \a it but the same \a backbones and \a whiskers allows to
+  accumulate lines for multiple data points.
+
+  This method assumes that \a it is a valid iterator within the bounds of this \ref QCPErrorBars
+  instance and within the bounds of the associated data plottable.
+*/
+void QCPErrorBars::getErrorBarLines(QCPErrorBarsDataContainer::const_iterator it, QVector<QLineF> &backbones, QVector<QLineF> &whiskers) const
+{
+  if (!mDataPlottable) return;
+  
+  int index = int(it-mDataContainer->constBegin());
+  QPointF centerPixel = mDataPlottable->interface1D()->dataPixelPosition(index);
+  if (qIsNaN(centerPixel.x()) || qIsNaN(centerPixel.y()))
+    return;
+  QCPAxis *errorAxis = mErrorType == etValueError ? mValueAxis.data() : mKeyAxis.data();
+  QCPAxis *orthoAxis = mErrorType == etValueError ? mKeyAxis.data() : mValueAxis.data();
+  const double centerErrorAxisPixel = errorAxis->orientation() == Qt::Horizontal ? centerPixel.x() : centerPixel.y();
+  const double centerOrthoAxisPixel = orthoAxis->orientation() == Qt::Horizontal ? centerPixel.x() : centerPixel.y();
+  const double centerErrorAxisCoord = errorAxis->pixelToCoord(centerErrorAxisPixel); // depending on plottable, this might be different from just mDataPlottable->interface1D()->dataMainKey/Value
+  const double symbolGap = mSymbolGap*0.5*errorAxis->pixelOrientation();
+  // plus error:
+  double errorStart, errorEnd;
+  if (!qIsNaN(it->errorPlus))
+  {
+    errorStart = centerErrorAxisPixel+symbolGap;
+    errorEnd = errorAxis->coordToPixel(centerErrorAxisCoord+it->errorPlus);
+    if (errorAxis->orientation() == Qt::Vertical)
     {
-      if (mKeyAxis)
-        result = mKeyAxis.data()->coordToPixel(key+mWidth*0.5)-keyPixel;
-      else
-        qDebug() << Q_FUNC_INFO << "No key axis defined";
-      break;
+      if ((errorStart > errorEnd) != errorAxis->rangeReversed())
+        backbones.append(QLineF(centerOrthoAxisPixel, errorStart, centerOrthoAxisPixel, errorEnd));
+      whiskers.append(QLineF(centerOrthoAxisPixel-mWhiskerWidth*0.5, errorEnd, centerOrthoAxisPixel+mWhiskerWidth*0.5, errorEnd));
+    } else
+    {
+      if ((errorStart < errorEnd) != errorAxis->rangeReversed())
+        backbones.append(QLineF(errorStart, centerOrthoAxisPixel, errorEnd, centerOrthoAxisPixel));
+      whiskers.append(QLineF(errorEnd, centerOrthoAxisPixel-mWhiskerWidth*0.5, errorEnd, centerOrthoAxisPixel+mWhiskerWidth*0.5));
+    }
+  }
+  // minus error:
+  if (!qIsNaN(it->errorMinus))
+  {
+    errorStart = centerErrorAxisPixel-symbolGap;
+    errorEnd = errorAxis->coordToPixel(centerErrorAxisCoord-it->errorMinus);
+    if (errorAxis->orientation() == Qt::Vertical)
+    {
+      if ((errorStart < errorEnd) != errorAxis->rangeReversed())
+        backbones.append(QLineF(centerOrthoAxisPixel, errorStart, centerOrthoAxisPixel, errorEnd));
+      whiskers.append(QLineF(centerOrthoAxisPixel-mWhiskerWidth*0.5, errorEnd, centerOrthoAxisPixel+mWhiskerWidth*0.5, errorEnd));
+    } else
+    {
+      if ((errorStart > errorEnd) != errorAxis->rangeReversed())
+        backbones.append(QLineF(errorStart, centerOrthoAxisPixel, errorEnd, centerOrthoAxisPixel));
+      whiskers.append(QLineF(errorEnd, centerOrthoAxisPixel-mWhiskerWidth*0.5, errorEnd, centerOrthoAxisPixel+mWhiskerWidth*0.5));
     }
   }
-  return result;
 }
 
 /*! \internal
 
-  This method is a helper function for \ref selectTest. It is used to test for selection when the
-  chart style is \ref csOhlc. It only tests against the data points between \a begin and \a end.
-  
-  Like \ref selectTest, this method returns the shortest distance of \a pos to the graphical
-  representation of the plottable, and \a closestDataPoint will point to the respective data point.
+  Calculates the error bar lines for the data points in the range [\a begin, \a end), applying the
+  adaptive sampling described at \ref setAdaptiveSampling. Like \ref getErrorBarLines, the lines
+  are appended to \a backbones and \a whiskers.
+
+  Consecutive data points are only merged if there are more of them than twice the number of pixels
+  along the orthogonal axis. Otherwise each error bar is generated by \ref getErrorBarLines, unless
+  its total extent along the error axis is below one pixel.
+
+  This method assumes that the data plottable is sorted by its main key, so all error bars within
+  [\a begin, \a end) are visible.
 */
-double QCPFinancial::ohlcSelectTest(const QPointF &pos, const QCPFinancialDataContainer::const_iterator &begin, const QCPFinancialDataContainer::const_iterator &end, QCPFinancialDataContainer::const_iterator &closestDataPoint) const
+void QCPErrorBars::getOptimizedErrorBarLines(QCPErrorBarsDataContainer::const_iterator begin, QCPErrorBarsDataContainer::const_iterator end, QVector<QLineF> &backbones, QVector<QLineF> &whiskers) const
 {
-  closestDataPoint = mDataContainer->constEnd();
-  QCPAxis *keyAxis = mKeyAxis.data();
-  QCPAxis *valueAxis = mValueAxis.data();
-  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return -1; }
-
-  double minDistSqr = (std::numeric_limits<double>::max)();
-  if (keyAxis->orientation() == Qt::Horizontal)
+  if (!mDataPlottable) return;
+  
+  QCPPlottableInterface1D *interface = mDataPlottable->interface1D();
+  QCPAxis *errorAxis = mErrorType == etValueError ? mValueAxis.data() : mKeyAxis.data();
+  QCPAxis *orthoAxis = mErrorType == etValueError ? mKeyAxis.data() : mValueAxis.data();
+  const bool errorAxisVertical = errorAxis->orientation() == Qt::Vertical;
+  const int orthoAxisPixels = orthoAxis->orientation() == Qt::Horizontal ? orthoAxis->axisRect()->width() : orthoAxis->axisRect()->height();
+  const bool mergeColumns = (end-begin) > 2*orthoAxisPixels; // merge once there are more than two error bars per pixel on average
+  
+  QCPErrorBarsDataContainer::const_iterator columnBegin = end;
+  int columnCount = 0;
+  int column = 0;
+  double columnOrtho = 0, columnLower = 0, columnUpper = 0;
+  for (QCPErrorBarsDataContainer::const_iterator it=begin; it!=end; ++it)
   {
-    for (QCPFinancialDataContainer::const_iterator it=begin; it!=end; ++it)
+    const QPointF centerPixel = interface->dataPixelPosition(int(it-mDataContainer->constBegin()));
+    if (qIsNaN(centerPixel.x()) || qIsNaN(centerPixel.y()))
+      continue;
+    const double centerErrorAxisPixel = errorAxisVertical ? centerPixel.y() : centerPixel.x();
+    const double centerOrthoAxisPixel = errorAxisVertical ? centerPixel.x() : centerPixel.y();
+    const double centerErrorAxisCoord = errorAxis->pixelToCoord(centerErrorAxisPixel);
+    double lower = centerErrorAxisPixel;
+    double upper = centerErrorAxisPixel;
+    if (!qIsNaN(it->errorPlus))
     {
-      double keyPixel = keyAxis->coordToPixel(it->key);
-      // calculate distance to backbone:
-      double currentDistSqr = QCPVector2D(pos).distanceSquaredToLine(QCPVector2D(keyPixel, valueAxis->coordToPixel(it->high)), QCPVector2D(keyPixel, valueAxis->coordToPixel(it->low)));
-      if (currentDistSqr < minDistSqr)
-      {
-        minDistSqr = currentDistSqr;
-        closestDataPoint = it;
-      }
+      const double errorEnd = errorAxis->coordToPixel(centerErrorAxisCoord+it->errorPlus);
+      lower = qMin(lower, errorEnd);
+      upper = qMax(upper, errorEnd);
     }
-  } else // keyAxis->orientation() == Qt::Vertical
-  {
-    for (QCPFinancialDataContainer::const_iterator it=begin; it!=end; ++it)
+    if (!qIsNaN(it->errorMinus))
     {
-      double keyPixel = keyAxis->coordToPixel(it->key);
-      // calculate distance to backbone:
-      double currentDistSqr = QCPVector2D(pos).distanceSquaredToLine(QCPVector2D(valueAxis->coordToPixel(it->high), keyPixel), QCPVector2D(valueAxis->coordToPixel(it->low), keyPixel));
-      if (currentDistSqr < minDistSqr)
+      const double errorEnd = errorAxis->coordToPixel(centerErrorAxisCoord-it->errorMinus);
+      lower = qMin(lower, errorEnd);
+      upper = qMax(upper, errorEnd);
+    }
+    const int pixelColumn = qFloor(centerOrthoAxisPixel);
+    if (mergeColumns && columnCount > 0 && pixelColumn == column)
+    {
+      columnLower = qMin(columnLower, lower);
+      columnUpper = qMax(columnUpper, upper);
+      ++columnCount;
+    } else
+    {
+      // flush previous column:
+      if (columnCount == 1)
       {
-        minDistSqr = currentDistSqr;
-        closestDataPoint = it;
-      }
+        if (columnUpper-columnLower >= 1.0)
+          getErrorBarLines(columnBegin, backbones, whiskers);
+      } else if (columnCount > 1)
+        appendMergedErrorBar(columnOrtho, columnLower, columnUpper, backbones, whiskers);
+      // start new column:
+      columnBegin = it;
+      columnCount = 1;
+      column = pixelColumn;
+      columnOrtho = centerOrthoAxisPixel;
+      columnLower = lower;
+      columnUpper = upper;
     }
   }
-  return qSqrt(minDistSqr);
+  // flush last column:
+  if (columnCount == 1)
+  {
+    if (columnUpper-columnLower >= 1.0)
+      getErrorBarLines(columnBegin, backbones, whiskers);
+  } else if (columnCount > 1)
+    appendMergedErrorBar(columnOrtho, columnLower, columnUpper, backbones, whiskers);
 }
 
 /*! \internal
-  
-  This method is a helper function for \ref selectTest. It is used to test for selection when the
-  chart style is \ref csCandlestick. It only tests against the data points between \a begin and \a
-  end.
-  
-  Like \ref selectTest, this method returns the shortest distance of \a pos to the graphical
-  representation of the plottable, and \a closestDataPoint will point to the respective data point.
+
+  Appends the backbone and the two whiskers of an error bar that represents several merged error
+  bars to \a backbones and \a whiskers. The bar is located at \a orthoAxisPixel and spans from \a
+  lowerErrorAxisPixel to \a upperErrorAxisPixel along the error axis. Bars shorter than one pixel
+  are skipped.
+
+  \see getOptimizedErrorBarLines
 */
-double QCPFinancial::candlestickSelectTest(const QPointF &pos, const QCPFinancialDataContainer::const_iterator &begin, const QCPFinancialDataContainer::const_iterator &end, QCPFinancialDataContainer::const_iterator &closestDataPoint) const
+void QCPErrorBars::appendMergedErrorBar(double orthoAxisPixel, double lowerErrorAxisPixel, double upperErrorAxisPixel, QVector<QLineF> &backbones, QVector<QLineF> &whiskers) const
+{
+  if (upperErrorAxisPixel-lowerErrorAxisPixel < 1.0)
+    return;
+  const QCPAxis *errorAxis = mErrorType == etValueError ? mValueAxis.data() : mKeyAxis.data();
+  if (errorAxis->orientation() == Qt::Vertical)
+  {
+    backbones.append(QLineF(orthoAxisPixel, lowerErrorAxisPixel, orthoAxisPixel, upperErrorAxisPixel));
+    whiskers.append(QLineF(orthoAxisPixel-mWhiskerWidth*0.5, lowerErrorAxisPixel, orthoAxisPixel+mWhiskerWidth*0.5, lowerErrorAxisPixel));
+    whiskers.append(QLineF(orthoAxisPixel-mWhiskerWidth*0.5, upperErrorAxisPixel, orthoAxisPixel+mWhiskerWidth*0.5, upperErrorAxisPixel));
+  } else
+  {
+    backbones.append(QLineF(lowerErrorAxisPixel, orthoAxisPixel, upperErrorAxisPixel, orthoAxisPixel));
+    whiskers.append(QLineF(lowerErrorAxisPixel, orthoAxisPixel-mWhiskerWidth*0.5, lowerErrorAxisPixel, orthoAxisPixel+mWhiskerWidth*0.5));
+    whiskers.append(QLineF(upperErrorAxisPixel, orthoAxisPixel-mWhiskerWidth*0.5, upperErrorAxisPixel, orthoAxisPixel+mWhiskerWidth*0.5));
+  }
+}
+
+/*! \internal
+
+  This method outputs the currently visible data range via \a begin and \a end. The returned range
+  will also never exceed \a rangeRestriction.
+
+  Since error bars with type \ref etKeyError may extend to arbitrarily positive and negative key
+  coordinates relative to their data point key, this method checks all outer error bars whether
+  they truly don't reach into the visible portion of the axis rect, by calling \ref
+  errorBarVisible. On the other hand error bars with type \ref etValueError that are associated
+  with data plottables whose sort key is equal to the main key (see \ref qcpdatacontainer-datatype
+  "QCPDataContainer DataType") can be handled very efficiently by finding the visible range of
+  error bars through binary search (\ref QCPPlottableInterface1D::findBegin and \ref
+  QCPPlottableInterface1D::findEnd).
+
+  If the plottable's sort key is not equal to the main key, this method returns the full data
+  range, only restricted by \a rangeRestriction. Drawing optimization then has to be done on a
+  point-by-point basis in the \ref draw method.
+*/
+void QCPErrorBars::getVisibleDataBounds(QCPErrorBarsDataContainer::const_iterator &begin, QCPErrorBarsDataContainer::const_iterator &end, const QCPDataRange &rangeRestriction) const
 {
-  closestDataPoint = mDataContainer->constEnd();
   QCPAxis *keyAxis = mKeyAxis.data();
   QCPAxis *valueAxis = mValueAxis.data();
-  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return -1; }
+  if (!keyAxis || !valueAxis)
+  {
+    qDebug() << Q_FUNC_INFO << "invalid key or value axis";
+    end = mDataContainer->constEnd();
+    begin = end;
+    return;
+  }
+  if (!mDataPlottable || rangeRestriction.isEmpty())
+  {
+    end = mDataContainer->constEnd();
+    begin = end;
+    return;
+  }
+  if (!mDataPlottable->interface1D()->sortKeyIsMainKey())
+  {
+    // if the sort key isn't the main key, it's not possible to find a contiguous range of visible
+    // data points, so this method then only applies the range restriction and otherwise returns
+    // the full data range. Visibility checks must be done on a per-datapoin-basis during drawing
+    QCPDataRange dataRange(0, mDataContainer->size());
+    dataRange = dataRange.bounded(rangeRestriction);
+    begin = mDataContainer->constBegin()+dataRange.begin();
+    end = mDataContainer->constBegin()+dataRange.end();
+    return;
+  }
+  
+  // get visible data range via interface from data plottable, and then restrict to available error data points:
+  const int n = qMin(mDataContainer->size(), mDataPlottable->interface1D()->dataCount());
+  int beginIndex = mDataPlottable->interface1D()->findBegin(keyAxis->range().lower);
+  int endIndex = mDataPlottable->interface1D()->findEnd(keyAxis->range().upper);
+  int i = beginIndex;
+  while (i > 0 && i < n && i > rangeRestriction.begin())
+  {
+    if (errorBarVisible(i))
+      beginIndex = i;
+    --i;
+  }
+  i = endIndex;
+  while (i >= 0 && i < n && i < rangeRestriction.end())
+  {
+    if (errorBarVisible(i))
+      endIndex = i+1;
+    ++i;
+  }
+  QCPDataRange dataRange(beginIndex, endIndex);
+  dataRange = dataRange.bounded(rangeRestriction.bounded(QCPDataRange(0, mDataContainer->size())));
+  begin = mDataContainer->constBegin()+dataRange.begin();
+  end = mDataContainer->constBegin()+dataRange.end();
+}
 
-  double minDistSqr = (std::numeric_limits<double>::max)();
-  if (keyAxis->orientation() == Qt::Horizontal)
+/*! \internal
+
+  Calculates the minimum distance in pixels the error bars' representation has from the given \a
+  pixelPoint. This is used to determine whether the error bar was clicked or not, e.g. in \ref
+  selectTest. The closest data point to \a pixelPoint is returned in \a closestData.
+*/
+double QCPErrorBars::pointDistance(const QPointF &pixelPoint, QCPErrorBarsDataContainer::const_iterator &closestData) const
+{
+  closestData = mDataContainer->constEnd();
+  if (!mDataPlottable || mDataContainer->isEmpty())
+    return -1.0;
+  if (!mKeyAxis || !mValueAxis)
   {
-    for (QCPFinancialDataContainer::const_iterator it=begin; it!=end; ++it)
-    {
-      double currentDistSqr;
-      // determine whether pos is in open-close-box:
-      QCPRange boxKeyRange(it->key-mWidth*0.5, it->key+mWidth*0.5);
-      QCPRange boxValueRange(it->close, it->open);
-      double posKey, posValue;
-      pixelsToCoords(pos, posKey, posValue);
-      if (boxKeyRange.contains(posKey) && boxValueRange.contains(posValue)) // is in open-close-box
-      {
-        currentDistSqr = mParentPlot->selectionTolerance()*0.99 * mParentPlot->selectionTolerance()*0.99;
-      } else
-      {
-        // calculate distance to high/low lines:
-        double keyPixel = keyAxis->coordToPixel(it->key);
-        double highLineDistSqr = QCPVector2D(pos).distanceSquaredToLine(QCPVector2D(keyPixel, valueAxis->coordToPixel(it->high)), QCPVector2D(keyPixel, valueAxis->coordToPixel(qMax(it->open, it->close))));
-        double lowLineDistSqr = QCPVector2D(pos).distanceSquaredToLine(QCPVector2D(keyPixel, valueAxis->coordToPixel(it->low)), QCPVector2D(keyPixel, valueAxis->coordToPixel(qMin(it->open, it->close))));
-        currentDistSqr = qMin(highLineDistSqr, lowLineDistSqr);
-      }
-      if (currentDistSqr < minDistSqr)
-      {
-        minDistSqr = currentDistSqr;
-        closestDataPoint = it;
-      }
-    }
-  } else // keyAxis->orientation() == Qt::Vertical
+    qDebug() << Q_FUNC_INFO << "invalid key or value axis";
+    return -1.0;
+  }
+  
+  QCPErrorBarsDataContainer::const_iterator begin, end;
+  getVisibleDataBounds(begin, end, QCPDataRange(0, dataCount()));
+  
+  // calculate minimum distances to error backbones (whiskers are ignored for speed) and find closestData iterator:
+  double minDistSqr = (std::numeric_limits<double>::max)();
+  QVector<QLineF> backbones, whiskers;
+  for (QCPErrorBarsDataContainer::const_iterator it=begin; it!=end; ++it)
   {
-    for (QCPFinancialDataContainer::const_iterator it=begin; it!=end; ++it)
+    getErrorBarLines(it, backbones, whiskers);
+    foreach (const QLineF &backbone, backbones)
     {
-      double currentDistSqr;
-      // determine whether pos is in open-close-box:
-      QCPRange boxKeyRange(it->key-mWidth*0.5, it->key+mWidth*0.5);
-      QCPRange boxValueRange(it->close, it->open);
-      double posKey, posValue;
-      pixelsToCoords(pos, posKey, posValue);
-      if (boxKeyRange.contains(posKey) && boxValueRange.contains(posValue)) // is in open-close-box
-      {
-        currentDistSqr = mParentPlot->selectionTolerance()*0.99 * mParentPlot->selectionTolerance()*0.99;
-      } else
-      {
-        // calculate distance to high/low lines:
-        double keyPixel = keyAxis->coordToPixel(it->key);
-        double highLineDistSqr = QCPVector2D(pos).distanceSquaredToLine(QCPVector2D(valueAxis->coordToPixel(it->high), keyPixel), QCPVector2D(valueAxis->coordToPixel(qMax(it->open, it->close)), keyPixel));
-        double lowLineDistSqr = QCPVector2D(pos).distanceSquaredToLine(QCPVector2D(valueAxis->coordToPixel(it->low), keyPixel), QCPVector2D(valueAxis->coordToPixel(qMin(it->open, it->close)), keyPixel));
-        currentDistSqr = qMin(highLineDistSqr, lowLineDistSqr);
-      }
+      const double currentDistSqr = QCPVector2D(pixelPoint).distanceSquaredToLine(backbone);
       if (currentDistSqr < minDistSqr)
       {
         minDistSqr = currentDistSqr;
-        closestDataPoint = it;
+        closestData = it;
       }
     }
   }
@@ -27832,1021 +32260,1137 @@ double QCPFinancial::candlestickSelectTest(const QPointF &pos, const QCPFinancia
 }
 
 /*! \internal
-  
-  called by the drawing methods to determine which data (key) range is visible at the current key
-  axis range setting, so only that needs to be processed.
-  
-  \a begin returns an iterator to the lowest data point that needs to be taken into account when
-  plotting. Note that in order to get a clean plot all the way to the edge of the axis rect, \a
-  begin may still be just outside the visible range.
-  
-  \a end returns the iterator just above the highest data point that needs to be taken into
-  account. Same as before, \a end may also lie just outside of the visible range
-  
-  if the plottable contains no data, both \a begin and \a end point to \c constEnd.
+
+  \note This method is identical to \ref QCPAbstractPlottable1D::getDataSegments but needs to be
+  reproduced here since the \ref QCPErrorBars plottable, as a special case that doesn't have its
+  own key/value data coordinates, doesn't derive from \ref QCPAbstractPlottable1D. See the
+  documentation there for details.
 */
-void QCPFinancial::getVisibleDataBounds(QCPFinancialDataContainer::const_iterator &begin, QCPFinancialDataContainer::const_iterator &end) const
+void QCPErrorBars::getDataSegments(QList<QCPDataRange> &selectedSegments, QList<QCPDataRange> &unselectedSegments) const
 {
-  if (!mKeyAxis)
+  selectedSegments.clear();
+  unselectedSegments.clear();
+  if (mSelectable == QCP::stWhole) // stWhole selection type draws the entire plottable with selected style if mSelection isn't empty
   {
-    qDebug() << Q_FUNC_INFO << "invalid key axis";
-    begin = mDataContainer->constEnd();
-    end = mDataContainer->constEnd();
-    return;
+    if (selected())
+      selectedSegments << QCPDataRange(0, dataCount());
+    else
+      unselectedSegments << QCPDataRange(0, dataCount());
+  } else
+  {
+    QCPDataSelection sel(selection());
+    sel.simplify();
+    selectedSegments = sel.dataRanges();
+    unselectedSegments = sel.inverse(QCPDataRange(0, dataCount())).dataRanges();
   }
-  begin = mDataContainer->findBegin(mKeyAxis.data()->range().lower-mWidth*0.5); // subtract half width of ohlc/candlestick to include partially visible data points
-  end = mDataContainer->findEnd(mKeyAxis.data()->range().upper+mWidth*0.5); // add half width of ohlc/candlestick to include partially visible data points
 }
 
-/*!  \internal
+/*! \internal
 
-  Returns the hit box in pixel coordinates that will be used for data selection with the selection
-  rect (\ref selectTestRect), of the data point given by \a it.
+  Returns whether the error bar at the specified \a index is visible within the current key axis
+  range.
+
+  This method assumes for performance reasons without checking that the key axis, the value axis,
+  and the data plottable (\ref setDataPlottable) are not \c nullptr and that \a index is within
+  valid bounds of this \ref QCPErrorBars instance and the bounds of the data plottable.
 */
-QRectF QCPFinancial::selectionHitBox(QCPFinancialDataContainer::const_iterator it) const
+bool QCPErrorBars::errorBarVisible(int index) const
 {
-  QCPAxis *keyAxis = mKeyAxis.data();
-  QCPAxis *valueAxis = mValueAxis.data();
-  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return {}; }
+  QPointF centerPixel = mDataPlottable->interface1D()->dataPixelPosition(index);
+  const double centerKeyPixel = mKeyAxis->orientation() == Qt::Horizontal ? centerPixel.x() : centerPixel.y();
+  if (qIsNaN(centerKeyPixel))
+    return false;
   
-  double keyPixel = keyAxis->coordToPixel(it->key);
-  double highPixel = valueAxis->coordToPixel(it->high);
-  double lowPixel = valueAxis->coordToPixel(it->low);
-  double keyWidthPixels = keyPixel-keyAxis->coordToPixel(it->key-mWidth*0.5);
-  if (keyAxis->orientation() == Qt::Horizontal)
-    return QRectF(keyPixel-keyWidthPixels, highPixel, keyWidthPixels*2, lowPixel-highPixel).normalized();
+  double keyMin, keyMax;
+  if (mErrorType == etKeyError)
+  {
+    const double centerKey = mKeyAxis->pixelToCoord(centerKeyPixel);
+    const double errorPlus = mDataContainer->at(index).errorPlus;
+    const double errorMinus = mDataContainer->at(index).errorMinus;
+    keyMax = centerKey+(qIsNaN(errorPlus) ? 0 : errorPlus);
+    keyMin = centerKey-(qIsNaN(errorMinus) ? 0 : errorMinus);
+  } else // mErrorType == etValueError
+  {
+    keyMax = mKeyAxis->pixelToCoord(centerKeyPixel+mWhiskerWidth*0.5*mKeyAxis->pixelOrientation());
+    keyMin = mKeyAxis->pixelToCoord(centerKeyPixel-mWhiskerWidth*0.5*mKeyAxis->pixelOrientation());
+  }
+  return ((keyMax > mKeyAxis->range().lower) && (keyMin < mKeyAxis->range().upper));
+}
+
+/*! \internal
+
+  Returns whether \a line intersects (or is contained in) \a pixelRect.
+
+  \a line is assumed to be either perfectly horizontal or perfectly vertical, as is the case for
+  error bar lines.
+*/
+bool QCPErrorBars::rectIntersectsLine(const QRectF &pixelRect, const QLineF &line) const
+{
+  if (pixelRect.left() > line.x1() && pixelRect.left() > line.x2())
+    return false;
+  else if (pixelRect.right() < line.x1() && pixelRect.right() < line.x2())
+    return false;
+  else if (pixelRect.top() > line.y1() && pixelRect.top() > line.y2())
+    return false;
+  else if (pixelRect.bottom() < line.y1() && pixelRect.bottom() < line.y2())
+    return false;
   else
-    return QRectF(highPixel, keyPixel-keyWidthPixels, lowPixel-highPixel, keyWidthPixels*2).normalized();
+    return true;
 }
-/* end of 'src/plottables/plottable-financial.cpp' */
+/* end of 'src/plottables/plottable-errorbar.cpp' */
 
 
-/* including file 'src/plottables/plottable-errorbar.cpp' */
-/* modified 2022-11-06T12:45:56, size 37679               */
+/* including file 'src/plottables/plottable-annotations.cpp' */
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-//////////////////// QCPErrorBarsData
+//////////////////// QCPAnnotationData
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-/*! \class QCPErrorBarsData
-  \brief Holds the data of one single error bar for QCPErrorBars.
-
+/*! \class QCPAnnotationData
+  \brief Holds the data of one single marker for QCPAnnotations.
+  
   The stored data is:
-  \li \a errorMinus: how much the error bar extends towards negative coordinates from the data
-  point position
-  \li \a errorPlus: how much the error bar extends towards positive coordinates from the data point
-  position
+  \li \a key: coordinate on the key axis of this marker (this is the \a mainKey and the \a sortKey)
+  \li \a span: extent of the marker on the key axis. Markers with a span of zero are drawn as lines,
+  markers with a positive span as bands from \a key to \a key + \a span.
+  \li \a style: index of the marker style, see \ref QCPAnnotations::addStyle
+  \li \a label: index of the label text, see \ref QCPAnnotations::addLabel, or -1 if the marker has
+  no label
+  
+  Markers don't have a value coordinate, they always span the visible value range of the axis rect.
+  
+  The container for storing multiple markers is \ref QCPAnnotationDataContainer. It is a typedef
+  for \ref QCPDataContainer with \ref QCPAnnotationData as the DataType template parameter. See the
+  documentation there for an explanation regarding the data type's generic methods.
+  
+  \see QCPAnnotationDataContainer
+*/
 
-  The container for storing the error bar information is \ref QCPErrorBarsDataContainer. It is a
-  typedef for <tt>QVector<\ref QCPErrorBarsData></tt>.
+/* start documentation of inline functions */
 
-  \see QCPErrorBarsDataContainer
+/*! \fn double QCPAnnotationData::sortKey() const
+  
+  Returns the \a key member of this marker.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
 */
 
-/*!
-  Constructs an error bar with errors set to zero.
+/*! \fn static QCPAnnotationData QCPAnnotationData::fromSortKey(double sortKey)
+  
+  Returns a marker with the specified \a sortKey, default style and no label.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
 */
-QCPErrorBarsData::QCPErrorBarsData() :
-  errorMinus(0),
-  errorPlus(0)
-{
-}
+
+/*! \fn static bool QCPAnnotationData::sortKeyIsMainKey()
+  
+  Since the member \a key is both the marker key coordinate and the data ordering parameter, this
+  method returns true.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/*! \fn double QCPAnnotationData::mainKey() const
+  
+  Returns the \a key member of this marker.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/*! \fn double QCPAnnotationData::mainValue() const
+  
+  Markers have no value coordinate, so this method returns zero.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/*! \fn QCPRange QCPAnnotationData::valueRange() const
+  
+  Markers have no value coordinate, so this method returns an empty range at zero.
+  
+  For a general explanation of what this method is good for in the context of the data container,
+  see the documentation of \ref QCPDataContainer.
+*/
+
+/* end documentation of inline functions */
 
 /*!
-  Constructs an error bar with equal \a error in both negative and positive direction.
+  Constructs a marker at key zero with the default style and no label.
 */
-QCPErrorBarsData::QCPErrorBarsData(double error) :
-  errorMinus(error),
-  errorPlus(error)
+QCPAnnotationData::QCPAnnotationData() :
+  key(0),
+  span(0),
+  style(0),
+  label(-1)
 {
 }
 
 /*!
-  Constructs an error bar with negative and positive errors set to \a errorMinus and \a errorPlus,
-  respectively.
+  Constructs a marker with the specified \a key, \a style, \a label and \a span.
 */
-QCPErrorBarsData::QCPErrorBarsData(double errorMinus, double errorPlus) :
-  errorMinus(errorMinus),
-  errorPlus(errorPlus)
+QCPAnnotationData::QCPAnnotationData(double key, int style, int label, double span) :
+  key(key),
+  span(span),
+  style(style),
+  label(label)
 {
 }
 
 
-////////////////////////////////////////////////////////////////////////////////////////////////////
-//////////////////// QCPErrorBars
-////////////////////////////////////////////////////////////////////////////////////////////////////
-
-/*! \class QCPErrorBars
-  \brief A plottable that adds a set of error bars to other plottables.
-
-  \image html QCPErrorBars.png
-
-  The \ref QCPErrorBars plottable can be attached to other one-dimensional plottables (e.g. \ref
-  QCPGraph, \ref QCPCurve, \ref QCPBars, etc.) and equips them with error bars.
-
-  Use \ref setDataPlottable to define for which plottable the \ref QCPErrorBars shall display the
-  error bars. The orientation of the error bars can be controlled with \ref setErrorType.
-
-  By using \ref setData, you can supply the actual error data, either as symmetric error or
-  plus/minus asymmetric errors. \ref QCPErrorBars only stores the error data. The absolute
-  key/value position of each error bar will be adopted from the configured data plottable. The
-  error data of the \ref QCPErrorBars are associated one-to-one via their index to the data points
-  of the data plottable. You can directly access and manipulate the error bar data via \ref data.
-
-  Set either of the plus/minus errors to NaN (<tt>qQNaN()</tt> or
-  <tt>std::numeric_limits<double>::quiet_NaN()</tt>) to not show the respective error bar on the data point at
-  that index.
-
-  \section qcperrorbars-appearance Changing the appearance
-
-  The appearance of the error bars is defined by the pen (\ref setPen), and the width of the
-  whiskers (\ref setWhiskerWidth). Further, the error bar backbones may leave a gap around the data
-  point center to prevent that error bars are drawn too close to or even through scatter points.
-  This gap size can be controlled via \ref setSymbolGap.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPAnnotations
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPAnnotations
+  \brief A plottable representing a large number of event markers with optional labels.
+  
+  Items like QCPItemStraightLine, QCPItemRect and QCPItemText are convenient for a handful of
+  annotations, but every item is a QObject with its own item positions, draw call and selection
+  test. QCPAnnotations stores markers as plain \ref QCPAnnotationData entries of a few bytes each,
+  sorted by key, which makes plots with tens of thousands of event markers practical:
+  
+  \li Only markers inside the visible key range are processed, found by binary search.
+  \li All visible markers of the same style are drawn with a single \c drawLines or \c drawRects
+  call. Line markers falling onto the same pixel column as the previous one of the same style are
+  skipped.
+  \li Labels that would overlap the previously drawn label are skipped.
+  \li \ref selectTest only inspects the markers within the selection tolerance, again found by
+  binary search.
+  
+  Line markers (span zero) are drawn perpendicular to the key axis across the entire visible value
+  range, band markers (positive span) as rectangles covering the key interval. Markers don't take
+  part in rescaling of the value axis.
+  
+  \section qcpannotations-styles Styles and labels
+  
+  The appearance of markers is defined by styles, which are referenced by index from the markers.
+  Style 0 always exists, further styles are added with \ref addStyle. Label texts are stored once
+  in a label table and referenced by index as well, see \ref addLabel.
+  
+  Marker appearance is controlled only by the styles (\ref setStyle, \ref addStyle). The legend
+  icon is drawn with style 0. The pen and brush of the plottable itself (\ref setPen, \ref
+  setBrush) only provide the initial pen and brush of style 0 at construction and have no effect
+  afterwards. Selected markers are drawn with the pen and brush of the selection decorator.
 */
 
 /* start of documentation of inline functions */
 
-/*! \fn QSharedPointer<QCPErrorBarsDataContainer> QCPErrorBars::data() const
+/*! \fn QSharedPointer<QCPAnnotationDataContainer> QCPAnnotations::data() const
+  
+  Returns a shared pointer to the internal data storage of type \ref QCPAnnotationDataContainer.
+  You may use it to directly manipulate the markers, which may be more convenient and faster than
+  using the regular \ref setData or \ref addData methods. If you change the span of markers this
+  way, call \ref updateMaxSpan afterwards.
+*/
 
-  Returns a shared pointer to the internal data storage of type \ref QCPErrorBarsDataContainer. You
-  may use it to directly manipulate the error values, which may be more convenient and faster than
-  using the regular \ref setData methods.
+/*! \fn QString QCPAnnotations::label(int label) const
+  
+  Returns the text of the label with index \a label, or an empty string if the index is invalid.
 */
 
 /* end of documentation of inline functions */
 
 /*!
-  Constructs an error bars plottable which uses \a keyAxis as its key axis ("x") and \a valueAxis as its value
-  axis ("y"). \a keyAxis and \a valueAxis must reside in the same QCustomPlot instance and not have
-  the same orientation. If either of these restrictions is violated, a corresponding message is
-  printed to the debug output (qDebug), the construction is not aborted, though.
-
-  It is also important that the \a keyAxis and \a valueAxis are the same for the error bars
-  plottable and the data plottable that the error bars shall be drawn on (\ref setDataPlottable).
-
-  The created \ref QCPErrorBars is automatically registered with the QCustomPlot instance inferred
-  from \a keyAxis. This QCustomPlot instance takes ownership of the \ref QCPErrorBars, so do not
-  delete it manually but use \ref QCustomPlot::removePlottable() instead.
+  Constructs an annotations plottable which uses \a keyAxis as its key axis ("x") and \a valueAxis
+  as its value axis ("y"). \a keyAxis and \a valueAxis must reside in the same QCustomPlot instance
+  and not have the same orientation. If either of these restrictions is violated, a corresponding
+  message is printed to the debug output (qDebug), the construction is not aborted, though.
+  
+  The created QCPAnnotations is automatically registered with the QCustomPlot instance inferred
+  from \a keyAxis. This QCustomPlot instance takes ownership of the QCPAnnotations, so do not delete
+  it manually but use QCustomPlot::removePlottable() instead.
 */
-QCPErrorBars::QCPErrorBars(QCPAxis *keyAxis, QCPAxis *valueAxis) :
-  QCPAbstractPlottable(keyAxis, valueAxis),
-  mDataContainer(new QVector<QCPErrorBarsData>),
-  mErrorType(etValueError),
-  mWhiskerWidth(9),
-  mSymbolGap(10)
-{
-  setPen(QPen(Qt::black, 0));
-  setBrush(Qt::NoBrush);
-}
-
-QCPErrorBars::~QCPErrorBars()
+QCPAnnotations::QCPAnnotations(QCPAxis *keyAxis, QCPAxis *valueAxis) :
+  QCPAbstractPlottable1D<QCPAnnotationData>(keyAxis, valueAxis),
+  mLabelPadding(3),
+  mMaxSpan(0)
 {
+  setPen(QPen(Qt::black));
+  setBrush(QColor(0, 0, 255, 40));
+  addStyle(mPen, mBrush, Qt::black, mParentPlot ? mParentPlot->font() : QFont());
 }
 
 /*! \overload
-
+  
   Replaces the current data container with the provided \a data container.
-
-  Since a QSharedPointer is used, multiple \ref QCPErrorBars instances may share the same data
-  container safely. Modifying the data in the container will then affect all \ref QCPErrorBars
-  instances that share the container. Sharing can be achieved by simply exchanging the data
-  containers wrapped in shared pointers:
-  \snippet documentation/doc-code-snippets/mainwindow.cpp qcperrorbars-datasharing-1
-
-  If you do not wish to share containers, but create a copy from an existing container, assign the
-  data containers directly:
-  \snippet documentation/doc-code-snippets/mainwindow.cpp qcperrorbars-datasharing-2
-  (This uses different notation compared with other plottables, because the \ref QCPErrorBars
-  uses a \c QVector<QCPErrorBarsData> as its data container, instead of a \ref QCPDataContainer.)
-
+  
+  Since a QSharedPointer is used, multiple QCPAnnotations may share the same data container safely.
+  Modifying the data in the container will then affect all annotation plottables that share the
+  container.
+  
   \see addData
 */
-void QCPErrorBars::setData(QSharedPointer<QCPErrorBarsDataContainer> data)
+void QCPAnnotations::setData(QSharedPointer<QCPAnnotationDataContainer> data)
 {
   mDataContainer = data;
+  updateMaxSpan();
 }
 
 /*! \overload
-
-  Sets symmetrical error values as specified in \a error. The errors will be associated one-to-one
-  by the data point index to the associated data plottable (\ref setDataPlottable).
-
-  You can directly access and manipulate the error bar data via \ref data.
-
+  
+  Replaces the current markers with line markers at the provided \a keys. \a styles and \a labels
+  hold the style and label index of each marker. They may be empty, in which case all markers use
+  style 0 and have no label, otherwise they must have the same size as \a keys.
+  
+  If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
+  can set \a alreadySorted to true, to improve performance by saving a sorting run.
+  
   \see addData
 */
-void QCPErrorBars::setData(const QVector<double> &error)
+void QCPAnnotations::setData(const QVector<double> &keys, const QVector<int> &styles, const QVector<int> &labels, bool alreadySorted)
 {
   mDataContainer->clear();
-  addData(error);
+  mMaxSpan = 0;
+  addData(keys, styles, labels, alreadySorted);
 }
 
-/*! \overload
-
-  Sets asymmetrical errors as specified in \a errorMinus and \a errorPlus. The errors will be
-  associated one-to-one by the data point index to the associated data plottable (\ref
-  setDataPlottable).
-
-  You can directly access and manipulate the error bar data via \ref data.
-
-  \see addData
+/*!
+  Sets the distance in pixels between a marker and its label, and between the label and the border
+  of the axis rect.
 */
-void QCPErrorBars::setData(const QVector<double> &errorMinus, const QVector<double> &errorPlus)
+void QCPAnnotations::setLabelPadding(int padding)
 {
-  mDataContainer->clear();
-  addData(errorMinus, errorPlus);
+  mLabelPadding = padding;
 }
 
 /*!
-  Sets the data plottable to which the error bars will be applied. The error values specified e.g.
-  via \ref setData will be associated one-to-one by the data point index to the data points of \a
-  plottable. This means that the error bars will adopt the key/value coordinates of the data point
-  with the same index.
-
-  The passed \a plottable must be a one-dimensional plottable, i.e. it must implement the \ref
-  QCPPlottableInterface1D. Further, it must not be a \ref QCPErrorBars instance itself. If either
-  of these restrictions is violated, a corresponding qDebug output is generated, and the data
-  plottable of this \ref QCPErrorBars instance is set to zero.
-
-  For proper display, care must also be taken that the key and value axes of the \a plottable match
-  those configured for this \ref QCPErrorBars instance.
+  Changes the existing marker \a style to use \a pen for lines and band borders, \a brush for band
+  fills, and \a textColor and \a font for labels.
+  
+  \see addStyle
 */
-void QCPErrorBars::setDataPlottable(QCPAbstractPlottable *plottable)
+void QCPAnnotations::setStyle(int style, const QPen &pen, const QBrush &brush, const QColor &textColor, const QFont &font)
 {
-  if (plottable && qobject_cast<QCPErrorBars*>(plottable))
-  {
-    mDataPlottable = nullptr;
-    qDebug() << Q_FUNC_INFO << "can't set another QCPErrorBars instance as data plottable";
-    return;
-  }
-  if (plottable && !plottable->interface1D())
+  if (style < 0 || style >= mStyles.size())
   {
-    mDataPlottable = nullptr;
-    qDebug() << Q_FUNC_INFO << "passed plottable doesn't implement 1d interface, can't associate with QCPErrorBars";
+    qDebug() << Q_FUNC_INFO << "Invalid style index:" << style;
     return;
   }
-  
-  mDataPlottable = plottable;
+  Style &target = mStyles[style];
+  target.pen = pen;
+  target.brush = brush;
+  target.textColor = textColor;
+  target.font = font;
+  mLabelSizes.clear();
 }
 
 /*!
-  Sets in which orientation the error bars shall appear on the data points. If your data needs both
-  error dimensions, create two \ref QCPErrorBars with different \a type.
+  Adds a new marker style and returns its index, which can then be used in the \a style member of
+  \ref QCPAnnotationData.
+  
+  \see setStyle
 */
-void QCPErrorBars::setErrorType(ErrorType type)
+int QCPAnnotations::addStyle(const QPen &pen, const QBrush &brush, const QColor &textColor, const QFont &font)
 {
-  mErrorType = type;
+  Style style;
+  style.pen = pen;
+  style.brush = brush;
+  style.textColor = textColor;
+  style.font = font;
+  mStyles.append(style);
+  return mStyles.size()-1;
 }
 
 /*!
-  Sets the width of the whiskers (the short bars at the end of the actual error bar backbones) to
-  \a pixels.
+  Returns the index of the label with the given \a text, which can then be used in the \a label
+  member of \ref QCPAnnotationData. If the text isn't in the label table yet, it is added.
+  
+  Since identical texts share one entry, markers that repeat the same few labels cost no additional
+  memory per marker.
+  
+  \see clearLabels
 */
-void QCPErrorBars::setWhiskerWidth(double pixels)
+int QCPAnnotations::addLabel(const QString &text)
 {
-  mWhiskerWidth = pixels;
+  QHash<QString, int>::const_iterator it = mLabelIds.constFind(text);
+  if (it != mLabelIds.constEnd())
+    return it.value();
+  mLabels.append(text);
+  mLabelIds.insert(text, mLabels.size()-1);
+  return mLabels.size()-1;
 }
 
 /*!
-  Sets the gap diameter around the data points that will be left out when drawing the error bar
-  backbones. This gap prevents that error bars are drawn too close to or even through scatter
-  points.
-*/
-void QCPErrorBars::setSymbolGap(double pixels)
-{
-  mSymbolGap = pixels;
-}
-
-/*! \overload
-
-  Adds symmetrical error values as specified in \a error. The errors will be associated one-to-one
-  by the data point index to the associated data plottable (\ref setDataPlottable).
-
-  You can directly access and manipulate the error bar data via \ref data.
-
-  \see setData
+  Removes all texts from the label table. Markers that still reference labels are drawn without
+  label until the table is filled again.
 */
-void QCPErrorBars::addData(const QVector<double> &error)
+void QCPAnnotations::clearLabels()
 {
-  addData(error, error);
+  mLabels.clear();
+  mLabelIds.clear();
+  mLabelSizes.clear();
 }
 
 /*! \overload
-
-  Adds asymmetrical errors as specified in \a errorMinus and \a errorPlus. The errors will be
-  associated one-to-one by the data point index to the associated data plottable (\ref
-  setDataPlottable).
-
-  You can directly access and manipulate the error bar data via \ref data.
-
-  \see setData
+  
+  Adds line markers at the provided \a keys to the current data. \a styles and \a labels hold the
+  style and label index of each marker. They may be empty, in which case all markers use style 0
+  and have no label, otherwise they must have the same size as \a keys.
+  
+  If you can guarantee that the passed data points are sorted by \a keys in ascending order, you
+  can set \a alreadySorted to true, to improve performance by saving a sorting run.
 */
-void QCPErrorBars::addData(const QVector<double> &errorMinus, const QVector<double> &errorPlus)
+void QCPAnnotations::addData(const QVector<double> &keys, const QVector<int> &styles, const QVector<int> &labels, bool alreadySorted)
 {
-  if (errorMinus.size() != errorPlus.size())
-    qDebug() << Q_FUNC_INFO << "minus and plus error vectors have different sizes:" << errorMinus.size() << errorPlus.size();
-  const int n = qMin(errorMinus.size(), errorPlus.size());
-  mDataContainer->reserve(n);
+  if ((!styles.isEmpty() && styles.size() != keys.size()) || (!labels.isEmpty() && labels.size() != keys.size()))
+    qDebug() << Q_FUNC_INFO << "styles and labels must be empty or have the same size as keys:" << keys.size() << styles.size() << labels.size();
+  const int n = keys.size();
+  QVector<QCPAnnotationData> tempData(n);
   for (int i=0; i<n; ++i)
-    mDataContainer->append(QCPErrorBarsData(errorMinus.at(i), errorPlus.at(i)));
+  {
+    tempData[i].key = keys.at(i);
+    tempData[i].style = styles.value(i, 0);
+    tempData[i].label = labels.value(i, -1);
+  }
+  mDataContainer->add(tempData, alreadySorted); // don't modify tempData beyond this to prevent copy on write
 }
 
 /*! \overload
-
-  Adds a single symmetrical error bar as specified in \a error. The errors will be associated
-  one-to-one by the data point index to the associated data plottable (\ref setDataPlottable).
-
-  You can directly access and manipulate the error bar data via \ref data.
-
-  \see setData
+  
+  Adds the provided marker at \a key with the given \a style and \a label index to the current
+  data. If \a span is positive, the marker is a band extending from \a key to \a key + \a span.
+  
+  Alternatively, you can also access and modify the data directly via the \ref data method, which
+  returns a pointer to the internal data container.
 */
-void QCPErrorBars::addData(double error)
+void QCPAnnotations::addData(double key, int style, int label, double span)
 {
-  mDataContainer->append(QCPErrorBarsData(error));
+  mDataContainer->add(QCPAnnotationData(key, style, label, span));
+  if (span > mMaxSpan)
+    mMaxSpan = span;
 }
 
-/*! \overload
-
-  Adds a single asymmetrical error bar as specified in \a errorMinus and \a errorPlus. The errors
-  will be associated one-to-one by the data point index to the associated data plottable (\ref
-  setDataPlottable).
-
-  You can directly access and manipulate the error bar data via \ref data.
-
-  \see setData
+/*!
+  Recalculates the largest marker span, which is needed to find band markers that start left of
+  the visible key range but reach into it. This is done automatically by \ref setData and \ref
+  addData. Call it if you modify the spans of markers via \ref data directly.
 */
-void QCPErrorBars::addData(double errorMinus, double errorPlus)
-{
-  mDataContainer->append(QCPErrorBarsData(errorMinus, errorPlus));
-}
-
-/* inherits documentation from base class */
-int QCPErrorBars::dataCount() const
-{
-  return mDataContainer->size();
-}
-
-/* inherits documentation from base class */
-double QCPErrorBars::dataMainKey(int index) const
-{
-  if (mDataPlottable)
-    return mDataPlottable->interface1D()->dataMainKey(index);
-  else
-    qDebug() << Q_FUNC_INFO << "no data plottable set";
-  return 0;
-}
-
-/* inherits documentation from base class */
-double QCPErrorBars::dataSortKey(int index) const
-{
-  if (mDataPlottable)
-    return mDataPlottable->interface1D()->dataSortKey(index);
-  else
-    qDebug() << Q_FUNC_INFO << "no data plottable set";
-  return 0;
-}
-
-/* inherits documentation from base class */
-double QCPErrorBars::dataMainValue(int index) const
-{
-  if (mDataPlottable)
-    return mDataPlottable->interface1D()->dataMainValue(index);
-  else
-    qDebug() << Q_FUNC_INFO << "no data plottable set";
-  return 0;
-}
-
-/* inherits documentation from base class */
-QCPRange QCPErrorBars::dataValueRange(int index) const
-{
-  if (mDataPlottable)
-  {
-    const double value = mDataPlottable->interface1D()->dataMainValue(index);
-    if (index >= 0 && index < mDataContainer->size() && mErrorType == etValueError)
-      return {value-mDataContainer->at(index).errorMinus, value+mDataContainer->at(index).errorPlus};
-    else
-      return {value, value};
-  } else
-  {
-    qDebug() << Q_FUNC_INFO << "no data plottable set";
-    return {};
-  }
-}
-
-/* inherits documentation from base class */
-QPointF QCPErrorBars::dataPixelPosition(int index) const
-{
-  if (mDataPlottable)
-    return mDataPlottable->interface1D()->dataPixelPosition(index);
-  else
-    qDebug() << Q_FUNC_INFO << "no data plottable set";
-  return {};
-}
-
-/* inherits documentation from base class */
-bool QCPErrorBars::sortKeyIsMainKey() const
+void QCPAnnotations::updateMaxSpan()
 {
-  if (mDataPlottable)
+  mMaxSpan = 0;
+  for (QCPAnnotationDataContainer::const_iterator it=mDataContainer->constBegin(); it!=mDataContainer->constEnd(); ++it)
   {
-    return mDataPlottable->interface1D()->sortKeyIsMainKey();
-  } else
-  {
-    qDebug() << Q_FUNC_INFO << "no data plottable set";
-    return true;
+    if (it->span > mMaxSpan)
+      mMaxSpan = it->span;
   }
 }
 
 /*!
-  \copydoc QCPPlottableInterface1D::selectTestRect
+  Returns a data selection containing all markers whose key interval intersects the key extent of
+  \a rect.
+  
+  \seebaseclassmethod \ref QCPAbstractPlottable::selectTestRect
 */
-QCPDataSelection QCPErrorBars::selectTestRect(const QRectF &rect, bool onlySelectable) const
+QCPDataSelection QCPAnnotations::selectTestRect(const QRectF &rect, bool onlySelectable) const
 {
   QCPDataSelection result;
-  if (!mDataPlottable)
-    return result;
   if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
     return result;
   if (!mKeyAxis || !mValueAxis)
     return result;
   
-  QCPErrorBarsDataContainer::const_iterator visibleBegin, visibleEnd;
-  getVisibleDataBounds(visibleBegin, visibleEnd, QCPDataRange(0, dataCount()));
+  QCPAxis *keyAxis = mKeyAxis.data();
+  double lower, upper;
+  if (keyAxis->orientation() == Qt::Horizontal)
+  {
+    lower = keyAxis->pixelToCoord(rect.left());
+    upper = keyAxis->pixelToCoord(rect.right());
+  } else
+  {
+    lower = keyAxis->pixelToCoord(rect.bottom());
+    upper = keyAxis->pixelToCoord(rect.top());
+  }
+  if (lower > upper)
+    qSwap(lower, upper);
   
-  QVector<QLineF> backbones, whiskers;
-  for (QCPErrorBarsDataContainer::const_iterator it=visibleBegin; it!=visibleEnd; ++it)
+  QCPAnnotationDataContainer::const_iterator begin = mDataContainer->findBegin(lower-mMaxSpan);
+  QCPAnnotationDataContainer::const_iterator end = mDataContainer->findEnd(upper);
+  for (QCPAnnotationDataContainer::const_iterator it=begin; it!=end; ++it)
   {
-    backbones.clear();
-    whiskers.clear();
-    getErrorBarLines(it, backbones, whiskers);
-    foreach (const QLineF &backbone, backbones)
-    {
-      if (rectIntersectsLine(rect, backbone))
-      {
-        result.addDataRange(QCPDataRange(int(it-mDataContainer->constBegin()), int(it-mDataContainer->constBegin()+1)), false);
-        break;
-      }
-    }
+    if (it->key <= upper && it->key+qMax(it->span, 0.0) >= lower)
+      result.addDataRange(QCPDataRange(int(it-mDataContainer->constBegin()), int(it-mDataContainer->constBegin()+1)), false);
   }
   result.simplify();
   return result;
 }
 
-/* inherits documentation from base class */
-int QCPErrorBars::findBegin(double sortKey, bool expandedRange) const
-{
-  if (mDataPlottable)
-  {
-    if (mDataContainer->isEmpty())
-      return 0;
-    int beginIndex = mDataPlottable->interface1D()->findBegin(sortKey, expandedRange);
-    if (beginIndex >= mDataContainer->size())
-      beginIndex = mDataContainer->size()-1;
-    return beginIndex;
-  } else
-    qDebug() << Q_FUNC_INFO << "no data plottable set";
-  return 0;
-}
-
-/* inherits documentation from base class */
-int QCPErrorBars::findEnd(double sortKey, bool expandedRange) const
-{
-  if (mDataPlottable)
-  {
-    if (mDataContainer->isEmpty())
-      return 0;
-    int endIndex = mDataPlottable->interface1D()->findEnd(sortKey, expandedRange);
-    if (endIndex > mDataContainer->size())
-      endIndex = mDataContainer->size();
-    return endIndex;
-  } else
-    qDebug() << Q_FUNC_INFO << "no data plottable set";
-  return 0;
-}
-
 /*!
-  Implements a selectTest specific to this plottable's point geometry.
-
-  If \a details is not 0, it will be set to a \ref QCPDataSelection, describing the closest data
-  point to \a pos.
+  Implements a selectTest specific to this plottable's point geometry. Only the markers within the
+  selection tolerance around \a pos are inspected, which are found by binary search in the sorted
+  data.
+  
+  If \a details is not 0, it will be set to a \ref QCPDataSelection, describing the closest marker
+  to \a pos.
   
   \seebaseclassmethod \ref QCPAbstractPlottable::selectTest
 */
-double QCPErrorBars::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
+double QCPAnnotations::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
 {
-  if (!mDataPlottable) return -1;
-  
   if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty())
     return -1;
   if (!mKeyAxis || !mValueAxis)
     return -1;
   
-  if (mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()) || mParentPlot->interactions().testFlag(QCP::iSelectPlottablesBeyondAxisRect))
+  if (mKeyAxis->axisRect()->rect().contains(pos.toPoint()) || mParentPlot->interactions().testFlag(QCP::iSelectPlottablesBeyondAxisRect))
   {
-    QCPErrorBarsDataContainer::const_iterator closestDataPoint = mDataContainer->constEnd();
-    double result = pointDistance(pos, closestDataPoint);
+    QCPAxis *keyAxis = mKeyAxis.data();
+    const double posKeyPixel = keyAxis->orientation() == Qt::Horizontal ? pos.x() : pos.y();
+    const double tolerance = mParentPlot->selectionTolerance();
+    double lower = keyAxis->pixelToCoord(posKeyPixel-tolerance);
+    double upper = keyAxis->pixelToCoord(posKeyPixel+tolerance);
+    if (lower > upper)
+      qSwap(lower, upper);
+    
+    QCPAnnotationDataContainer::const_iterator closestDataPoint = mDataContainer->constEnd();
+    QCPAnnotationDataContainer::const_iterator begin = mDataContainer->findBegin(lower-mMaxSpan);
+    QCPAnnotationDataContainer::const_iterator end = mDataContainer->findEnd(upper);
+    double minDist = (std::numeric_limits<double>::max)();
+    for (QCPAnnotationDataContainer::const_iterator it=begin; it!=end; ++it)
+    {
+      const double keyPixel = keyAxis->coordToPixel(it->key);
+      double currentDist;
+      if (it->span > 0)
+      {
+        const double keyEndPixel = keyAxis->coordToPixel(it->key+it->span);
+        if (posKeyPixel >= qMin(keyPixel, keyEndPixel) && posKeyPixel <= qMax(keyPixel, keyEndPixel))
+          currentDist = tolerance*0.99;
+        else
+          currentDist = qMin(qAbs(posKeyPixel-keyPixel), qAbs(posKeyPixel-keyEndPixel));
+      } else
+        currentDist = qAbs(posKeyPixel-keyPixel);
+      if (currentDist < minDist)
+      {
+        minDist = currentDist;
+        closestDataPoint = it;
+      }
+    }
+    if (closestDataPoint == mDataContainer->constEnd())
+      return -1;
     if (details)
     {
       int pointIndex = int(closestDataPoint-mDataContainer->constBegin());
       details->setValue(QCPDataSelection(QCPDataRange(pointIndex, pointIndex+1)));
     }
-    return result;
-  } else
-    return -1;
+    return minDist;
+  }
+  return -1;
 }
 
 /* inherits documentation from base class */
-void QCPErrorBars::draw(QCPPainter *painter)
+QCPRange QCPAnnotations::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
 {
-  if (!mDataPlottable) return;
-  if (!mKeyAxis || !mValueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
-  if (mKeyAxis.data()->range().size() <= 0 || mDataContainer->isEmpty()) return;
-  
-  // if the sort key isn't the main key, we must check the visibility for each data point/error bar individually
-  // (getVisibleDataBounds applies range restriction, but otherwise can only return full data range):
-  bool checkPointVisibility = !mDataPlottable->interface1D()->sortKeyIsMainKey();
-      
-    // check data validity if flag set:
-#ifdef QCUSTOMPLOT_CHECK_DATA
-  QCPErrorBarsDataContainer::const_iterator it;
-  for (it = mDataContainer->constBegin(); it != mDataContainer->constEnd(); ++it)
-  {
-    if (QCP::isInvalidData(it->errorMinus, it->errorPlus))
-      qDebug() << Q_FUNC_INFO << "Data point at index" << it-mDataContainer->constBegin() << "invalid." << "Plottable name:" << name();
-  }
-#endif
-  
-  applyDefaultAntialiasingHint(painter);
-  painter->setBrush(Qt::NoBrush);
-  // loop over and draw segments of unselected/selected data:
-  QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
-  getDataSegments(selectedSegments, unselectedSegments);
-  allSegments << unselectedSegments << selectedSegments;
-  QVector<QLineF> backbones, whiskers;
-  for (int i=0; i<allSegments.size(); ++i)
+  QCPRange range = mDataContainer->keyRange(foundRange, inSignDomain);
+  // include the end of band markers:
+  if (foundRange && mMaxSpan > 0)
   {
-    QCPErrorBarsDataContainer::const_iterator begin, end;
-    getVisibleDataBounds(begin, end, allSegments.at(i));
-    if (begin == end)
-      continue;
-    
-    bool isSelectedSegment = i >= unselectedSegments.size();
-    if (isSelectedSegment && mSelectionDecorator)
-      mSelectionDecorator->applyPen(painter);
-    else
-      painter->setPen(mPen);
-    if (painter->pen().capStyle() == Qt::SquareCap)
+    for (QCPAnnotationDataContainer::const_iterator it=mDataContainer->constBegin(); it!=mDataContainer->constEnd(); ++it)
     {
-      QPen capFixPen(painter->pen());
-      capFixPen.setCapStyle(Qt::FlatCap);
-      painter->setPen(capFixPen);
-    }
-    backbones.clear();
-    whiskers.clear();
-    for (QCPErrorBarsDataContainer::const_iterator it=begin; it!=end; ++it)
-    {
-      if (!checkPointVisibility || errorBarVisible(int(it-mDataContainer->constBegin())))
-        getErrorBarLines(it, backbones, whiskers);
+      const double end = it->key+it->span;
+      if (it->span > 0 && end > range.upper && (inSignDomain != QCP::sdNegative || end < 0))
+        range.upper = end;
     }
-    painter->drawLines(backbones);
-    painter->drawLines(whiskers);
-  }
-  
-  // draw other selection decoration that isn't just line/scatter pens and brushes:
-  if (mSelectionDecorator)
-    mSelectionDecorator->drawDecoration(painter, selection());
-}
-
-/* inherits documentation from base class */
-void QCPErrorBars::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
-{
-  applyDefaultAntialiasingHint(painter);
-  painter->setPen(mPen);
-  if (mErrorType == etValueError && mValueAxis && mValueAxis->orientation() == Qt::Vertical)
-  {
-    painter->drawLine(QLineF(rect.center().x(), rect.top()+2, rect.center().x(), rect.bottom()-1));
-    painter->drawLine(QLineF(rect.center().x()-4, rect.top()+2, rect.center().x()+4, rect.top()+2));
-    painter->drawLine(QLineF(rect.center().x()-4, rect.bottom()-1, rect.center().x()+4, rect.bottom()-1));
-  } else
-  {
-    painter->drawLine(QLineF(rect.left()+2, rect.center().y(), rect.right()-2, rect.center().y()));
-    painter->drawLine(QLineF(rect.left()+2, rect.center().y()-4, rect.left()+2, rect.center().y()+4));
-    painter->drawLine(QLineF(rect.right()-2, rect.center().y()-4, rect.right()-2, rect.center().y()+4));
   }
+  return range;
 }
 
-/* inherits documentation from base class */
-QCPRange QCPErrorBars::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
-{
-  if (!mDataPlottable)
-  {
-    foundRange = false;
-    return {};
-  }
-  
-  QCPRange range;
-  bool haveLower = false;
-  bool haveUpper = false;
-  QCPErrorBarsDataContainer::const_iterator it;
-  for (it = mDataContainer->constBegin(); it != mDataContainer->constEnd(); ++it)
-  {
-    if (mErrorType == etValueError)
-    {
-      // error bar doesn't extend in key dimension (except whisker but we ignore that here), so only use data point center
-      const double current = mDataPlottable->interface1D()->dataMainKey(int(it-mDataContainer->constBegin()));
-      if (qIsNaN(current)) continue;
-      if (inSignDomain == QCP::sdBoth || (inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
-      {
-        if (current < range.lower || !haveLower)
-        {
-          range.lower = current;
-          haveLower = true;
-        }
-        if (current > range.upper || !haveUpper)
-        {
-          range.upper = current;
-          haveUpper = true;
-        }
-      }
-    } else // mErrorType == etKeyError
-    {
-      const double dataKey = mDataPlottable->interface1D()->dataMainKey(int(it-mDataContainer->constBegin()));
-      if (qIsNaN(dataKey)) continue;
-      // plus error:
-      double current = dataKey + (qIsNaN(it->errorPlus) ? 0 : it->errorPlus);
-      if (inSignDomain == QCP::sdBoth || (inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
-      {
-        if (current > range.upper || !haveUpper)
-        {
-          range.upper = current;
-          haveUpper = true;
-        }
-      }
-      // minus error:
-      current = dataKey - (qIsNaN(it->errorMinus) ? 0 : it->errorMinus);
-      if (inSignDomain == QCP::sdBoth || (inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
-      {
-        if (current < range.lower || !haveLower)
-        {
-          range.lower = current;
-          haveLower = true;
-        }
-      }
-    }
-  }
-  
-  if (haveUpper && !haveLower)
-  {
-    range.lower = range.upper;
-    haveLower = true;
-  } else if (haveLower && !haveUpper)
-  {
-    range.upper = range.lower;
-    haveUpper = true;
-  }
+/*!
+  Markers span the visible value range and don't have a value extent of their own, so this method
+  always sets \a foundRange to false.
   
-  foundRange = haveLower && haveUpper;
-  return range;
+  \seebaseclassmethod \ref QCPAbstractPlottable::getValueRange
+*/
+QCPRange QCPAnnotations::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
+{
+  Q_UNUSED(inSignDomain)
+  Q_UNUSED(inKeyRange)
+  foundRange = false;
+  return QCPRange();
 }
 
 /* inherits documentation from base class */
-QCPRange QCPErrorBars::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
+void QCPAnnotations::draw(QCPPainter *painter)
 {
-  if (!mDataPlottable)
-  {
-    foundRange = false;
-    return {};
-  }
-  
-  QCPRange range;
-  const bool restrictKeyRange = inKeyRange != QCPRange();
-  bool haveLower = false;
-  bool haveUpper = false;
-  QCPErrorBarsDataContainer::const_iterator itBegin = mDataContainer->constBegin();
-  QCPErrorBarsDataContainer::const_iterator itEnd = mDataContainer->constEnd();
-  if (mDataPlottable->interface1D()->sortKeyIsMainKey() && restrictKeyRange)
+  if (mDataContainer->isEmpty()) return;
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
+  
+  QCPAnnotationDataContainer::const_iterator visibleBegin, visibleEnd;
+  getVisibleDataBounds(visibleBegin, visibleEnd);
+  if (visibleBegin == visibleEnd)
+    return;
+  
+  // markers span the entire visible value range:
+  const double valueLowerPixel = valueAxis->coordToPixel(valueAxis->range().lower);
+  const double valueUpperPixel = valueAxis->coordToPixel(valueAxis->range().upper);
+  const bool keyIsHorizontal = keyAxis->orientation() == Qt::Horizontal;
+  const int styleCount = mStyles.size();
+  if (mStyleLines.size() != styleCount)
   {
-    itBegin = mDataContainer->constBegin()+findBegin(inKeyRange.lower, false);
-    itEnd = mDataContainer->constBegin()+findEnd(inKeyRange.upper, false);
+    mStyleLines.resize(styleCount);
+    mStyleBands.resize(styleCount);
   }
-  for (QCPErrorBarsDataContainer::const_iterator it = itBegin; it != itEnd; ++it)
+  QVector<int> lastLinePixel(styleCount);
+  
+  // loop over and draw segments of unselected/selected data:
+  QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
+  getDataSegments(selectedSegments, unselectedSegments);
+  allSegments << unselectedSegments << selectedSegments;
+  applyDefaultAntialiasingHint(painter);
+  for (int i=0; i<allSegments.size(); ++i)
   {
-    if (restrictKeyRange)
+    bool isSelectedSegment = i >= unselectedSegments.size();
+    QCPAnnotationDataContainer::const_iterator begin = visibleBegin;
+    QCPAnnotationDataContainer::const_iterator end = visibleEnd;
+    mDataContainer->limitIteratorsToDataRange(begin, end, allSegments.at(i));
+    if (begin == end)
+      continue;
+    
+    // sort the markers into per-style batches, skipping line markers that fall onto the same pixel
+    // column as the previous line of the same style:
+    for (int s=0; s<styleCount; ++s)
     {
-      const double dataKey = mDataPlottable->interface1D()->dataMainKey(int(it-mDataContainer->constBegin()));
-      if (dataKey < inKeyRange.lower || dataKey > inKeyRange.upper)
-        continue;
+      mStyleLines[s].resize(0);
+      mStyleBands[s].resize(0);
+      lastLinePixel[s] = (std::numeric_limits<int>::min)();
     }
-    if (mErrorType == etValueError)
+    for (QCPAnnotationDataContainer::const_iterator it=begin; it!=end; ++it)
     {
-      const double dataValue = mDataPlottable->interface1D()->dataMainValue(int(it-mDataContainer->constBegin()));
-      if (qIsNaN(dataValue)) continue;
-      // plus error:
-      double current = dataValue + (qIsNaN(it->errorPlus) ? 0 : it->errorPlus);
-      if (inSignDomain == QCP::sdBoth || (inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
+      const int style = styleIndex(it->style);
+      const double keyPixel = keyAxis->coordToPixel(it->key);
+      if (it->span > 0)
       {
-        if (current > range.upper || !haveUpper)
-        {
-          range.upper = current;
-          haveUpper = true;
-        }
-      }
-      // minus error:
-      current = dataValue - (qIsNaN(it->errorMinus) ? 0 : it->errorMinus);
-      if (inSignDomain == QCP::sdBoth || (inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
+        const double keyEndPixel = keyAxis->coordToPixel(it->key+it->span);
+        if (keyIsHorizontal)
+          mStyleBands[style].append(QRectF(QPointF(keyPixel, valueUpperPixel), QPointF(keyEndPixel, valueLowerPixel)).normalized());
+        else
+          mStyleBands[style].append(QRectF(QPointF(valueLowerPixel, keyPixel), QPointF(valueUpperPixel, keyEndPixel)).normalized());
+      } else
       {
-        if (current < range.lower || !haveLower)
-        {
-          range.lower = current;
-          haveLower = true;
-        }
+        const int pixelColumn = qFloor(keyPixel);
+        if (pixelColumn == lastLinePixel.at(style))
+          continue;
+        lastLinePixel[style] = pixelColumn;
+        if (keyIsHorizontal)
+          mStyleLines[style].append(QLineF(keyPixel, valueLowerPixel, keyPixel, valueUpperPixel));
+        else
+          mStyleLines[style].append(QLineF(valueLowerPixel, keyPixel, valueUpperPixel, keyPixel));
       }
-    } else // mErrorType == etKeyError
+    }
+    
+    // draw each style batch with a single call:
+    for (int s=0; s<styleCount; ++s)
     {
-      // error bar doesn't extend in value dimension (except whisker but we ignore that here), so only use data point center
-      const double current = mDataPlottable->interface1D()->dataMainValue(int(it-mDataContainer->constBegin()));
-      if (qIsNaN(current)) continue;
-      if (inSignDomain == QCP::sdBoth || (inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
+      if (mStyleLines.at(s).isEmpty() && mStyleBands.at(s).isEmpty())
+        continue;
+      if (isSelectedSegment && mSelectionDecorator)
       {
-        if (current < range.lower || !haveLower)
-        {
-          range.lower = current;
-          haveLower = true;
-        }
-        if (current > range.upper || !haveUpper)
-        {
-          range.upper = current;
-          haveUpper = true;
-        }
+        mSelectionDecorator->applyPen(painter);
+        mSelectionDecorator->applyBrush(painter);
+      } else
+      {
+        painter->setPen(mStyles.at(s).pen);
+        painter->setBrush(mStyles.at(s).brush);
       }
+      if (!mStyleBands.at(s).isEmpty())
+        painter->drawRects(mStyleBands.at(s));
+      if (!mStyleLines.at(s).isEmpty())
+        painter->drawLines(mStyleLines.at(s));
     }
+    
+    if (!mLabels.isEmpty())
+      drawLabels(painter, begin, end, isSelectedSegment);
   }
   
-  if (haveUpper && !haveLower)
-  {
-    range.lower = range.upper;
-    haveLower = true;
-  } else if (haveLower && !haveUpper)
-  {
-    range.upper = range.lower;
-    haveUpper = true;
-  }
-  
-  foundRange = haveLower && haveUpper;
-  return range;
+  // draw other selection decoration that isn't just line/scatter pens and brushes:
+  if (mSelectionDecorator)
+    mSelectionDecorator->drawDecoration(painter, selection());
 }
 
-/*! \internal
-
-  Calculates the lines that make up the error bar belonging to the data point \a it.
-
-  The resulting lines are added to \a backbones and \a whiskers. The vectors are not cleared, so
-  calling this method with different \a it but the same \a backbones and \a whiskers allows to
-  accumulate lines for multiple data points.
+/* inherits documentation from base class */
+void QCPAnnotations::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
+{
+  // the icon shows style 0, which always exists and is what markers use by default:
+  const Style &style = mStyles.first();
+  applyDefaultAntialiasingHint(painter);
+  painter->setPen(style.pen);
+  painter->setBrush(style.brush);
+  QRectF r = QRectF(0, 0, rect.width()*0.4, rect.height());
+  r.moveCenter(rect.center());
+  painter->fillRect(r, style.brush);
+  painter->drawLine(QLineF(r.left(), r.top(), r.left(), r.bottom()));
+}
 
-  This method assumes that \a it is a valid iterator within the bounds of this \ref QCPErrorBars
-  instance and within the bounds of the associated data plottable.
+/*! \internal
+  
+  Draws the labels of the markers in the range \a begin to \a end. Labels are placed at the upper
+  end of the value axis next to their marker. A label that would overlap the previously drawn label
+  is skipped, so dense marker regions don't turn into unreadable text clutter.
+  
+  Label sizes are cached per label and style, so only labels that become visible for the first time
+  are measured.
 */
-void QCPErrorBars::getErrorBarLines(QCPErrorBarsDataContainer::const_iterator it, QVector<QLineF> &backbones, QVector<QLineF> &whiskers) const
+void QCPAnnotations::drawLabels(QCPPainter *painter, QCPAnnotationDataContainer::const_iterator begin, QCPAnnotationDataContainer::const_iterator end, bool selected) const
 {
-  if (!mDataPlottable) return;
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  const bool keyIsHorizontal = keyAxis->orientation() == Qt::Horizontal;
+  const double valueLowerPixel = valueAxis->coordToPixel(valueAxis->range().lower);
+  const double valueUpperPixel = valueAxis->coordToPixel(valueAxis->range().upper);
+  const QColor selectedColor = mSelectionDecorator ? mSelectionDecorator->pen().color() : QColor();
   
-  int index = int(it-mDataContainer->constBegin());
-  QPointF centerPixel = mDataPlottable->interface1D()->dataPixelPosition(index);
-  if (qIsNaN(centerPixel.x()) || qIsNaN(centerPixel.y()))
-    return;
-  QCPAxis *errorAxis = mErrorType == etValueError ? mValueAxis.data() : mKeyAxis.data();
-  QCPAxis *orthoAxis = mErrorType == etValueError ? mKeyAxis.data() : mValueAxis.data();
-  const double centerErrorAxisPixel = errorAxis->orientation() == Qt::Horizontal ? centerPixel.x() : centerPixel.y();
-  const double centerOrthoAxisPixel = orthoAxis->orientation() == Qt::Horizontal ? centerPixel.x() : centerPixel.y();
-  const double centerErrorAxisCoord = errorAxis->pixelToCoord(centerErrorAxisPixel); // depending on plottable, this might be different from just mDataPlottable->interface1D()->dataMainKey/Value
-  const double symbolGap = mSymbolGap*0.5*errorAxis->pixelOrientation();
-  // plus error:
-  double errorStart, errorEnd;
-  if (!qIsNaN(it->errorPlus))
+  QRectF lastLabelRect;
+  int currentStyle = -1;
+  for (QCPAnnotationDataContainer::const_iterator it=begin; it!=end; ++it)
   {
-    errorStart = centerErrorAxisPixel+symbolGap;
-    errorEnd = errorAxis->coordToPixel(centerErrorAxisCoord+it->errorPlus);
-    if (errorAxis->orientation() == Qt::Vertical)
+    if (it->label < 0 || it->label >= mLabels.size())
+      continue;
+    const int style = styleIndex(it->style);
+    const QString &text = mLabels.at(it->label);
+    
+    const quint64 sizeKey = (quint64(quint32(style)) << 32) | quint32(it->label);
+    QHash<quint64, QSize>::const_iterator sizeIt = mLabelSizes.constFind(sizeKey);
+    QSize labelSize;
+    if (sizeIt != mLabelSizes.constEnd())
     {
-      if ((errorStart > errorEnd) != errorAxis->rangeReversed())
-        backbones.append(QLineF(centerOrthoAxisPixel, errorStart, centerOrthoAxisPixel, errorEnd));
-      whiskers.append(QLineF(centerOrthoAxisPixel-mWhiskerWidth*0.5, errorEnd, centerOrthoAxisPixel+mWhiskerWidth*0.5, errorEnd));
+      labelSize = sizeIt.value();
     } else
     {
-      if ((errorStart < errorEnd) != errorAxis->rangeReversed())
-        backbones.append(QLineF(errorStart, centerOrthoAxisPixel, errorEnd, centerOrthoAxisPixel));
-      whiskers.append(QLineF(errorEnd, centerOrthoAxisPixel-mWhiskerWidth*0.5, errorEnd, centerOrthoAxisPixel+mWhiskerWidth*0.5));
+      labelSize = QFontMetrics(mStyles.at(style).font).boundingRect(0, 0, 0, 0, Qt::TextDontClip, text).size();
+      mLabelSizes.insert(sizeKey, labelSize);
     }
-  }
-  // minus error:
-  if (!qIsNaN(it->errorMinus))
-  {
-    errorStart = centerErrorAxisPixel-symbolGap;
-    errorEnd = errorAxis->coordToPixel(centerErrorAxisCoord-it->errorMinus);
-    if (errorAxis->orientation() == Qt::Vertical)
-    {
-      if ((errorStart < errorEnd) != errorAxis->rangeReversed())
-        backbones.append(QLineF(centerOrthoAxisPixel, errorStart, centerOrthoAxisPixel, errorEnd));
-      whiskers.append(QLineF(centerOrthoAxisPixel-mWhiskerWidth*0.5, errorEnd, centerOrthoAxisPixel+mWhiskerWidth*0.5, errorEnd));
-    } else
+    
+    const double keyPixel = keyAxis->coordToPixel(it->key);
+    QRectF labelRect;
+    if (keyIsHorizontal)
+      labelRect = QRectF(keyPixel+mLabelPadding, qMin(valueLowerPixel, valueUpperPixel)+mLabelPadding, labelSize.width(), labelSize.height());
+    else
+      labelRect = QRectF(qMax(valueLowerPixel, valueUpperPixel)-mLabelPadding-labelSize.width(), keyPixel-mLabelPadding-labelSize.height(), labelSize.width(), labelSize.height());
+    if (lastLabelRect.isValid() && labelRect.intersects(lastLabelRect))
+      continue;
+    lastLabelRect = labelRect;
+    
+    if (style != currentStyle)
     {
-      if ((errorStart > errorEnd) != errorAxis->rangeReversed())
-        backbones.append(QLineF(errorStart, centerOrthoAxisPixel, errorEnd, centerOrthoAxisPixel));
-      whiskers.append(QLineF(errorEnd, centerOrthoAxisPixel-mWhiskerWidth*0.5, errorEnd, centerOrthoAxisPixel+mWhiskerWidth*0.5));
+      painter->setFont(mStyles.at(style).font);
+      painter->setPen(selected && mSelectionDecorator ? selectedColor : mStyles.at(style).textColor);
+      currentStyle = style;
     }
+    painter->drawText(labelRect, Qt::TextDontClip, text);
   }
 }
 
 /*! \internal
-
-  This method outputs the currently visible data range via \a begin and \a end. The returned range
-  will also never exceed \a rangeRestriction.
-
-  Since error bars with type \ref etKeyError may extend to arbitrarily positive and negative key
-  coordinates relative to their data point key, this method checks all outer error bars whether
-  they truly don't reach into the visible portion of the axis rect, by calling \ref
-  errorBarVisible. On the other hand error bars with type \ref etValueError that are associated
-  with data plottables whose sort key is equal to the main key (see \ref qcpdatacontainer-datatype
-  "QCPDataContainer DataType") can be handled very efficiently by finding the visible range of
-  error bars through binary search (\ref QCPPlottableInterface1D::findBegin and \ref
-  QCPPlottableInterface1D::findEnd).
-
-  If the plottable's sort key is not equal to the main key, this method returns the full data
-  range, only restricted by \a rangeRestriction. Drawing optimization then has to be done on a
-  point-by-point basis in the \ref draw method.
+  
+  called by \ref draw to determine which markers need to be processed. Band markers that start
+  before the visible key range but reach into it are included, by extending the search range by
+  the largest marker span.
 */
-void QCPErrorBars::getVisibleDataBounds(QCPErrorBarsDataContainer::const_iterator &begin, QCPErrorBarsDataContainer::const_iterator &end, const QCPDataRange &rangeRestriction) const
+void QCPAnnotations::getVisibleDataBounds(QCPAnnotationDataContainer::const_iterator &begin, QCPAnnotationDataContainer::const_iterator &end) const
 {
-  QCPAxis *keyAxis = mKeyAxis.data();
-  QCPAxis *valueAxis = mValueAxis.data();
-  if (!keyAxis || !valueAxis)
+  if (!mKeyAxis)
   {
-    qDebug() << Q_FUNC_INFO << "invalid key or value axis";
+    qDebug() << Q_FUNC_INFO << "invalid key axis";
+    begin = mDataContainer->constEnd();
     end = mDataContainer->constEnd();
-    begin = end;
     return;
   }
-  if (!mDataPlottable || rangeRestriction.isEmpty())
+  begin = mDataContainer->findBegin(mKeyAxis.data()->range().lower-mMaxSpan);
+  end = mDataContainer->findEnd(mKeyAxis.data()->range().upper);
+}
+/* end of 'src/plottables/plottable-annotations.cpp' */
+
+
+/* including file 'src/modelbinding.cpp'    */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPModelBinding
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPModelBinding
+  \brief Keeps the data of a QCPGraph or QCPBars in sync with two columns of a QAbstractItemModel
+  
+  Plotting model data by reading all rows into vectors and calling \ref QCPGraph::setData whenever
+  the model emits \c dataChanged means rebuilding the entire data container for every single edited
+  cell. QCPModelBinding instead listens to the model's change signals and patches only the affected
+  data points:
+  
+  \li \c dataChanged: the affected rows are read from the model again. A data point whose key did
+  not change is updated in place, otherwise it is moved to its new sorted position.
+  \li \c rowsInserted: the new rows are read and merged into the sorted container.
+  \li \c rowsRemoved: the data points of the removed rows are removed from the container.
+  \li \c modelReset, \c layoutChanged, \c rowsMoved and column changes: the data is rebuilt from the
+  model, see \ref rebuild.
+  
+  All data points removed or moved by one model signal are patched together: the removals are
+  applied in a single pass over the container and the moved points are merged back in one step, so
+  a signal affecting k of N rows costs O(N + k log k) regardless of k.
+  
+  Keys and values are read from the columns passed to the constructor, using the item data role
+  set with \ref setRole (default Qt::EditRole, which models typically use for the unformatted
+  value). Rows whose key is not
+  numeric are left out, non-numeric values become NaN, which creates a gap in graphs. Only the
+  top-level rows of the model are considered, and the column indices are not adjusted when columns
+  are inserted or removed.
+  
+  Changes of the model are reflected in the plot with a queued replot (\ref
+  QCustomPlot::rpQueuedReplot), so bursts of model signals result in a single replot. See \ref
+  setAutoReplot.
+  
+  The binding keeps the last known key and value of every row, because \c rowsRemoved is emitted
+  after the rows are gone from the model. Don't modify the plottable's data container directly
+  while a binding is active, or call \ref rebuild afterwards.
+*/
+
+/*!
+  Creates a binding that fills \a graph with the data of \a model, using \a keyColumn for the keys
+  and \a valueColumn for the values of the data points. The current data of \a graph is replaced by
+  the model data.
+*/
+QCPModelBinding::QCPModelBinding(QAbstractItemModel *model, QCPGraph *graph, int keyColumn, int valueColumn, QObject *parent) :
+  QObject(parent),
+  mModel(model),
+  mGraph(graph),
+  mKeyColumn(keyColumn),
+  mValueColumn(valueColumn),
+  mRole(Qt::EditRole),
+  mAutoReplot(true)
+{
+  connectModel();
+  rebuild();
+}
+
+/*!
+  Creates a binding that fills \a bars with the data of \a model, using \a keyColumn for the keys
+  and \a valueColumn for the values of the bars. The current data of \a bars is replaced by the
+  model data.
+*/
+QCPModelBinding::QCPModelBinding(QAbstractItemModel *model, QCPBars *bars, int keyColumn, int valueColumn, QObject *parent) :
+  QObject(parent),
+  mModel(model),
+  mBars(bars),
+  mKeyColumn(keyColumn),
+  mValueColumn(valueColumn),
+  mRole(Qt::EditRole),
+  mAutoReplot(true)
+{
+  connectModel();
+  rebuild();
+}
+
+QCPModelBinding::~QCPModelBinding()
+{
+}
+
+/*!
+  Returns the plottable whose data is kept in sync with the model, or \c nullptr if it was deleted.
+*/
+QCPAbstractPlottable *QCPModelBinding::plottable() const
+{
+  if (mGraph)
+    return mGraph.data();
+  return mBars.data();
+}
+
+/*!
+  Sets the item data role used to read keys and values from the model. The data is rebuilt with
+  the new role.
+*/
+void QCPModelBinding::setRole(int role)
+{
+  if (mRole != role)
   {
-    end = mDataContainer->constEnd();
-    begin = end;
-    return;
+    mRole = role;
+    rebuild();
   }
-  if (!mDataPlottable->interface1D()->sortKeyIsMainKey())
-  {
-    // if the sort key isn't the main key, it's not possible to find a contiguous range of visible
-    // data points, so this method then only applies the range restriction and otherwise returns
-    // the full data range. Visibility checks must be done on a per-datapoin-basis during drawing
-    QCPDataRange dataRange(0, mDataContainer->size());
-    dataRange = dataRange.bounded(rangeRestriction);
-    begin = mDataContainer->constBegin()+dataRange.begin();
-    end = mDataContainer->constBegin()+dataRange.end();
+}
+
+/*!
+  Sets whether the parent plot of the plottable is replotted automatically when the model changes.
+  The replot is queued, see \ref QCustomPlot::rpQueuedReplot, so bursts of model changes cause a
+  single replot.
+*/
+void QCPModelBinding::setAutoReplot(bool enabled)
+{
+  mAutoReplot = enabled;
+}
+
+/*!
+  Replaces the plottable's data with all top-level rows of the model. This is done automatically
+  on construction and whenever the model signals a reset or a structural change that can't be
+  patched.
+*/
+void QCPModelBinding::rebuild()
+{
+  if (mGraph)
+    rebuildData(mGraph.data()->data().data());
+  else if (mBars)
+    rebuildData(mBars.data()->data().data());
+  dataUpdated();
+}
+
+/*! \internal
+  
+  Connects the change signals of the model to the patch slots of this binding.
+*/
+void QCPModelBinding::connectModel()
+{
+  if (!mModel)
     return;
-  }
+  connect(mModel.data(), SIGNAL(dataChanged(QModelIndex,QModelIndex)), this, SLOT(modelDataChanged(QModelIndex,QModelIndex)));
+  connect(mModel.data(), SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(modelRowsInserted(QModelIndex,int,int)));
+  connect(mModel.data(), SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(modelRowsRemoved(QModelIndex,int,int)));
+  connect(mModel.data(), SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)), this, SLOT(rebuild()));
+  connect(mModel.data(), SIGNAL(columnsInserted(QModelIndex,int,int)), this, SLOT(rebuild()));
+  connect(mModel.data(), SIGNAL(columnsRemoved(QModelIndex,int,int)), this, SLOT(rebuild()));
+  connect(mModel.data(), SIGNAL(columnsMoved(QModelIndex,int,int,QModelIndex,int)), this, SLOT(rebuild()));
+  connect(mModel.data(), SIGNAL(layoutChanged()), this, SLOT(rebuild()));
+  connect(mModel.data(), SIGNAL(modelReset()), this, SLOT(rebuild()));
+}
+
+/*! \internal
   
-  // get visible data range via interface from data plottable, and then restrict to available error data points:
-  const int n = qMin(mDataContainer->size(), mDataPlottable->interface1D()->dataCount());
-  int beginIndex = mDataPlottable->interface1D()->findBegin(keyAxis->range().lower);
-  int endIndex = mDataPlottable->interface1D()->findEnd(keyAxis->range().upper);
-  int i = beginIndex;
-  while (i > 0 && i < n && i > rangeRestriction.begin())
+  Reads the key and value of \a row from the model. If the respective cell can't be converted to a
+  number, NaN is returned.
+*/
+void QCPModelBinding::readRow(int row, double &key, double &value) const
+{
+  bool ok = false;
+  key = mModel.data()->index(row, mKeyColumn).data(mRole).toDouble(&ok);
+  if (!ok)
+    key = qQNaN();
+  value = mModel.data()->index(row, mValueColumn).data(mRole).toDouble(&ok);
+  if (!ok)
+    value = qQNaN();
+}
+
+/*! \internal
+  
+  Queues a replot of the parent plot if \ref setAutoReplot is enabled.
+*/
+void QCPModelBinding::dataUpdated()
+{
+  QCPAbstractPlottable *target = plottable();
+  if (mAutoReplot && target && target->parentPlot())
+    target->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+}
+
+/*! \internal
+  
+  Reads all rows of the model into \a container.
+*/
+template <class DataType>
+void QCPModelBinding::rebuildData(QCPDataContainer<DataType> *container)
+{
+  const int rowCount = mModel ? mModel.data()->rowCount() : 0;
+  mRowKeys.resize(rowCount);
+  mRowValues.resize(rowCount);
+  QVector<DataType> data;
+  data.reserve(rowCount);
+  for (int row=0; row<rowCount; ++row)
   {
-    if (errorBarVisible(i))
-      beginIndex = i;
-    --i;
+    readRow(row, mRowKeys[row], mRowValues[row]);
+    if (!qIsNaN(mRowKeys.at(row)))
+      data.append(DataType(mRowKeys.at(row), mRowValues.at(row)));
   }
-  i = endIndex;
-  while (i >= 0 && i < n && i < rangeRestriction.end())
+  container->set(data);
+}
+
+/*! \internal
+  
+  Reads the inserted rows \a first to \a last (inclusive) and merges them into \a container.
+*/
+template <class DataType>
+void QCPModelBinding::insertData(QCPDataContainer<DataType> *container, int first, int last)
+{
+  const int count = last-first+1;
+  mRowKeys.insert(first, count, qQNaN());
+  mRowValues.insert(first, count, qQNaN());
+  QVector<DataType> data;
+  data.reserve(count);
+  for (int row=first; row<=last; ++row)
   {
-    if (errorBarVisible(i))
-      endIndex = i+1;
-    ++i;
+    readRow(row, mRowKeys[row], mRowValues[row]);
+    if (!qIsNaN(mRowKeys.at(row)))
+      data.append(DataType(mRowKeys.at(row), mRowValues.at(row)));
   }
-  QCPDataRange dataRange(beginIndex, endIndex);
-  dataRange = dataRange.bounded(rangeRestriction.bounded(QCPDataRange(0, mDataContainer->size())));
-  begin = mDataContainer->constBegin()+dataRange.begin();
-  end = mDataContainer->constBegin()+dataRange.end();
+  container->add(data);
 }
 
 /*! \internal
-
-  Calculates the minimum distance in pixels the error bars' representation has from the given \a
-  pixelPoint. This is used to determine whether the error bar was clicked or not, e.g. in \ref
-  selectTest. The closest data point to \a pixelPoint is returned in \a closestData.
+  
+  Removes the data points of the removed rows \a first to \a last (inclusive) from \a container.
 */
-double QCPErrorBars::pointDistance(const QPointF &pixelPoint, QCPErrorBarsDataContainer::const_iterator &closestData) const
+template <class DataType>
+void QCPModelBinding::removeData(QCPDataContainer<DataType> *container, int first, int last)
 {
-  closestData = mDataContainer->constEnd();
-  if (!mDataPlottable || mDataContainer->isEmpty())
-    return -1.0;
-  if (!mKeyAxis || !mValueAxis)
+  QVector<DataType> removed;
+  removed.reserve(last-first+1);
+  for (int row=first; row<=last; ++row)
   {
-    qDebug() << Q_FUNC_INFO << "invalid key or value axis";
-    return -1.0;
+    if (!qIsNaN(mRowKeys.at(row)))
+      removed.append(DataType(mRowKeys.at(row), mRowValues.at(row)));
   }
+  removePoints(container, removed);
+  mRowKeys.remove(first, last-first+1);
+  mRowValues.remove(first, last-first+1);
+}
+
+/*! \internal
   
-  QCPErrorBarsDataContainer::const_iterator begin, end;
-  getVisibleDataBounds(begin, end, QCPDataRange(0, dataCount()));
-  
-  // calculate minimum distances to error backbones (whiskers are ignored for speed) and find closestData iterator:
-  double minDistSqr = (std::numeric_limits<double>::max)();
-  QVector<QLineF> backbones, whiskers;
-  for (QCPErrorBarsDataContainer::const_iterator it=begin; it!=end; ++it)
+  Reads the changed rows \a first to \a last (inclusive) and updates their data points in \a
+  container. Points whose new key still lies between its neighbours are updated in place, all
+  others are collected, removed in one pass and merged in again at their new sorted positions.
+*/
+template <class DataType>
+void QCPModelBinding::updateData(QCPDataContainer<DataType> *container, int first, int last)
+{
+  QVector<DataType> removed, added;
+  for (int row=first; row<=last; ++row)
   {
-    getErrorBarLines(it, backbones, whiskers);
-    foreach (const QLineF &backbone, backbones)
+    const double oldKey = mRowKeys.at(row);
+    const double oldValue = mRowValues.at(row);
+    double key, value;
+    readRow(row, key, value);
+    mRowKeys[row] = key;
+    mRowValues[row] = value;
+    
+    if (!qIsNaN(oldKey))
     {
-      const double currentDistSqr = QCPVector2D(pixelPoint).distanceSquaredToLine(backbone);
-      if (currentDistSqr < minDistSqr)
+      // find the point of this row among the points with the same key:
+      const int index = int(container->findBegin(oldKey, false)-container->constBegin());
+      typename QCPDataContainer<DataType>::iterator it = container->begin()+index;
+      const typename QCPDataContainer<DataType>::iterator end = container->end();
+      while (it != end && it->key == oldKey && !(it->value == oldValue || (qIsNaN(it->value) && qIsNaN(oldValue))))
+        ++it;
+      if (it != end && it->key == oldKey && !qIsNaN(key))
       {
-        minDistSqr = currentDistSqr;
-        closestData = it;
+        const bool afterPrevious = it == container->begin() || (it-1)->key <= key;
+        const bool beforeNext = it+1 == end || (it+1)->key >= key;
+        if (afterPrevious && beforeNext)
+        {
+          it->key = key;
+          it->value = value;
+          continue;
+        }
       }
+      removed.append(DataType(oldKey, oldValue));
     }
+    if (!qIsNaN(key))
+      added.append(DataType(key, value));
   }
-  return qSqrt(minDistSqr);
+  removePoints(container, removed);
+  if (!added.isEmpty())
+    container->add(added);
 }
 
 /*! \internal
-
-  \note This method is identical to \ref QCPAbstractPlottable1D::getDataSegments but needs to be
-  reproduced here since the \ref QCPErrorBars plottable, as a special case that doesn't have its
-  own key/value data coordinates, doesn't derive from \ref QCPAbstractPlottable1D. See the
-  documentation there for details.
+  
+  Removes one data point from \a container for every entry of \a points, matched by key and value.
+  Other points with the same key are kept, entries without a matching point are ignored. The
+  container is compacted in a single pass, so removing many points costs the same as removing one.
 */
-void QCPErrorBars::getDataSegments(QList<QCPDataRange> &selectedSegments, QList<QCPDataRange> &unselectedSegments) const
+template <class DataType>
+void QCPModelBinding::removePoints(QCPDataContainer<DataType> *container, QVector<DataType> points)
 {
-  selectedSegments.clear();
-  unselectedSegments.clear();
-  if (mSelectable == QCP::stWhole) // stWhole selection type draws the entire plottable with selected style if mSelection isn't empty
-  {
-    if (selected())
-      selectedSegments << QCPDataRange(0, dataCount());
-    else
-      unselectedSegments << QCPDataRange(0, dataCount());
-  } else
+  if (points.isEmpty())
+    return;
+  std::sort(points.begin(), points.end(), qcpLessThanSortKey<DataType>);
+  
+  QVector<DataType> kept;
+  kept.reserve(container->size());
+  QVector<bool> used(points.size(), false);
+  int next = 0; // first pending point whose key isn't smaller than the current key
+  for (typename QCPDataContainer<DataType>::const_iterator it=container->constBegin(); it!=container->constEnd(); ++it)
   {
-    QCPDataSelection sel(selection());
-    sel.simplify();
-    selectedSegments = sel.dataRanges();
-    unselectedSegments = sel.inverse(QCPDataRange(0, dataCount())).dataRanges();
+    while (next < points.size() && points.at(next).key < it->key)
+      ++next;
+    bool removed = false;
+    for (int i=next; i<points.size() && points.at(i).key == it->key; ++i)
+    {
+      if (!used.at(i) && (points.at(i).value == it->value || (qIsNaN(points.at(i).value) && qIsNaN(it->value))))
+      {
+        used[i] = true;
+        removed = true;
+        break;
+      }
+    }
+    if (!removed)
+      kept.append(*it);
   }
+  container->set(kept, true);
 }
 
 /*! \internal
-
-  Returns whether the error bar at the specified \a index is visible within the current key axis
-  range.
-
-  This method assumes for performance reasons without checking that the key axis, the value axis,
-  and the data plottable (\ref setDataPlottable) are not \c nullptr and that \a index is within
-  valid bounds of this \ref QCPErrorBars instance and the bounds of the data plottable.
+  
+  Handles the \c dataChanged signal of the model by updating the data points of the affected rows,
+  if the change touches the key or value column.
 */
-bool QCPErrorBars::errorBarVisible(int index) const
+void QCPModelBinding::modelDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
 {
-  QPointF centerPixel = mDataPlottable->interface1D()->dataPixelPosition(index);
-  const double centerKeyPixel = mKeyAxis->orientation() == Qt::Horizontal ? centerPixel.x() : centerPixel.y();
-  if (qIsNaN(centerKeyPixel))
-    return false;
+  if (topLeft.parent().isValid())
+    return;
+  const bool keyChanged = mKeyColumn >= topLeft.column() && mKeyColumn <= bottomRight.column();
+  const bool valueChanged = mValueColumn >= topLeft.column() && mValueColumn <= bottomRight.column();
+  if (!keyChanged && !valueChanged)
+    return;
+  const int first = topLeft.row();
+  const int last = qMin(bottomRight.row(), mRowKeys.size()-1);
+  if (first > last)
+    return;
   
-  double keyMin, keyMax;
-  if (mErrorType == etKeyError)
-  {
-    const double centerKey = mKeyAxis->pixelToCoord(centerKeyPixel);
-    const double errorPlus = mDataContainer->at(index).errorPlus;
-    const double errorMinus = mDataContainer->at(index).errorMinus;
-    keyMax = centerKey+(qIsNaN(errorPlus) ? 0 : errorPlus);
-    keyMin = centerKey-(qIsNaN(errorMinus) ? 0 : errorMinus);
-  } else // mErrorType == etValueError
+  if (mGraph)
+    updateData(mGraph.data()->data().data(), first, last);
+  else if (mBars)
+    updateData(mBars.data()->data().data(), first, last);
+  dataUpdated();
+}
+
+/*! \internal
+  
+  Handles the \c rowsInserted signal of the model by adding the data points of the new rows.
+*/
+void QCPModelBinding::modelRowsInserted(const QModelIndex &parent, int first, int last)
+{
+  if (parent.isValid())
+    return;
+  if (first > mRowKeys.size())
   {
-    keyMax = mKeyAxis->pixelToCoord(centerKeyPixel+mWhiskerWidth*0.5*mKeyAxis->pixelOrientation());
-    keyMin = mKeyAxis->pixelToCoord(centerKeyPixel-mWhiskerWidth*0.5*mKeyAxis->pixelOrientation());
+    rebuild();
+    return;
   }
-  return ((keyMax > mKeyAxis->range().lower) && (keyMin < mKeyAxis->range().upper));
+  if (mGraph)
+    insertData(mGraph.data()->data().data(), first, last);
+  else if (mBars)
+    insertData(mBars.data()->data().data(), first, last);
+  dataUpdated();
 }
 
 /*! \internal
-
-  Returns whether \a line intersects (or is contained in) \a pixelRect.
-
-  \a line is assumed to be either perfectly horizontal or perfectly vertical, as is the case for
-  error bar lines.
+  
+  Handles the \c rowsRemoved signal of the model by removing the data points of the removed rows.
 */
-bool QCPErrorBars::rectIntersectsLine(const QRectF &pixelRect, const QLineF &line) const
+void QCPModelBinding::modelRowsRemoved(const QModelIndex &parent, int first, int last)
 {
-  if (pixelRect.left() > line.x1() && pixelRect.left() > line.x2())
-    return false;
-  else if (pixelRect.right() < line.x1() && pixelRect.right() < line.x2())
-    return false;
-  else if (pixelRect.top() > line.y1() && pixelRect.top() > line.y2())
-    return false;
-  else if (pixelRect.bottom() < line.y1() && pixelRect.bottom() < line.y2())
-    return false;
-  else
-    return true;
+  if (parent.isValid())
+    return;
+  if (last >= mRowKeys.size())
+  {
+    rebuild();
+    return;
+  }
+  if (mGraph)
+    removeData(mGraph.data()->data().data(), first, last);
+  else if (mBars)
+    removeData(mBars.data()->data().data(), first, last);
+  dataUpdated();
 }
-/* end of 'src/plottables/plottable-errorbar.cpp' */
+/* end of 'src/modelbinding.cpp' */
 
 
 /* including file 'src/items/item-straightline.cpp' */
@@ -34462,6 +39006,7 @@ QCPPolarGraph::QCPPolarGraph(QCPPolarAxisAngular *keyAxis, QCPPolarAxisRadial *v
   mPen(Qt::black),
   mBrush(Qt::NoBrush),
   mPeriodic(true),
+  mAdaptiveSampling(true),
   mKeyAxis(keyAxis),
   mValueAxis(valueAxis),
   mSelectable(QCP::stWhole)
@@ -34470,6 +39015,12 @@ QCPPolarGraph::QCPPolarGraph(QCPPolarAxisAngular *keyAxis, QCPPolarAxisRadial *v
   if (keyAxis->parentPlot() != valueAxis->parentPlot())
     qDebug() << Q_FUNC_INFO << "Parent plot of keyAxis is not the same as that of valueAxis.";
   
+  mTrigCache.referenceKey = 0;
+  mTrigCache.angularScale = 0;
+  mTrigCache.candidateSize = -1;
+  mTrigCache.candidateFirstKey = 0;
+  mTrigCache.candidateLastKey = 0;
+  
   mKeyAxis->registerPolarGraph(this);
   
   //setSelectionDecorator(new QCPSelectionDecorator); // TODO
@@ -34497,6 +39048,8 @@ QCPPolarGraph::~QCPPolarGraph()
 void QCPPolarGraph::setName(const QString &name)
 {
   mName = name;
+  if (mParentPlot)
+    mParentPlot->invalidateLayout();
 }
 
 /*!
@@ -34553,6 +39106,23 @@ void QCPPolarGraph::setPeriodic(bool enabled)
   mPeriodic = enabled;
 }
 
+/*!
+  Sets whether adaptive sampling shall be used when plotting this graph. Analogous to \ref
+  QCPGraph::setAdaptiveSampling, data points are grouped into angular bins, each spanning one pixel
+  on the outer circle of the angular axis. If there are at least two data points per bin on
+  average, each bin is reduced to its first, minimum, maximum and last data point for lines, and to
+  one data point per radial pixel for scatters.
+
+  Sampled points keep the keys of the original data points, so the cached angle table built for
+  data with unchanging keys stays usable.
+
+  By default, adaptive sampling is enabled.
+*/
+void QCPPolarGraph::setAdaptiveSampling(bool enabled)
+{
+  mAdaptiveSampling = enabled;
+}
+
 /*!
   The key axis of a plottable can be set to any axis of a QCustomPlot, as long as it is orthogonal
   to the plottable's value axis. This function performs no checks to make sure this is the case.
@@ -34972,6 +39542,7 @@ void QCPPolarGraph::draw(QCPPainter *painter)
   if (mLineStyle == lsNone && mScatterStyle.isNone()) return;
   
   painter->setClipRegion(mKeyAxis->exactClipRegion());
+  updateTrigCache();
   
   QVector<QPointF> lines, scatters; // line and (if necessary) scatter pixel coordinates will be stored here while iterating over segments
   
@@ -35364,7 +39935,7 @@ void QCPPolarGraph::getLines(QVector<QPointF> *lines, const QCPDataRange &dataRa
   switch (mLineStyle)
   {
     case lsNone: lines->clear(); break;
-    case lsLine: *lines = dataToLines(lineData); break;
+    case lsLine: dataToPixels(lineData, lines); break;
   }
 }
 
@@ -35383,21 +39954,27 @@ void QCPPolarGraph::getScatters(QVector<QPointF> *scatters, const QCPDataRange &
     return;
   }
   
-  QVector<QCPGraphData> data;
-  getOptimizedScatterData(&data, begin, end);
-  
-  scatters->resize(data.size());
-  for (int i=0; i<data.size(); ++i)
-  {
-    if (!qIsNaN(data.at(i).value))
-      (*scatters)[i] = valueAxis->coordToPixel(data.at(i).key, data.at(i).value);
-  }
+  QCPScratchBuffer<QCPGraphData> data(mParentPlot ? mParentPlot->frameArena()->graphDataPool() : nullptr);
+  getOptimizedScatterData(data.data(), begin, end);
+  dataToPixels(*data, scatters);
 }
 
 void QCPPolarGraph::getOptimizedLineData(QVector<QCPGraphData> *lineData, const QCPGraphDataContainer::const_iterator &begin, const QCPGraphDataContainer::const_iterator &end) const
 {
   lineData->clear();
   
+  // reduce dense data to angular bins first, the clipping below then works on the binned data:
+  QCPScratchBuffer<QCPGraphData> binnedData(mParentPlot ? mParentPlot->frameArena()->graphDataPool() : nullptr);
+  QCPGraphDataContainer::const_iterator dataBegin = begin;
+  QCPGraphDataContainer::const_iterator dataEnd = end;
+  const double binWidth = adaptiveSamplingBinWidth(begin, end);
+  if (binWidth > 0)
+  {
+    getAngularBinnedData(binnedData.data(), begin, end, binWidth);
+    dataBegin = binnedData->constBegin();
+    dataEnd = binnedData->constEnd();
+  }
+  
   // TODO: fix for log axes and thick line style
   
   const QCPRange range = mValueAxis->range();
@@ -35409,8 +39986,8 @@ void QCPPolarGraph::getOptimizedLineData(QVector<QCPGraphData> *lineData, const
   double skipBegin = 0;
   bool belowRange = false;
   bool aboveRange = false;
-  QCPGraphDataContainer::const_iterator it = begin;
-  while (it != end)
+  QCPGraphDataContainer::const_iterator it = dataBegin;
+  while (it != dataEnd)
   {
     if (it->value < lowerClipValue)
     {
@@ -35492,11 +40069,31 @@ void QCPPolarGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData,
   const double clipMargin = range.size()*0.05;
   const double upperClipValue = range.upper + (reversed ? 0 : clipMargin); // clip slightly outside of actual range to avoid scatter size to peek into visible circle
   const double lowerClipValue = range.lower - (reversed ? clipMargin : 0); // clip slightly outside of actual range to avoid scatter size to peek into visible circle
+  // with adaptive sampling, only keep one scatter per radial pixel in each angular bin:
+  const double binWidth = adaptiveSamplingBinWidth(begin, end);
+  const double firstKey = begin == end ? 0 : begin->key;
+  // for each radial pixel, index of the angular bin that last placed a scatter there. Reuses the
+  // member buffer, fill only reallocates when the axis radius grows:
+  QVector<qint64> &radialPixelBin = mRadialPixelBin;
+  if (binWidth > 0)
+    radialPixelBin.fill(-1, int(mKeyAxis->radius()*1.2)+2);
   QCPGraphDataContainer::const_iterator it = begin;
   while (it != end)
   {
     if (it->value > lowerClipValue && it->value < upperClipValue)
-      scatterData->append(*it);
+    {
+      if (binWidth > 0)
+      {
+        const qint64 bin = qint64((it->key-firstKey)/binWidth);
+        const int radialPixel = qBound(0, int(mValueAxis->coordToRadius(it->value)), radialPixelBin.size()-1);
+        if (radialPixelBin.at(radialPixel) != bin)
+        {
+          radialPixelBin[radialPixel] = bin;
+          scatterData->append(*it);
+        }
+      } else
+        scatterData->append(*it);
+    }
     ++it;
   }
 }
@@ -35514,15 +40111,187 @@ void QCPPolarGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData,
 QVector<QPointF> QCPPolarGraph::dataToLines(const QVector<QCPGraphData> &data) const
 {
   QVector<QPointF> result;
-  QCPPolarAxisAngular *keyAxis = mKeyAxis.data();
-  QCPPolarAxisRadial *valueAxis = mValueAxis.data();
-  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return result; }
+  dataToPixels(data, &result);
+  return result;
+}
 
-  // transform data points to pixels:
-  result.resize(data.size());
+/*! \internal
+
+  Transforms the data points \a data from plot coordinates to pixel coordinates and stores them in
+  \a pixels, which is resized accordingly.
+
+  If the angle table is available (see \ref updateTrigCache), the sine and cosine of data points
+  whose keys are found in the table are taken from there and only rotated to the current angular
+  offset, so panning the angular axis, rotating it or changing the radial range doesn't require any
+  trigonometric functions per point. Keys not found in the table are transformed directly. Since
+  the table is searched with a forward-only cursor, \a data is expected to be sorted by key.
+*/
+void QCPPolarGraph::dataToPixels(const QVector<QCPGraphData> &data, QVector<QPointF> *pixels) const
+{
+  if (!pixels) return;
+  QCPPolarAxisRadial *valueAxis = mValueAxis.data();
+  if (!mKeyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; pixels->clear(); return; }
+  
+  QCPPolarAxisAngular *angularAxis = valueAxis->angularAxis();
+  const QPointF center = angularAxis->center();
+  const int cacheSize = mTrigCache.keys.size();
+  const double *cacheKeys = mTrigCache.keys.constData();
+  const QPointF *cacheUnitVectors = mTrigCache.unitVectors.constData();
+  double rotationCos = 1, rotationSin = 0;
+  if (cacheSize > 0)
+  {
+    const double rotation = angularAxis->coordToAngleRad(mTrigCache.referenceKey);
+    rotationCos = qCos(rotation);
+    rotationSin = qSin(rotation);
+  }
+  
+  pixels->resize(data.size());
+  QPointF *pixelData = pixels->data();
+  int cursor = 0;
   for (int i=0; i<data.size(); ++i)
-    result[i] = mValueAxis->coordToPixel(data.at(i).key, data.at(i).value);
-  return result;
+  {
+    const QCPGraphData &point = data.at(i);
+    const double radius = valueAxis->coordToRadius(point.value);
+    double unitX, unitY;
+    while (cursor < cacheSize && cacheKeys[cursor] < point.key)
+      ++cursor;
+    if (cursor < cacheSize && cacheKeys[cursor] == point.key)
+    {
+      const QPointF &unit = cacheUnitVectors[cursor];
+      unitX = unit.x()*rotationCos - unit.y()*rotationSin;
+      unitY = unit.x()*rotationSin + unit.y()*rotationCos;
+    } else
+    {
+      const double angleRad = angularAxis->coordToAngleRad(point.key);
+      unitX = qCos(angleRad);
+      unitY = qSin(angleRad);
+    }
+    pixelData[i] = QPointF(center.x()+unitX*radius, center.y()+unitY*radius);
+  }
+}
+
+/*! \internal
+
+  Returns the key width of the angular bins used for adaptive sampling of the data points in the
+  range [\a begin, \a end). One bin corresponds to one pixel on the outer circle of the angular
+  axis.
+
+  Returns 0 if adaptive sampling is disabled, or if there are less than two data points per bin on
+  average, in which case no sampling shall take place.
+
+  \see setAdaptiveSampling, getAngularBinnedData
+*/
+double QCPPolarGraph::adaptiveSamplingBinWidth(QCPGraphDataContainer::const_iterator begin, QCPGraphDataContainer::const_iterator end) const
+{
+  if (!mAdaptiveSampling || !mKeyAxis || begin == end)
+    return 0;
+  const double binWidth = mKeyAxis->range().size()/(2.0*M_PI*mKeyAxis->radius());
+  if (binWidth <= 0)
+    return 0;
+  const double binCount = ((end-1)->key-begin->key)/binWidth;
+  if (double(end-begin) < 2*binCount+2)
+    return 0;
+  return binWidth;
+}
+
+/*! \internal
+
+  Reduces the data points in the range [\a begin, \a end) to at most four points per angular bin
+  of width \a binWidth: the first, the minimum, the maximum and the last point of each bin, in their
+  original order. The reduced data is stored in \a binnedData.
+
+  In contrast to \ref QCPGraph::getOptimizedLineData, the points keep their original keys, so they
+  can be looked up in the angle table (see \ref updateTrigCache).
+
+  \see adaptiveSamplingBinWidth
+*/
+void QCPPolarGraph::getAngularBinnedData(QVector<QCPGraphData> *binnedData, QCPGraphDataContainer::const_iterator begin, QCPGraphDataContainer::const_iterator end, double binWidth) const
+{
+  binnedData->clear();
+  if (begin == end) return;
+  
+  const double firstKey = begin->key;
+  QCPGraphDataContainer::const_iterator it = begin;
+  while (it != end)
+  {
+    const double binEndKey = firstKey+(qint64((it->key-firstKey)/binWidth)+1)*binWidth;
+    QCPGraphDataContainer::const_iterator binFirst = it;
+    QCPGraphDataContainer::const_iterator binMin = it;
+    QCPGraphDataContainer::const_iterator binMax = it;
+    ++it;
+    while (it != end && it->key < binEndKey)
+    {
+      if (it->value < binMin->value)
+        binMin = it;
+      else if (it->value > binMax->value)
+        binMax = it;
+      ++it;
+    }
+    const QCPGraphDataContainer::const_iterator binPoints[4] = {binFirst, qMin(binMin, binMax), qMax(binMin, binMax), it-1};
+    for (int i=0; i<4; ++i)
+    {
+      if (i == 0 || binPoints[i] != binPoints[i-1])
+        binnedData->append(*binPoints[i]);
+    }
+  }
+}
+
+/*! \internal
+
+  Updates the table of sine and cosine values used by \ref dataToPixels. The table holds the unit
+  vectors of all data keys relative to the first key, so it only depends on the keys and on the
+  size and direction of the angular range. Panning and rotating the angular axis as well as any
+  change of the radial axis keep the table valid.
+
+  To avoid building the table for data whose keys change with every replot (e.g. streaming data),
+  it is only built once the data keys were unchanged between two consecutive calls. This is
+  checked via the data count and the first and last key. Keys that are nonetheless missing from
+  the table are transformed directly by \ref dataToPixels, so a stale table never causes wrong
+  output.
+*/
+void QCPPolarGraph::updateTrigCache() const
+{
+  QCPPolarAxisRadial *valueAxis = mValueAxis.data();
+  if (!valueAxis || mDataContainer->isEmpty())
+  {
+    mTrigCache.keys.clear();
+    mTrigCache.unitVectors.clear();
+    mTrigCache.candidateSize = -1;
+    return;
+  }
+  
+  const QCPPolarAxisAngular *angularAxis = valueAxis->angularAxis();
+  const int dataCount = mDataContainer->size();
+  const double firstKey = mDataContainer->constBegin()->key;
+  const double lastKey = (mDataContainer->constEnd()-1)->key;
+  const double angularScale = (angularAxis->rangeReversed() ? -2.0*M_PI : 2.0*M_PI)/angularAxis->range().size();
+  
+  const bool keysUnchanged = dataCount == mTrigCache.candidateSize &&
+                             firstKey == mTrigCache.candidateFirstKey &&
+                             lastKey == mTrigCache.candidateLastKey;
+  mTrigCache.candidateSize = dataCount;
+  mTrigCache.candidateFirstKey = firstKey;
+  mTrigCache.candidateLastKey = lastKey;
+  if (!keysUnchanged)
+  {
+    mTrigCache.keys.clear();
+    mTrigCache.unitVectors.clear();
+    return;
+  }
+  if (mTrigCache.keys.size() == dataCount && mTrigCache.angularScale == angularScale)
+    return; // table is still valid
+  
+  mTrigCache.referenceKey = firstKey;
+  mTrigCache.angularScale = angularScale;
+  mTrigCache.keys.resize(dataCount);
+  mTrigCache.unitVectors.resize(dataCount);
+  int i = 0;
+  for (QCPGraphDataContainer::const_iterator it=mDataContainer->constBegin(); it!=mDataContainer->constEnd(); ++it, ++i)
+  {
+    const double angleRad = (it->key-firstKey)*angularScale;
+    mTrigCache.keys[i] = it->key;
+    mTrigCache.unitVectors[i] = QPointF(qCos(angleRad), qSin(angleRad));
+  }
 }
 /* end of 'src/polar/polargraph.cpp' */
 
@@ -57,6 +57,7 @@
 #include <QtGui/QMouseEvent>
 #include <QtGui/QWheelEvent>
 #include <QtGui/QPixmap>
+#include <QtGui/QPicture>
 #include <QtCore/QVector>
 #include <QtCore/QString>
 #include <QtCore/QDateTime>
@@ -66,9 +67,19 @@
 #include <QtCore/QStack>
 #include <QtCore/QCache>
 #include <QtCore/QMargins>
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/QFile>
+#include <QtCore/QSet>
+#include <QtCore/QHash>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <qmath.h>
 #include <limits>
 #include <algorithm>
+#include <atomic>
 #ifdef QCP_OPENGL_FBO
 #  include <QtGui/QOpenGLContext>
 #  if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -102,6 +113,11 @@
 # if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
 #  include <QtCore/QTimeZone>
 #endif
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+#  include <QtCore/QJsonArray>
+#  include <QtCore/QJsonDocument>
+#  include <QtCore/QJsonObject>
+#endif
 
 class QCPPainter;
 class QCustomPlot;
@@ -109,10 +125,14 @@ class QCPLayerable;
 class QCPLayoutElement;
 class QCPLayout;
 class QCPAxis;
+class QCPAxisGroup;
 class QCPAxisRect;
 class QCPAxisPainterPrivate;
 class QCPAbstractPlottable;
 class QCPGraph;
+class QCPGraphData;
+class QCPFrameArena;
+class QCPProfiler;
 class QCPAbstractItem;
 class QCPPlottableInterface1D;
 class QCPLegend;
@@ -268,6 +288,8 @@ enum PlottingHint { phNone              = 0x000 ///< <tt>0x000</tt> No hints are
                     ,phImmediateRefresh = 0x002 ///< <tt>0x002</tt> causes an immediate repaint() instead of a soft update() when QCustomPlot::replot() is called with parameter \ref QCustomPlot::rpRefreshHint.
                                                 ///<                This is set by default to prevent the plot from freezing on fast consecutive replots (e.g. user drags ranges with mouse).
                     ,phCacheLabels      = 0x004 ///< <tt>0x004</tt> axis (tick) labels will be cached as pixmaps, increasing replot performance.
+                    ,phProgressiveRendering = 0x008 ///< <tt>0x008</tt> while the user drags or zooms axis ranges, graphs are drawn from a coarse subset of their data. Full detail is
+                                                    ///<                restored once the interaction is idle for \ref QCustomPlot::setProgressiveRefineDelay milliseconds.
                   };
 Q_DECLARE_FLAGS(PlottingHints, PlottingHint)
 
@@ -626,6 +648,37 @@ protected:
 };
 
 
+class QCP_LIB_DECL QCPPaintBufferTiledImage : public QCPAbstractPaintBuffer
+{
+public:
+  explicit QCPPaintBufferTiledImage(const QSize &size, double devicePixelRatio, int tileCount=0);
+  virtual ~QCPPaintBufferTiledImage() Q_DECL_OVERRIDE;
+  
+  // getters:
+  int tileCount() const { return mTileCount; }
+  
+  // reimplemented virtual methods:
+  virtual QCPPainter *startPainting() Q_DECL_OVERRIDE;
+  virtual void donePainting() Q_DECL_OVERRIDE;
+  virtual void draw(QCPPainter *painter) const Q_DECL_OVERRIDE;
+  void clear(const QColor &color) Q_DECL_OVERRIDE;
+  
+protected:
+  // non-property members:
+  QImage mBuffer;
+  QPicture mRecording;
+  int mTileCount;
+  
+  // reimplemented virtual methods:
+  virtual void reallocateBuffer() Q_DECL_OVERRIDE;
+  
+  // non-virtual methods:
+  void paintTile(uchar *bits, int tileIndex, int tileCount, const QPicture &picture) const;
+  
+  friend class QCPPaintBufferTileTask;
+};
+
+
 #ifdef QCP_OPENGL_PBUFFER
 class QCP_LIB_DECL QCPPaintBufferGlPbuffer : public QCPAbstractPaintBuffer
 {
@@ -736,6 +789,7 @@ protected:
   
   // non-virtual methods:
   void draw(QCPPainter *painter);
+  void drawChild(QCPPainter *painter, QCPLayerable *child);
   void drawToPaintBuffer();
   void addChild(QCPLayerable *layerable, bool prepend);
   void removeChild(QCPLayerable *layerable);
@@ -1752,20 +1806,42 @@ public:
   TickStepStrategy tickStepStrategy() const { return mTickStepStrategy; }
   int tickCount() const { return mTickCount; }
   double tickOrigin() const { return mTickOrigin; }
+  bool caching() const { return mCaching; }
   
   // setters:
   void setTickStepStrategy(TickStepStrategy strategy);
   void setTickCount(int count);
   void setTickOrigin(double origin);
+  void setCaching(bool enabled);
+  
+  // non-virtual methods:
+  void invalidateCache() { mCache.valid = false; }
   
   // introduced virtual methods:
   virtual void generate(const QCPRange &range, const QLocale &locale, QChar formatChar, int precision, QVector<double> &ticks, QVector<double> *subTicks, QVector<QString> *tickLabels);
   
 protected:
+  struct GenerateCache
+  {
+    bool valid;
+    QCPRange range;
+    QLocale locale;
+    QChar formatChar;
+    int precision;
+    double tickStep;
+    bool hasSubTicks, hasTickLabels;
+    QVector<double> ticks, subTicks;
+    QVector<QString> tickLabels;
+  };
+  
   // property members:
   TickStepStrategy mTickStepStrategy;
   int mTickCount;
   double mTickOrigin;
+  bool mCaching;
+  
+  // non-property members:
+  GenerateCache mCache;
   
   // introduced virtual methods:
   virtual double getTickStep(const QCPRange &range);
@@ -1780,6 +1856,7 @@ protected:
   double pickClosest(double target, const QVector<double> &candidates) const;
   double getMantissa(double input, double *magnitude=nullptr) const;
   double cleanMantissa(double input) const;
+  QVector<QString> createLabelVectorReusingCache(const QVector<double> &ticks, const QLocale &locale, QChar formatChar, int precision);
   
 private:
   Q_DISABLE_COPY(QCPAxisTicker)
@@ -1943,7 +2020,7 @@ public:
   QCPAxisTickerText();
   
   // getters:
-  QMap<double, QString> &ticks() { return mTicks; }
+  QMap<double, QString> &ticks() { invalidateCache(); return mTicks; }
   int subTickCount() const { return mSubTickCount; }
   
   // setters:
@@ -2218,6 +2295,7 @@ public:
   const QCPRange range() const { return mRange; }
   bool rangeReversed() const { return mRangeReversed; }
   QSharedPointer<QCPAxisTicker> ticker() const { return mTicker; }
+  QCPAxisGroup *axisGroup() const { return mAxisGroup; }
   bool ticks() const { return mTicks; }
   bool tickLabels() const { return mTickLabels; }
   int tickLabelPadding() const;
@@ -2265,6 +2343,7 @@ public:
   void setRangeUpper(double upper);
   void setRangeReversed(bool reversed);
   void setTicker(QSharedPointer<QCPAxisTicker> ticker);
+  void setAxisGroup(QCPAxisGroup *group);
   void setTicks(bool show);
   void setTickLabels(bool show);
   void setTickLabelPadding(int padding);
@@ -2321,6 +2400,7 @@ public:
   QList<QCPAbstractItem*> items() const;
   
   static AxisType marginSideToAxisType(QCP::MarginSide side);
+  static QCP::MarginSide axisTypeToMarginSide(AxisType type);
   static Qt::Orientation orientation(AxisType type) { return type==atBottom || type==atTop ? Qt::Horizontal : Qt::Vertical; }
   static AxisType opposite(AxisType type);
   
@@ -2377,6 +2457,7 @@ protected:
   QVector<double> mSubTickVector;
   bool mCachedMarginValid;
   int mCachedMargin;
+  QCPAxisGroup *mAxisGroup;
   bool mDragging;
   QCPRange mDragStartRange;
   QCP::AntialiasedElements mAADragBackup, mNotAADragBackup;
@@ -2413,6 +2494,7 @@ private:
   friend class QCustomPlot;
   friend class QCPGrid;
   friend class QCPAxisRect;
+  friend class QCPAxisGroup;
 };
 Q_DECLARE_OPERATORS_FOR_FLAGS(QCPAxis::SelectableParts)
 Q_DECLARE_OPERATORS_FOR_FLAGS(QCPAxis::AxisTypes)
@@ -2488,6 +2570,61 @@ protected:
   virtual void getMaxTickLabelSize(const QFont &font, const QString &text, QSize *tickLabelsSize) const;
 };
 
+
+class QCP_LIB_DECL QCPAxisGroup : public QObject
+{
+  Q_OBJECT
+  /// \cond INCLUDE_QPROPERTIES
+  Q_PROPERTY(QCPRange range READ range WRITE setRange)
+  Q_PROPERTY(bool autoReplot READ autoReplot WRITE setAutoReplot)
+  /// \endcond
+public:
+  explicit QCPAxisGroup(QObject *parent=nullptr);
+  virtual ~QCPAxisGroup() Q_DECL_OVERRIDE;
+  
+  // getters:
+  QCPRange range() const { return mRange; }
+  bool autoReplot() const { return mAutoReplot; }
+  QSharedPointer<QCPAxisTicker> ticker() const { return mTicker; }
+  
+  // setters:
+  Q_SLOT void setRange(const QCPRange &range);
+  void setAutoReplot(bool enabled);
+  
+  // non-virtual methods:
+  QList<QCPAxis*> axes() const { return mAxes; }
+  QList<QCustomPlot*> plots() const;
+  bool isEmpty() const { return mAxes.isEmpty(); }
+  void clear();
+  void setTicker(QSharedPointer<QCPAxisTicker> ticker);
+  Q_SLOT void queueReplot();
+  
+signals:
+  void rangeChanged(const QCPRange &newRange, const QCPRange &oldRange);
+  
+protected:
+  // property members:
+  QCPRange mRange;
+  bool mAutoReplot;
+  QSharedPointer<QCPAxisTicker> mTicker;
+  
+  // non-property members:
+  QList<QCPAxis*> mAxes;
+  bool mUpdating;
+  bool mReplotQueued;
+  
+  // non-virtual methods:
+  void addChild(QCPAxis *axis);
+  void removeChild(QCPAxis *axis);
+  void axisRangeChanged(QCPAxis *axis);
+  Q_SLOT void replotMembers();
+  
+private:
+  Q_DISABLE_COPY(QCPAxisGroup)
+  
+  friend class QCPAxis;
+};
+
 /* end of 'src/axis/axis.h' */
 
 
@@ -3442,6 +3579,309 @@ void QCPDataContainer<DataType>::performAutoSqueeze()
 /* end of 'src/datacontainer.h' */
 
 
+/* including file 'src/framearena.h'       */
+
+template <typename T>
+class QCPScratchPool // no QCP_LIB_DECL, template class ends up in header
+{
+public:
+  QCPScratchPool() : mBytesAllocated(0), mAllocations(0) {}
+  ~QCPScratchPool() { qDeleteAll(mEntries); }
+  
+  // getters:
+  qint64 bytesAllocated() const { return mBytesAllocated; }
+  int allocations() const { return mAllocations; }
+  qint64 bytesReserved() const;
+  
+  // non-virtual methods:
+  QVector<T> *acquire();
+  void release(QVector<T> *buffer);
+  void resetCounters() { mBytesAllocated = 0; mAllocations = 0; }
+  void releaseMemory();
+  
+protected:
+  struct Entry
+  {
+    QVector<T> buffer;
+    int capacity;
+    bool inUse;
+  };
+  QList<Entry*> mEntries;
+  qint64 mBytesAllocated;
+  int mAllocations;
+  
+private:
+  Q_DISABLE_COPY(QCPScratchPool)
+};
+
+template <typename T>
+class QCPScratchBuffer // no QCP_LIB_DECL, template class ends up in header
+{
+public:
+  explicit QCPScratchBuffer(QCPScratchPool<T> *pool) : mPool(pool), mBuffer(pool ? pool->acquire() : &mOwnBuffer) {}
+  ~QCPScratchBuffer() { if (mPool) mPool->release(mBuffer); }
+  
+  QVector<T> *data() const { return mBuffer; }
+  QVector<T> *operator->() const { return mBuffer; }
+  QVector<T> &operator*() const { return *mBuffer; }
+  
+protected:
+  QCPScratchPool<T> *mPool;
+  QVector<T> mOwnBuffer;
+  QVector<T> *mBuffer;
+  
+private:
+  Q_DISABLE_COPY(QCPScratchBuffer)
+};
+
+class QCP_LIB_DECL QCPFrameArena
+{
+public:
+  QCPFrameArena();
+  ~QCPFrameArena();
+  
+  // getters:
+  qint64 bytesAllocatedLastFrame() const { return mBytesAllocatedLastFrame; }
+  int allocationsLastFrame() const { return mAllocationsLastFrame; }
+  qint64 bytesReserved() const;
+  qint64 frameCount() const { return mFrameCount; }
+  QCPScratchPool<QPointF> *pointPool() { return &mPointPool; }
+  QCPScratchPool<QCPGraphData> *graphDataPool() { return mGraphDataPool; }
+  
+  // non-virtual methods:
+  void endFrame();
+  void releaseMemory();
+  
+protected:
+  QCPScratchPool<QPointF> mPointPool;
+  QCPScratchPool<QCPGraphData> *mGraphDataPool; // pointer because QCPGraphData is still incomplete here
+  qint64 mBytesAllocatedLastFrame;
+  int mAllocationsLastFrame;
+  qint64 mFrameCount;
+  
+private:
+  Q_DISABLE_COPY(QCPFrameArena)
+};
+
+
+
+// include implementation in header since it is a class template:
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPScratchPool
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPScratchPool
+  \brief A pool of reusable vectors for temporary per-replot storage
+  
+  Plottables need a number of temporary buffers while drawing, e.g. the optimized data points and
+  their pixel coordinates. Instead of creating and freeing a new QVector for each of those on every
+  replot, the buffers can be borrowed from a QCPScratchPool with \ref acquire and handed back with
+  \ref release. Released buffers are cleared but keep their capacity, so once the pool has warmed
+  up, replots of data with unchanged size don't cause any heap allocations for these buffers.
+  
+  Typically the pool isn't used directly, but via the RAII handle \ref QCPScratchBuffer, and pools
+  are owned by the \ref QCPFrameArena of the parent plot (\ref QCustomPlot::frameArena).
+  
+  The pool keeps track of how many bytes it had to newly allocate since the last call to \ref
+  resetCounters, by comparing the capacity of each buffer at \ref release to its capacity at \ref
+  acquire.
+*/
+
+/*!
+  Returns a cleared buffer from the pool. If all buffers are currently in use, a new one is
+  created. Each buffer obtained with this method must be handed back via \ref release.
+*/
+template <typename T>
+QVector<T> *QCPScratchPool<T>::acquire()
+{
+  foreach (Entry *entry, mEntries)
+  {
+    if (!entry->inUse)
+    {
+      entry->inUse = true;
+      return &entry->buffer;
+    }
+  }
+  Entry *entry = new Entry;
+  entry->capacity = 0;
+  entry->inUse = true;
+  mEntries.append(entry);
+  ++mAllocations;
+  return &entry->buffer;
+}
+
+/*!
+  Returns \a buffer, previously obtained with \ref acquire, to the pool. The buffer is cleared
+  while retaining its capacity, and any growth of its capacity is accounted in \ref bytesAllocated.
+*/
+template <typename T>
+void QCPScratchPool<T>::release(QVector<T> *buffer)
+{
+  foreach (Entry *entry, mEntries)
+  {
+    if (&entry->buffer == buffer)
+    {
+      entry->buffer.clear(); // keeps capacity unless the buffer was shared in the meantime
+      if (entry->buffer.capacity() > entry->capacity)
+      {
+        mBytesAllocated += qint64(entry->buffer.capacity()-entry->capacity)*qint64(sizeof(T));
+        ++mAllocations;
+      }
+      entry->capacity = entry->buffer.capacity();
+      entry->inUse = false;
+      return;
+    }
+  }
+  qDebug() << Q_FUNC_INFO << "buffer doesn't belong to this pool";
+}
+
+/*!
+  Returns the number of bytes currently held by the buffers of this pool.
+*/
+template <typename T>
+qint64 QCPScratchPool<T>::bytesReserved() const
+{
+  qint64 result = 0;
+  foreach (const Entry *entry, mEntries)
+    result += qint64(entry->buffer.capacity())*qint64(sizeof(T));
+  return result;
+}
+
+/*!
+  Frees the memory of all buffers which are currently not in use. This may be useful after having
+  displayed a very large data set, since the pool otherwise keeps the capacity of its buffers.
+*/
+template <typename T>
+void QCPScratchPool<T>::releaseMemory()
+{
+  for (int i=mEntries.size()-1; i>=0; --i)
+  {
+    if (!mEntries.at(i)->inUse)
+      delete mEntries.takeAt(i);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPScratchBuffer
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPScratchBuffer
+  \brief Scoped handle to a vector borrowed from a QCPScratchPool
+  
+  Acquires a buffer from the pool passed to the constructor and releases it again when going out
+  of scope. The buffer is accessed via \ref data, or with the dereference operators like a pointer
+  to a QVector.
+  
+  If the passed pool is \c nullptr, the handle falls back to an own, non-pooled vector.
+*/
+
+/* end of 'src/framearena.h' */
+
+
+/* including file 'src/profiler.h'         */
+
+class QCP_LIB_DECL QCPProfiler
+{
+public:
+  /*!
+    Defines the replot phases the profiler distinguishes. Phases may be nested, e.g. \ref
+    phAxisTicks is recorded during \ref phLayout, and \ref phDataPreparation during \ref
+    phPlottableDraw.
+  */
+  enum Phase { phReplot          ///< The complete \ref QCustomPlot::replot call
+               ,phLayout         ///< Layout update of the plot (\ref QCustomPlot::updateLayout)
+               ,phAxisTicks      ///< Tick generation of one axis (\ref QCPAxis::setupTickVectors)
+               ,phTickLabels     ///< Painting the tick labels of one axis
+               ,phPlottableDraw  ///< Drawing one plottable, including its data preparation
+               ,phDataPreparation ///< Preparing the (optimized) pixel data of one plottable
+               ,phCompositing    ///< Composing the layer paint buffers onto the widget
+             };
+  enum { phaseCount = phCompositing+1 };
+  enum { maxLabelLength = 31 };
+  
+  /*!
+    One recorded timing event. Times are in nanoseconds relative to the creation of the profiler.
+  */
+  struct Event
+  {
+    Phase phase;
+    qint64 frame;
+    qint64 startNs;
+    qint64 durationNs;
+    QChar label[maxLabelLength];
+    int labelLength;
+    
+    QString labelString() const { return QString(label, labelLength); }
+  };
+  
+  explicit QCPProfiler(int capacity=4096);
+  ~QCPProfiler();
+  
+  // getters:
+  bool enabled() const { return mEnabled; }
+  bool overlayVisible() const { return mOverlayVisible; }
+  int capacity() const { return mCapacity; }
+  qint64 frame() const { return mFrame; }
+  
+  // setters:
+  void setEnabled(bool enabled);
+  void setOverlayVisible(bool visible);
+  
+  // non-virtual methods:
+  void beginFrame();
+  qint64 timestamp() const { return mClock.nsecsElapsed(); }
+  void record(Phase phase, qint64 startNs, qint64 endNs, const QString &label=QString());
+  QVector<Event> events() const;
+  QVector<double> phaseTimes(qint64 frame) const;
+  bool exportChromeTrace(const QString &fileName) const;
+  void drawOverlay(QCPPainter *painter, const QRect &rect) const;
+  void clear();
+  static QString phaseName(Phase phase);
+  
+protected:
+  struct Slot
+  {
+    std::atomic<qint64> sequence; // odd while the slot is being written, 2*(write count) when complete
+    Event event;
+  };
+  
+  // property members:
+  bool mEnabled;
+  bool mOverlayVisible;
+  
+  // non-property members:
+  int mCapacity;
+  Slot *mSlots;
+  std::atomic<qint64> mWriteCount;
+  qint64 mFrame;
+  QElapsedTimer mClock;
+  
+private:
+  Q_DISABLE_COPY(QCPProfiler)
+};
+Q_DECLARE_TYPEINFO(QCPProfiler::Event, Q_PRIMITIVE_TYPE);
+
+
+class QCP_LIB_DECL QCPProfilerScope
+{
+public:
+  QCPProfilerScope(QCustomPlot *parentPlot, QCPProfiler::Phase phase, const QString &label=QString());
+  ~QCPProfilerScope();
+  
+protected:
+  QCPProfiler *mProfiler;
+  QCPProfiler::Phase mPhase;
+  QString mLabel;
+  qint64 mStartNs;
+  
+private:
+  Q_DISABLE_COPY(QCPProfilerScope)
+};
+
+/* end of 'src/profiler.h' */
+
+
 /* including file 'src/plottable.h'        */
 /* modified 2022-11-06T12:45:56, size 8461 */
 
@@ -3846,6 +4286,14 @@ public:
   QCP::SelectionRectMode selectionRectMode() const { return mSelectionRectMode; }
   QCPSelectionRect *selectionRect() const { return mSelectionRect; }
   bool openGl() const { return mOpenGl; }
+  bool tiledPainting() const { return mTiledPainting; }
+  int paintTileCount() const { return mPaintTileCount; }
+  int progressiveRefineDelay() const { return mProgressiveRefineDelay; }
+  bool coarseRendering() const { return mCoarseRendering; }
+  bool layoutCaching() const { return mLayoutCaching; }
+  int layoutSkipCount() const { return mLayoutSkipCount; }
+  QCPFrameArena *frameArena() const { return mFrameArena; }
+  QCPProfiler *profiler() const { return mProfiler; }
   
   // setters:
   void setViewport(const QRect &rect);
@@ -3870,6 +4318,9 @@ public:
   void setSelectionRectMode(QCP::SelectionRectMode mode);
   void setSelectionRect(QCPSelectionRect *selectionRect);
   void setOpenGl(bool enabled, int multisampling=16);
+  void setTiledPainting(bool enabled, int tileCount=0);
+  void setProgressiveRefineDelay(int msec);
+  void setLayoutCaching(bool enabled);
   
   // non-property methods:
   // plottable interface:
@@ -3940,6 +4391,7 @@ public:
   void toPainter(QCPPainter *painter, int width=0, int height=0);
   Q_SLOT void replot(QCustomPlot::RefreshPriority refreshPriority=QCustomPlot::rpRefreshHint);
   double replotTime(bool average=false) const;
+  void invalidateLayout() { mLayoutValid = false; }
   
   QCPAxis *xAxis, *yAxis, *xAxis2, *yAxis2;
   QCPLegend *legend;
@@ -3990,6 +4442,10 @@ protected:
   QCP::SelectionRectMode mSelectionRectMode;
   QCPSelectionRect *mSelectionRect;
   bool mOpenGl;
+  bool mTiledPainting;
+  int mPaintTileCount;
+  int mProgressiveRefineDelay;
+  bool mLayoutCaching;
   
   // non-property members:
   QList<QSharedPointer<QCPAbstractPaintBuffer> > mPaintBuffers;
@@ -4002,6 +4458,12 @@ protected:
   bool mReplotting;
   bool mReplotQueued;
   double mReplotTime, mReplotTimeAverage;
+  QCPFrameArena *mFrameArena;
+  QCPProfiler *mProfiler;
+  bool mCoarseRendering;
+  QTimer *mProgressiveRefineTimer;
+  bool mLayoutValid;
+  int mLayoutSkipCount;
   int mOpenGlMultisamples;
   QCP::AntialiasedElements mOpenGlAntialiasedElementsBackup;
   bool mOpenGlCacheLabelsBackup;
@@ -4032,6 +4494,8 @@ protected:
   Q_SLOT virtual void processPointSelection(QMouseEvent *event);
   
   // non-virtual methods:
+  void beginCoarseRendering();
+  Q_SLOT void endCoarseRendering();
   bool registerPlottable(QCPAbstractPlottable *plottable);
   bool registerGraph(QCPGraph *graph);
   bool registerItem(QCPAbstractItem* item);
@@ -4049,6 +4513,7 @@ protected:
   friend class QCPAxis;
   friend class QCPLayer;
   friend class QCPAxisRect;
+  friend class QCPAxisGroup;
   friend class QCPAbstractPlottable;
   friend class QCPGraph;
   friend class QCPAbstractItem;
@@ -5491,6 +5956,86 @@ Q_DECLARE_TYPEINFO(QCPGraphData, Q_PRIMITIVE_TYPE);
 */
 typedef QCPDataContainer<QCPGraphData> QCPGraphDataContainer;
 
+class QCP_LIB_DECL QCPGraphHistory
+{
+public:
+  struct BlockHeader
+  {
+    double keyLower, keyUpper;   ///< key of the first and the last data point in the block
+    double firstValue, lastValue; ///< value of the first and the last data point in the block
+    double minKey, minValue;     ///< key and value of the data point with the smallest value (NaN if all values are NaN)
+    double maxKey, maxValue;     ///< key and value of the data point with the largest value (NaN if all values are NaN)
+    int count;                   ///< number of data points in the block
+  };
+  
+  explicit QCPGraphHistory(int blockSize=1024);
+  
+  // getters:
+  int blockSize() const { return mBlockSize; }
+  int size() const { return mSize; }
+  bool isEmpty() const { return mSize == 0; }
+  int blockCount() const { return mHeaders.size() + (mTail.isEmpty() ? 0 : 1); }
+  BlockHeader blockHeader(int index) const;
+  quint64 revision() const { return mRevision; }
+  qint64 compressedSize() const;
+  qint64 uncompressedSize() const { return qint64(mSize)*qint64(sizeof(QCPGraphData)); }
+  double compressionRatio() const;
+  
+  // setters:
+  void setBlockSize(int size);
+  
+  // non-property methods:
+  void add(double key, double value);
+  void add(const QVector<double> &keys, const QVector<double> &values);
+  void clear();
+  QCPRange keyRange(bool &foundRange, QCP::SignDomain signDomain=QCP::sdBoth) const;
+  QCPRange valueRange(bool &foundRange, QCP::SignDomain signDomain=QCP::sdBoth, const QCPRange &inKeyRange=QCPRange()) const;
+  int findBlock(double key) const;
+  void decodeBlock(int index, QVector<QCPGraphData> *data) const;
+  void decode(QVector<QCPGraphData> *data, const QCPRange &keyRange) const;
+  
+protected:
+  class BitWriter
+  {
+  public:
+    explicit BitWriter(QByteArray *data);
+    void write(quint64 bits, int count);
+  private:
+    QByteArray *mData;
+    int mFreeBits;
+  };
+  
+  class BitReader
+  {
+  public:
+    explicit BitReader(const QByteArray &data);
+    quint64 read(int count);
+    bool readBit();
+  private:
+    const uchar *mData;
+    int mByte, mBit;
+  };
+  
+  // property members:
+  int mBlockSize;
+  
+  // non-property members:
+  QVector<BlockHeader> mHeaders;
+  QVector<QByteArray> mBlockData;
+  QVector<QCPGraphData> mTail;
+  BlockHeader mTailHeader;
+  int mSize;
+  quint64 mRevision;
+  
+  // non-virtual methods:
+  void sealTail();
+  QByteArray encodeBlock(const QVector<QCPGraphData> &data) const;
+  static void includeInHeader(BlockHeader &header, double key, double value);
+  static void expandRange(QCPRange &range, bool &foundRange, double lower, double upper);
+  static int leadingZeroBits(quint64 x);
+  static int trailingZeroBits(quint64 x);
+};
+
 class QCP_LIB_DECL QCPGraph : public QCPAbstractPlottable1D<QCPGraphData>
 {
   Q_OBJECT
@@ -5527,10 +6072,12 @@ public:
   int scatterSkip() const { return mScatterSkip; }
   QCPGraph *channelFillGraph() const { return mChannelFillGraph.data(); }
   bool adaptiveSampling() const { return mAdaptiveSampling; }
+  QSharedPointer<QCPGraphHistory> history() const { return mHistory; }
   
   // setters:
   void setData(QSharedPointer<QCPGraphDataContainer> data);
   void setData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted=false);
+  void setHistory(QSharedPointer<QCPGraphHistory> history);
   void setLineStyle(LineStyle ls);
   void setScatterStyle(const QCPScatterStyle &style);
   void setScatterSkip(int skip);
@@ -5553,6 +6100,16 @@ protected:
   int mScatterSkip;
   QPointer<QCPGraph> mChannelFillGraph;
   bool mAdaptiveSampling;
+  QSharedPointer<QCPGraphHistory> mHistory;
+  
+  // non-property members:
+  mutable QVector<QPointF> mChannelFillLines;
+  mutable bool mChannelFillLinesValid;
+  mutable QPolygonF mFillPolygon;
+  bool mHistoryViewValid;
+  quint64 mHistoryViewRevision;
+  QCPRange mHistoryViewRange;
+  double mHistoryViewPixels;
   
   // reimplemented virtual methods:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
@@ -5569,19 +6126,29 @@ protected:
   
   // non-virtual methods:
   void getVisibleDataBounds(QCPGraphDataContainer::const_iterator &begin, QCPGraphDataContainer::const_iterator &end, const QCPDataRange &rangeRestriction) const;
+  void updateHistoryView();
   void getLines(QVector<QPointF> *lines, const QCPDataRange &dataRange) const;
   void getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataRange) const;
+  bool getCoarseData(QVector<QCPGraphData> *data, QCPGraphDataContainer::const_iterator begin, QCPGraphDataContainer::const_iterator end) const;
   QVector<QPointF> dataToLines(const QVector<QCPGraphData> &data) const;
   QVector<QPointF> dataToStepLeftLines(const QVector<QCPGraphData> &data) const;
   QVector<QPointF> dataToStepRightLines(const QVector<QCPGraphData> &data) const;
   QVector<QPointF> dataToStepCenterLines(const QVector<QCPGraphData> &data) const;
   QVector<QPointF> dataToImpulseLines(const QVector<QCPGraphData> &data) const;
+  void dataToLines(const QVector<QCPGraphData> &data, QVector<QPointF> *lines) const;
+  void dataToStepLeftLines(const QVector<QCPGraphData> &data, QVector<QPointF> *lines) const;
+  void dataToStepRightLines(const QVector<QCPGraphData> &data, QVector<QPointF> *lines) const;
+  void dataToStepCenterLines(const QVector<QCPGraphData> &data, QVector<QPointF> *lines) const;
+  void dataToImpulseLines(const QVector<QCPGraphData> &data, QVector<QPointF> *lines) const;
   QVector<QCPDataRange> getNonNanSegments(const QVector<QPointF> *lineData, Qt::Orientation keyOrientation) const;
   QVector<QPair<QCPDataRange, QCPDataRange> > getOverlappingSegments(QVector<QCPDataRange> thisSegments, const QVector<QPointF> *thisData, QVector<QCPDataRange> otherSegments, const QVector<QPointF> *otherData) const;
   bool segmentsIntersect(double aLower, double aUpper, double bLower, double bUpper, int &bPrecedence) const;
   QPointF getFillBasePoint(QPointF matchingDataPoint) const;
   const QPolygonF getFillPolygon(const QVector<QPointF> *lineData, QCPDataRange segment) const;
   const QPolygonF getChannelFillPolygon(const QVector<QPointF> *thisData, QCPDataRange thisSegment, const QVector<QPointF> *otherData, QCPDataRange otherSegment) const;
+  bool getNextNonNanSegment(const QVector<QPointF> *lineData, Qt::Orientation keyOrientation, int &index, QCPDataRange &segment) const;
+  void appendFillPolygon(QPolygonF *polygon, const QVector<QPointF> *lineData, QCPDataRange segment) const;
+  bool appendChannelFillSegment(QPolygonF *polygon, const QVector<QPointF> *lineData, QCPDataRange segment, double lowerKey, double upperKey) const;
   int findIndexBelowX(const QVector<QPointF> *data, double x) const;
   int findIndexAboveX(const QVector<QPointF> *data, double x) const;
   int findIndexBelowY(const QVector<QPointF> *data, double y) const;
@@ -5996,6 +6563,20 @@ protected:
   QPen mMedianPen;
   QCPScatterStyle mOutlierStyle;
   
+  // non-property members:
+  struct OutlierSprite
+  {
+    QPixmap pixmap;
+    QPointF offset;
+    QCPScatterStyle::ScatterShape shape;
+    double size;
+    QPen pen;
+    QBrush brush;
+    bool antialiased;
+    double devicePixelRatio;
+  };
+  mutable OutlierSprite mOutlierSprite;
+  
   // reimplemented virtual methods:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
   virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const Q_DECL_OVERRIDE;
@@ -6008,6 +6589,8 @@ protected:
   QRectF getQuartileBox(QCPStatisticalBoxDataContainer::const_iterator it) const;
   QVector<QLineF> getWhiskerBackboneLines(QCPStatisticalBoxDataContainer::const_iterator it) const;
   QVector<QLineF> getWhiskerBarLines(QCPStatisticalBoxDataContainer::const_iterator it) const;
+  void drawOutliers(QCPPainter *painter, QCPStatisticalBoxDataContainer::const_iterator it, const QCPScatterStyle &outlierStyle) const;
+  bool updateOutlierSprite(QCPPainter *painter, const QCPScatterStyle &outlierStyle) const;
   
   friend class QCustomPlot;
   friend class QCPLegend;
@@ -6152,6 +6735,148 @@ protected:
 /* end of 'src/plottables/plottable-colormap.h' */
 
 
+/* including file 'src/plottables/plottable-tiledcolormap.h' */
+
+class QCP_LIB_DECL QCPColorMapTileStore
+{
+public:
+  QCPColorMapTileStore();
+  ~QCPColorMapTileStore();
+  
+  // getters:
+  bool isOpen() const { return mMap != nullptr; }
+  bool isWritable() const { return mWritable; }
+  QString fileName() const { return mFile.fileName(); }
+  int keySize() const { return mHeader.keySize; }
+  int valueSize() const { return mHeader.valueSize; }
+  int tileSize() const { return mHeader.tileSize; }
+  int levelCount() const { return mHeader.levelCount; }
+  QCPRange keyRange() const { return QCPRange(mHeader.keyLower, mHeader.keyUpper); }
+  QCPRange valueRange() const { return QCPRange(mHeader.valueLower, mHeader.valueUpper); }
+  QCPRange dataBounds() const { return QCPRange(mHeader.dataLower, mHeader.dataUpper); }
+  int levelKeySize(int level) const { return (mHeader.keySize + (1 << level) - 1) >> level; }
+  int levelValueSize(int level) const { return (mHeader.valueSize + (1 << level) - 1) >> level; }
+  int keyTileCount(int level) const { return (levelKeySize(level) + mHeader.tileSize - 1)/mHeader.tileSize; }
+  int valueTileCount(int level) const { return (levelValueSize(level) + mHeader.tileSize - 1)/mHeader.tileSize; }
+  
+  // non-property methods:
+  bool create(const QString &fileName, int keySize, int valueSize, const QCPRange &keyRange, const QCPRange &valueRange, int tileSize=256);
+  bool open(const QString &fileName);
+  void close();
+  void setCell(int keyIndex, int valueIndex, double z);
+  void setRow(int valueIndex, const double *z);
+  bool buildLevels();
+  const float *tile(int level, int keyTile, int valueTile) const;
+  QImage colorizeTile(int level, int keyTile, int valueTile, QCPColorGradient gradient, const QCPRange &dataRange, bool logarithmic=false) const;
+  double cellWidth() const;
+  double cellHeight() const;
+  
+protected:
+  struct FileHeader
+  {
+    char magic[4];
+    quint32 version;
+    qint32 keySize, valueSize, tileSize, levelCount;
+    double keyLower, keyUpper, valueLower, valueUpper;
+    double dataLower, dataUpper;
+  };
+  
+  // non-property members:
+  QFile mFile;
+  uchar *mMap;
+  bool mWritable;
+  FileHeader mHeader;
+  QVector<qint64> mLevelOffsets;
+  
+  // non-virtual methods:
+  static bool validSizes(int keySize, int valueSize, int tileSize);
+  void updateLevelOffsets();
+  float *cell(int level, int keyIndex, int valueIndex) const;
+  
+private:
+  Q_DISABLE_COPY(QCPColorMapTileStore)
+};
+
+
+class QCP_LIB_DECL QCPTiledColorMap : public QCPAbstractPlottable
+{
+  Q_OBJECT
+  /// \cond INCLUDE_QPROPERTIES
+  Q_PROPERTY(QCPRange dataRange READ dataRange WRITE setDataRange NOTIFY dataRangeChanged)
+  Q_PROPERTY(QCPAxis::ScaleType dataScaleType READ dataScaleType WRITE setDataScaleType NOTIFY dataScaleTypeChanged)
+  Q_PROPERTY(QCPColorGradient gradient READ gradient WRITE setGradient NOTIFY gradientChanged)
+  Q_PROPERTY(bool interpolate READ interpolate WRITE setInterpolate)
+  Q_PROPERTY(int tileCacheSize READ tileCacheSize WRITE setTileCacheSize)
+  /// \endcond
+public:
+  explicit QCPTiledColorMap(QCPAxis *keyAxis, QCPAxis *valueAxis);
+  virtual ~QCPTiledColorMap() Q_DECL_OVERRIDE;
+  
+  // getters:
+  QSharedPointer<QCPColorMapTileStore> tileStore() const { return mTileStore; }
+  QCPRange dataRange() const { return mDataRange; }
+  QCPAxis::ScaleType dataScaleType() const { return mDataScaleType; }
+  QCPColorGradient gradient() const { return mGradient; }
+  bool interpolate() const { return mInterpolate; }
+  int tileCacheSize() const { return mTileCache.maxCost(); }
+  
+  // setters:
+  void setTileStore(QSharedPointer<QCPColorMapTileStore> store);
+  Q_SLOT void setDataRange(const QCPRange &dataRange);
+  Q_SLOT void setDataScaleType(QCPAxis::ScaleType scaleType);
+  Q_SLOT void setGradient(const QCPColorGradient &gradient);
+  void setInterpolate(bool enabled);
+  void setTileCacheSize(int tiles);
+  
+  // non-property methods:
+  void rescaleDataRange();
+  void clearTileCache();
+  
+  // reimplemented virtual methods:
+  virtual double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details=nullptr) const Q_DECL_OVERRIDE;
+  virtual QCPRange getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth) const Q_DECL_OVERRIDE;
+  virtual QCPRange getValueRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth, const QCPRange &inKeyRange=QCPRange()) const Q_DECL_OVERRIDE;
+  
+signals:
+  void dataRangeChanged(const QCPRange &newRange);
+  void dataScaleTypeChanged(QCPAxis::ScaleType scaleType);
+  void gradientChanged(const QCPColorGradient &newGradient);
+  
+protected:
+  // property members:
+  QSharedPointer<QCPColorMapTileStore> mTileStore;
+  QCPRange mDataRange;
+  QCPAxis::ScaleType mDataScaleType;
+  QCPColorGradient mGradient;
+  bool mInterpolate;
+  
+  // non-property members:
+  QCache<quint64, QImage> mTileCache;
+  QHash<quint64, QSharedPointer<QAtomicInt> > mPendingTiles; // cancellation flags of the queued tasks
+  int mGeneration;
+  QThreadPool mLoaderPool;
+  
+  // reimplemented virtual methods:
+  virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
+  virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const Q_DECL_OVERRIDE;
+  
+  // non-virtual methods:
+  int levelForView() const;
+  void visibleTiles(int level, int &keyTileLower, int &keyTileUpper, int &valueTileLower, int &valueTileUpper) const;
+  void requestTile(int level, int keyTile, int valueTile);
+  void cancelPendingTiles(const QSet<quint64> &keep);
+  void drawTile(QCPPainter *painter, const QImage &image, int level, int keyTile, int valueTile) const;
+  QRectF tileCoordRect(int level, int keyTile, int valueTile) const;
+  static quint64 tileKey(int level, int keyTile, int valueTile) { return (quint64(level) << 48) | (quint64(keyTile) << 24) | quint64(valueTile); }
+  Q_SLOT void tileLoaded(int generation, int level, int keyTile, int valueTile, const QImage &image);
+  
+  friend class QCustomPlot;
+  friend class QCPLegend;
+};
+
+/* end of 'src/plottables/plottable-tiledcolormap.h' */
+
+
 /* including file 'src/plottables/plottable-financial.h' */
 /* modified 2022-11-06T12:45:56, size 8644               */
 
@@ -6332,6 +7057,7 @@ class QCP_LIB_DECL QCPErrorBars : public QCPAbstractPlottable, public QCPPlottab
   Q_PROPERTY(ErrorType errorType READ errorType WRITE setErrorType)
   Q_PROPERTY(double whiskerWidth READ whiskerWidth WRITE setWhiskerWidth)
   Q_PROPERTY(double symbolGap READ symbolGap WRITE setSymbolGap)
+  Q_PROPERTY(bool adaptiveSampling READ adaptiveSampling WRITE setAdaptiveSampling)
   /// \endcond
 public:
   
@@ -6354,6 +7080,7 @@ public:
   ErrorType errorType() const { return mErrorType; }
   double whiskerWidth() const { return mWhiskerWidth; }
   double symbolGap() const { return mSymbolGap; }
+  bool adaptiveSampling() const { return mAdaptiveSampling; }
   
   // setters:
   void setData(QSharedPointer<QCPErrorBarsDataContainer> data);
@@ -6363,6 +7090,7 @@ public:
   void setErrorType(ErrorType type);
   void setWhiskerWidth(double pixels);
   void setSymbolGap(double pixels);
+  void setAdaptiveSampling(bool enabled);
   
   // non-property methods:
   void addData(const QVector<double> &error);
@@ -6393,6 +7121,10 @@ protected:
   ErrorType mErrorType;
   double mWhiskerWidth;
   double mSymbolGap;
+  bool mAdaptiveSampling;
+  
+  // non-property members:
+  QVector<QLineF> mBackboneLines, mWhiskerLines;
   
   // reimplemented virtual methods:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
@@ -6402,6 +7134,8 @@ protected:
   
   // non-virtual methods:
   void getErrorBarLines(QCPErrorBarsDataContainer::const_iterator it, QVector<QLineF> &backbones, QVector<QLineF> &whiskers) const;
+  void getOptimizedErrorBarLines(QCPErrorBarsDataContainer::const_iterator begin, QCPErrorBarsDataContainer::const_iterator end, QVector<QLineF> &backbones, QVector<QLineF> &whiskers) const;
+  void appendMergedErrorBar(double orthoAxisPixel, double lowerErrorAxisPixel, double upperErrorAxisPixel, QVector<QLineF> &backbones, QVector<QLineF> &whiskers) const;
   void getVisibleDataBounds(QCPErrorBarsDataContainer::const_iterator &begin, QCPErrorBarsDataContainer::const_iterator &end, const QCPDataRange &rangeRestriction) const;
   double pointDistance(const QPointF &pixelPoint, QCPErrorBarsDataContainer::const_iterator &closestData) const;
   // helpers:
@@ -6416,6 +7150,185 @@ protected:
 /* end of 'src/plottables/plottable-errorbar.h' */
 
 
+/* including file 'src/plottables/plottable-annotations.h' */
+
+class QCP_LIB_DECL QCPAnnotationData
+{
+public:
+  QCPAnnotationData();
+  QCPAnnotationData(double key, int style=0, int label=-1, double span=0);
+  
+  inline double sortKey() const { return key; }
+  inline static QCPAnnotationData fromSortKey(double sortKey) { return QCPAnnotationData(sortKey); }
+  inline static bool sortKeyIsMainKey() { return true; }
+  
+  inline double mainKey() const { return key; }
+  inline double mainValue() const { return 0; }
+  
+  inline QCPRange valueRange() const { return QCPRange(0, 0); }
+  
+  double key, span;
+  int style, label;
+};
+Q_DECLARE_TYPEINFO(QCPAnnotationData, Q_MOVABLE_TYPE);
+
+
+/*! \typedef QCPAnnotationDataContainer
+  
+  Container for storing \ref QCPAnnotationData markers. The data is stored sorted by \a key.
+  
+  This template instantiation is the container in which QCPAnnotations holds its data. For details
+  about the generic container, see the documentation of the class template \ref QCPDataContainer.
+  
+  \see QCPAnnotationData, QCPAnnotations::setData
+*/
+typedef QCPDataContainer<QCPAnnotationData> QCPAnnotationDataContainer;
+
+class QCP_LIB_DECL QCPAnnotations : public QCPAbstractPlottable1D<QCPAnnotationData>
+{
+  Q_OBJECT
+  /// \cond INCLUDE_QPROPERTIES
+  Q_PROPERTY(int labelPadding READ labelPadding WRITE setLabelPadding)
+  /// \endcond
+public:
+  explicit QCPAnnotations(QCPAxis *keyAxis, QCPAxis *valueAxis);
+  
+  // getters:
+  QSharedPointer<QCPAnnotationDataContainer> data() const { return mDataContainer; }
+  int labelPadding() const { return mLabelPadding; }
+  int styleCount() const { return mStyles.size(); }
+  QPen stylePen(int style) const { return styleAt(style).pen; }
+  QBrush styleBrush(int style) const { return styleAt(style).brush; }
+  QColor styleTextColor(int style) const { return styleAt(style).textColor; }
+  QFont styleFont(int style) const { return styleAt(style).font; }
+  int labelCount() const { return mLabels.size(); }
+  QString label(int label) const { return mLabels.value(label); }
+  
+  // setters:
+  void setData(QSharedPointer<QCPAnnotationDataContainer> data);
+  void setData(const QVector<double> &keys, const QVector<int> &styles, const QVector<int> &labels, bool alreadySorted=false);
+  void setLabelPadding(int padding);
+  void setStyle(int style, const QPen &pen, const QBrush &brush, const QColor &textColor, const QFont &font);
+  
+  // non-property methods:
+  int addStyle(const QPen &pen, const QBrush &brush=Qt::NoBrush, const QColor &textColor=Qt::black, const QFont &font=QFont());
+  int addLabel(const QString &text);
+  void clearLabels();
+  void addData(const QVector<double> &keys, const QVector<int> &styles, const QVector<int> &labels, bool alreadySorted=false);
+  void addData(double key, int style=0, int label=-1, double span=0);
+  void updateMaxSpan();
+  
+  // reimplemented virtual methods:
+  virtual QCPDataSelection selectTestRect(const QRectF &rect, bool onlySelectable) const Q_DECL_OVERRIDE;
+  virtual double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details=nullptr) const Q_DECL_OVERRIDE;
+  virtual QCPRange getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth) const Q_DECL_OVERRIDE;
+  virtual QCPRange getValueRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth, const QCPRange &inKeyRange=QCPRange()) const Q_DECL_OVERRIDE;
+  
+protected:
+  struct Style
+  {
+    QPen pen;
+    QBrush brush;
+    QColor textColor;
+    QFont font;
+  };
+  
+  // property members:
+  int mLabelPadding;
+  
+  // non-property members:
+  QVector<Style> mStyles;
+  QVector<QString> mLabels;
+  QHash<QString, int> mLabelIds;
+  double mMaxSpan;
+  QVector<QVector<QLineF> > mStyleLines;
+  QVector<QVector<QRectF> > mStyleBands;
+  mutable QHash<quint64, QSize> mLabelSizes;
+  
+  // reimplemented virtual methods:
+  virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
+  virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const Q_DECL_OVERRIDE;
+  
+  // introduced virtual methods:
+  virtual void drawLabels(QCPPainter *painter, QCPAnnotationDataContainer::const_iterator begin, QCPAnnotationDataContainer::const_iterator end, bool selected) const;
+  
+  // non-virtual methods:
+  void getVisibleDataBounds(QCPAnnotationDataContainer::const_iterator &begin, QCPAnnotationDataContainer::const_iterator &end) const;
+  int styleIndex(int style) const { return style >= 0 && style < mStyles.size() ? style : 0; }
+  const Style &styleAt(int style) const { return mStyles.at(styleIndex(style)); }
+  
+  friend class QCustomPlot;
+  friend class QCPLegend;
+};
+
+/* end of 'src/plottables/plottable-annotations.h' */
+
+
+/* including file 'src/modelbinding.h'      */
+
+class QCP_LIB_DECL QCPModelBinding : public QObject
+{
+  Q_OBJECT
+  /// \cond INCLUDE_QPROPERTIES
+  Q_PROPERTY(QAbstractItemModel* model READ model)
+  Q_PROPERTY(QCPAbstractPlottable* plottable READ plottable)
+  Q_PROPERTY(int keyColumn READ keyColumn)
+  Q_PROPERTY(int valueColumn READ valueColumn)
+  Q_PROPERTY(int role READ role WRITE setRole)
+  Q_PROPERTY(bool autoReplot READ autoReplot WRITE setAutoReplot)
+  /// \endcond
+public:
+  explicit QCPModelBinding(QAbstractItemModel *model, QCPGraph *graph, int keyColumn, int valueColumn, QObject *parent=nullptr);
+  explicit QCPModelBinding(QAbstractItemModel *model, QCPBars *bars, int keyColumn, int valueColumn, QObject *parent=nullptr);
+  virtual ~QCPModelBinding() Q_DECL_OVERRIDE;
+  
+  // getters:
+  QAbstractItemModel *model() const { return mModel.data(); }
+  QCPAbstractPlottable *plottable() const;
+  int keyColumn() const { return mKeyColumn; }
+  int valueColumn() const { return mValueColumn; }
+  int role() const { return mRole; }
+  bool autoReplot() const { return mAutoReplot; }
+  
+  // setters:
+  void setRole(int role);
+  void setAutoReplot(bool enabled);
+  
+  // non-property methods:
+  Q_SLOT void rebuild();
+  
+protected:
+  // property members:
+  QPointer<QAbstractItemModel> mModel;
+  QPointer<QCPGraph> mGraph;
+  QPointer<QCPBars> mBars;
+  int mKeyColumn, mValueColumn;
+  int mRole;
+  bool mAutoReplot;
+  
+  // non-property members:
+  QVector<double> mRowKeys, mRowValues;
+  
+  // non-virtual methods:
+  void connectModel();
+  void readRow(int row, double &key, double &value) const;
+  void dataUpdated();
+  template <class DataType> void rebuildData(QCPDataContainer<DataType> *container);
+  template <class DataType> void insertData(QCPDataContainer<DataType> *container, int first, int last);
+  template <class DataType> void removeData(QCPDataContainer<DataType> *container, int first, int last);
+  template <class DataType> void updateData(QCPDataContainer<DataType> *container, int first, int last);
+  template <class DataType> void removePoints(QCPDataContainer<DataType> *container, QVector<DataType> points);
+  Q_SLOT void modelDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+  Q_SLOT void modelRowsInserted(const QModelIndex &parent, int first, int last);
+  Q_SLOT void modelRowsRemoved(const QModelIndex &parent, int first, int last);
+  
+private:
+  Q_DISABLE_COPY(QCPModelBinding)
+};
+
+/* end of 'src/modelbinding.h' */
+
+
 /* including file 'src/items/item-straightline.h' */
 /* modified 2022-11-06T12:45:56, size 3137        */
 
@@ -7661,6 +8574,7 @@ public:
   QPen pen() const { return mPen; }
   QBrush brush() const { return mBrush; }
   bool periodic() const { return mPeriodic; }
+  bool adaptiveSampling() const { return mAdaptiveSampling; }
   QCPPolarAxisAngular *keyAxis() const { return mKeyAxis.data(); }
   QCPPolarAxisRadial *valueAxis() const { return mValueAxis.data(); }
   QCP::SelectionType selectable() const { return mSelectable; }
@@ -7678,6 +8592,7 @@ public:
   void setPen(const QPen &pen);
   void setBrush(const QBrush &brush);
   void setPeriodic(bool enabled);
+  void setAdaptiveSampling(bool enabled);
   void setKeyAxis(QCPPolarAxisAngular *axis);
   void setValueAxis(QCPPolarAxisRadial *axis);
   Q_SLOT void setSelectable(QCP::SelectionType selectable);
@@ -7724,12 +8639,26 @@ protected:
   QPen mPen;
   QBrush mBrush;
   bool mPeriodic;
+  bool mAdaptiveSampling;
   QPointer<QCPPolarAxisAngular> mKeyAxis;
   QPointer<QCPPolarAxisRadial> mValueAxis;
   QCP::SelectionType mSelectable;
   QCPDataSelection mSelection;
   //QCPSelectionDecorator *mSelectionDecorator;
   
+  // non-property members:
+  struct TrigCache
+  {
+    QVector<double> keys;
+    QVector<QPointF> unitVectors; // (cos, sin) of (key-referenceKey)*angularScale
+    double referenceKey;
+    double angularScale;
+    int candidateSize; // key signature of the previous update, the cache is only built once it stays the same between two replots
+    double candidateFirstKey, candidateLastKey;
+  };
+  mutable TrigCache mTrigCache;
+  mutable QVector<qint64> mRadialPixelBin; // scratch buffer of getOptimizedScatterData, kept across replots to avoid reallocation
+  
   // introduced virtual methods (later reimplemented TODO from QCPAbstractPolarPlottable):
   virtual QRect clipRect() const;
   virtual void draw(QCPPainter *painter);
@@ -7760,6 +8689,10 @@ protected:
   void getOptimizedLineData(QVector<QCPGraphData> *lineData, const QCPGraphDataContainer::const_iterator &begin, const QCPGraphDataContainer::const_iterator &end) const;
   void getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGraphDataContainer::const_iterator begin, QCPGraphDataContainer::const_iterator end) const;
   QVector<QPointF> dataToLines(const QVector<QCPGraphData> &data) const;
+  void dataToPixels(const QVector<QCPGraphData> &data, QVector<QPointF> *pixels) const;
+  double adaptiveSamplingBinWidth(QCPGraphDataContainer::const_iterator begin, QCPGraphDataContainer::const_iterator end) const;
+  void getAngularBinnedData(QVector<QCPGraphData> *binnedData, QCPGraphDataContainer::const_iterator begin, QCPGraphDataContainer::const_iterator end, double binWidth) const;
+  void updateTrigCache() const;
 
 private:
   Q_DISABLE_COPY(QCPPolarGraph)
@@ -0,0 +1,173 @@
+/*
+ * 坐标轴刻度缓存回归测试
+ *
+ * 覆盖QCPAxisTicker的结果缓存：范围与格式不变时重绘不再重新生成刻度，
+ * 修改刻度器设置后重新生成；同一坐标轴组的成员共享一个刻度器，每次范围变化只计算一次。
+ * 每项检查失败时输出原因，有任何失败时返回非0。
+ */
+
+#include "qcustomplot.h"
+
+#include <QApplication>
+
+#include <cstdio>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char *what)
+{
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+// 统计刻度步长计算与标签格式化的次数，每次真正执行generate都会计算一次步长
+class CountingDateTimeTicker : public QCPAxisTickerDateTime
+{
+public:
+    int tickStepCalls  = 0;
+    int tickLabelCalls = 0;
+
+protected:
+    double getTickStep(const QCPRange &range) override
+    {
+        ++tickStepCalls;
+        return QCPAxisTickerDateTime::getTickStep(range);
+    }
+
+    QString getTickLabel(double tick, const QLocale &locale, QChar formatChar, int precision) override
+    {
+        ++tickLabelCalls;
+        return QCPAxisTickerDateTime::getTickLabel(tick, locale, formatChar, precision);
+    }
+};
+
+// 直接继承QCPAxisTicker的刻度器，默认不缓存，由坐标轴组开启
+class CountingTicker : public QCPAxisTicker
+{
+public:
+    int tickStepCalls = 0;
+
+protected:
+    double getTickStep(const QCPRange &range) override
+    {
+        ++tickStepCalls;
+        return QCPAxisTicker::getTickStep(range);
+    }
+};
+
+// 内置刻度器默认开启缓存，文本刻度器与直接创建的基类刻度器默认关闭
+void testDefaultCaching()
+{
+    check(QCPAxisTickerDateTime().caching(), "date time ticker caches by default");
+    check(QCPAxisTickerTime().caching(), "time ticker caches by default");
+    check(QCPAxisTickerFixed().caching(), "fixed ticker caches by default");
+    check(QCPAxisTickerPi().caching(), "pi ticker caches by default");
+    check(QCPAxisTickerLog().caching(), "log ticker caches by default");
+    check(!QCPAxisTickerText().caching(), "text ticker doesn't cache by default");
+    check(!QCPAxisTicker().caching(), "plain ticker doesn't cache by default");
+
+    QCustomPlot plot;
+    check(plot.xAxis->ticker()->caching(), "default axis ticker caches");
+}
+
+// 日期时间坐标轴在范围不变时重绘，不再计算刻度和格式化标签
+void testDateTimeReplotSkipsGenerate()
+{
+    QCustomPlot plot;
+    plot.setViewport(QRect(0, 0, 400, 300));
+    QSharedPointer<CountingDateTimeTicker> ticker(new CountingDateTimeTicker);
+    plot.xAxis->setTicker(ticker);
+    plot.xAxis->setRange(1.7e9, 1.7e9 + 3600);
+
+    plot.replot();
+    const int tickSteps  = ticker->tickStepCalls;
+    const int tickLabels = ticker->tickLabelCalls;
+    check(tickSteps > 0 && tickLabels > 0, "first replot generates ticks and labels");
+
+    plot.replot();
+    check(ticker->tickStepCalls == tickSteps, "replot over unchanged range skips tick generation");
+    check(ticker->tickLabelCalls == tickLabels, "replot over unchanged range skips label formatting");
+
+    ticker->setDateTimeFormat(QLatin1String("hh:mm"));
+    plot.replot();
+    check(ticker->tickStepCalls > tickSteps, "format change regenerates ticks");
+}
+
+// 20个坐标轴组成一组，平移时整组只计算一次刻度
+void testGroupComputesTicksOnce()
+{
+    const int                      axisCount = 20;
+    QCPAxisGroup                   group;
+    QSharedPointer<CountingTicker> ticker(new CountingTicker);
+    QList<QCustomPlot *>           plots;
+    group.setAutoReplot(false);
+    group.setTicker(ticker);
+    check(ticker->caching(), "group enables caching on its ticker");
+
+    for (int i = 0; i < axisCount; ++i) {
+        QCustomPlot *plot = new QCustomPlot;
+        plot->setViewport(QRect(0, 0, 400, 100 + i)); // 高度不同不影响刻度
+        plot->xAxis->setAxisGroup(&group);
+        plots << plot;
+    }
+
+    bool allShared = true;
+    for (QCustomPlot *plot : plots)
+        allShared &= plot->xAxis->ticker() == group.ticker();
+    check(allShared, "joining axes take over the group ticker");
+
+    group.setRange(QCPRange(0, 10));
+    for (QCustomPlot *plot : plots)
+        plot->replot();
+    const int afterFirst = ticker->tickStepCalls;
+    check(afterFirst == 1, "first range is computed once for the whole group");
+
+    group.setRange(QCPRange(2, 12));
+    for (QCustomPlot *plot : plots)
+        plot->replot();
+    check(ticker->tickStepCalls == afterFirst + 1, "pan is computed once for the whole group");
+
+    qDeleteAll(plots);
+}
+
+// 没有调用setTicker时，组采用第一个成员的刻度器，后加入的成员共享它
+void testGroupAdoptsFirstTicker()
+{
+    QCPAxisGroup group;
+    QCustomPlot  first;
+    QCustomPlot  second;
+    group.setAutoReplot(false);
+    const QSharedPointer<QCPAxisTicker> firstTicker = first.xAxis->ticker();
+
+    first.xAxis->setAxisGroup(&group);
+    second.xAxis->setAxisGroup(&group);
+    check(group.ticker() == firstTicker, "group adopts the ticker of its first member");
+    check(second.xAxis->ticker() == firstTicker, "later members share the adopted ticker");
+
+    second.xAxis->setAxisGroup(nullptr);
+    first.xAxis->setAxisGroup(nullptr);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 没有显示环境时使用offscreen平台，便于在CI中运行
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    testDefaultCaching();
+    testDateTimeReplotSkipsGenerate();
+    testGroupComputesTicksOnce();
+    testGroupAdoptsFirstTicker();
+
+    if (failures == 0)
+        std::printf("all axis ticker checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
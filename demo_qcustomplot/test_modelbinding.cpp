@@ -0,0 +1,118 @@
+/*
+ * QCPModelBinding 回归测试
+ *
+ * 覆盖键重复时的增量更新：删除或修改同一键下的某个数据点，只影响对应的那一个点。
+ * 每项检查失败时输出原因，有任何失败时返回非0。
+ */
+
+#include "qcustomplot.h"
+
+#include <QApplication>
+#include <QStandardItemModel>
+
+#include <cstdio>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char *what)
+{
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+void appendRow(QStandardItemModel *model, double key, double value)
+{
+    QList<QStandardItem *> row;
+    QStandardItem         *keyItem   = new QStandardItem;
+    QStandardItem         *valueItem = new QStandardItem;
+    keyItem->setData(key, Qt::EditRole);
+    valueItem->setData(value, Qt::EditRole);
+    row << keyItem << valueItem;
+    model->appendRow(row);
+}
+
+// 图表数据按顺序展开为 (key, value) 列表
+QVector<QPair<double, double>> points(const QCPGraph *graph)
+{
+    QVector<QPair<double, double>> result;
+    for (auto it = graph->data()->constBegin(); it != graph->data()->constEnd(); ++it)
+        result.append(qMakePair(it->key, it->value));
+    return result;
+}
+
+QVector<QPair<double, double>> makePoints(std::initializer_list<QPair<double, double>> list)
+{
+    return QVector<QPair<double, double>>(list);
+}
+
+// 删除同一键下的第二个点，第一个点保留，且不会被重复添加
+void testRemoveDuplicateKey()
+{
+    QCustomPlot        plot;
+    QStandardItemModel model(0, 2);
+    appendRow(&model, 1, 10);
+    appendRow(&model, 1, 20);
+    QCPModelBinding binding(&model, plot.addGraph(), 0, 1);
+    binding.setAutoReplot(false);
+
+    model.removeRow(1);
+    check(points(plot.graph(0)) == makePoints({{1, 10}}), "remove second of two equal keys");
+}
+
+// 三个同键点中删除中间的一个，其余两个各保留一份
+void testRemoveMiddleOfThree()
+{
+    QCustomPlot        plot;
+    QStandardItemModel model(0, 2);
+    appendRow(&model, 0, 5);
+    appendRow(&model, 2, 1);
+    appendRow(&model, 2, 2);
+    appendRow(&model, 2, 3);
+    appendRow(&model, 4, 7);
+    QCPModelBinding binding(&model, plot.addGraph(), 0, 1);
+    binding.setAutoReplot(false);
+
+    model.removeRow(2);
+    check(points(plot.graph(0)) == makePoints({{0, 5}, {2, 1}, {2, 3}, {4, 7}}), "remove middle of three equal keys");
+
+    model.removeRow(1);
+    check(points(plot.graph(0)) == makePoints({{0, 5}, {2, 3}, {4, 7}}), "remove first of remaining equal keys");
+}
+
+// 修改同键点的键，只有被修改的点移动到新位置
+void testMoveDuplicateKey()
+{
+    QCustomPlot        plot;
+    QStandardItemModel model(0, 2);
+    appendRow(&model, 1, 10);
+    appendRow(&model, 1, 20);
+    appendRow(&model, 3, 30);
+    QCPModelBinding binding(&model, plot.addGraph(), 0, 1);
+    binding.setAutoReplot(false);
+
+    model.setData(model.index(1, 0), 5.0, Qt::EditRole);
+    check(points(plot.graph(0)) == makePoints({{1, 10}, {3, 30}, {5, 20}}), "move one of two equal keys");
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 没有显示环境时使用offscreen平台，便于在CI中运行
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    testRemoveDuplicateKey();
+    testRemoveMiddleOfThree();
+    testMoveDuplicateKey();
+
+    if (failures == 0)
+        std::printf("all model binding checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
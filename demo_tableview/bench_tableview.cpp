@@ -0,0 +1,816 @@
+/*
+ * 表格模型基准测试
+ *
+ * 对比QList<TableItem>逐行存储与TableModel列式存储的内存占用和扫描/排序吞吐，
+ * 编译后的筛选谓词与逐行QVariant读取的筛选耗时，同步与并行模式下的筛选排序耗时，
+ * 名称n-gram索引的建立耗时、内存和查询延迟，表格滚动时每帧的data()调用次数和耗时，
+ * 旧版与分块列式文件格式的保存、加载耗时，以及逐行与批量删除行的耗时，
+ * 结果以JSON输出，便于不同版本之间做回归对比。
+ *
+ * 用法示例：
+ *   bench_tableview --rows 1e6,1e7 --output result.json
+ *   bench_tableview --filter storage --rows 1e5
+ */
+
+#include "tablefilterproxymodel.h"
+#include "tableitemdelegate.h"
+#include "tablemodel.h"
+#include "tableparallel.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDataStream>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QScrollBar>
+#include <QSysInfo>
+#include <QTableView>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <numeric>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#if __GLIBC_PREREQ(2, 33)
+#define BENCH_TRACK_HEAP 1
+#endif
+#endif
+
+namespace {
+
+// 测试用例描述：run对给定行数执行一次测试并返回结果
+struct BenchCase
+{
+    QString                          name;
+    std::function<QJsonObject(int)> run;
+};
+
+// 当前已分配的堆内存（字节），不支持时返回-1
+qint64 heapInUse()
+{
+#ifdef BENCH_TRACK_HEAP
+    const struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+qint64 heapDelta(qint64 before)
+{
+    return before < 0 ? -1 : heapInUse() - before;
+}
+
+template <typename Work>
+double timeMs(Work &&work)
+{
+    QElapsedTimer timer;
+    timer.start();
+    work();
+    return timer.nsecsElapsed() / 1e6;
+}
+
+double rowsPerSecond(int rows, double ms)
+{
+    return ms > 0 ? rows / (ms / 1000.0) : 0;
+}
+
+// 深拷贝字符串，模拟从文件逐行读取时每行各自持有一份字符串
+QString detached(const QString &text)
+{
+    return QString(text.unicode(), text.size());
+}
+
+QList<TableItem> legacyItems(const TableColumnStore &store)
+{
+    QList<TableItem> items;
+    items.reserve(store.rowCount());
+    for (int row = 0; row < store.rowCount(); ++row) {
+        items.append(TableItem(store.id(row),
+                               detached(store.name(row)),
+                               detached(store.category(row)),
+                               store.date(row),
+                               store.price(row),
+                               store.isAvailable(row)));
+    }
+    return items;
+}
+
+// 行存储与列存储的内存、扫描与排序对比
+QJsonObject runStorage(int rows)
+{
+    QJsonObject result;
+
+    TableModel   model;
+    const qint64 modelHeap = heapInUse();
+    result["columnar_build_ms"] = timeMs([&] { model.generateTestData(rows); });
+    result["columnar_heap_bytes"] = double(heapDelta(modelHeap));
+    result["columnar_estimated_bytes"] = double(model.store().memoryUsage());
+
+    const TableColumnStore &store = model.store();
+    QList<TableItem>        items;
+    const qint64            legacyHeap = heapInUse();
+    result["legacy_build_ms"] = timeMs([&] { items = legacyItems(store); });
+    result["legacy_heap_bytes"] = double(heapDelta(legacyHeap));
+
+    // 扫描：统计可用商品的价格总和
+    double       legacySum = 0;
+    const double legacyScan = timeMs([&] {
+        for (const TableItem &item : items) {
+            if (item.isAvailable())
+                legacySum += item.getPrice();
+        }
+    });
+
+    double       columnarSum = 0;
+    const double columnarScan = timeMs([&] {
+        const double  *prices = store.priceData();
+        const quint64 *bits = store.availableWords();
+        for (int row = 0; row < rows; ++row) {
+            if ((bits[row >> 6] >> (row & 63)) & 1)
+                columnarSum += prices[row];
+        }
+    });
+
+    // 经过模型接口（QModelIndex + QVariant）的同样扫描
+    double       modelSum = 0;
+    const double modelScan = timeMs([&] {
+        for (int row = 0; row < rows; ++row) {
+            if (model.data(model.index(row, TableItem::AvailableColumn), Qt::EditRole).toBool())
+                modelSum += model.data(model.index(row, TableItem::PriceColumn), Qt::EditRole).toDouble();
+        }
+    });
+
+    result["legacy_scan_rows_per_s"] = rowsPerSecond(rows, legacyScan);
+    result["columnar_scan_rows_per_s"] = rowsPerSecond(rows, columnarScan);
+    result["model_scan_rows_per_s"] = rowsPerSecond(rows, modelScan);
+    result["scan_checksum_match"] = qFuzzyCompare(1 + legacySum, 1 + columnarSum)
+                                    && qFuzzyCompare(1 + legacySum, 1 + modelSum);
+
+    // 排序：按价格对行号做稳定排序
+    QVector<int> order(rows);
+    std::iota(order.begin(), order.end(), 0);
+    const double legacySort = timeMs([&] {
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return items.at(a).getPrice() < items.at(b).getPrice();
+        });
+    });
+
+    std::iota(order.begin(), order.end(), 0);
+    const double columnarSort = timeMs([&] {
+        const double *prices = store.priceData();
+        std::stable_sort(order.begin(), order.end(), [prices](int a, int b) {
+            return prices[a] < prices[b];
+        });
+    });
+
+    result["legacy_sort_ms"] = legacySort;
+    result["columnar_sort_ms"] = columnarSort;
+    return result;
+}
+
+// 原先filterAcceptsRow的做法：每行5次QModelIndex + QVariant读取
+bool legacyAccepts(const QAbstractItemModel              &model,
+                   int                                    row,
+                   const TableFilterPredicate::Conditions &conditions)
+{
+    const QString name = model.data(model.index(row, TableItem::NameColumn)).toString();
+    const QString category = model.data(model.index(row, TableItem::CategoryColumn)).toString();
+    const QDate   date = model.data(model.index(row, TableItem::DateColumn), Qt::EditRole).toDate();
+    const double  price = model.data(model.index(row, TableItem::PriceColumn), Qt::EditRole).toDouble();
+    const bool    available
+        = model.data(model.index(row, TableItem::AvailableColumn), Qt::EditRole).toBool();
+
+    if (conditions.nameEnabled && !name.contains(conditions.name, Qt::CaseInsensitive))
+        return false;
+    if (conditions.categoryEnabled && category != conditions.category)
+        return false;
+    if (conditions.dateEnabled && date.isValid()
+        && (date < conditions.dateFrom || date > conditions.dateTo))
+        return false;
+    if (conditions.priceEnabled && (price < conditions.minPrice || price > conditions.maxPrice))
+        return false;
+    if (conditions.availabilityEnabled && available != conditions.available)
+        return false;
+    return true;
+}
+
+// 筛选：逐行QVariant读取、编译后的谓词与代理模型整体重新筛选的对比
+QJsonObject runFilter(int rows)
+{
+    QJsonObject result;
+
+    TableModel model;
+    model.generateTestData(rows);
+
+    // 界面上常见的组合：名称子串 + 日期 + 价格区间 + 可用
+    TableFilterPredicate::Conditions conditions;
+    conditions.nameEnabled = true;
+    conditions.name = QStringLiteral("电脑");
+    conditions.dateEnabled = true;
+    conditions.dateFrom = QDate::currentDate().addMonths(-6);
+    conditions.dateTo = QDate::currentDate();
+    conditions.priceEnabled = true;
+    conditions.minPrice = 100;
+    conditions.maxPrice = 800;
+    conditions.availabilityEnabled = true;
+    conditions.available = true;
+
+    int          legacyAccepted = 0;
+    const double legacyMs = timeMs([&] {
+        for (int row = 0; row < rows; ++row) {
+            if (legacyAccepts(model, row, conditions))
+                ++legacyAccepted;
+        }
+    });
+
+    TableFilterPredicate predicate;
+    const double         compileMs = timeMs([&] { predicate.compile(model.store(), conditions); });
+
+    int          rowAccepted = 0;
+    const double rowMs = timeMs([&] {
+        for (int row = 0; row < rows; ++row) {
+            if (predicate.accepts(model.store(), row))
+                ++rowAccepted;
+        }
+    });
+
+    QVector<quint64> mask((rows + 63) / 64);
+    int              maskAccepted = 0;
+    const double     maskMs = timeMs([&] {
+        predicate.evaluate(model.store(), 0, rows, mask.data());
+        for (quint64 word : mask)
+            maskAccepted += qPopulationCount(word);
+    });
+
+    TableFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.storeNameFilter(conditions.name);
+    proxy.storeCategoryFilter(QStringLiteral("全部"));
+    proxy.storeDateFrom(conditions.dateFrom);
+    proxy.storeDateTo(conditions.dateTo);
+    proxy.storeMinPrice(conditions.minPrice);
+    proxy.storeMaxPrice(conditions.maxPrice);
+    proxy.storeAvailabilityFilter(1);
+    const double applyMs = timeMs([&] { proxy.applyFilters(); });
+    const bool   applyMatch = legacyAccepted == proxy.rowCount();
+
+    // 逐字输入/删除名称与收紧价格区间：只复查可能改变的行
+    const double widenMs = timeMs([&] { proxy.setNameFilter(QStringLiteral("电")); });
+    const double narrowMs = timeMs([&] { proxy.setNameFilter(conditions.name); });
+    const double tightenMs = timeMs([&] { proxy.setPriceRangeFilter(200, 800); });
+
+    // 同样收紧价格区间，但源数据修改过，只能完整求值
+    proxy.setPriceRangeFilter(conditions.minPrice, conditions.maxPrice);
+    model.setData(model.index(0, TableItem::IdColumn), model.store().id(0));
+    const double fullMs = timeMs([&] { proxy.setPriceRangeFilter(200, 800); });
+
+    result["accepted_rows"] = legacyAccepted;
+    result["results_match"] = legacyAccepted == rowAccepted && legacyAccepted == maskAccepted && applyMatch;
+    result["legacy_ms"] = legacyMs;
+    result["compile_ms"] = compileMs;
+    result["predicate_row_ms"] = rowMs;
+    result["predicate_vectorized_ms"] = maskMs;
+    result["proxy_apply_ms"] = applyMs;
+    result["proxy_widen_ms"] = widenMs;
+    result["proxy_narrow_ms"] = narrowMs;
+    result["proxy_tighten_ms"] = tightenMs;
+    result["proxy_tighten_full_ms"] = fullMs;
+    return result;
+}
+
+// 等待并行模式的代理发布结果
+void waitUntilIdle(TableFilterProxyModel *proxy)
+{
+    if (!proxy->isBusy())
+        return;
+    QEventLoop loop;
+    QObject::connect(proxy, &TableFilterProxyModel::busyChanged, &loop, [&loop](bool busy) {
+        if (!busy)
+            loop.quit();
+    });
+    loop.exec();
+}
+
+void storeBenchFilters(TableFilterProxyModel *proxy)
+{
+    proxy->storeNameFilter(QStringLiteral("电脑"));
+    proxy->storeCategoryFilter(QStringLiteral("全部"));
+    proxy->storeDateFrom(QDate::currentDate().addMonths(-6));
+    proxy->storeDateTo(QDate::currentDate());
+    proxy->storeMinPrice(100);
+    proxy->storeMaxPrice(800);
+    proxy->storeAvailabilityFilter(1);
+}
+
+// 并行：同步与并行模式下的筛选、排序耗时
+QJsonObject runParallel(int rows)
+{
+    QJsonObject result;
+
+    TableModel model;
+    model.generateTestData(rows);
+
+    TableFilterProxyModel serial;
+    serial.setSourceModel(&model);
+    storeBenchFilters(&serial);
+    result["serial_filter_ms"] = timeMs([&] { serial.applyFilters(); });
+    result["serial_sort_ms"] = timeMs([&] { serial.sort(TableItem::PriceColumn); });
+
+    TableFilterProxyModel parallel;
+    parallel.setSourceModel(&model);
+    parallel.setParallelEnabled(true);
+    storeBenchFilters(&parallel);
+    result["parallel_filter_ms"] = timeMs([&] {
+        parallel.applyFilters();
+        waitUntilIdle(&parallel);
+    });
+    result["parallel_sort_ms"] = timeMs([&] {
+        parallel.sort(TableItem::PriceColumn);
+        waitUntilIdle(&parallel);
+    });
+
+    // 连续发出多次请求，只有最后一次会被发布
+    result["parallel_superseded_ms"] = timeMs([&] {
+        for (int i = 0; i < 8; ++i) {
+            parallel.setPriceRangeFilter(100 + i * 10, 800);
+            parallel.sort(i % 2 ? TableItem::NameColumn : TableItem::DateColumn);
+        }
+        waitUntilIdle(&parallel);
+    });
+
+    QThreadPool      pool;
+    QVector<quint32> ranks;
+    result["sort_ranks_ms"] = timeMs([&] {
+        TableParallel::sortRanks(&pool,
+                                 model.store(),
+                                 TableItem::PriceColumn,
+                                 Qt::CaseInsensitive,
+                                 false,
+                                 &ranks,
+                                 [] { return false; });
+    });
+    result["threads"] = pool.maxThreadCount();
+
+    serial.setPriceRangeFilter(170, 800);
+    serial.sort(TableItem::NameColumn);
+    result["results_match"] = serial.rowCount() == parallel.rowCount();
+    return result;
+}
+
+// 与TableModel::generateTestData相同的商品名，加上品牌和型号组合出大量不同的名称
+QString productName(int variant)
+{
+    static const QStringList brands = {QStringLiteral("华为"),
+                                       QStringLiteral("小米"),
+                                       QStringLiteral("联想"),
+                                       QStringLiteral("得力"),
+                                       QStringLiteral("晨光"),
+                                       QStringLiteral("迪卡侬"),
+                                       QStringLiteral("德芙"),
+                                       QStringLiteral("农夫山泉"),
+                                       QStringLiteral("汇源"),
+                                       QStringLiteral("人民文学")};
+    static const QStringList products = {QStringLiteral("笔记本电脑"),
+                                         QStringLiteral("智能手机"),
+                                         QStringLiteral("平板电脑"),
+                                         QStringLiteral("咖啡杯"),
+                                         QStringLiteral("办公桌"),
+                                         QStringLiteral("座椅"),
+                                         QStringLiteral("订书机"),
+                                         QStringLiteral("文件夹"),
+                                         QStringLiteral("笔筒"),
+                                         QStringLiteral("帐篷"),
+                                         QStringLiteral("睡袋"),
+                                         QStringLiteral("背包"),
+                                         QStringLiteral("巧克力"),
+                                         QStringLiteral("矿泉水"),
+                                         QStringLiteral("果汁"),
+                                         QStringLiteral("小说"),
+                                         QStringLiteral("编程书籍"),
+                                         QStringLiteral("影片光盘")};
+
+    const int combinations = brands.size() * products.size();
+    return brands.at(variant % brands.size()) + products.at(variant / brands.size() % products.size())
+           + QStringLiteral(" %1型").arg(variant / combinations + 1);
+}
+
+void fillProducts(TableColumnStore *store, int rows, int distinct)
+{
+    QRandomGenerator random(42);
+    const QDate      today = QDate::currentDate();
+    store->reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        store->append(row + 1,
+                      productName(random.bounded(distinct)),
+                      QStringLiteral("电子产品"),
+                      today,
+                      random.bounded(1000),
+                      random.bounded(2) > 0);
+    }
+}
+
+int acceptedRows(const TableColumnStore &store, const TableFilterPredicate &predicate)
+{
+    QVector<quint64> mask((store.rowCount() + 63) / 64);
+    predicate.evaluate(store, 0, store.rowCount(), mask.data());
+    int accepted = 0;
+    for (quint64 word : mask)
+        accepted += qPopulationCount(word);
+    return accepted;
+}
+
+// 名称索引：建立耗时、增量维护开销、内存占用，以及编译名称筛选条件的延迟
+QJsonObject runNgram(int rows)
+{
+    QJsonObject result;
+
+    // 大约每10行一种名称，上限100万种
+    const int distinct = qBound(1, rows / 10, 1000000);
+
+    TableColumnStore plain;
+    TableColumnStore indexed;
+    indexed.setNameIndexEnabled(true);
+    result["plain_append_ms"] = timeMs([&] { fillProducts(&plain, rows, distinct); });
+    result["indexed_append_ms"] = timeMs([&] { fillProducts(&indexed, rows, distinct); });
+    result["distinct_names"] = plain.nameCount();
+    result["store_bytes"] = double(plain.memoryUsage());
+    result["index_bytes"] = double(indexed.nameIndex()->memoryUsage());
+
+    // 每个查询重复多次取平均，编译时间主要花在名称匹配上
+    const int         repeats = 5;
+    QJsonArray        queries;
+    bool              match = true;
+    const QStringList needles = {QStringLiteral("电"),
+                                 QStringLiteral("电脑"),
+                                 QStringLiteral("笔记本电脑"),
+                                 QStringLiteral("小米智能"),
+                                 QStringLiteral("汇源果汁 7型"),
+                                 QStringLiteral("不存在的商品")};
+    for (const QString &needle : needles) {
+        TableFilterPredicate::Conditions conditions;
+        conditions.nameEnabled = true;
+        conditions.name = needle;
+
+        TableFilterPredicate scan;
+        TableFilterPredicate lookup;
+        const double         scanMs = timeMs([&] {
+            for (int i = 0; i < repeats; ++i)
+                scan.compile(plain, conditions);
+        });
+        const double indexMs = timeMs([&] {
+            for (int i = 0; i < repeats; ++i)
+                lookup.compile(indexed, conditions);
+        });
+
+        QVector<quint32> candidates;
+        indexed.nameIndex()->candidates(needle, &candidates);
+        const int accepted = acceptedRows(plain, scan);
+        match = match && accepted == acceptedRows(indexed, lookup);
+
+        QJsonObject query;
+        query["query"] = needle;
+        query["scan_ms"] = scanMs / repeats;
+        query["index_ms"] = indexMs / repeats;
+        query["candidate_names"] = candidates.size();
+        query["accepted_rows"] = accepted;
+        queries.append(query);
+    }
+    result["queries"] = queries;
+    result["results_match"] = match;
+
+    // 在已有的字符串池上一次性建立索引
+    result["index_build_ms"] = timeMs([&] { plain.setNameIndexEnabled(true); });
+    return result;
+}
+
+// 统计data()调用次数；legacy为true时按缓存前的方式每次重新格式化字符串、构造画刷
+class CountingTableModel : public TableModel
+{
+public:
+    explicit CountingTableModel(bool legacy)
+        : m_legacy(legacy)
+    {}
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        ++calls;
+        if (m_legacy && index.isValid())
+            return legacyData(index, role);
+        return TableModel::data(index, role);
+    }
+
+    mutable qint64 calls = 0;
+
+private:
+    QVariant legacyData(const QModelIndex &index, int role) const
+    {
+        const int row = index.row();
+        if (role == Qt::DisplayRole && index.column() == TableItem::DateColumn)
+            return QLocale::system().toString(store().date(row), QLocale::ShortFormat);
+        if (role == Qt::DisplayRole && index.column() == TableItem::PriceColumn)
+            return QLocale::system().toCurrencyString(store().price(row));
+        if (role == Qt::BackgroundRole) {
+            if (row % 2 == 0)
+                return QBrush(QColor(240, 240, 240));
+            if (index.column() == TableItem::CategoryColumn) {
+                const QString &category = store().category(row);
+                if (category == QStringLiteral("电子产品"))
+                    return QBrush(QColor(230, 255, 230));
+                if (category == QStringLiteral("家居用品"))
+                    return QBrush(QColor(230, 230, 255));
+                if (category == QStringLiteral("办公用品"))
+                    return QBrush(QColor(255, 230, 230));
+            }
+            return QBrush();
+        }
+        return TableModel::data(index, role);
+    }
+
+    bool m_legacy;
+};
+
+// 滚动：离屏表格视图按滚轮（每帧3行）和翻页两种步长重绘，统计每帧的data()调用和耗时
+QJsonObject runScroll(int rows)
+{
+    QJsonObject result;
+    const int   frames = 200;
+
+    for (bool legacy : {true, false}) {
+        CountingTableModel model(legacy);
+        model.generateTestData(rows);
+        TableFilterProxyModel proxy;
+        proxy.setSourceModel(&model);
+
+        QTableView view;
+        view.setModel(&proxy);
+        view.setItemDelegate(new TableItemDelegate(&view));
+        view.resize(1280, 800);
+        view.show();
+        QApplication::processEvents();
+
+        QScrollBar *bar = view.verticalScrollBar();
+        QJsonObject modes;
+        for (bool page : {false, true}) {
+            const int step = page ? bar->pageStep() : 3 * bar->singleStep();
+            bar->setValue(0);
+            view.viewport()->repaint();
+            model.calls = 0;
+
+            const double ms = timeMs([&] {
+                for (int frame = 0; frame < frames; ++frame) {
+                    bar->setValue(bar->value() + step > bar->maximum() ? 0 : bar->value() + step);
+                    view.viewport()->repaint();
+                }
+            });
+
+            QJsonObject mode;
+            mode["frame_ms"] = ms / frames;
+            mode["data_calls_per_frame"] = double(model.calls) / frames;
+            mode["data_call_ns"] = model.calls > 0 ? ms * 1e6 / model.calls : 0;
+            modes[page ? "page" : "wheel"] = mode;
+        }
+        result[legacy ? "legacy" : "cached"] = modes;
+    }
+    return result;
+}
+
+// 按旧版格式逐字段写入QDataStream
+void writeLegacyFile(const TableColumnStore &store, const QString &filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << store.rowCount();
+    for (int row = 0; row < store.rowCount(); ++row) {
+        out << store.id(row) << store.name(row) << store.category(row) << store.date(row)
+            << store.price(row) << store.isAvailable(row);
+    }
+}
+
+double megabytesPerSecond(qint64 bytes, double ms)
+{
+    return ms > 0 ? bytes / 1048576.0 / (ms / 1000.0) : 0;
+}
+
+// 文件：旧版QDataStream格式与分块列式格式（压缩/不压缩）的保存、首屏与完整加载耗时
+QJsonObject runFile(int rows)
+{
+    QJsonObject result;
+
+    QTemporaryDir dir;
+    TableModel    model;
+    model.generateTestData(rows);
+
+    const QString legacyPath = dir.filePath("legacy.dat");
+    QJsonObject   legacy;
+    legacy["save_ms"] = timeMs([&] { writeLegacyFile(model.store(), legacyPath); });
+    legacy["bytes"] = double(QFileInfo(legacyPath).size());
+    TableModel legacyModel;
+    legacy["load_ms"] = timeMs([&] { legacyModel.loadFromFile(legacyPath); });
+    legacy["rows_match"] = legacyModel.rowCount() == rows;
+    result["legacy"] = legacy;
+
+    for (bool compressed : {false, true}) {
+        const QString path = dir.filePath(compressed ? "compressed.dat" : "columnar.dat");
+        QJsonObject   format;
+
+        const double saveMs = timeMs([&] { model.saveToFile(path, compressed); });
+        const qint64 bytes = QFileInfo(path).size();
+        format["save_ms"] = saveMs;
+        format["bytes"] = double(bytes);
+        format["save_mb_per_s"] = megabytesPerSecond(bytes, saveMs);
+
+        // 打开文件只加载第一块，其余的块按需加载
+        TableModel loaded;
+        format["first_screen_ms"] = timeMs([&] { loaded.loadFromFile(path); });
+        format["first_screen_rows"] = loaded.rowCount();
+        const double fetchMs = timeMs([&] { loaded.fetchAll(); });
+        format["fetch_all_ms"] = fetchMs;
+        format["load_mb_per_s"] = megabytesPerSecond(bytes, fetchMs);
+        format["rows_match"] = loaded.rowCount() == rows;
+        result[compressed ? "compressed" : "columnar"] = format;
+    }
+    return result;
+}
+
+// 以固定种子随机选取约fraction比例的行号（升序）
+QList<int> sampleRows(int rows, double fraction)
+{
+    QRandomGenerator generator(42);
+    QList<int>       selected;
+    for (int row = 0; row < rows; ++row) {
+        if (generator.generateDouble() < fraction)
+            selected.append(row);
+    }
+    return selected;
+}
+
+// 删除：随机选中10%、50%、90%的行，对比逐行removeItem与批量removeRows（均挂接代理模型）。
+// 逐行删除是O(n^2)，只按行号均匀抽取一部分计时，再按比例估算总耗时
+QJsonObject runRemove(int rows)
+{
+    QJsonObject result;
+    const int   perRowSample = 2000;
+
+    for (int percent : {10, 50, 90}) {
+        const QList<int> selected = sampleRows(rows, percent / 100.0);
+        QJsonObject      fraction;
+        fraction["rows_removed"] = selected.size();
+
+        {
+            TableModel model;
+            model.generateTestData(rows);
+            TableFilterProxyModel proxy;
+            proxy.setSourceModel(&model);
+
+            // 从大到小删除，与原来的界面逻辑一致
+            const int    sample = qMin(perRowSample, selected.size());
+            const int    stride = sample > 0 ? selected.size() / sample : 1;
+            const double ms = timeMs([&] {
+                for (int i = sample - 1; i >= 0; --i)
+                    model.removeItem(selected.at(i * stride));
+            });
+            fraction["per_row_sample_ms"] = ms;
+            fraction["per_row_estimated_ms"] = sample > 0 ? ms * selected.size() / sample : 0;
+        }
+
+        {
+            TableModel model;
+            model.generateTestData(rows);
+            TableFilterProxyModel proxy;
+            proxy.setSourceModel(&model);
+
+            int removed = 0;
+            fraction["batch_ms"] = timeMs([&] { removed = model.removeRows(selected); });
+            fraction["rows_match"] = removed == selected.size() && model.rowCount() == rows - removed
+                                     && proxy.rowCount() == model.rowCount();
+        }
+        result[QStringLiteral("percent_%1").arg(percent)] = fraction;
+    }
+    return result;
+}
+
+QList<BenchCase> createCases()
+{
+    QList<BenchCase> cases;
+    cases << BenchCase{"storage", runStorage};
+    cases << BenchCase{"filter", runFilter};
+    cases << BenchCase{"parallel", runParallel};
+    cases << BenchCase{"ngram", runNgram};
+    cases << BenchCase{"scroll", runScroll};
+    cases << BenchCase{"file", runFile};
+    cases << BenchCase{"remove", runRemove};
+    return cases;
+}
+
+QList<int> parseRows(const QString &text, bool *ok)
+{
+    QList<int> rows;
+    *ok = true;
+    for (const QString &part : text.split(',', Qt::SkipEmptyParts)) {
+        // 支持1e6这样的科学计数写法
+        bool         valueOk = false;
+        const double value = part.trimmed().toDouble(&valueOk);
+        if (!valueOk || value < 1 || value > 1e8) {
+            *ok = false;
+            return rows;
+        }
+        rows << int(value);
+    }
+    return rows;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 没有显示环境时使用offscreen平台，便于在CI中运行
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("bench_tableview");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("TableModel benchmark");
+    parser.addHelpOption();
+    QCommandLineOption rowsOption("rows", "Comma separated row counts, e.g. 1e6,1e7.", "list", "1e6,1e7");
+    QCommandLineOption filterOption("filter", "Regular expression selecting the cases to run.", "regexp", ".*");
+    QCommandLineOption outputOption("output", "Write the JSON report to this file instead of stdout.", "file");
+    QCommandLineOption listOption("list", "List the available cases and exit.");
+    parser.addOptions({rowsOption, filterOption, outputOption, listOption});
+    parser.process(app);
+
+    const QList<BenchCase> cases = createCases();
+    if (parser.isSet(listOption)) {
+        for (const BenchCase &benchCase : cases)
+            std::printf("%s\n", qPrintable(benchCase.name));
+        return 0;
+    }
+
+    bool                     ok = false;
+    const QList<int>         rowCounts = parseRows(parser.value(rowsOption), &ok);
+    const QRegularExpression filter(parser.value(filterOption));
+    if (!ok || rowCounts.isEmpty() || !filter.isValid()) {
+        std::fprintf(stderr, "invalid arguments, see --help\n");
+        return 1;
+    }
+
+    QJsonArray results;
+    for (const BenchCase &benchCase : cases) {
+        if (!filter.match(benchCase.name).hasMatch())
+            continue;
+        for (int rows : rowCounts) {
+            QJsonObject result = benchCase.run(rows);
+            result["case"] = benchCase.name;
+            result["rows"] = rows;
+            std::fprintf(stderr, "%-16s %10d  done\n", qPrintable(benchCase.name), rows);
+            results.append(result);
+        }
+    }
+
+    QJsonObject meta;
+    meta["qt"] = qVersion();
+    meta["os"] = QSysInfo::prettyProductName();
+    meta["cpu"] = QSysInfo::currentCpuArchitecture();
+    meta["threads"] = QThread::idealThreadCount();
+#ifdef BENCH_TRACK_HEAP
+    meta["heap_tracking"] = true;
+#else
+    meta["heap_tracking"] = false;
+#endif
+    meta["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+
+    QJsonObject root;
+    root["meta"] = meta;
+    root["results"] = results;
+    const QByteArray json = QJsonDocument(root).toJson();
+
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::fprintf(stderr, "cannot write %s\n", qPrintable(file.fileName()));
+            return 1;
+        }
+        file.write(json);
+    } else {
+        std::fwrite(json.constData(), 1, size_t(json.size()), stdout);
+    }
+    return 0;
+}
@@ -22,6 +22,9 @@
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , m_fileAction(NoFileAction)
+    , m_fileRows(0)
+    , m_fileBytes(0)
 {
     ui->setupUi(this);
 
@@ -37,6 +40,7 @@ MainWindow::MainWindow(QWidget *parent)
     m_proxyModel = new TableFilterProxyModel(this);
     m_proxyModel->setSourceModel(m_tableModel);
     m_proxyModel->setSortCaseSensitivity(Qt::CaseInsensitive);
+    m_proxyModel->setParallelEnabled(true); // 大表的筛选和排序在后台执行
 
     // 设置UI界面
     setupUI();
@@ -91,6 +95,9 @@ void MainWindow::setupUI()
     m_nameFilterEdit = new QLineEdit(filterGroupBox);
     m_nameFilterEdit->setClearButtonEnabled(true);
     m_nameFilterEdit->setPlaceholderText(tr("输入关键字筛选"));
+    m_nameFilterTimer = new QTimer(this);
+    m_nameFilterTimer->setSingleShot(true);
+    m_nameFilterTimer->setInterval(250);
     filterLayout->addWidget(nameLabel, 0, 0);
     filterLayout->addWidget(m_nameFilterEdit, 0, 1);
 
@@ -215,41 +222,19 @@ void MainWindow::setupUI()
     buttonLayout->addWidget(m_loadButton);
 
     mainLayout->addLayout(buttonLayout);
-}
 
-void MainWindow::setupFilters()
-{
-    // 更新类别过滤器
-    updateCategoryFilter();
+    // 后台加载/保存时在状态栏显示取消按钮
+    m_cancelFileButton = new QPushButton(tr("取消"), this);
+    m_cancelFileButton->hide();
+    statusBar()->addPermanentWidget(m_cancelFileButton);
 }
 
-void MainWindow::updateCategoryFilter()
+void MainWindow::setupFilters()
 {
-    // 获取所有唯一的类别值
-    QSet<QString> categories;
-    for (int i = 0; i < m_tableModel->rowCount(); ++i) {
-        TableItem item = m_tableModel->getItem(i);
-        categories.insert(item.getCategory());
-    }
-
-    // 保存当前选中项
-    QString currentCategory = m_categoryFilterCombo->currentText();
-
-    // 清空并重新填充
-    m_categoryFilterCombo->clear();
-    m_categoryFilterCombo->addItem(tr("全部"));
-
-    QStringList categoryList = categories.toList();
-    std::sort(categoryList.begin(), categoryList.end());
-    for (const QString &category : categoryList) {
-        m_categoryFilterCombo->addItem(category);
-    }
-
-    // 恢复之前的选择
-    int index = m_categoryFilterCombo->findText(currentCategory);
-    if (index >= 0) {
-        m_categoryFilterCombo->setCurrentIndex(index);
-    }
+    // 类别下拉框由模型提供，随表格中的类别集合增量更新
+    m_categoryModel = new TableCategoryModel(this);
+    m_categoryModel->setSourceModel(m_tableModel);
+    m_categoryFilterCombo->setModel(m_categoryModel);
 }
 
 void MainWindow::connectSignals()
@@ -257,6 +242,16 @@ void MainWindow::connectSignals()
     // 数据修改信号
     connect(m_tableModel, &TableModel::dataChanged, this, &MainWindow::onTableDataChanged);
 
+    // 后台筛选/排序状态
+    connect(m_proxyModel, &TableFilterProxyModel::busyChanged, this, [this](bool busy) {
+        if (busy) {
+            statusBar()->showMessage(tr("正在筛选和排序..."));
+        } else {
+            statusBar()->showMessage(tr("筛选和排序完成，共 %1 行").arg(m_proxyModel->rowCount()),
+                                     3000);
+        }
+    });
+
     // 表格项双击信号
     connect(m_tableView, &QTableView::doubleClicked, this, &MainWindow::onTableItemDoubleClicked);
 
@@ -265,13 +260,24 @@ void MainWindow::connectSignals()
     connect(m_removeButton, &QPushButton::clicked, this, &MainWindow::onRemoveItemClicked);
     connect(m_saveButton, &QPushButton::clicked, this, &MainWindow::onSaveClicked);
     connect(m_loadButton, &QPushButton::clicked, this, &MainWindow::onLoadClicked);
+    connect(m_cancelFileButton, &QPushButton::clicked, m_tableModel, &TableModel::cancelFileOperation);
+
+    // 后台文件操作
+    connect(m_tableModel, &TableModel::fileOperationProgress, this, &MainWindow::onFileOperationProgress);
+    connect(m_tableModel, &TableModel::fileOperationFinished, this, &MainWindow::onFileOperationFinished);
     connect(m_resetFilterButton, &QPushButton::clicked, this, &MainWindow::onResetFilterClicked);
     connect(m_applyFilterButton, &QPushButton::clicked, this, &MainWindow::onApplyFilterClicked);
 
-    // 筛选控件信号 - 值改变时只保存到对应变量，不直接触发筛选
+    // 名称筛选随输入生效，停止输入一段时间后才筛选，连续的按键只触发一次
     connect(m_nameFilterEdit, &QLineEdit::textChanged, [this](const QString &text) {
         m_proxyModel->storeNameFilter(text);
+        m_nameFilterTimer->start();
     });
+    connect(m_nameFilterTimer, &QTimer::timeout, [this]() {
+        onFilterTextChanged(m_nameFilterEdit->text());
+    });
+
+    // 其他筛选控件信号 - 值改变时只保存到对应变量，不直接触发筛选
 
     connect(m_categoryFilterCombo, &QComboBox::currentTextChanged, [this](const QString &category) {
         m_proxyModel->storeCategoryFilter(category);
@@ -306,9 +312,6 @@ void MainWindow::createTestData()
 {
     m_tableModel->generateTestData(100);
 
-    // 更新类别下拉框
-    updateCategoryFilter();
-
     // 默认排序
     m_tableView->sortByColumn(TableItem::IdColumn, Qt::AscendingOrder);
 }
@@ -330,9 +333,6 @@ void MainWindow::onAddItemClicked()
     m_tableView->setCurrentIndex(proxyIndex);
     m_tableView->edit(proxyIndex);
 
-    // 更新类别筛选器
-    updateCategoryFilter();
-
     statusBar()->showMessage(tr("添加了新记录"), 3000);
 }
 
@@ -355,54 +355,34 @@ void MainWindow::onRemoveItemClicked()
         return;
     }
 
-    // 从大到小排序，避免删除小索引影响大索引
-    std::sort(selectedRows.begin(),
-              selectedRows.end(),
-              [](const QModelIndex &a, const QModelIndex &b) { return a.row() > b.row(); });
-
-    // 逐个删除，避免索引失效
+    // 映射到源模型行号后一次删除，模型把相邻的行合并为区间
+    QList<int> rows;
+    rows.reserve(selectedRows.size());
     for (const QModelIndex &proxyIndex : selectedRows) {
-        QModelIndex sourceIndex = m_proxyModel->mapToSource(proxyIndex);
-        m_tableModel->removeItem(sourceIndex.row());
+        rows.append(m_proxyModel->mapToSource(proxyIndex).row());
     }
+    const int removed = m_tableModel->removeRows(rows);
 
-    // 更新类别筛选器
-    updateCategoryFilter();
-
-    statusBar()->showMessage(tr("删除了 %1 条记录").arg(selectedRows.size()), 3000);
+    statusBar()->showMessage(tr("删除了 %1 条记录").arg(removed), 3000);
 }
 
 void MainWindow::onSaveClicked()
 {
-    // 如果已有当前文件路径，直接保存到该文件
-    if (!m_currentFilePath.isEmpty()) {
-        if (m_tableModel->saveToFile(m_currentFilePath)) {
-            statusBar()->showMessage(tr("数据已保存到：%1").arg(m_currentFilePath), 5000);
-        } else {
-            QMessageBox::warning(this,
-                                 tr("保存失败"),
-                                 tr("无法保存数据到文件：%1").arg(m_currentFilePath));
-        }
-        return;
-    }
-
-    // 如果没有当前文件路径，弹出对话框让用户选择
-    QString filename = QFileDialog::getSaveFileName(this,
-                                                    tr("保存数据"),
-                                                    QString(),
-                                                    tr("数据文件 (*.dat);;所有文件 (*.*)"));
-
+    // 如果已有当前文件路径，直接保存到该文件，否则弹出对话框让用户选择
+    QString filename = m_currentFilePath;
     if (filename.isEmpty()) {
-        return;
+        filename = QFileDialog::getSaveFileName(this,
+                                                tr("保存数据"),
+                                                QString(),
+                                                tr("数据文件 (*.dat);;所有文件 (*.*)"));
+        if (filename.isEmpty()) {
+            return;
+        }
     }
 
-    // 保存文件并记录路径
-    if (m_tableModel->saveToFile(filename)) {
-        m_currentFilePath = filename;
-        statusBar()->showMessage(tr("数据已保存到：%1").arg(filename), 5000);
-    } else {
-        QMessageBox::warning(this, tr("保存失败"), tr("无法保存数据到文件：%1").arg(filename));
-    }
+    // 后台保存，完成后记录路径
+    beginFileOperation(SavingFile, filename);
+    m_tableModel->saveToFileAsync(filename);
 }
 
 void MainWindow::onLoadClicked()
@@ -416,17 +396,79 @@ void MainWindow::onLoadClicked()
         return;
     }
 
-    if (m_tableModel->loadFromFile(filename)) {
-        // 记录当前文件路径
-        m_currentFilePath = filename;
+    // 后台加载，数据分批出现在表格中
+    beginFileOperation(LoadingFile, filename);
+    m_tableModel->loadFromFileAsync(filename);
+}
+
+void MainWindow::beginFileOperation(FileAction action, const QString &filename)
+{
+    m_fileAction = action;
+    m_pendingFilePath = filename;
+    m_fileRows = 0;
+    m_fileBytes = 0;
+    m_fileTimer.start();
+
+    m_saveButton->setEnabled(false);
+    m_loadButton->setEnabled(false);
+    m_cancelFileButton->show();
+
+    statusBar()->showMessage(action == LoadingFile ? tr("正在加载：%1").arg(filename)
+                                                   : tr("正在保存：%1").arg(filename));
+}
+
+QString MainWindow::fileThroughputText() const
+{
+    const double seconds = qMax<qint64>(m_fileTimer.elapsed(), 1) / 1000.0;
+    return tr("%1 行，%2 行/秒，%3 MB/秒")
+        .arg(m_fileRows)
+        .arg(qRound64(m_fileRows / seconds))
+        .arg(m_fileBytes / seconds / (1024.0 * 1024.0), 0, 'f', 1);
+}
+
+void MainWindow::onFileOperationProgress(qint64 rows, qint64 bytes)
+{
+    m_fileRows = rows;
+    m_fileBytes = bytes;
+    statusBar()->showMessage((m_fileAction == LoadingFile ? tr("正在加载：%1") : tr("正在保存：%1"))
+                                 .arg(fileThroughputText()));
+}
 
-        // 更新类别筛选器
-        updateCategoryFilter();
+void MainWindow::onFileOperationFinished(bool success, bool cancelled, const QString &error)
+{
+    const FileAction action = m_fileAction;
+    m_fileAction = NoFileAction;
+    m_saveButton->setEnabled(true);
+    m_loadButton->setEnabled(true);
+    m_cancelFileButton->hide();
+
+    if (cancelled) {
+        statusBar()->showMessage(action == LoadingFile
+                                     ? tr("加载已取消，保留已加载的 %1 行").arg(m_tableModel->rowCount())
+                                     : tr("保存已取消，原文件未改动"),
+                                 5000);
+        return;
+    }
 
-        statusBar()->showMessage(tr("数据已从 %1 加载").arg(filename), 5000);
-    } else {
-        QMessageBox::warning(this, tr("加载失败"), tr("无法从文件加载数据：%1").arg(filename));
+    if (!success) {
+        if (action == LoadingFile) {
+            QMessageBox::warning(this,
+                                 tr("加载失败"),
+                                 tr("无法从文件加载数据：%1\n%2").arg(m_pendingFilePath, error));
+        } else {
+            QMessageBox::warning(this,
+                                 tr("保存失败"),
+                                 tr("无法保存数据到文件：%1\n%2").arg(m_pendingFilePath, error));
+        }
+        return;
     }
+
+    // 记录当前文件路径
+    m_currentFilePath = m_pendingFilePath;
+    statusBar()->showMessage(action == LoadingFile
+                                 ? tr("数据已从 %1 加载（%2）").arg(m_pendingFilePath, fileThroughputText())
+                                 : tr("数据已保存到：%1（%2）").arg(m_pendingFilePath, fileThroughputText()),
+                             5000);
 }
 
 void MainWindow::onFilterTextChanged(const QString &text)
@@ -479,9 +521,6 @@ void MainWindow::onTableDataChanged(const QModelIndex &topLeft, const QModelInde
     Q_UNUSED(topLeft);
     Q_UNUSED(bottomRight);
 
-    // 如果有类别数据变更，更新筛选器
-    updateCategoryFilter();
-
     statusBar()->showMessage(tr("数据已更新"), 3000);
 }
 
@@ -1,11 +1,13 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include "tablecategorymodel.h"
 #include "tablefilterproxymodel.h"
 #include "tablemodel.h"
 #include <QComboBox>
 #include <QDateEdit>
 #include <QDoubleSpinBox>
+#include <QElapsedTimer>
 #include <QFileDialog>
 #include <QLineEdit>
 #include <QMainWindow>
@@ -13,6 +15,7 @@
 #include <QPushButton>
 #include <QStandardItemModel>
 #include <QTableView>
+#include <QTimer>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -44,6 +47,10 @@ private slots:
     // 加载数据
     void onLoadClicked();
 
+    // 后台加载/保存的进度与结束
+    void onFileOperationProgress(qint64 rows, qint64 bytes);
+    void onFileOperationFinished(bool success, bool cancelled, const QString &error);
+
     // 筛选器更新
     void onFilterTextChanged(const QString &text);
     void onCategoryFilterChanged(const QString &category);
@@ -67,21 +74,24 @@ private:
     void setupUI();
     void setupFilters();
 
-    // 更新类别过滤器
-    void updateCategoryFilter();
-
     // 连接信号槽
     void connectSignals();
 
     // 创建测试数据
     void createTestData();
 
+    // 后台文件操作
+    enum FileAction { NoFileAction, LoadingFile, SavingFile };
+    void    beginFileOperation(FileAction action, const QString &filename);
+    QString fileThroughputText() const;
+
 private:
     Ui::MainWindow *ui;
 
     TableModel            *m_tableModel;
     QTableView            *m_tableView;
-    TableFilterProxyModel *m_proxyModel; // 表格筛选代理模型
+    TableFilterProxyModel *m_proxyModel;    // 表格筛选代理模型
+    TableCategoryModel    *m_categoryModel; // 类别下拉框模型
 
     // 操作按钮
     QPushButton *m_addButton;
@@ -90,6 +100,7 @@ private:
     QPushButton *m_loadButton;
     QPushButton *m_resetFilterButton;
     QPushButton *m_applyFilterButton; // 新增筛选按钮
+    QPushButton *m_cancelFileButton;  // 取消后台加载/保存
 
     // 筛选组件
     QLineEdit      *m_nameFilterEdit;
@@ -99,8 +110,16 @@ private:
     QDoubleSpinBox *m_minPriceFilterSpin; // 改为最小价格
     QDoubleSpinBox *m_maxPriceFilterSpin; // 添加最大价格
     QComboBox      *m_availableFilterCombo;
+    QTimer         *m_nameFilterTimer; // 合并连续输入的名称筛选
 
     // 当前加载的文件路径
     QString m_currentFilePath;
+
+    // 进行中的后台文件操作，用于计算吞吐量
+    FileAction    m_fileAction;
+    QString       m_pendingFilePath;
+    QElapsedTimer m_fileTimer;
+    qint64        m_fileRows;
+    qint64        m_fileBytes;
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,59 @@
+#include "tablecategorymodel.h"
+#include "tablemodel.h"
+
+TableCategoryModel::TableCategoryModel(QObject *parent)
+    : QAbstractListModel(parent)
+{}
+
+void TableCategoryModel::setSourceModel(TableModel *model)
+{
+    if (m_sourceModel == model)
+        return;
+
+    if (m_sourceModel)
+        disconnect(m_sourceModel, nullptr, this, nullptr);
+    m_sourceModel = model;
+    if (m_sourceModel)
+        connect(m_sourceModel, &TableModel::categoriesChanged, this, &TableCategoryModel::refresh);
+    refresh();
+}
+
+int TableCategoryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_categories.size() + 1;
+}
+
+QVariant TableCategoryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() > m_categories.size())
+        return QVariant();
+
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+        return index.row() == 0 ? tr("全部") : m_categories.at(index.row() - 1);
+    return QVariant();
+}
+
+void TableCategoryModel::refresh()
+{
+    const QStringList next = m_sourceModel ? m_sourceModel->categories() : QStringList();
+
+    // 两个有序列表归并比较，第i项对应模型的第i + 1行
+    int i = 0;
+    int j = 0;
+    while (i < m_categories.size() || j < next.size()) {
+        if (j >= next.size() || (i < m_categories.size() && m_categories.at(i) < next.at(j))) {
+            beginRemoveRows(QModelIndex(), i + 1, i + 1);
+            m_categories.removeAt(i);
+            endRemoveRows();
+        } else if (i >= m_categories.size() || next.at(j) < m_categories.at(i)) {
+            beginInsertRows(QModelIndex(), i + 1, i + 1);
+            m_categories.insert(i, next.at(j));
+            endInsertRows();
+            ++i;
+            ++j;
+        } else {
+            ++i;
+            ++j;
+        }
+    }
+}
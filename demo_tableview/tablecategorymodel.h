@@ -0,0 +1,37 @@
+#ifndef TABLECATEGORYMODEL_H
+#define TABLECATEGORYMODEL_H
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <QStringList>
+
+class TableModel;
+
+/**
+ * @brief 类别下拉框使用的列表模型
+ *
+ * 第0行固定为“全部”，其后是源模型中实际使用的类别（升序）。
+ * 源模型发出categoriesChanged时与当前列表按序比较，只插入或删除变化的行，
+ * 下拉框的当前选择因此保持不变，也不必清空重建。
+ */
+class TableCategoryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit TableCategoryModel(QObject *parent = nullptr);
+
+    void        setSourceModel(TableModel *model);
+    TableModel *sourceModel() const { return m_sourceModel; }
+
+    int      rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    void refresh();
+
+    QPointer<TableModel> m_sourceModel;
+    QStringList          m_categories; // 不含“全部”
+};
+
+#endif // TABLECATEGORYMODEL_H
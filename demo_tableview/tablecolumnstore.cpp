@@ -0,0 +1,419 @@
+#include "tablecolumnstore.h"
+#include <QDebug>
+#include <algorithm>
+
+const qint32 TableColumnStore::InvalidJulianDay;
+const int    TableColumnStore::MaxCategoryCount;
+
+TableColumnStore::TableColumnStore()
+    : m_nameIndexEnabled(false)
+    , m_dictionaryRevision(0)
+    , m_categorySetRevision(0)
+    , m_revision(0)
+{
+    // 类别编号0固定为空类别，字典溢出时也回退到它
+    internCategory(QString());
+}
+
+void TableColumnStore::reserve(int rows)
+{
+    m_ids.reserve(rows);
+    m_nameIds.reserve(rows);
+    m_categoryIds.reserve(rows);
+    m_julianDays.reserve(rows);
+    m_prices.reserve(rows);
+    m_availableBits.reserve((rows + 63) / 64);
+}
+
+void TableColumnStore::clear()
+{
+    // 每行都引用一个类别，有行时清空必然改变已用类别集合
+    if (!m_ids.isEmpty())
+        ++m_categorySetRevision;
+
+    m_ids.clear();
+    m_nameIds.clear();
+    m_categoryIds.clear();
+    m_julianDays.clear();
+    m_prices.clear();
+    m_availableBits.clear();
+
+    m_namePool.clear();
+    m_nameLookup.clear();
+    m_nameIndex.clear();
+    m_categories.clear();
+    m_categoryLookup.clear();
+    m_categoryRowCounts.clear();
+    ++m_dictionaryRevision;
+    ++m_revision;
+    internCategory(QString());
+}
+
+void TableColumnStore::append(const TableItem &item)
+{
+    append(item.getId(),
+           item.getName(),
+           item.getCategory(),
+           item.getDate(),
+           item.getPrice(),
+           item.isAvailable());
+}
+
+void TableColumnStore::append(int            id,
+                              const QString &name,
+                              const QString &category,
+                              const QDate   &date,
+                              double         price,
+                              bool           available)
+{
+    const int row = m_ids.size();
+    if ((row & 63) == 0)
+        m_availableBits.append(0);
+    ++m_revision;
+
+    const int categoryId = internCategory(category);
+    addCategoryRef(categoryId);
+
+    m_ids.append(id);
+    m_nameIds.append(quint32(internName(name)));
+    m_categoryIds.append(quint16(categoryId));
+    m_julianDays.append(toJulianDay(date));
+    m_prices.append(price);
+    setAvailable(row, available);
+}
+
+void TableColumnStore::removeRows(int row, int count)
+{
+    if (row < 0 || count <= 0 || row + count > m_ids.size())
+        return;
+
+    RowRange range;
+    range.first = row;
+    range.count = count;
+    removeRanges(QVector<RowRange>{range});
+}
+
+void TableColumnStore::removeRanges(const QVector<RowRange> &ranges)
+{
+    if (ranges.isEmpty())
+        return;
+    ++m_revision;
+
+    for (const RowRange &range : ranges) {
+        for (int i = range.first; i < range.first + range.count; ++i)
+            releaseCategoryRef(m_categoryIds.at(i));
+    }
+
+    // 保留的行依次前移到写入位置，目标总在源之前，可以原地顺序复制
+    const int rows = m_ids.size();
+
+    auto keptEnd = [&ranges, rows](int range) {
+        return range + 1 < ranges.size() ? ranges.at(range + 1).first : rows;
+    };
+    auto compact = [&ranges, &keptEnd](auto *column) {
+        int write = ranges.first().first;
+        for (int range = 0; range < ranges.size(); ++range) {
+            const int kept = ranges.at(range).first + ranges.at(range).count;
+            const int end = keptEnd(range);
+            std::copy(column->begin() + kept, column->begin() + end, column->begin() + write);
+            write += end - kept;
+        }
+        column->resize(write);
+    };
+    compact(&m_ids);
+    compact(&m_nameIds);
+    compact(&m_categoryIds);
+    compact(&m_julianDays);
+    compact(&m_prices);
+
+    // 位列逐位前移
+    int write = ranges.first().first;
+    for (int range = 0; range < ranges.size(); ++range) {
+        for (int i = ranges.at(range).first + ranges.at(range).count; i < keptEnd(range); ++i, ++write) {
+            const quint64 mask = quint64(1) << (write & 63);
+            if ((m_availableBits.at(i >> 6) >> (i & 63)) & 1)
+                m_availableBits[write >> 6] |= mask;
+            else
+                m_availableBits[write >> 6] &= ~mask;
+        }
+    }
+    m_availableBits.resize((write + 63) / 64);
+    const int tail = write & 63;
+    if (tail != 0)
+        m_availableBits.last() &= (quint64(1) << tail) - 1;
+}
+
+void TableColumnStore::appendColumns(int            rows,
+                                     const qint32  *ids,
+                                     const quint32 *nameIds,
+                                     const quint16 *categoryIds,
+                                     const qint32  *julianDays,
+                                     const double  *prices,
+                                     const quint64 *availableWords)
+{
+    const int first = m_ids.size();
+    ++m_revision;
+
+    auto appendArray = [first, rows](auto *column, const auto *values) {
+        column->resize(first + rows);
+        std::copy(values, values + rows, column->begin() + first);
+    };
+    appendArray(&m_ids, ids);
+    appendArray(&m_nameIds, nameIds);
+    appendArray(&m_categoryIds, categoryIds);
+    appendArray(&m_julianDays, julianDays);
+    appendArray(&m_prices, prices);
+    for (int i = 0; i < rows; ++i)
+        addCategoryRef(categoryIds[i]);
+
+    // 起始行按字对齐时整字复制，否则逐位写入
+    m_availableBits.resize((first + rows + 63) / 64);
+    if ((first & 63) == 0) {
+        std::copy(availableWords, availableWords + (rows + 63) / 64, m_availableBits.begin() + first / 64);
+        const int tail = (first + rows) & 63;
+        if (tail != 0)
+            m_availableBits.last() &= (quint64(1) << tail) - 1;
+    } else {
+        for (int i = 0; i < rows; ++i)
+            setAvailable(first + i, (availableWords[i >> 6] >> (i & 63)) & 1);
+    }
+}
+
+TableItem TableColumnStore::item(int row) const
+{
+    return TableItem(id(row), name(row), category(row), date(row), price(row), isAvailable(row));
+}
+
+void TableColumnStore::setItem(int row, const TableItem &item)
+{
+    setId(row, item.getId());
+    setName(row, item.getName());
+    setCategory(row, item.getCategory());
+    setDate(row, item.getDate());
+    setPrice(row, item.getPrice());
+    setAvailable(row, item.isAvailable());
+}
+
+QVariant TableColumnStore::data(int row, int column) const
+{
+    switch (column) {
+    case TableItem::IdColumn:
+        return id(row);
+    case TableItem::NameColumn:
+        return name(row);
+    case TableItem::CategoryColumn:
+        return category(row);
+    case TableItem::DateColumn:
+        return date(row);
+    case TableItem::PriceColumn:
+        return price(row);
+    case TableItem::AvailableColumn:
+        return isAvailable(row);
+    default:
+        return QVariant();
+    }
+}
+
+bool TableColumnStore::setData(int row, int column, const QVariant &value)
+{
+    switch (column) {
+    case TableItem::IdColumn:
+        if (value.canConvert<int>()) {
+            setId(row, value.toInt());
+            return true;
+        }
+        break;
+    case TableItem::NameColumn:
+        if (value.canConvert<QString>()) {
+            setName(row, value.toString());
+            return true;
+        }
+        break;
+    case TableItem::CategoryColumn:
+        if (value.canConvert<QString>()) {
+            setCategory(row, value.toString());
+            return true;
+        }
+        break;
+    case TableItem::DateColumn:
+        if (value.canConvert<QDate>()) {
+            setDate(row, value.toDate());
+            return true;
+        }
+        break;
+    case TableItem::PriceColumn:
+        if (value.canConvert<double>()) {
+            setPrice(row, value.toDouble());
+            return true;
+        }
+        break;
+    case TableItem::AvailableColumn:
+        if (value.canConvert<bool>()) {
+            setAvailable(row, value.toBool());
+            return true;
+        }
+        break;
+    }
+    return false;
+}
+
+QDate TableColumnStore::date(int row) const
+{
+    const qint32 day = m_julianDays.at(row);
+    return day == InvalidJulianDay ? QDate() : QDate::fromJulianDay(day);
+}
+
+void TableColumnStore::setId(int row, int id)
+{
+    m_ids[row] = id;
+    ++m_revision;
+}
+
+void TableColumnStore::setName(int row, const QString &name)
+{
+    m_nameIds[row] = quint32(internName(name));
+    ++m_revision;
+}
+
+void TableColumnStore::setCategory(int row, const QString &category)
+{
+    const int categoryId = internCategory(category);
+    const int previous = m_categoryIds.at(row);
+    if (categoryId != previous) {
+        addCategoryRef(categoryId);
+        releaseCategoryRef(previous);
+        m_categoryIds[row] = quint16(categoryId);
+    }
+    ++m_revision;
+}
+
+void TableColumnStore::setDate(int row, const QDate &date)
+{
+    m_julianDays[row] = toJulianDay(date);
+    ++m_revision;
+}
+
+void TableColumnStore::setPrice(int row, double price)
+{
+    m_prices[row] = price;
+    ++m_revision;
+}
+
+void TableColumnStore::setAvailable(int row, bool available)
+{
+    const quint64 mask = quint64(1) << (row & 63);
+    if (available)
+        m_availableBits[row >> 6] |= mask;
+    else
+        m_availableBits[row >> 6] &= ~mask;
+    ++m_revision;
+}
+
+int TableColumnStore::findCategory(const QString &category) const
+{
+    return m_categoryLookup.value(category, -1);
+}
+
+bool TableColumnStore::restoreDictionaries(const QVector<QString> &names, const QVector<QString> &categories)
+{
+    clear();
+
+    // 类别编号0固定为空类别
+    if (categories.isEmpty() || !categories.first().isEmpty())
+        return false;
+
+    for (int nameId = 0; nameId < names.size(); ++nameId) {
+        if (internName(names.at(nameId)) != nameId)
+            return false;
+    }
+    for (int categoryId = 1; categoryId < categories.size(); ++categoryId) {
+        if (internCategory(categories.at(categoryId)) != categoryId)
+            return false;
+    }
+    return true;
+}
+
+void TableColumnStore::setNameIndexEnabled(bool enabled)
+{
+    if (m_nameIndexEnabled == enabled)
+        return;
+
+    m_nameIndexEnabled = enabled;
+    m_nameIndex.clear();
+    if (enabled) {
+        for (int nameId = 0; nameId < m_namePool.size(); ++nameId)
+            m_nameIndex.add(nameId, m_namePool.at(nameId));
+    }
+}
+
+qint64 TableColumnStore::memoryUsage() const
+{
+    qint64 bytes = qint64(m_ids.capacity()) * sizeof(qint32)
+                   + qint64(m_nameIds.capacity()) * sizeof(quint32)
+                   + qint64(m_categoryIds.capacity()) * sizeof(quint16)
+                   + qint64(m_julianDays.capacity()) * sizeof(qint32)
+                   + qint64(m_prices.capacity()) * sizeof(double)
+                   + qint64(m_availableBits.capacity()) * sizeof(quint64);
+
+    // 字典部分：字符串内容加上哈希表节点的粗略估算
+    for (const QString &name : m_namePool)
+        bytes += qint64(sizeof(QString)) * 2 + name.capacity() * qint64(sizeof(QChar));
+    for (const QString &category : m_categories)
+        bytes += qint64(sizeof(QString)) * 2 + category.capacity() * qint64(sizeof(QChar));
+    bytes += qint64(m_nameLookup.capacity() + m_categoryLookup.capacity()) * qint64(sizeof(void *));
+    bytes += qint64(m_categoryRowCounts.capacity()) * sizeof(int);
+    if (m_nameIndexEnabled)
+        bytes += m_nameIndex.memoryUsage();
+    return bytes;
+}
+
+qint32 TableColumnStore::toJulianDay(const QDate &date)
+{
+    return date.isValid() ? qint32(date.toJulianDay()) : InvalidJulianDay;
+}
+
+int TableColumnStore::internName(const QString &name)
+{
+    auto it = m_nameLookup.constFind(name);
+    if (it != m_nameLookup.constEnd())
+        return it.value();
+
+    const int nameId = m_namePool.size();
+    m_namePool.append(name);
+    m_nameLookup.insert(name, nameId);
+    if (m_nameIndexEnabled)
+        m_nameIndex.add(nameId, name);
+    ++m_dictionaryRevision;
+    return nameId;
+}
+
+int TableColumnStore::internCategory(const QString &category)
+{
+    auto it = m_categoryLookup.constFind(category);
+    if (it != m_categoryLookup.constEnd())
+        return it.value();
+
+    if (m_categories.size() >= MaxCategoryCount) {
+        qWarning() << "类别数量超出上限，回退为空类别:" << category;
+        return 0;
+    }
+
+    const int categoryId = m_categories.size();
+    m_categories.append(category);
+    m_categoryLookup.insert(category, categoryId);
+    m_categoryRowCounts.append(0);
+    ++m_dictionaryRevision;
+    return categoryId;
+}
+
+void TableColumnStore::addCategoryRef(int categoryId)
+{
+    if (m_categoryRowCounts[categoryId]++ == 0)
+        ++m_categorySetRevision;
+}
+
+void TableColumnStore::releaseCategoryRef(int categoryId)
+{
+    if (--m_categoryRowCounts[categoryId] == 0)
+        ++m_categorySetRevision;
+}
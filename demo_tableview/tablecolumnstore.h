@@ -0,0 +1,159 @@
+#ifndef TABLECOLUMNSTORE_H
+#define TABLECOLUMNSTORE_H
+
+#include "tableitem.h"
+#include "tablengramindex.h"
+#include <QHash>
+#include <QVector>
+#include <limits>
+
+/**
+ * @brief 表格数据的列式存储
+ *
+ * 每一列单独保存在连续数组中，避免QList<TableItem>每行一个堆节点的开销，
+ * 排序和筛选时只需顺序扫描用到的列：
+ * - ID：int32数组
+ * - 名称：字符串池 + 每行的池编号，相同名称只保存一份
+ * - 类别：字典编码，每行保存16位类别编号
+ * - 日期：儒略日（int32），无效日期记为InvalidJulianDay
+ * - 价格：double数组
+ * - 可用性：按位压缩，每64行占用一个quint64
+ *
+ * 可选的名称索引是字符串池上的n-gram倒排索引，随新名称入池增量维护。
+ * 类别字典带有每个编号的引用行数，增删改行时O(1)更新，无需扫描即可得到实际使用的类别。
+ */
+class TableColumnStore
+{
+public:
+    static const qint32 InvalidJulianDay = std::numeric_limits<qint32>::min();
+    static const int    MaxCategoryCount = std::numeric_limits<quint16>::max() + 1;
+
+    // 连续的行区间
+    struct RowRange
+    {
+        int first = 0;
+        int count = 0;
+    };
+
+    TableColumnStore();
+
+    int  rowCount() const { return m_ids.size(); }
+    bool isEmpty() const { return m_ids.isEmpty(); }
+    void reserve(int rows);
+    void clear();
+
+    // 行级操作
+    void      append(const TableItem &item);
+    void      append(int            id,
+                     const QString &name,
+                     const QString &category,
+                     const QDate   &date,
+                     double         price,
+                     bool           available);
+    void      removeRows(int row, int count);
+    // 一次删除多个按行号升序、互不重叠的区间，各列只压缩一遍
+    void      removeRanges(const QVector<RowRange> &ranges);
+
+    // 批量追加，调用方需保证名称、类别编号已在字典中
+    void appendColumns(int            rows,
+                       const qint32  *ids,
+                       const quint32 *nameIds,
+                       const quint16 *categoryIds,
+                       const qint32  *julianDays,
+                       const double  *prices,
+                       const quint64 *availableWords);
+    TableItem item(int row) const;
+    void      setItem(int row, const TableItem &item);
+
+    // 与TableItem::data/setData一致的按列读写
+    QVariant data(int row, int column) const;
+    bool     setData(int row, int column, const QVariant &value);
+
+    // 单元格读取
+    int            id(int row) const { return m_ids.at(row); }
+    int            nameId(int row) const { return int(m_nameIds.at(row)); }
+    const QString &name(int row) const { return m_namePool.at(int(m_nameIds.at(row))); }
+    int            categoryId(int row) const { return m_categoryIds.at(row); }
+    const QString &category(int row) const { return m_categories.at(m_categoryIds.at(row)); }
+    qint32         julianDay(int row) const { return m_julianDays.at(row); }
+    QDate          date(int row) const;
+    double         price(int row) const { return m_prices.at(row); }
+    bool           isAvailable(int row) const
+    {
+        return (m_availableBits.at(row >> 6) >> (row & 63)) & 1;
+    }
+
+    // 单元格修改
+    void setId(int row, int id);
+    void setName(int row, const QString &name);
+    void setCategory(int row, const QString &category);
+    void setDate(int row, const QDate &date);
+    void setPrice(int row, double price);
+    void setAvailable(int row, bool available);
+
+    // 字典访问
+    int            nameCount() const { return m_namePool.size(); }
+    const QString &poolName(int nameId) const { return m_namePool.at(nameId); }
+    int            categoryCount() const { return m_categories.size(); }
+    const QString &categoryName(int categoryId) const { return m_categories.at(categoryId); }
+    int            findCategory(const QString &category) const;
+
+    // 类别引用计数：引用该类别编号的行数
+    int categoryRowCount(int categoryId) const { return m_categoryRowCounts.at(categoryId); }
+
+    // 清空后按给定顺序重建字典，使编号与文件中保存的编号一致；字典含重复项时返回false
+    bool restoreDictionaries(const QVector<QString> &names, const QVector<QString> &categories);
+
+    // 名称子串索引：启用时在现有字符串池上建立，之后随新名称增量维护；未启用时返回nullptr
+    void                   setNameIndexEnabled(bool enabled);
+    bool                   isNameIndexEnabled() const { return m_nameIndexEnabled; }
+    const TableNgramIndex *nameIndex() const { return m_nameIndexEnabled ? &m_nameIndex : nullptr; }
+
+    // 字典版本号：清空或新增名称、类别时递增，编号含义变化时据此失效缓存
+    quint64 dictionaryRevision() const { return m_dictionaryRevision; }
+
+    // 类别集合版本号：某个类别的引用行数在0与非0之间变化时递增
+    quint64 categorySetRevision() const { return m_categorySetRevision; }
+
+    // 数据版本号：任何修改都会递增，用于判断后台计算所用的快照是否过期
+    quint64 revision() const { return m_revision; }
+
+    // 原始列数组，供排序和筛选批量扫描
+    const qint32  *idData() const { return m_ids.constData(); }
+    const quint32 *nameIdData() const { return m_nameIds.constData(); }
+    const quint16 *categoryIdData() const { return m_categoryIds.constData(); }
+    const qint32  *julianDayData() const { return m_julianDays.constData(); }
+    const double  *priceData() const { return m_prices.constData(); }
+    const quint64 *availableWords() const { return m_availableBits.constData(); }
+
+    // 估算占用的堆内存（字节）
+    qint64 memoryUsage() const;
+
+    static qint32 toJulianDay(const QDate &date);
+
+private:
+    int  internName(const QString &name);
+    int  internCategory(const QString &category);
+    void addCategoryRef(int categoryId);
+    void releaseCategoryRef(int categoryId);
+
+    QVector<qint32>  m_ids;
+    QVector<quint32> m_nameIds;
+    QVector<quint16> m_categoryIds;
+    QVector<qint32>  m_julianDays;
+    QVector<double>  m_prices;
+    QVector<quint64> m_availableBits;
+
+    QVector<QString>    m_namePool;          // 名称字符串池
+    QHash<QString, int> m_nameLookup;        // 名称 -> 池编号
+    QVector<QString>    m_categories;        // 类别字典
+    QHash<QString, int> m_categoryLookup;    // 类别 -> 类别编号
+    QVector<int>        m_categoryRowCounts; // 按类别编号索引的引用行数
+    TableNgramIndex     m_nameIndex;         // 字符串池上的n-gram索引
+    bool                m_nameIndexEnabled;
+    quint64             m_dictionaryRevision;
+    quint64             m_categorySetRevision;
+    quint64             m_revision;
+};
+
+#endif // TABLECOLUMNSTORE_H
@@ -0,0 +1,459 @@
+#include "tablefile.h"
+#include <QSaveFile>
+#include <QtEndian>
+#include <array>
+#include <cstring>
+
+namespace TableFile {
+
+namespace {
+
+const quint32 Magic = 0x4C424154; // "TABL"
+const quint16 Version = 1;
+const quint16 CompressedFlag = 0x0001;
+const int     HeaderSize = 64;
+const int     ChunkEntrySize = 64;
+const int     ColumnBlocks = 6;
+// 读取时接受的每块最大行数，保证列块字节数（最多rows * 8）不超出quint32和int
+const quint32 MaxChunkRows = 1u << 24;
+
+// 文件头中各字段的偏移
+enum HeaderField {
+    MagicOffset = 0,
+    VersionOffset = 4,
+    FlagsOffset = 6,
+    ChunkRowsOffset = 8,
+    ChunkCountOffset = 12,
+    RowCountOffset = 16,
+    DictionaryOffsetOffset = 24,
+    DictionarySizeOffset = 32,
+    ChunkTableOffsetOffset = 40,
+    DictionaryChecksumOffset = 48,
+    ChunkTableChecksumOffset = 52,
+    HeaderChecksumOffset = 60
+};
+
+quint32 crc32(const uchar *data, qint64 size, quint32 crc = 0)
+{
+    static const std::array<quint32, 256> table = [] {
+        std::array<quint32, 256> values;
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 value = i;
+            for (int bit = 0; bit < 8; ++bit)
+                value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+            values[i] = value;
+        }
+        return values;
+    }();
+
+    crc = ~crc;
+    for (qint64 i = 0; i < size; ++i)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+quint32 crc32(const QByteArray &bytes, quint32 crc = 0)
+{
+    return crc32(reinterpret_cast<const uchar *>(bytes.constData()), bytes.size(), crc);
+}
+
+template <typename T>
+void appendValue(QByteArray *out, T value)
+{
+    const T littleEndian = qToLittleEndian(value);
+    out->append(reinterpret_cast<const char *>(&littleEndian), int(sizeof(T)));
+}
+
+template <typename T>
+void writeValue(QByteArray *out, int offset, T value)
+{
+    qToLittleEndian(value, out->data() + offset);
+}
+
+template <typename T>
+T readValue(const uchar *data)
+{
+    return qFromLittleEndian<T>(data);
+}
+
+// 列数据转为小端字节序列
+template <typename T>
+QByteArray columnBytes(const T *values, int count)
+{
+    QByteArray bytes(int(count * sizeof(T)), Qt::Uninitialized);
+    qToLittleEndian<T>(values, count, bytes.data());
+    return bytes;
+}
+
+void appendString(QByteArray *out, const QString &text)
+{
+    appendValue<quint32>(out, quint32(text.size()));
+    out->append(columnBytes(reinterpret_cast<const quint16 *>(text.utf16()), text.size()));
+}
+
+// 解码一个列块：未压缩时直接从映射读取，压缩时先解压
+template <typename T>
+bool decodeColumn(const uchar *stored, quint32 storedSize, quint32 rawSize, QVector<T> *values)
+{
+    QByteArray unpacked;
+    const uchar *source = stored;
+    if (storedSize != rawSize) {
+        unpacked = qUncompress(stored, int(storedSize));
+        if (unpacked.size() != int(rawSize))
+            return false;
+        source = reinterpret_cast<const uchar *>(unpacked.constData());
+    }
+
+    values->resize(int(rawSize / sizeof(T)));
+    qFromLittleEndian<T>(source, values->size(), values->data());
+    return true;
+}
+
+// 每个列块解码后应有的字节数
+quint32 expectedRawSize(int block, quint32 rows)
+{
+    switch (block) {
+    case 0: // ID
+    case 1: // 名称编号
+    case 3: // 儒略日
+        return rows * 4;
+    case 2: // 类别编号
+        return rows * 2;
+    case 4: // 价格
+        return rows * 8;
+    default: // 可用性位图
+        return (rows + 63) / 64 * 8;
+    }
+}
+
+} // namespace
+
+bool isColumnarFile(const QString &filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QByteArray header = file.read(HeaderSize);
+    return header.size() == HeaderSize
+           && readValue<quint32>(reinterpret_cast<const uchar *>(header.constData())) == Magic;
+}
+
+bool write(const TableColumnStore &store,
+           const QString          &filename,
+           bool                    compressed,
+           QString                *error,
+           const Progress         &progress)
+{
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        *error = file.errorString();
+        return false;
+    }
+
+    const int rows = store.rowCount();
+    const int chunkCount = (rows + ChunkRows - 1) / ChunkRows;
+
+    // 先写占位的文件头，各部分的位置确定后再回填
+    file.write(QByteArray(HeaderSize, '\0'));
+
+    QByteArray chunkTable;
+    chunkTable.reserve(chunkCount * ChunkEntrySize);
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        const int first = chunk * ChunkRows;
+        const int count = qMin(ChunkRows, rows - first);
+
+        const QByteArray blocks[ColumnBlocks] = {
+            columnBytes(store.idData() + first, count),
+            columnBytes(store.nameIdData() + first, count),
+            columnBytes(store.categoryIdData() + first, count),
+            columnBytes(store.julianDayData() + first, count),
+            columnBytes(reinterpret_cast<const quint64 *>(store.priceData() + first), count),
+            columnBytes(store.availableWords() + first / 64, (count + 63) / 64),
+        };
+
+        appendValue<qint64>(&chunkTable, file.pos());
+        appendValue<quint32>(&chunkTable, quint32(count));
+
+        QByteArray sizes;
+        quint32    checksum = 0;
+        for (const QByteArray &block : blocks) {
+            // 只有压缩后确实变小才保存压缩数据，读取时按大小是否一致区分
+            QByteArray stored = block;
+            if (compressed) {
+                const QByteArray packed = qCompress(block, 1);
+                if (packed.size() < block.size())
+                    stored = packed;
+            }
+            file.write(stored);
+            checksum = crc32(stored, checksum);
+            appendValue<quint32>(&sizes, quint32(stored.size()));
+            appendValue<quint32>(&sizes, quint32(block.size()));
+        }
+        appendValue<quint32>(&chunkTable, checksum);
+        chunkTable.append(sizes);
+
+        // 未提交的临时文件随QSaveFile析构删除
+        if (progress && !progress(first + count, file.pos())) {
+            file.cancelWriting();
+            *error = QStringLiteral("已取消");
+            return false;
+        }
+    }
+
+    QByteArray dictionary;
+    appendValue<quint32>(&dictionary, quint32(store.nameCount()));
+    appendValue<quint32>(&dictionary, quint32(store.categoryCount()));
+    for (int nameId = 0; nameId < store.nameCount(); ++nameId)
+        appendString(&dictionary, store.poolName(nameId));
+    for (int categoryId = 0; categoryId < store.categoryCount(); ++categoryId)
+        appendString(&dictionary, store.categoryName(categoryId));
+
+    const qint64 dictionaryOffset = file.pos();
+    file.write(dictionary);
+    const qint64 chunkTableOffset = file.pos();
+    file.write(chunkTable);
+
+    QByteArray header(HeaderSize, '\0');
+    writeValue<quint32>(&header, MagicOffset, Magic);
+    writeValue<quint16>(&header, VersionOffset, Version);
+    writeValue<quint16>(&header, FlagsOffset, compressed ? CompressedFlag : 0);
+    writeValue<quint32>(&header, ChunkRowsOffset, quint32(ChunkRows));
+    writeValue<quint32>(&header, ChunkCountOffset, quint32(chunkCount));
+    writeValue<qint64>(&header, RowCountOffset, rows);
+    writeValue<qint64>(&header, DictionaryOffsetOffset, dictionaryOffset);
+    writeValue<qint64>(&header, DictionarySizeOffset, dictionary.size());
+    writeValue<qint64>(&header, ChunkTableOffsetOffset, chunkTableOffset);
+    writeValue<quint32>(&header, DictionaryChecksumOffset, crc32(dictionary));
+    writeValue<quint32>(&header, ChunkTableChecksumOffset, crc32(chunkTable));
+    writeValue<quint32>(&header,
+                        HeaderChecksumOffset,
+                        crc32(reinterpret_cast<const uchar *>(header.constData()), HeaderChecksumOffset));
+
+    file.seek(0);
+    file.write(header);
+
+    // 最后一块之后仍可能被取消，提交前再检查一次，否则界面报告已取消而原文件却被替换
+    if (progress && !progress(rows, file.pos())) {
+        file.cancelWriting();
+        *error = QStringLiteral("已取消");
+        return false;
+    }
+
+    // 任何一次写入失败都会使commit失败，原文件保持不变
+    if (!file.commit()) {
+        *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+Reader::Reader()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_rowCount(0)
+{}
+
+Reader::~Reader()
+{
+    close();
+}
+
+bool Reader::open(const QString &filename)
+{
+    close();
+
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return fail(m_file.errorString());
+
+    m_size = m_file.size();
+    if (m_size < HeaderSize)
+        return fail(QStringLiteral("文件头不完整"));
+    m_data = m_file.map(0, m_size);
+    if (!m_data)
+        return fail(m_file.errorString());
+
+    // 文件头
+    if (readValue<quint32>(m_data + MagicOffset) != Magic)
+        return fail(QStringLiteral("不是列式数据文件"));
+    if (crc32(m_data, HeaderChecksumOffset) != readValue<quint32>(m_data + HeaderChecksumOffset))
+        return fail(QStringLiteral("文件头校验失败"));
+    if (readValue<quint16>(m_data + VersionOffset) != Version)
+        return fail(QStringLiteral("不支持的文件版本"));
+
+    const quint32 chunkRows = readValue<quint32>(m_data + ChunkRowsOffset);
+    const quint32 chunkCount = readValue<quint32>(m_data + ChunkCountOffset);
+    const qint64  rowCount = readValue<qint64>(m_data + RowCountOffset);
+    const qint64  dictionaryOffset = readValue<qint64>(m_data + DictionaryOffsetOffset);
+    const qint64  dictionarySize = readValue<qint64>(m_data + DictionarySizeOffset);
+    const qint64  chunkTableOffset = readValue<qint64>(m_data + ChunkTableOffsetOffset);
+    const qint64  chunkTableSize = qint64(chunkCount) * ChunkEntrySize;
+
+    // 偏移和大小来自文件，先确认偏移在文件内，再与剩余长度比较，避免相加溢出
+    if (chunkRows == 0 || chunkRows % 64 != 0 || chunkRows > MaxChunkRows || rowCount < 0
+        || rowCount > std::numeric_limits<int>::max() || dictionaryOffset < HeaderSize
+        || dictionaryOffset > m_size || dictionarySize < 8 || dictionarySize > m_size - dictionaryOffset
+        || chunkTableOffset < HeaderSize || chunkTableOffset > m_size
+        || chunkTableSize > m_size - chunkTableOffset) {
+        return fail(QStringLiteral("文件头数据无效"));
+    }
+
+    // 块索引
+    const uchar *table = m_data + chunkTableOffset;
+    if (crc32(table, chunkTableSize) != readValue<quint32>(m_data + ChunkTableChecksumOffset))
+        return fail(QStringLiteral("块索引校验失败"));
+
+    qint64 rows = 0;
+    m_chunks.resize(int(chunkCount));
+    for (quint32 chunk = 0; chunk < chunkCount; ++chunk) {
+        const uchar *entryData = table + qint64(chunk) * ChunkEntrySize;
+        ChunkEntry  &entry = m_chunks[int(chunk)];
+        entry.offset = readValue<qint64>(entryData);
+        entry.rows = readValue<quint32>(entryData + 8);
+        entry.checksum = readValue<quint32>(entryData + 12);
+
+        // 除最后一块外每块都是整块，保证可用性位图按字对齐
+        const bool last = chunk + 1 == chunkCount;
+        if (entry.rows == 0 || entry.rows > chunkRows || (!last && entry.rows != chunkRows))
+            return fail(QStringLiteral("块索引数据无效"));
+
+        qint64 stored = 0;
+        for (int block = 0; block < ColumnBlocks; ++block) {
+            entry.storedSizes[block] = readValue<quint32>(entryData + 16 + block * 8);
+            entry.rawSizes[block] = readValue<quint32>(entryData + 20 + block * 8);
+            if (entry.rawSizes[block] != expectedRawSize(block, entry.rows))
+                return fail(QStringLiteral("块索引数据无效"));
+            stored += entry.storedSizes[block];
+        }
+        if (entry.offset < HeaderSize || entry.offset > m_size || stored > m_size - entry.offset)
+            return fail(QStringLiteral("块索引数据无效"));
+        rows += entry.rows;
+    }
+    if (rows != rowCount)
+        return fail(QStringLiteral("块索引与总行数不一致"));
+    m_rowCount = rowCount;
+
+    // 字典
+    const quint32 dictionaryChecksum = readValue<quint32>(m_data + DictionaryChecksumOffset);
+    if (crc32(m_data + dictionaryOffset, dictionarySize) != dictionaryChecksum)
+        return fail(QStringLiteral("字典校验失败"));
+    if (!readDictionary(dictionaryOffset, dictionarySize))
+        return fail(QStringLiteral("字典数据无效"));
+
+    return true;
+}
+
+void Reader::close()
+{
+    if (m_data)
+        m_file.unmap(const_cast<uchar *>(m_data));
+    m_file.close();
+
+    m_data = nullptr;
+    m_size = 0;
+    m_rowCount = 0;
+    m_chunks.clear();
+    m_names.clear();
+    m_categories.clear();
+}
+
+qint64 Reader::chunkSize(int chunk) const
+{
+    const ChunkEntry &entry = m_chunks.at(chunk);
+    qint64            stored = 0;
+    for (int block = 0; block < ColumnBlocks; ++block)
+        stored += entry.storedSizes[block];
+    return stored;
+}
+
+bool Reader::readChunk(int chunk, Chunk *result)
+{
+    if (!m_data || chunk < 0 || chunk >= m_chunks.size())
+        return fail(QStringLiteral("块编号无效"));
+
+    const ChunkEntry &entry = m_chunks.at(chunk);
+    const qint64      stored = chunkSize(chunk);
+    if (crc32(m_data + entry.offset, stored) != entry.checksum)
+        return fail(QStringLiteral("第%1块校验失败").arg(chunk + 1));
+
+    const uchar *data = m_data + entry.offset;
+    auto         next = [&entry, &data](int block) {
+        const uchar *blockData = data;
+        data += entry.storedSizes[block];
+        return blockData;
+    };
+
+    QVector<quint64> prices;
+    const bool       decoded
+        = decodeColumn(next(0), entry.storedSizes[0], entry.rawSizes[0], &result->ids)
+          && decodeColumn(next(1), entry.storedSizes[1], entry.rawSizes[1], &result->nameIds)
+          && decodeColumn(next(2), entry.storedSizes[2], entry.rawSizes[2], &result->categoryIds)
+          && decodeColumn(next(3), entry.storedSizes[3], entry.rawSizes[3], &result->julianDays)
+          && decodeColumn(next(4), entry.storedSizes[4], entry.rawSizes[4], &prices)
+          && decodeColumn(next(5), entry.storedSizes[5], entry.rawSizes[5], &result->availableWords);
+    if (!decoded)
+        return fail(QStringLiteral("第%1块解压失败").arg(chunk + 1));
+
+    // 名称、类别编号必须落在字典范围内
+    const quint32 nameCount = quint32(m_names.size());
+    const int     categoryCount = m_categories.size();
+    for (int row = 0; row < int(entry.rows); ++row) {
+        if (result->nameIds.at(row) >= nameCount || result->categoryIds.at(row) >= categoryCount)
+            return fail(QStringLiteral("第%1块数据无效").arg(chunk + 1));
+    }
+
+    result->rows = int(entry.rows);
+    result->prices.resize(prices.size());
+    memcpy(result->prices.data(), prices.constData(), size_t(prices.size()) * sizeof(double));
+    return true;
+}
+
+bool Reader::fail(const QString &error)
+{
+    close();
+    m_error = error;
+    return false;
+}
+
+bool Reader::readDictionary(qint64 offset, qint64 size)
+{
+    const uchar *data = m_data + offset;
+    const uchar *end = data + size;
+
+    const quint32 nameCount = readValue<quint32>(data);
+    const quint32 categoryCount = readValue<quint32>(data + 4);
+    data += 8;
+    if (categoryCount == 0 || categoryCount > quint32(TableColumnStore::MaxCategoryCount))
+        return false;
+
+    auto readString = [&data, end](QString *text) {
+        if (end - data < 4)
+            return false;
+        const quint32 length = readValue<quint32>(data);
+        data += 4;
+        if (quint64(end - data) < quint64(length) * 2)
+            return false;
+        text->resize(int(length));
+        qFromLittleEndian<quint16>(data, length, text->data());
+        data += qint64(length) * 2;
+        return true;
+    };
+
+    // 每个字符串至少占4字节，据此限制预分配
+    if (quint64(nameCount) + categoryCount > quint64(size) / 4)
+        return false;
+    m_names.resize(int(nameCount));
+    for (QString &name : m_names) {
+        if (!readString(&name))
+            return false;
+    }
+    m_categories.resize(int(categoryCount));
+    for (QString &category : m_categories) {
+        if (!readString(&category))
+            return false;
+    }
+    return data == end;
+}
+
+} // namespace TableFile
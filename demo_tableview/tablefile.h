@@ -0,0 +1,103 @@
+#ifndef TABLEFILE_H
+#define TABLEFILE_H
+
+#include "tablecolumnstore.h"
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+/**
+ * @brief 分块列式数据文件
+ *
+ * 文件结构（小端序）：
+ * - 文件头：魔数、版本、标志、每块行数、块数、总行数，字典与块索引的位置，以及校验和
+ * - 块数据：每块依次保存ID、名称编号、类别编号、儒略日、价格、可用性位图六个列块，
+ *   列块可单独压缩，整块带CRC-32校验
+ * - 字典：名称字符串池与类别字典，编号与块中的名称、类别编号对应
+ * - 块索引：每块的位置、行数、校验和与各列块的大小
+ *
+ * 读取时映射整个文件，只解析文件头、字典和块索引，块数据按需逐块解码。
+ */
+namespace TableFile {
+
+// 每块的行数，保持为64的倍数，使可用性位图按字对齐
+const int ChunkRows = 64 * 1024;
+
+// 文件头以魔数开始，据此区分旧版QDataStream格式
+bool isColumnarFile(const QString &filename);
+
+// 写入进度回调：参数为已写入的行数和字节数，返回false时取消写入
+using Progress = std::function<bool(qint64 rows, qint64 bytes)>;
+
+// 把store完整写入filename；compressed为true时压缩能变小的列块。
+// 每写完一块调用一次progress，提交前再调用一次；取消或失败时原文件保持不变
+bool write(const TableColumnStore &store,
+           const QString          &filename,
+           bool                    compressed,
+           QString                *error,
+           const Progress         &progress = Progress());
+
+// 解码后的一个数据块
+struct Chunk
+{
+    int              rows = 0;
+    QVector<qint32>  ids;
+    QVector<quint32> nameIds;
+    QVector<quint16> categoryIds;
+    QVector<qint32>  julianDays;
+    QVector<double>  prices;
+    QVector<quint64> availableWords;
+};
+
+/**
+ * @brief 按需读取分块列式文件
+ */
+class Reader
+{
+public:
+    Reader();
+    ~Reader();
+
+    // 映射文件并校验文件头、块索引和字典，失败时errorString()给出原因
+    bool open(const QString &filename);
+    void close();
+
+    QString errorString() const { return m_error; }
+
+    qint64                  rowCount() const { return m_rowCount; }
+    int                     chunkCount() const { return m_chunks.size(); }
+    int                     chunkRows(int chunk) const { return int(m_chunks.at(chunk).rows); }
+    qint64                  chunkSize(int chunk) const;
+    const QVector<QString> &names() const { return m_names; }
+    const QVector<QString> &categories() const { return m_categories; }
+
+    // 校验并解码一个块，名称、类别编号保证在字典范围内；失败后读取器关闭
+    bool readChunk(int chunk, Chunk *result);
+
+private:
+    struct ChunkEntry
+    {
+        qint64  offset = 0;
+        quint32 rows = 0;
+        quint32 checksum = 0;
+        quint32 storedSizes[6] = {};
+        quint32 rawSizes[6] = {};
+    };
+
+    bool fail(const QString &error);
+    bool readDictionary(qint64 offset, qint64 size);
+
+    QFile               m_file;
+    const uchar        *m_data;
+    qint64              m_size;
+    qint64              m_rowCount;
+    QVector<ChunkEntry> m_chunks;
+    QVector<QString>    m_names;
+    QVector<QString>    m_categories;
+    QString             m_error;
+};
+
+} // namespace TableFile
+
+#endif // TABLEFILE_H
@@ -0,0 +1,332 @@
+#include "tablefilterpredicate.h"
+#include <algorithm>
+
+namespace {
+
+// 抽样估计选择率时使用的最大样本数
+const int SelectivitySamples = 512;
+
+qint32 clampJulianDay(const QDate &date)
+{
+    // 无效日期的儒略日为qint64最小值，钳位后与原先QDate比较的结果一致
+    return qint32(qBound<qint64>(std::numeric_limits<qint32>::min(),
+                                 date.toJulianDay(),
+                                 std::numeric_limits<qint32>::max()));
+}
+
+using Refinement = TableFilterPredicate::Refinement;
+
+// 合并两个条件的变化，方向相反时无法增量求值
+Refinement combine(Refinement a, Refinement b)
+{
+    if (a == TableFilterPredicate::Unchanged)
+        return b;
+    if (b == TableFilterPredicate::Unchanged || a == b)
+        return a;
+    return TableFilterPredicate::Unrelated;
+}
+
+// 单个条件的变化：新启用为收窄，停用为放宽，都启用时由compareEnabled比较
+template <typename Compare>
+Refinement conditionRefinement(bool previousEnabled, bool nextEnabled, Compare compareEnabled)
+{
+    if (!previousEnabled && !nextEnabled)
+        return TableFilterPredicate::Unchanged;
+    if (!previousEnabled)
+        return TableFilterPredicate::Narrowed;
+    if (!nextEnabled)
+        return TableFilterPredicate::Widened;
+    return compareEnabled();
+}
+
+// 闭区间的变化：新区间落在旧区间内为收窄，包含旧区间为放宽
+template <typename T>
+Refinement rangeRefinement(T previousFrom, T previousTo, T nextFrom, T nextTo)
+{
+    const bool inside = nextFrom >= previousFrom && nextTo <= previousTo;
+    const bool outside = nextFrom <= previousFrom && nextTo >= previousTo;
+    if (inside && outside)
+        return TableFilterPredicate::Unchanged;
+    if (inside)
+        return TableFilterPredicate::Narrowed;
+    if (outside)
+        return TableFilterPredicate::Widened;
+    return TableFilterPredicate::Unrelated;
+}
+
+} // namespace
+
+TableFilterPredicate::Refinement TableFilterPredicate::refinement(const Conditions &previous,
+                                                                  const Conditions &next)
+{
+    Refinement result = Unchanged;
+
+    // 名称：包含旧子串的新子串只会匹配更少的名称
+    result = combine(result, conditionRefinement(previous.nameEnabled, next.nameEnabled, [&] {
+        const bool longer = next.name.contains(previous.name, Qt::CaseInsensitive);
+        const bool shorter = previous.name.contains(next.name, Qt::CaseInsensitive);
+        if (longer && shorter)
+            return Unchanged;
+        if (longer)
+            return Narrowed;
+        return shorter ? Widened : Unrelated;
+    }));
+
+    // 类别：在两个类别之间切换时结果没有包含关系
+    result = combine(result, conditionRefinement(previous.categoryEnabled, next.categoryEnabled, [&] {
+        return previous.category == next.category ? Unchanged : Unrelated;
+    }));
+
+    result = combine(result, conditionRefinement(previous.dateEnabled, next.dateEnabled, [&] {
+        return rangeRefinement(clampJulianDay(previous.dateFrom),
+                               clampJulianDay(previous.dateTo),
+                               clampJulianDay(next.dateFrom),
+                               clampJulianDay(next.dateTo));
+    }));
+
+    // 价格区间含NaN时比较均为false，按Unrelated处理
+    result = combine(result, conditionRefinement(previous.priceEnabled, next.priceEnabled, [&] {
+        return rangeRefinement(previous.minPrice, previous.maxPrice, next.minPrice, next.maxPrice);
+    }));
+
+    result = combine(result,
+                     conditionRefinement(previous.availabilityEnabled, next.availabilityEnabled, [&] {
+                         return previous.available == next.available ? Unchanged : Unrelated;
+                     }));
+
+    return result;
+}
+
+TableFilterPredicate::TableFilterPredicate()
+    : m_store(nullptr)
+    , m_revision(0)
+    , m_categoryId(-1)
+    , m_dateFrom(0)
+    , m_dateTo(0)
+    , m_minPrice(0)
+    , m_maxPrice(0)
+    , m_available(false)
+{}
+
+void TableFilterPredicate::compile(const TableColumnStore &store, const Conditions &conditions)
+{
+    reset();
+    m_store = &store;
+    m_revision = store.dictionaryRevision();
+
+    // 名称子串：每个不同的名称只比较一次，有索引时只确认索引给出的候选名称
+    if (conditions.nameEnabled) {
+        QVector<quint32>       candidates;
+        const TableNgramIndex *index = store.nameIndex();
+        if (index && index->candidates(conditions.name, &candidates)) {
+            m_nameMatches.fill(0, store.nameCount());
+            for (quint32 nameId : candidates) {
+                m_nameMatches[int(nameId)] = store.poolName(int(nameId)).contains(conditions.name,
+                                                                                  Qt::CaseInsensitive);
+            }
+        } else {
+            m_nameMatches.resize(store.nameCount());
+            for (int nameId = 0; nameId < store.nameCount(); ++nameId) {
+                m_nameMatches[nameId] = store.poolName(nameId).contains(conditions.name,
+                                                                        Qt::CaseInsensitive);
+            }
+        }
+        m_steps.append(Step{NameStep, 2.0, 1.0});
+    }
+
+    if (conditions.categoryEnabled) {
+        m_categoryId = store.findCategory(conditions.category);
+        m_steps.append(Step{CategoryStep, 1.0, 1.0});
+    }
+
+    if (conditions.dateEnabled) {
+        m_dateFrom = clampJulianDay(conditions.dateFrom);
+        m_dateTo = clampJulianDay(conditions.dateTo);
+        m_steps.append(Step{DateStep, 1.0, 1.0});
+    }
+
+    if (conditions.priceEnabled) {
+        m_minPrice = conditions.minPrice;
+        m_maxPrice = conditions.maxPrice;
+        m_steps.append(Step{PriceStep, 1.5, 1.0});
+    }
+
+    if (conditions.availabilityEnabled) {
+        m_available = conditions.available;
+        m_steps.append(Step{AvailabilityStep, 0.5, 1.0});
+    }
+
+    // 等距抽样估计每个谓词的通过率
+    const int rows = store.rowCount();
+    const int samples = qMin(rows, SelectivitySamples);
+    for (Step &step : m_steps) {
+        int passed = 0;
+        for (int i = 0; i < samples; ++i) {
+            if (acceptsStep(step.kind, store, int(qint64(i) * rows / samples)))
+                ++passed;
+        }
+        step.selectivity = (passed + 1.0) / (samples + 2.0);
+    }
+
+    // 按 代价 / 淘汰率 升序执行，使期望的求值代价最小
+    std::stable_sort(m_steps.begin(), m_steps.end(), [](const Step &a, const Step &b) {
+        return a.cost / (1.0 - a.selectivity) < b.cost / (1.0 - b.selectivity);
+    });
+}
+
+void TableFilterPredicate::reset()
+{
+    m_store = nullptr;
+    m_revision = 0;
+    m_steps.clear();
+    m_nameMatches.clear();
+    m_categoryId = -1;
+}
+
+bool TableFilterPredicate::isCompiledFor(const TableColumnStore &store) const
+{
+    return m_store == &store && m_revision == store.dictionaryRevision();
+}
+
+bool TableFilterPredicate::accepts(const TableColumnStore &store, int row) const
+{
+    for (const Step &step : m_steps) {
+        if (!acceptsStep(step.kind, store, row))
+            return false;
+    }
+    return true;
+}
+
+void TableFilterPredicate::evaluate(const TableColumnStore &store,
+                                    int                     first,
+                                    int                     count,
+                                    quint64                *mask) const
+{
+    const int words = (count + 63) / 64;
+    for (int w = 0; w < words; ++w) {
+        const int n = qMin(64, count - w * 64);
+        mask[w] = n == 64 ? ~quint64(0) : (quint64(1) << n) - 1;
+    }
+
+    // 逐个谓词扫描对应的列，已全部淘汰的64行组直接跳过
+    for (const Step &step : m_steps) {
+        for (int w = 0; w < words; ++w) {
+            if (mask[w] == 0)
+                continue;
+            mask[w] &= evaluateWord(step.kind, store, first + w * 64, qMin(64, count - w * 64));
+        }
+    }
+}
+
+void TableFilterPredicate::refine(const TableColumnStore &store,
+                                  Refinement              refinement,
+                                  int                     first,
+                                  int                     count,
+                                  quint64                *mask) const
+{
+    if (refinement == Unchanged)
+        return;
+    if (refinement == Unrelated) {
+        evaluate(store, first, count, mask);
+        return;
+    }
+
+    // 逐组处理：候选行在某一步全部淘汰后，剩余的谓词不再求值
+    const bool narrowed = refinement == Narrowed;
+    const int  words = (count + 63) / 64;
+    for (int w = 0; w < words; ++w) {
+        const int     n = qMin(64, count - w * 64);
+        const quint64 valid = n == 64 ? ~quint64(0) : (quint64(1) << n) - 1;
+        const quint64 previous = mask[w] & valid;
+
+        // 收窄时候选为已接受的行，放宽时为被淘汰的行
+        quint64 candidates = narrowed ? previous : ~previous & valid;
+        for (const Step &step : m_steps) {
+            if (candidates == 0)
+                break;
+            candidates &= evaluateWord(step.kind, store, first + w * 64, n);
+        }
+        mask[w] = narrowed ? candidates : previous | candidates;
+    }
+}
+
+bool TableFilterPredicate::acceptsStep(StepKind kind, const TableColumnStore &store, int row) const
+{
+    switch (kind) {
+    case NameStep:
+        return m_nameMatches.at(store.nameId(row));
+    case CategoryStep:
+        return store.categoryId(row) == m_categoryId;
+    case DateStep: {
+        // 与原先的逻辑一致：无效日期不参与日期筛选
+        const qint32 day = store.julianDay(row);
+        return day == TableColumnStore::InvalidJulianDay || (day >= m_dateFrom && day <= m_dateTo);
+    }
+    case PriceStep: {
+        const double price = store.price(row);
+        return !(price < m_minPrice) && !(price > m_maxPrice);
+    }
+    case AvailabilityStep:
+        return store.isAvailable(row) == m_available;
+    }
+    return true;
+}
+
+quint64 TableFilterPredicate::evaluateWord(StepKind                kind,
+                                           const TableColumnStore &store,
+                                           int                     first,
+                                           int                     count) const
+{
+    quint64 bits = 0;
+
+    switch (kind) {
+    case NameStep: {
+        const quint32 *nameIds = store.nameIdData() + first;
+        const quint8  *matches = m_nameMatches.constData();
+        for (int i = 0; i < count; ++i)
+            bits |= quint64(matches[nameIds[i]]) << i;
+        break;
+    }
+    case CategoryStep: {
+        const quint16 *categoryIds = store.categoryIdData() + first;
+        const int      categoryId = m_categoryId;
+        for (int i = 0; i < count; ++i)
+            bits |= quint64(categoryIds[i] == categoryId) << i;
+        break;
+    }
+    case DateStep: {
+        const qint32 *days = store.julianDayData() + first;
+        const qint32  from = m_dateFrom;
+        const qint32  to = m_dateTo;
+        for (int i = 0; i < count; ++i) {
+            const qint32 day = days[i];
+            bits |= quint64((day == TableColumnStore::InvalidJulianDay) | ((day >= from) & (day <= to)))
+                    << i;
+        }
+        break;
+    }
+    case PriceStep: {
+        const double *prices = store.priceData() + first;
+        const double  minPrice = m_minPrice;
+        const double  maxPrice = m_maxPrice;
+        for (int i = 0; i < count; ++i)
+            bits |= quint64(!(prices[i] < minPrice) & !(prices[i] > maxPrice)) << i;
+        break;
+    }
+    case AvailabilityStep: {
+        // 可用性本身就是位图，按起始行的位偏移拼出对应的64位
+        const quint64 *words = store.availableWords();
+        const int      word = first >> 6;
+        const int      shift = first & 63;
+        quint64        value = words[word] >> shift;
+        if (shift != 0 && shift + count > 64)
+            value |= words[word + 1] << (64 - shift);
+        bits = m_available ? value : ~value;
+        break;
+    }
+    }
+
+    if (count < 64)
+        bits &= (quint64(1) << count) - 1;
+    return bits;
+}
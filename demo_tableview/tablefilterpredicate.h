@@ -0,0 +1,90 @@
+#ifndef TABLEFILTERPREDICATE_H
+#define TABLEFILTERPREDICATE_H
+
+#include "tablecolumnstore.h"
+#include <QDate>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 编译后的筛选条件，直接读取TableColumnStore的列数组求值
+ *
+ * 名称子串在字符串池上预先求值一次，逐行只需按名称编号查表；类别比较类别编号，
+ * 日期比较儒略日。各谓词按抽样估计的选择率和代价排序，选择性强、代价低的先执行。
+ * 批量求值按64行一组生成结果位图，组内循环无分支，便于编译器向量化。
+ * 条件只是收窄或放宽时，可以在上一次的结果位图上只复查可能改变的行。
+ */
+class TableFilterPredicate
+{
+public:
+    // 需要编译的筛选条件
+    struct Conditions
+    {
+        bool    nameEnabled = false;
+        QString name;
+        bool    categoryEnabled = false;
+        QString category;
+        bool    dateEnabled = false;
+        QDate   dateFrom;
+        QDate   dateTo;
+        bool    priceEnabled = false;
+        double  minPrice = 0;
+        double  maxPrice = 0;
+        bool    availabilityEnabled = false;
+        bool    available = false;
+    };
+
+    // 新条件与上一次条件的关系：收窄时新结果是旧结果的子集，放宽时是旧结果的超集
+    enum Refinement { Unchanged, Narrowed, Widened, Unrelated };
+
+    TableFilterPredicate();
+
+    static Refinement refinement(const Conditions &previous, const Conditions &next);
+
+    void compile(const TableColumnStore &store, const Conditions &conditions);
+    void reset();
+
+    // 编译结果是否仍适用于store（字典变化后名称、类别编号需要重新解析）
+    bool isCompiledFor(const TableColumnStore &store) const;
+    bool acceptsAll() const { return m_steps.isEmpty(); }
+
+    bool accepts(const TableColumnStore &store, int row) const;
+
+    // 对[first, first + count)行批量求值，mask至少需要(count + 63) / 64个字
+    void evaluate(const TableColumnStore &store, int first, int count, quint64 *mask) const;
+
+    // 在mask中上一次的结果上增量求值：收窄时只复查已接受的行，放宽时只复查被淘汰的行，
+    // Unrelated时完整求值
+    void refine(const TableColumnStore &store,
+                Refinement              refinement,
+                int                     first,
+                int                     count,
+                quint64                *mask) const;
+
+private:
+    enum StepKind { NameStep, CategoryStep, DateStep, PriceStep, AvailabilityStep };
+
+    struct Step
+    {
+        StepKind kind;
+        double   cost;        // 单行求值的相对代价
+        double   selectivity; // 抽样估计的通过率
+    };
+
+    bool    acceptsStep(StepKind kind, const TableColumnStore &store, int row) const;
+    quint64 evaluateWord(StepKind kind, const TableColumnStore &store, int first, int count) const;
+
+    const TableColumnStore *m_store;
+    quint64                 m_revision;
+    QVector<Step>           m_steps; // 按执行顺序排列
+
+    QVector<quint8> m_nameMatches; // 按名称编号记录是否包含筛选子串
+    int             m_categoryId;  // -1表示类别不存在，所有行都不匹配
+    qint32          m_dateFrom;
+    qint32          m_dateTo;
+    double          m_minPrice;
+    double          m_maxPrice;
+    bool            m_available;
+};
+
+#endif // TABLEFILTERPREDICATE_H
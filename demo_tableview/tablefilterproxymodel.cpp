@@ -1,5 +1,45 @@
 #include "tablefilterproxymodel.h"
 #include "tablemodel.h"
+#include "tableparallel.h"
+#include <QSharedPointer>
+#include <QSignalBlocker>
+
+namespace {
+
+// 并行模式下，行数达到该值才转到后台计算
+const int ParallelRowThreshold = 64 * 1024;
+
+// 所有行都接受的结果位图
+QVector<quint64> allRowsMask(int rows)
+{
+    QVector<quint64> mask((rows + 63) / 64, ~quint64(0));
+    if (rows & 63)
+        mask.last() = (quint64(1) << (rows & 63)) - 1;
+    return mask;
+}
+
+// 除Unrelated外都可以在上一次的结果位图上继续求值，Unchanged直接沿用
+bool isIncremental(TableFilterPredicate::Refinement refinement)
+{
+    return refinement != TableFilterPredicate::Unrelated;
+}
+
+} // namespace
+
+// 后台任务的计算结果
+struct TableFilterProxyModel::ParallelResult
+{
+    quint64          generation = 0;
+    quint64          revision = 0;
+    bool                             filter = false;
+    TableFilterPredicate::Conditions conditions;
+    QVector<quint64>                 mask;
+    int                              maskRows = 0;
+    bool             sort = false;
+    int              sortColumn = -1;
+    Qt::SortOrder    sortOrder = Qt::AscendingOrder;
+    SortRanks        ranks;
+};
 
 TableFilterProxyModel::TableFilterProxyModel(QObject *parent)
     : QSortFilterProxyModel(parent)
@@ -14,12 +54,36 @@ TableFilterProxyModel::TableFilterProxyModel(QObject *parent)
     , m_storedMinPrice(0)
     , m_storedMaxPrice(10000)
     , m_storedAvailabilityState(-1)
+    , m_tableModel(nullptr)
+    , m_acceptedMaskRows(0)
+    , m_appliedMaskRows(-1)
+    , m_appliedRevision(0)
+    , m_parallelEnabled(false)
+    , m_busy(false)
+    , m_filterPending(false)
+    , m_sortPending(false)
+    , m_deferSort(false)
+    , m_pendingSortColumn(-1)
+    , m_pendingSortOrder(Qt::AscendingOrder)
+    , m_generation(0)
 {
+    m_jobPool.setMaxThreadCount(1);
+
     // 设置初始日期
     m_dateFrom = QDate::currentDate().addMonths(-1);
     m_dateTo = QDate::currentDate();
     m_storedDateFrom = m_dateFrom;
     m_storedDateTo = m_dateTo;
+    m_appliedConditions = conditions();
+}
+
+TableFilterProxyModel::~TableFilterProxyModel()
+{
+    // 取消并等待后台任务，任务不会再访问已销毁的成员
+    ++m_generation;
+    m_jobPool.clear();
+    m_jobPool.waitForDone();
+    m_workerPool.waitForDone();
 }
 
 void TableFilterProxyModel::storeNameFilter(const QString &name)
@@ -86,7 +150,7 @@ void TableFilterProxyModel::applyFilters()
     m_availabilityFilterEnabled = (m_availabilityState != -1);
 
     // 触发筛选
-    invalidateFilter();
+    refilter();
 }
 
 void TableFilterProxyModel::setNameFilter(const QString &name)
@@ -94,7 +158,7 @@ void TableFilterProxyModel::setNameFilter(const QString &name)
     storeNameFilter(name);
     m_nameFilter = name;
     m_nameFilterEnabled = !name.isEmpty();
-    invalidateFilter();
+    refilter();
 }
 
 void TableFilterProxyModel::setCategoryFilter(const QString &category)
@@ -107,7 +171,7 @@ void TableFilterProxyModel::setCategoryFilter(const QString &category)
         m_categoryFilter = category;
         m_categoryFilterEnabled = true;
     }
-    invalidateFilter();
+    refilter();
 }
 
 void TableFilterProxyModel::setDateRangeFilter(const QDate &from, const QDate &to)
@@ -118,7 +182,7 @@ void TableFilterProxyModel::setDateRangeFilter(const QDate &from, const QDate &t
     m_dateFrom = from;
     m_dateTo = to;
     m_dateFilterEnabled = true;
-    invalidateFilter();
+    refilter();
 }
 
 void TableFilterProxyModel::setPriceRangeFilter(double minPrice, double maxPrice)
@@ -129,7 +193,7 @@ void TableFilterProxyModel::setPriceRangeFilter(double minPrice, double maxPrice
     m_minPrice = minPrice;
     m_maxPrice = maxPrice;
     m_priceFilterEnabled = (minPrice > 0 || maxPrice < 10000);
-    invalidateFilter();
+    refilter();
 }
 
 void TableFilterProxyModel::setAvailabilityFilter(int state)
@@ -138,7 +202,7 @@ void TableFilterProxyModel::setAvailabilityFilter(int state)
 
     m_availabilityState = state;
     m_availabilityFilterEnabled = (state != -1);
-    invalidateFilter();
+    refilter();
 }
 
 void TableFilterProxyModel::resetFilters()
@@ -167,10 +231,374 @@ void TableFilterProxyModel::resetFilters()
     m_maxPrice = 10000.00;
     m_availabilityState = -1;
 
+    refilter();
+}
+
+void TableFilterProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    // 切换源模型时基类会重建全部映射，未完成的请求直接丢弃
+    cancelParallelJob(false);
+    m_tableModel = qobject_cast<TableModel *>(sourceModel);
+    m_predicate.reset();
+    m_sortRanks = SortRanks();
+    m_appliedConditions = conditions();
+    m_appliedMask.clear();
+    m_appliedMaskRows = -1;
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
+void TableFilterProxyModel::setParallelEnabled(bool enabled)
+{
+    if (m_parallelEnabled == enabled)
+        return;
+
+    m_parallelEnabled = enabled;
+    if (!enabled)
+        cancelParallelJob(true);
+}
+
+void TableFilterProxyModel::sort(int column, Qt::SortOrder order)
+{
+    // 没有可用排名时到后台计算；已有任务在执行时合并进新任务，保证请求按顺序生效
+    if (useParallel() && (m_busy || (column >= 0 && !sortRanksValid(column)))) {
+        m_sortPending = true;
+        m_pendingSortColumn = column;
+        m_pendingSortOrder = order;
+        startParallelJob();
+        return;
+    }
+
+    QSortFilterProxyModel::sort(column, order);
+}
+
+void TableFilterProxyModel::refilter()
+{
+    m_predicate.reset();
+
+    // 条件没有变化时映射已是最新结果（动态筛选会跟踪源模型的修改）
+    const TableFilterPredicate::Conditions next = conditions();
+    if (!m_busy && dynamicSortFilter()
+        && TableFilterPredicate::refinement(m_appliedConditions, next) == TableFilterPredicate::Unchanged) {
+        return;
+    }
+
+    // 并行模式下大表在后台筛选，完成后再发布
+    if (useParallel()) {
+        m_filterPending = true;
+        startParallelJob();
+        return;
+    }
+
+    // 先按列批量求值，随后基类逐行调用filterAcceptsRow时只需查位图。
+    // 条件只是收窄或放宽时，在上一次的结果上只复查可能改变的行
+    if (m_tableModel) {
+        const TableColumnStore &store = m_tableModel->store();
+        m_acceptedMaskRows = store.rowCount();
+        if (anyFilterEnabled()) {
+            const TableFilterPredicate::Refinement refinement = refinementFor(next);
+            m_predicate.compile(store, next);
+            if (isIncremental(refinement))
+                m_acceptedMask = m_appliedMask;
+            else
+                m_acceptedMask.resize((m_acceptedMaskRows + 63) / 64);
+            m_predicate.refine(store, refinement, 0, m_acceptedMaskRows, m_acceptedMask.data());
+        } else {
+            m_acceptedMask = allRowsMask(m_acceptedMaskRows);
+        }
+        m_appliedRevision = store.revision();
+    }
+
     invalidateFilter();
+
+    m_appliedConditions = next;
+    m_appliedMask = m_acceptedMask;
+    m_appliedMaskRows = m_tableModel ? m_acceptedMaskRows : -1;
+    m_acceptedMask.clear();
+    m_acceptedMaskRows = 0;
+}
+
+TableFilterPredicate::Conditions TableFilterProxyModel::conditions() const
+{
+    TableFilterPredicate::Conditions conditions;
+    conditions.nameEnabled = m_nameFilterEnabled;
+    conditions.name = m_nameFilter;
+    conditions.categoryEnabled = m_categoryFilterEnabled;
+    conditions.category = m_categoryFilter;
+    conditions.dateEnabled = m_dateFilterEnabled;
+    conditions.dateFrom = m_dateFrom;
+    conditions.dateTo = m_dateTo;
+    conditions.priceEnabled = m_priceFilterEnabled;
+    conditions.minPrice = m_minPrice;
+    conditions.maxPrice = m_maxPrice;
+    conditions.availabilityEnabled = m_availabilityFilterEnabled;
+    conditions.available = (m_availabilityState == 1);
+    return conditions;
+}
+
+bool TableFilterProxyModel::anyFilterEnabled() const
+{
+    return m_nameFilterEnabled || m_categoryFilterEnabled || m_dateFilterEnabled
+           || m_priceFilterEnabled || m_availabilityFilterEnabled;
+}
+
+TableFilterPredicate::Refinement TableFilterProxyModel::refinementFor(
+    const TableFilterPredicate::Conditions &next) const
+{
+    const TableFilterPredicate::Refinement refinement = TableFilterPredicate::refinement(m_appliedConditions,
+                                                                                         next);
+    if (refinement != TableFilterPredicate::Unrelated && !appliedMaskValid())
+        return TableFilterPredicate::Unrelated;
+    return refinement;
+}
+
+bool TableFilterProxyModel::appliedMaskValid() const
+{
+    // 源模型的任何修改都会改变修订号，此后位图可能与映射不一致
+    return m_tableModel && m_appliedMaskRows == m_tableModel->store().rowCount()
+           && m_appliedRevision == m_tableModel->store().revision();
 }
 
 bool TableFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (!anyFilterEnabled())
+        return true;
+
+    if (!m_tableModel || sourceParent.isValid())
+        return filterAcceptsRowGeneric(sourceRow, sourceParent);
+
+    // refilter期间直接使用批量求值的结果
+    if (sourceRow < m_acceptedMaskRows)
+        return (m_acceptedMask.at(sourceRow >> 6) >> (sourceRow & 63)) & 1;
+
+    // 插入或修改的行：逐行求值，字典变化后先重新编译
+    const TableColumnStore &store = m_tableModel->store();
+    if (!m_predicate.isCompiledFor(store))
+        m_predicate.compile(store, conditions());
+    return m_predicate.accepts(store, sourceRow);
+}
+
+bool TableFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    if (m_deferSort)
+        return false;
+
+    const int role = sortRole();
+    if (!m_tableModel || left.parent().isValid() || left.column() != right.column()
+        || (role != Qt::DisplayRole && role != Qt::EditRole)) {
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
+
+    if (sortRanksValid(left.column()))
+        return m_sortRanks.ranks.at(left.row()) < m_sortRanks.ranks.at(right.row());
+    return lessThanTyped(left.column(), left.row(), right.row());
+}
+
+bool TableFilterProxyModel::useParallel() const
+{
+    // 已有任务在执行时继续走后台，使新请求与未完成的请求合并
+    return m_parallelEnabled && m_tableModel
+           && (m_busy || m_tableModel->rowCount() >= ParallelRowThreshold);
+}
+
+void TableFilterProxyModel::startParallelJob()
+{
+    // 新的代数会让旧任务在下一个分块检查时退出
+    const quint64                          generation = ++m_generation;
+    const TableColumnStore                 store = m_tableModel->store(); // 隐式共享的快照
+    const bool                             filter = m_filterPending;
+    const bool                             filterEnabled = anyFilterEnabled();
+    const TableFilterPredicate::Conditions filterConditions = conditions();
+    const TableFilterPredicate::Refinement refinement = filterEnabled ? refinementFor(filterConditions)
+                                                                      : TableFilterPredicate::Unrelated;
+    const QVector<quint64>                 previousMask = isIncremental(refinement) ? m_appliedMask
+                                                                                    : QVector<quint64>();
+    const bool                             sortRequested = m_sortPending;
+    const int                              requestedColumn = m_pendingSortColumn;
+    const Qt::SortOrder                    requestedOrder = m_pendingSortOrder;
+    const Qt::CaseSensitivity              caseSensitivity = sortCaseSensitivity();
+    const bool                             localeAware = isSortLocaleAware();
+
+    // 发布时基类会按排序列重新排序，提前算好该列的排名
+    const int  rankColumn = sortRequested ? requestedColumn : sortColumn();
+    const bool needRanks = rankColumn >= 0 && !sortRanksValid(rankColumn);
+
+    if (!m_busy) {
+        m_busy = true;
+        emit busyChanged(true);
+    }
+
+    std::atomic<quint64> *current = &m_generation;
+    QThreadPool          *workers = &m_workerPool;
+    m_jobPool.start([=] {
+        const TableParallel::CancelCheck isCancelled = [current, generation] {
+            return current->load() != generation;
+        };
+        if (isCancelled())
+            return;
+
+        QSharedPointer<ParallelResult> result(new ParallelResult);
+        result->generation = generation;
+        result->revision = store.revision();
+        result->filter = filter;
+        result->conditions = filterConditions;
+        result->sort = sortRequested;
+        result->sortColumn = requestedColumn;
+        result->sortOrder = requestedOrder;
+
+        if (filter && filterEnabled) {
+            TableFilterPredicate predicate;
+            predicate.compile(store, filterConditions);
+            if (isIncremental(refinement))
+                result->mask = previousMask;
+            else
+                result->mask.resize((store.rowCount() + 63) / 64);
+            if (!TableParallel::evaluateFilter(workers,
+                                               predicate,
+                                               store,
+                                               refinement,
+                                               result->mask.data(),
+                                               isCancelled))
+                return;
+            result->maskRows = store.rowCount();
+        }
+
+        if (needRanks) {
+            if (!TableParallel::sortRanks(workers,
+                                          store,
+                                          rankColumn,
+                                          caseSensitivity,
+                                          localeAware,
+                                          &result->ranks.ranks,
+                                          isCancelled))
+                return;
+            result->ranks.column = rankColumn;
+            result->ranks.revision = store.revision();
+            result->ranks.caseSensitivity = caseSensitivity;
+            result->ranks.localeAware = localeAware;
+        }
+
+        if (isCancelled())
+            return;
+        QMetaObject::invokeMethod(
+            this, [this, result] { publishResult(*result); }, Qt::QueuedConnection);
+    });
+}
+
+void TableFilterProxyModel::cancelParallelJob(bool applyPending)
+{
+    if (!m_busy)
+        return;
+
+    ++m_generation;
+    m_busy = false;
+
+    const bool filter = m_filterPending;
+    const bool sortRequested = m_sortPending;
+    m_filterPending = false;
+    m_sortPending = false;
+
+    // 未发布的请求改为同步执行，避免丢失
+    if (applyPending) {
+        if (sortRequested)
+            QSortFilterProxyModel::sort(m_pendingSortColumn, m_pendingSortOrder);
+        if (filter)
+            refilter();
+    }
+
+    emit busyChanged(false);
+}
+
+void TableFilterProxyModel::publishResult(const ParallelResult &result)
+{
+    // 已被更新的请求取代
+    if (result.generation != m_generation.load() || !m_tableModel)
+        return;
+
+    // 计算期间源模型被修改过，快照已过期，按最新数据重新计算
+    if (result.revision != m_tableModel->store().revision()) {
+        startParallelJob();
+        return;
+    }
+
+    if (result.ranks.column >= 0)
+        m_sortRanks = result.ranks;
+
+    m_busy = false;
+    m_filterPending = false;
+    m_sortPending = false;
+
+    // 同时有排序和筛选时只记录排序列和顺序：屏蔽信号且比较恒为假，稳定排序保持原映射不变，
+    // 真正的排序在invalidate重建映射时按排名进行，视图只收到一次layoutChanged
+    if (result.sort && result.filter) {
+        const QSignalBlocker blocker(this);
+        m_deferSort = true;
+        QSortFilterProxyModel::sort(result.sortColumn, result.sortOrder);
+        m_deferSort = false;
+    } else if (result.sort) {
+        QSortFilterProxyModel::sort(result.sortColumn, result.sortOrder);
+    }
+
+    // invalidate只发出一次layoutChanged，映射重建期间逐行查询结果位图
+    if (result.filter) {
+        m_acceptedMask = result.mask;
+        m_acceptedMaskRows = result.maskRows;
+        invalidate();
+        rowCount();
+        m_acceptedMask.clear();
+        m_acceptedMaskRows = 0;
+
+        const int rows = m_tableModel->store().rowCount();
+        m_appliedConditions = result.conditions;
+        m_appliedMask = result.mask.isEmpty() ? allRowsMask(rows) : result.mask;
+        m_appliedMaskRows = rows;
+        m_appliedRevision = result.revision;
+    }
+
+    emit busyChanged(false);
+}
+
+bool TableFilterProxyModel::sortRanksValid(int column) const
+{
+    return m_tableModel && m_sortRanks.column == column
+           && m_sortRanks.revision == m_tableModel->store().revision()
+           && m_sortRanks.caseSensitivity == sortCaseSensitivity()
+           && m_sortRanks.localeAware == isSortLocaleAware();
+}
+
+bool TableFilterProxyModel::lessThanTyped(int column, int left, int right) const
+{
+    const TableColumnStore &store = m_tableModel->store();
+
+    switch (column) {
+    case TableItem::IdColumn:
+        return store.id(left) < store.id(right);
+    case TableItem::NameColumn:
+        return store.nameId(left) != store.nameId(right)
+               && TableParallel::compareText(store.name(left),
+                                             store.name(right),
+                                             sortCaseSensitivity(),
+                                             isSortLocaleAware())
+                      < 0;
+    case TableItem::CategoryColumn:
+        return store.categoryId(left) != store.categoryId(right)
+               && TableParallel::compareText(store.category(left),
+                                             store.category(right),
+                                             sortCaseSensitivity(),
+                                             isSortLocaleAware())
+                      < 0;
+    case TableItem::DateColumn:
+        return store.julianDay(left) < store.julianDay(right);
+    case TableItem::PriceColumn:
+        return TableParallel::priceLessThan(store.price(left), store.price(right));
+    case TableItem::AvailableColumn:
+        return !store.isAvailable(left) && store.isAvailable(right);
+    default:
+        return false;
+    }
+}
+
+bool TableFilterProxyModel::filterAcceptsRowGeneric(int                sourceRow,
+                                                    const QModelIndex &sourceParent) const
 {
     // 获取所有需要筛选的字段
     QModelIndex nameIndex = sourceModel()->index(sourceRow, TableItem::NameColumn, sourceParent);
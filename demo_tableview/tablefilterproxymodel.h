@@ -3,8 +3,13 @@
 
 #include <QSortFilterProxyModel>
 #include <QDate>
+#include <QThreadPool>
+#include <atomic>
+#include "tablefilterpredicate.h"
 #include "tableitem.h"
 
+class TableModel;
+
 /**
  * @brief 自定义过滤代理模型，支持日期范围、价格范围和可用性的筛选
  */
@@ -14,6 +19,7 @@ class TableFilterProxyModel : public QSortFilterProxyModel
 
 public:
     explicit TableFilterProxyModel(QObject *parent = nullptr);
+    ~TableFilterProxyModel() override;
 
     // 存储筛选条件（不应用）
     void storeNameFilter(const QString &name);
@@ -37,11 +43,60 @@ public:
     // 重置所有筛选器
     void resetFilters();
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    // 并行模式：大表的筛选和排序在后台线程池中计算，完成后一次性发布结果。
+    // 计算期间视图继续显示上一次的结果，新的请求会取消尚未完成的旧请求
+    void setParallelEnabled(bool enabled);
+    bool isParallelEnabled() const { return m_parallelEnabled; }
+    bool isBusy() const { return m_busy; }
+
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+signals:
+    // 后台筛选或排序开始/结束
+    void busyChanged(bool busy);
+
 protected:
     // 重写父类的过滤方法
     bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
 
+    // 按列的实际类型比较，存在后台计算的排名时直接比较排名
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
 private:
+    struct ParallelResult;
+
+    // 后台计算得到的排序排名，键相同的行排名相同
+    struct SortRanks
+    {
+        QVector<quint32>    ranks;
+        int                 column = -1;
+        quint64             revision = 0;
+        Qt::CaseSensitivity caseSensitivity = Qt::CaseSensitive;
+        bool                localeAware = false;
+    };
+
+    // 并行计算相关
+    bool useParallel() const;
+    void startParallelJob();
+    void cancelParallelJob(bool applyPending);
+    void publishResult(const ParallelResult &result);
+    bool sortRanksValid(int column) const;
+    bool lessThanTyped(int column, int left, int right) const;
+
+    // 编译当前筛选条件并批量求值后重新筛选
+    void refilter();
+    TableFilterPredicate::Conditions conditions() const;
+    bool anyFilterEnabled() const;
+
+    // 新条件相对已应用条件的关系，上一次的结果位图已过期时只能完整求值
+    TableFilterPredicate::Refinement refinementFor(const TableFilterPredicate::Conditions &next) const;
+    bool appliedMaskValid() const;
+
+    // 源模型不是TableModel时，通过data()逐列读取的通用筛选
+    bool filterAcceptsRowGeneric(int sourceRow, const QModelIndex &sourceParent) const;
+
     // 存储的筛选条件（未应用）
     QString m_storedNameFilter;
     QString m_storedCategoryFilter;
@@ -66,6 +121,31 @@ private:
     bool m_dateFilterEnabled;
     bool m_priceFilterEnabled;
     bool m_availabilityFilterEnabled;
+
+    // 编译后的筛选条件，以及refilter期间的批量求值结果
+    TableModel                  *m_tableModel;
+    mutable TableFilterPredicate m_predicate;
+    QVector<quint64>             m_acceptedMask;
+    int                          m_acceptedMaskRows;
+
+    // 当前映射对应的筛选条件和结果位图，用于条件收窄或放宽时增量求值
+    TableFilterPredicate::Conditions m_appliedConditions;
+    QVector<quint64>                 m_appliedMask;
+    int                              m_appliedMaskRows; // -1表示没有可用的结果
+    quint64                          m_appliedRevision;
+
+    // 并行模式的状态：待发布的请求、排序排名和任务代数
+    bool                 m_parallelEnabled;
+    bool                 m_busy;
+    bool                 m_filterPending;
+    bool                 m_sortPending;
+    bool                 m_deferSort; // 发布结果时只记录排序列，不实际排序
+    int                  m_pendingSortColumn;
+    Qt::SortOrder        m_pendingSortOrder;
+    SortRanks            m_sortRanks;
+    std::atomic<quint64> m_generation;
+    QThreadPool          m_jobPool;    // 串行执行后台任务
+    QThreadPool          m_workerPool; // 分块并行计算
 };
 
 #endif // TABLEFILTERPROXYMODEL_H
@@ -195,9 +195,9 @@ void TableItemDelegate::paintPriceCell(QPainter                   *painter,
     QStyle *style = option.widget ? option.widget->style() : QApplication::style();
     style->drawPrimitive(QStyle::PE_PanelItemViewItem, &opt, painter, option.widget);
 
-    // 获取价格数据
+    // 获取价格数据，显示文本直接使用模型缓存的格式化结果
     double  price = index.data(Qt::EditRole).toDouble();
-    QString priceText = QLocale::system().toCurrencyString(price);
+    QString priceText = index.data(Qt::DisplayRole).toString();
 
     // 设置字体和对齐方式
     QFont font = option.font;
@@ -238,8 +238,7 @@ void TableItemDelegate::paintDateCell(QPainter                   *painter,
     style->drawPrimitive(QStyle::PE_PanelItemViewItem, &opt, painter, option.widget);
 
     // 获取日期数据
-    QDate   date = index.data(Qt::EditRole).toDate();
-    QString dateText = QLocale::system().toString(date, QLocale::ShortFormat);
+    QString dateText = index.data(Qt::DisplayRole).toString();
 
     // 绘制日期图标
     int   iconSize = option.rect.height() - 4;
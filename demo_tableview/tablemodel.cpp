@@ -1,21 +1,83 @@
 #include "tablemodel.h"
+#include "tablefile.h"
 #include <QColor>
 #include <QDataStream>
 #include <QDebug>
 #include <QFile>
 #include <QLocale>
 #include <QRandomGenerator>
+#include <algorithm>
+
+namespace {
+
+// 后台加载旧版格式时每批插入的行数
+const int LegacyBatchRows = 64 * 1024;
+
+// 已解析、等待GUI线程插入的批次上限，插入跟不上解析时工作线程等待
+const int StagingBatches = 4;
+
+// 批量删除的区间数超过该值时改为一次布局变化，避免代理模型逐个区间更新映射
+const int LayoutChangeRangeThreshold = 32;
+
+// 删除ranges后原行号row的新行号，row本身被删除时返回-1；removedBefore[i]为第i个区间之前删除的行数
+int rowAfterRemoval(const QVector<TableColumnStore::RowRange> &ranges,
+                    const QVector<int>                        &removedBefore,
+                    int                                        row)
+{
+    auto next = std::upper_bound(ranges.constBegin(),
+                                 ranges.constEnd(),
+                                 row,
+                                 [](int value, const TableColumnStore::RowRange &range) {
+                                     return value < range.first;
+                                 });
+    if (next == ranges.constBegin())
+        return row;
+
+    const int                         range = int(next - ranges.constBegin()) - 1;
+    const TableColumnStore::RowRange &previous = ranges.at(range);
+    if (row < previous.first + previous.count)
+        return -1;
+    return row - removedBefore.at(range) - previous.count;
+}
+
+} // namespace
+
+const int TableModel::DisplayCacheSize;
 
 TableModel::TableModel(QObject *parent)
     : QAbstractTableModel(parent)
-{}
+    , m_locale(QLocale::system())
+    , m_displayCache(DisplayCacheSize)
+    , m_alternateBrush(QColor(240, 240, 240))
+    , m_categoryBrushRevision(0)
+    , m_nextChunk(0)
+    , m_stagingSlots(StagingBatches)
+    , m_ioGeneration(0)
+    , m_fileOperationRunning(false)
+    , m_categorySetRevision(m_store.categorySetRevision())
+{
+    m_ioPool.setMaxThreadCount(1);
+
+    // 所有修改都会发出以下信号之一，类别集合只在计数跨过0时才算变化
+    connect(this, &QAbstractItemModel::rowsInserted, this, &TableModel::checkCategoriesChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &TableModel::checkCategoriesChanged);
+    connect(this, &QAbstractItemModel::modelReset, this, &TableModel::checkCategoriesChanged);
+    connect(this, &QAbstractItemModel::layoutChanged, this, &TableModel::checkCategoriesChanged);
+    connect(this, &QAbstractItemModel::dataChanged, this, &TableModel::checkCategoriesChanged);
+}
 
-TableModel::~TableModel() {}
+TableModel::~TableModel()
+{
+    // 取消并等待后台操作，任务不会再访问已销毁的成员
+    ++m_ioGeneration;
+    m_ioPool.clear();
+    m_ioPool.waitForDone();
+}
 
 int TableModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent)
-    return m_items.count();
+    return m_store.rowCount();
 }
 
 int TableModel::columnCount(const QModelIndex &parent) const
@@ -26,32 +88,32 @@ int TableModel::columnCount(const QModelIndex &parent) const
 
 QVariant TableModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() >= m_items.count())
+    if (!index.isValid() || index.row() >= m_store.rowCount())
         return QVariant();
 
-    const TableItem &item = m_items.at(index.row());
+    const int row = index.row();
 
     switch (role) {
     case Qt::DisplayRole:
         switch (index.column()) {
         case TableItem::IdColumn:
-            return item.getId();
+            return m_store.id(row);
         case TableItem::NameColumn:
-            return item.getName();
+            return m_store.name(row);
         case TableItem::CategoryColumn:
-            return item.getCategory();
+            return m_store.category(row);
         case TableItem::DateColumn:
-            return formatDate(item.getDate());
+            return displayCache(row).date;
         case TableItem::PriceColumn:
-            return formatPrice(item.getPrice());
+            return displayCache(row).price;
         case TableItem::AvailableColumn:
-            return item.isAvailable() ? QStringLiteral("是") : QStringLiteral("否");
+            return m_store.isAvailable(row) ? QStringLiteral("是") : QStringLiteral("否");
         default:
             return QVariant();
         }
 
     case Qt::EditRole:
-        return item.data(index.column());
+        return m_store.data(row, index.column());
 
     case Qt::TextAlignmentRole:
         switch (index.column()) {
@@ -69,22 +131,22 @@ QVariant TableModel::data(const QModelIndex &index, int role) const
 
     case Qt::ForegroundRole:
         // 如果不可用，使用灰色文本
-        if (index.column() == TableItem::AvailableColumn && !item.isAvailable()) {
+        if (index.column() == TableItem::AvailableColumn && !m_store.isAvailable(row)) {
             return QColor(Qt::darkGray);
         }
         // 价格低于50时显示红色
-        if (index.column() == TableItem::PriceColumn && item.getPrice() < 50.0) {
+        if (index.column() == TableItem::PriceColumn && m_store.price(row) < 50.0) {
             return QColor(Qt::red);
         }
         // 价格高于500时显示蓝色
-        if (index.column() == TableItem::PriceColumn && item.getPrice() > 500.0) {
+        if (index.column() == TableItem::PriceColumn && m_store.price(row) > 500.0) {
             return QColor(Qt::blue);
         }
         return QVariant();
 
     case Qt::CheckStateRole:
         if (index.column() == TableItem::AvailableColumn) {
-            return item.isAvailable() ? Qt::Checked : Qt::Unchecked;
+            return m_store.isAvailable(row) ? Qt::Checked : Qt::Unchecked;
         }
         return QVariant();
     }
@@ -108,18 +170,17 @@ QVariant TableModel::headerData(int section, Qt::Orientation orientation, int ro
 
 bool TableModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
-    if (!index.isValid() || index.row() >= m_items.count())
+    if (!index.isValid() || index.row() >= m_store.rowCount())
         return false;
 
     if (role == Qt::EditRole) {
-        TableItem &item = m_items[index.row()];
-        if (item.setData(index.column(), value)) {
+        if (m_store.setData(index.row(), index.column(), value)) {
+            invalidateDisplayCache(index.row());
             emit dataChanged(index, index);
             return true;
         }
     } else if (role == Qt::CheckStateRole && index.column() == TableItem::AvailableColumn) {
-        TableItem &item = m_items[index.row()];
-        item.setAvailable(value.toInt() == Qt::Checked);
+        m_store.setAvailable(index.row(), value.toInt() == Qt::Checked);
         emit dataChanged(index, index);
         return true;
     }
@@ -147,10 +208,57 @@ Qt::ItemFlags TableModel::flags(const QModelIndex &index) const
     return flags;
 }
 
+bool TableModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_fileReader && m_nextChunk < m_fileReader->chunkCount();
+}
+
+void TableModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    TableFile::Chunk chunk;
+    if (!m_fileReader->readChunk(m_nextChunk, &chunk)) {
+        qWarning() << "加载数据块失败:" << m_fileReader->errorString();
+        m_fileReader.reset();
+        return;
+    }
+    appendChunk(chunk);
+
+    // 全部加载后释放文件映射
+    if (++m_nextChunk >= m_fileReader->chunkCount())
+        m_fileReader.reset();
+}
+
+void TableModel::fetchAll()
+{
+    while (canFetchMore(QModelIndex()))
+        fetchMore(QModelIndex());
+}
+
+void TableModel::appendChunk(const TableFile::Chunk &chunk)
+{
+    if (chunk.rows <= 0)
+        return;
+
+    // 加载期间新增的行位于尚未加载的块之前
+    const int first = m_store.rowCount();
+    beginInsertRows(QModelIndex(), first, first + chunk.rows - 1);
+    m_store.appendColumns(chunk.rows,
+                          chunk.ids.constData(),
+                          chunk.nameIds.constData(),
+                          chunk.categoryIds.constData(),
+                          chunk.julianDays.constData(),
+                          chunk.prices.constData(),
+                          chunk.availableWords.constData());
+    endInsertRows();
+}
+
 void TableModel::addItem(const TableItem &item)
 {
-    beginInsertRows(QModelIndex(), m_items.count(), m_items.count());
-    m_items.append(item);
+    beginInsertRows(QModelIndex(), m_store.rowCount(), m_store.rowCount());
+    m_store.append(item);
     endInsertRows();
 }
 
@@ -159,51 +267,141 @@ void TableModel::addItems(const QList<TableItem> &items)
     if (items.isEmpty())
         return;
 
-    beginInsertRows(QModelIndex(), m_items.count(), m_items.count() + items.count() - 1);
-    m_items.append(items);
+    const int first = m_store.rowCount();
+    beginInsertRows(QModelIndex(), first, first + items.count() - 1);
+    m_store.reserve(first + items.count());
+    for (const TableItem &item : items)
+        m_store.append(item);
     endInsertRows();
 }
 
-void TableModel::removeItem(int row)
+bool TableModel::removeRows(int row, int count, const QModelIndex &parent)
 {
-    if (row < 0 || row >= m_items.count())
-        return;
+    if (parent.isValid() || row < 0 || count <= 0 || row + count > m_store.rowCount())
+        return false;
 
-    beginRemoveRows(QModelIndex(), row, row);
-    m_items.removeAt(row);
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    m_store.removeRows(row, count);
+    clearDisplayCache();
     endRemoveRows();
+    return true;
+}
+
+void TableModel::removeItem(int row)
+{
+    removeRows(row, 1);
+}
+
+int TableModel::removeRows(const QList<int> &rows)
+{
+    // 去掉越界行后排序去重，相邻的行合并为区间
+    QVector<int> sorted;
+    sorted.reserve(rows.size());
+    for (int row : rows) {
+        if (row >= 0 && row < m_store.rowCount())
+            sorted.append(row);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    QVector<TableColumnStore::RowRange> ranges;
+    for (int row : sorted) {
+        if (!ranges.isEmpty() && ranges.last().first + ranges.last().count == row) {
+            ++ranges.last().count;
+        } else {
+            TableColumnStore::RowRange range;
+            range.first = row;
+            range.count = 1;
+            ranges.append(range);
+        }
+    }
+    if (ranges.isEmpty())
+        return 0;
+
+    // 区间不多时逐个区间发出删除信号，从后往前删除使前面区间的行号不变
+    if (ranges.size() <= LayoutChangeRangeThreshold) {
+        for (int range = ranges.size() - 1; range >= 0; --range)
+            removeRows(ranges.at(range).first, ranges.at(range).count);
+        return sorted.size();
+    }
+
+    // 区间很多时一次压缩所有列，只发出一次布局变化，持久索引映射到新行号
+    emit layoutAboutToBeChanged();
+
+    QVector<int> removedBefore(ranges.size());
+    for (int range = 1; range < ranges.size(); ++range)
+        removedBefore[range] = removedBefore.at(range - 1) + ranges.at(range - 1).count;
+
+    const QModelIndexList from = persistentIndexList();
+    QModelIndexList       to;
+    to.reserve(from.size());
+    for (const QModelIndex &index : from) {
+        const int row = rowAfterRemoval(ranges, removedBefore, index.row());
+        to.append(row < 0 ? QModelIndex() : createIndex(row, index.column()));
+    }
+
+    m_store.removeRanges(ranges);
+    clearDisplayCache();
+    changePersistentIndexList(from, to);
+    emit layoutChanged();
+    return sorted.size();
 }
 
 void TableModel::clearItems()
 {
+    cancelFileOperation();
     beginResetModel();
-    m_items.clear();
+    m_fileReader.reset();
+    m_store.clear();
+    clearDisplayCache();
     endResetModel();
 }
 
 TableItem TableModel::getItem(int row) const
 {
-    if (row >= 0 && row < m_items.count())
-        return m_items.at(row);
+    if (row >= 0 && row < m_store.rowCount())
+        return m_store.item(row);
     return TableItem();
 }
 
+QStringList TableModel::categories() const
+{
+    QStringList categories;
+    for (int categoryId = 0; categoryId < m_store.categoryCount(); ++categoryId) {
+        if (m_store.categoryRowCount(categoryId) > 0)
+            categories.append(m_store.categoryName(categoryId));
+    }
+    std::sort(categories.begin(), categories.end());
+    return categories;
+}
+
 QList<TableItem> TableModel::getAllItems() const
 {
-    return m_items;
+    QList<TableItem> items;
+    items.reserve(m_store.rowCount());
+    for (int row = 0; row < m_store.rowCount(); ++row)
+        items.append(m_store.item(row));
+    return items;
 }
 
-TableItem *TableModel::getItemPtr(int row)
+void TableModel::setItem(int row, const TableItem &item)
 {
-    if (row >= 0 && row < m_items.count())
-        return &m_items[row];
-    return nullptr;
+    if (row < 0 || row >= m_store.rowCount())
+        return;
+
+    m_store.setItem(row, item);
+    invalidateDisplayCache(row);
+    emit dataChanged(index(row, 0), index(row, TableItem::ColumnCount - 1));
 }
 
 void TableModel::generateTestData(int count)
 {
+    cancelFileOperation();
     beginResetModel();
-    m_items.clear();
+    m_fileReader.reset();
+    m_store.clear();
+    m_store.reserve(count);
+    clearDisplayCache();
 
     QStringList categories = {QStringLiteral("电子产品"),
                               QStringLiteral("家居用品"),
@@ -242,38 +440,81 @@ void TableModel::generateTestData(int count)
                        + QRandomGenerator::global()->bounded(100) / 100.0;
         bool available = QRandomGenerator::global()->bounded(2) > 0;
 
-        m_items.append(TableItem(id, name, category, date, price, available));
+        m_store.append(id, name, category, date, price, available);
     }
 
     endResetModel();
 }
 
-bool TableModel::saveToFile(const QString &filename)
+bool TableModel::saveToFile(const QString &filename, bool compressed)
 {
-    QFile file(filename);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "无法打开文件进行写入:" << filename;
+    // 先读完仍在按需加载的文件，保存完整数据，同时释放对原文件的映射
+    fetchAll();
+
+    QString error;
+    if (!TableFile::write(m_store, filename, compressed, &error)) {
+        qWarning() << "无法保存文件:" << filename << error;
         return false;
     }
+    return true;
+}
 
-    QDataStream out(&file);
-    out.setVersion(QDataStream::Qt_5_15);
+bool TableModel::loadFromFile(const QString &filename)
+{
+    cancelFileOperation();
 
-    // 写入项目数量
-    int count = m_items.count();
-    out << count;
+    // 按文件头区分分块列式格式与旧版QDataStream格式
+    if (TableFile::isColumnarFile(filename))
+        return loadColumnarFile(filename);
+    return loadLegacyFile(filename);
+}
 
-    // 依次写入每个项目
-    for (const TableItem &item : m_items) {
-        out << item.getId() << item.getName() << item.getCategory() << item.getDate()
-            << item.getPrice() << item.isAvailable();
+bool TableModel::loadColumnarFile(const QString &filename)
+{
+    QScopedPointer<TableFile::Reader> reader(new TableFile::Reader);
+    if (!reader->open(filename)) {
+        qWarning() << "无法读取文件:" << filename << reader->errorString();
+        return false;
     }
 
-    file.close();
+    // 第一块先行加载，打开大文件时立即显示第一屏
+    TableFile::Chunk chunk;
+    if (reader->chunkCount() > 0 && !reader->readChunk(0, &chunk)) {
+        qWarning() << "无法读取文件:" << filename << reader->errorString();
+        return false;
+    }
+
+    beginResetModel();
+    m_fileReader.reset();
+    clearDisplayCache();
+    const bool restored = m_store.restoreDictionaries(reader->names(), reader->categories());
+    if (restored && chunk.rows > 0) {
+        m_store.appendColumns(chunk.rows,
+                              chunk.ids.constData(),
+                              chunk.nameIds.constData(),
+                              chunk.categoryIds.constData(),
+                              chunk.julianDays.constData(),
+                              chunk.prices.constData(),
+                              chunk.availableWords.constData());
+    }
+    if (!restored)
+        m_store.clear();
+    endResetModel();
+
+    if (!restored) {
+        qWarning() << "无法读取文件:" << filename << "字典包含重复项";
+        return false;
+    }
+
+    // 其余的块由fetchMore按需加载
+    if (reader->chunkCount() > 1) {
+        m_fileReader.swap(reader);
+        m_nextChunk = 1;
+    }
     return true;
 }
 
-bool TableModel::loadFromFile(const QString &filename)
+bool TableModel::loadLegacyFile(const QString &filename)
 {
     QFile file(filename);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -290,7 +531,11 @@ bool TableModel::loadFromFile(const QString &filename)
 
     // 清空当前数据
     beginResetModel();
-    m_items.clear();
+    m_fileReader.reset();
+    m_store.clear();
+    clearDisplayCache();
+    // 每行至少占用8字节，据此限制预分配，避免损坏的行数导致巨量分配
+    m_store.reserve(int(qBound<qint64>(0, count, file.size() / 8)));
 
     // 依次读取每个项目
     for (int i = 0; i < count; ++i) {
@@ -302,7 +547,7 @@ bool TableModel::loadFromFile(const QString &filename)
 
         in >> id >> name >> category >> date >> price >> available;
 
-        m_items.append(TableItem(id, name, category, date, price, available));
+        m_store.append(id, name, category, date, price, available);
     }
 
     endResetModel();
@@ -310,36 +555,309 @@ bool TableModel::loadFromFile(const QString &filename)
     return true;
 }
 
+void TableModel::loadFromFileAsync(const QString &filename)
+{
+    const quint64 generation = startFileOperation();
+    m_ioPool.start([this, filename, generation] {
+        if (TableFile::isColumnarFile(filename))
+            readColumnarFileAsync(filename, generation);
+        else
+            readLegacyFileAsync(filename, generation);
+    });
+}
+
+void TableModel::saveToFileAsync(const QString &filename, bool compressed)
+{
+    const quint64 generation = startFileOperation();
+
+    // 隐式共享的快照：之后对模型的修改触发写时复制，不影响后台写入
+    fetchAll();
+    const TableColumnStore snapshot = m_store;
+
+    m_ioPool.start([this, filename, compressed, snapshot, generation] {
+        const TableFile::Progress progress = [this, generation](qint64 rows, qint64 bytes) {
+            if (generation != m_ioGeneration.load())
+                return false;
+            QMetaObject::invokeMethod(
+                this,
+                [this, generation, rows, bytes] {
+                    if (generation == m_ioGeneration.load())
+                        emit fileOperationProgress(rows, bytes);
+                },
+                Qt::QueuedConnection);
+            return true;
+        };
+
+        QString    error;
+        const bool written = TableFile::write(snapshot, filename, compressed, &error, progress);
+        postFinished(generation, written, error);
+    });
+}
+
+void TableModel::cancelFileOperation()
+{
+    if (!m_fileOperationRunning)
+        return;
+
+    // 工作线程在下一批之前退出，已排队的批次被丢弃
+    ++m_ioGeneration;
+    m_fileOperationRunning = false;
+    emit fileOperationFinished(false, true, QString());
+}
+
+quint64 TableModel::startFileOperation()
+{
+    cancelFileOperation();
+    m_fileOperationRunning = true;
+    return ++m_ioGeneration;
+}
+
+void TableModel::readColumnarFileAsync(const QString &filename, quint64 generation)
+{
+    TableFile::Reader reader;
+    if (!reader.open(filename)) {
+        postFinished(generation, false, reader.errorString());
+        return;
+    }
+
+    // 先清空模型并恢复字典，之后各块的名称、类别编号可以直接追加。
+    // 文件头中的行数未经块数据验证（压缩后也无法按文件大小估计上限），因此不预分配
+    const QVector<QString> names = reader.names();
+    const QVector<QString> categories = reader.categories();
+    QMetaObject::invokeMethod(
+        this,
+        [this, generation, names, categories] {
+            if (generation != m_ioGeneration.load())
+                return;
+            beginResetModel();
+            m_fileReader.reset();
+            clearDisplayCache();
+            const bool restored = m_store.restoreDictionaries(names, categories);
+            if (!restored)
+                m_store.clear();
+            endResetModel();
+            if (!restored)
+                finishFileOperation(generation, false, tr("字典包含重复项"));
+        },
+        Qt::QueuedConnection);
+
+    qint64 bytes = 0;
+    qint64 loadedRows = 0;
+    for (int chunk = 0; chunk < reader.chunkCount(); ++chunk) {
+        TableFile::Chunk staged;
+        if (!reader.readChunk(chunk, &staged)) {
+            postFinished(generation, false, reader.errorString());
+            return;
+        }
+        bytes += reader.chunkSize(chunk);
+        loadedRows += staged.rows;
+
+        if (!acquireStagingSlot(generation))
+            return;
+        QMetaObject::invokeMethod(
+            this,
+            [this, generation, staged, loadedRows, bytes] {
+                m_stagingSlots.release();
+                if (generation != m_ioGeneration.load())
+                    return;
+                appendChunk(staged);
+                emit fileOperationProgress(loadedRows, bytes);
+            },
+            Qt::QueuedConnection);
+    }
+    postFinished(generation, true, QString());
+}
+
+void TableModel::readLegacyFileAsync(const QString &filename, quint64 generation)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        postFinished(generation, false, file.errorString());
+        return;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_15);
+
+    int count;
+    in >> count;
+
+    // 每行至少占用8字节，据此限制预分配，避免损坏的行数导致巨量分配
+    const int reserved = int(qBound<qint64>(0, count, file.size() / 8));
+    QMetaObject::invokeMethod(
+        this,
+        [this, generation, reserved] {
+            if (generation != m_ioGeneration.load())
+                return;
+            beginResetModel();
+            m_fileReader.reset();
+            m_store.clear();
+            m_store.reserve(reserved);
+            clearDisplayCache();
+            endResetModel();
+        },
+        Qt::QueuedConnection);
+
+    // 逐行解析到暂存批次，攒满一批交给GUI线程插入
+    QVector<TableItem> batch;
+    for (int i = 0; i < count; ++i) {
+        int     id;
+        QString name, category;
+        QDate   date;
+        double  price;
+        bool    available;
+
+        in >> id >> name >> category >> date >> price >> available;
+        if (in.status() != QDataStream::Ok) {
+            postFinished(generation, false, tr("文件数据不完整"));
+            return;
+        }
+
+        if (batch.isEmpty())
+            batch.reserve(qMin(LegacyBatchRows, count - i));
+        batch.append(TableItem(id, name, category, date, price, available));
+        if (batch.size() < LegacyBatchRows && i + 1 < count)
+            continue;
+
+        if (!acquireStagingSlot(generation))
+            return;
+        const qint64 loadedRows = i + 1;
+        const qint64 bytes = file.pos();
+        QMetaObject::invokeMethod(
+            this,
+            [this, generation, batch, loadedRows, bytes] {
+                m_stagingSlots.release();
+                if (generation != m_ioGeneration.load())
+                    return;
+                const int first = m_store.rowCount();
+                beginInsertRows(QModelIndex(), first, first + batch.size() - 1);
+                for (const TableItem &item : batch)
+                    m_store.append(item);
+                endInsertRows();
+                emit fileOperationProgress(loadedRows, bytes);
+            },
+            Qt::QueuedConnection);
+        batch = QVector<TableItem>();
+    }
+    postFinished(generation, true, QString());
+}
+
+bool TableModel::acquireStagingSlot(quint64 generation)
+{
+    // 暂存区已满时等待GUI线程插入，期间仍能响应取消
+    while (!m_stagingSlots.tryAcquire(1, 50)) {
+        if (generation != m_ioGeneration.load())
+            return false;
+    }
+    if (generation != m_ioGeneration.load()) {
+        m_stagingSlots.release();
+        return false;
+    }
+    return true;
+}
+
+void TableModel::postFinished(quint64 generation, bool success, const QString &error)
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this, generation, success, error] { finishFileOperation(generation, success, error); },
+        Qt::QueuedConnection);
+}
+
+void TableModel::finishFileOperation(quint64 generation, bool success, const QString &error)
+{
+    // 已被取消或被新的操作取代
+    if (generation != m_ioGeneration.load())
+        return;
+
+    // 失败时让工作线程随之退出
+    ++m_ioGeneration;
+    m_fileOperationRunning = false;
+    if (!success)
+        qWarning() << "后台读写文件失败:" << error;
+    emit fileOperationFinished(success, false, error);
+}
+
 QBrush TableModel::getCellBackgroundColor(int row, int column) const
 {
     // 交替行背景色
     if (row % 2 == 0) {
-        return QBrush(QColor(240, 240, 240));
+        return m_alternateBrush;
     }
 
-    // 特定列背景色
+    // 特定列背景色，按类别编号查表
     if (column == TableItem::CategoryColumn) {
-        const TableItem &item = m_items.at(row);
-        QString          category = item.getCategory();
+        updateCategoryBrushes();
+        return m_categoryBrushes.at(m_store.categoryId(row));
+    }
+
+    return QBrush();
+}
+
+void TableModel::updateCategoryBrushes() const
+{
+    // 字典变化后类别编号可能重新分配，需要重建
+    if (m_categoryBrushRevision == m_store.dictionaryRevision()
+        && m_categoryBrushes.size() == m_store.categoryCount()) {
+        return;
+    }
+
+    m_categoryBrushes.resize(m_store.categoryCount());
+    for (int categoryId = 0; categoryId < m_store.categoryCount(); ++categoryId) {
+        const QString &category = m_store.categoryName(categoryId);
 
         if (category == QStringLiteral("电子产品")) {
-            return QBrush(QColor(230, 255, 230));
+            m_categoryBrushes[categoryId] = QBrush(QColor(230, 255, 230));
         } else if (category == QStringLiteral("家居用品")) {
-            return QBrush(QColor(230, 230, 255));
+            m_categoryBrushes[categoryId] = QBrush(QColor(230, 230, 255));
         } else if (category == QStringLiteral("办公用品")) {
-            return QBrush(QColor(255, 230, 230));
+            m_categoryBrushes[categoryId] = QBrush(QColor(255, 230, 230));
+        } else {
+            m_categoryBrushes[categoryId] = QBrush();
         }
     }
-
-    return QBrush();
+    m_categoryBrushRevision = m_store.dictionaryRevision();
 }
 
 QString TableModel::formatPrice(double price) const
 {
-    return QLocale::system().toCurrencyString(price);
+    return m_locale.toCurrencyString(price);
 }
 
 QString TableModel::formatDate(const QDate &date) const
 {
-    return QLocale::system().toString(date, QLocale::ShortFormat);
+    return m_locale.toString(date, QLocale::ShortFormat);
+}
+
+const TableModel::DisplayCacheEntry &TableModel::displayCache(int row) const
+{
+    DisplayCacheEntry &entry = m_displayCache[row & (DisplayCacheSize - 1)];
+    if (entry.row != row) {
+        entry.row = row;
+        entry.date = formatDate(m_store.date(row));
+        entry.price = formatPrice(m_store.price(row));
+    }
+    return entry;
+}
+
+void TableModel::invalidateDisplayCache(int row)
+{
+    DisplayCacheEntry &entry = m_displayCache[row & (DisplayCacheSize - 1)];
+    if (entry.row == row)
+        entry.row = -1;
+}
+
+void TableModel::clearDisplayCache()
+{
+    for (DisplayCacheEntry &entry : m_displayCache)
+        entry.row = -1;
+}
+
+void TableModel::checkCategoriesChanged()
+{
+    if (m_store.categorySetRevision() == m_categorySetRevision)
+        return;
+
+    m_categorySetRevision = m_store.categorySetRevision();
+    emit categoriesChanged();
 }
@@ -5,8 +5,19 @@
 #include <QList>
 #include <QColor>
 #include <QBrush>
+#include <QLocale>
+#include <QScopedPointer>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <atomic>
+#include "tablecolumnstore.h"
 #include "tableitem.h"
 
+namespace TableFile {
+class Reader;
+struct Chunk;
+}
+
 /**
  * @brief 表格模型类，用于管理表格数据并提供给QTableView显示
  */
@@ -25,32 +36,113 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
     bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
     Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    // 分块列式文件按需加载：打开时只加载第一块，视图滚动到末尾时再逐块追加
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    void fetchAll();
 
     // 筛选和排序所需的方法
     void addItem(const TableItem &item);
     void addItems(const QList<TableItem> &items);
     void removeItem(int row);
+    // 批量删除任意行（可无序、可重复），相邻行合并为区间，返回实际删除的行数
+    int  removeRows(const QList<int> &rows);
     void clearItems();
     TableItem getItem(int row) const;
     QList<TableItem> getAllItems() const;
-    TableItem *getItemPtr(int row);
+    void setItem(int row, const TableItem &item);
+
+    // 列式存储，供筛选和排序直接读取列数据
+    const TableColumnStore &store() const { return m_store; }
+
+    // 表格中实际使用的类别（升序），由类别引用计数得到，无需扫描行
+    QStringList categories() const;
+
+    // 名称子串索引，名称种类很多时可加快名称筛选
+    void setNameIndexEnabled(bool enabled) { m_store.setNameIndexEnabled(enabled); }
+    bool isNameIndexEnabled() const { return m_store.isNameIndexEnabled(); }
     
     // 生成测试数据
     void generateTestData(int count = 50);
 
-    // 数据保存与加载方法
-    bool saveToFile(const QString &filename);
+    // 数据保存与加载方法：保存为分块列式格式，加载时也能读取旧版QDataStream格式
+    bool saveToFile(const QString &filename, bool compressed = false);
     bool loadFromFile(const QString &filename);
 
+    // 后台加载与保存：加载在工作线程解析，数据分批插入，视图逐步显示；
+    // 保存先取写时复制的快照，再在工作线程写入。同一时间只进行一个后台操作
+    void loadFromFileAsync(const QString &filename);
+    void saveToFileAsync(const QString &filename, bool compressed = false);
+    void cancelFileOperation();
+    bool isFileOperationRunning() const { return m_fileOperationRunning; }
+
+signals:
+    // 实际使用的类别集合发生变化（出现新类别或某个类别已无行引用）
+    void categoriesChanged();
+
+    // 后台操作已处理的行数和文件字节数
+    void fileOperationProgress(qint64 rows, qint64 bytes);
+    // 后台操作结束；取消时cancelled为true，已加载的行保留在模型中
+    void fileOperationFinished(bool success, bool cancelled, const QString &error);
+
 private:
-    QList<TableItem> m_items;  // 存储表格数据
+    // 显示字符串缓存的一项，按行号直接映射到固定数量的槽位
+    struct DisplayCacheEntry
+    {
+        int     row = -1;
+        QString date;
+        QString price;
+    };
+    static const int DisplayCacheSize = 4096; // 需为2的幂
+
+    TableColumnStore m_store;  // 按列存储的表格数据
     
     // 获取单元格背景色
     QBrush getCellBackgroundColor(int row, int column) const;
+    void   updateCategoryBrushes() const;
     
     // 格式化数据显示
     QString formatPrice(double price) const;
     QString formatDate(const QDate &date) const;
+
+    // 两种文件格式的加载
+    bool loadLegacyFile(const QString &filename);
+    bool loadColumnarFile(const QString &filename);
+    void appendChunk(const TableFile::Chunk &chunk);
+
+    // 后台操作：读取函数在工作线程中执行，只通过排队调用修改模型
+    quint64 startFileOperation();
+    void    readColumnarFileAsync(const QString &filename, quint64 generation);
+    void    readLegacyFileAsync(const QString &filename, quint64 generation);
+    bool    acquireStagingSlot(quint64 generation);
+    void    postFinished(quint64 generation, bool success, const QString &error);
+    void    finishFileOperation(quint64 generation, bool success, const QString &error);
+
+    // 行增删、数据修改或重置后比较类别集合版本号
+    void checkCategoriesChanged();
+
+    // 显示字符串缓存：修改某行时只失效该行，删除或重置时全部失效
+    const DisplayCacheEntry &displayCache(int row) const;
+    void                     invalidateDisplayCache(int row);
+    void                     clearDisplayCache();
+
+    QLocale                            m_locale;                // 缓存的系统区域设置
+    mutable QVector<DisplayCacheEntry> m_displayCache;
+    QBrush                             m_alternateBrush;        // 交替行背景
+    mutable QVector<QBrush>            m_categoryBrushes;       // 按类别编号索引的背景
+    mutable quint64                    m_categoryBrushRevision; // 建表时的字典版本号
+
+    QScopedPointer<TableFile::Reader> m_fileReader; // 仍有未加载块的文件
+    int                               m_nextChunk;  // 下一个要加载的块
+
+    QThreadPool          m_ioPool;               // 串行执行后台加载与保存
+    QSemaphore           m_stagingSlots;         // 已解析、等待插入的批次数上限
+    std::atomic<quint64> m_ioGeneration;         // 递增即取消进行中的后台操作
+    bool                 m_fileOperationRunning;
+
+    quint64 m_categorySetRevision; // 上次发出categoriesChanged时的类别集合版本号
 };
 
 #endif // TABLEMODEL_H
@@ -0,0 +1,147 @@
+#include "tablengramindex.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// 单字与三字组使用不同的键空间
+const quint64 TrigramTag = quint64(1) << 48;
+
+quint64 unigramKey(ushort a)
+{
+    return a;
+}
+
+quint64 trigramKey(ushort a, ushort b, ushort c)
+{
+    return TrigramTag | (quint64(a) << 32) | (quint64(b) << 16) | c;
+}
+
+// 与QString::contains(..., Qt::CaseInsensitive)一致的逐码元大小写折叠
+QVector<ushort> foldedUnits(const QString &text)
+{
+    QVector<ushort> units(text.size());
+    for (int i = 0; i < text.size(); ++i)
+        units[i] = text.at(i).toCaseFolded().unicode();
+    return units;
+}
+
+// 查询需要的n-gram：至少三个字时取所有三字组，否则取单字
+QVector<quint64> queryKeys(const QVector<ushort> &units)
+{
+    QVector<quint64> keys;
+    if (units.size() >= 3) {
+        for (int i = 0; i + 2 < units.size(); ++i)
+            keys.append(trigramKey(units.at(i), units.at(i + 1), units.at(i + 2)));
+    } else {
+        for (ushort unit : units)
+            keys.append(unigramKey(unit));
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+} // namespace
+
+TableNgramIndex::TableNgramIndex()
+    : m_count(0)
+{}
+
+void TableNgramIndex::clear()
+{
+    m_postings.clear();
+    m_unindexed.clear();
+    m_count = 0;
+}
+
+void TableNgramIndex::add(int id, const QString &text)
+{
+    Q_ASSERT(id == m_count);
+    ++m_count;
+
+    // 代理对按码元折叠与Qt按码位折叠的结果可能不同，这类条目总是作为候选
+    if (hasSurrogates(text)) {
+        m_unindexed.append(quint32(id));
+        return;
+    }
+
+    // 条目编号递增，同一条目内重复的n-gram只需比较倒排表末尾
+    auto post = [this, id](quint64 key) {
+        QVector<quint32> &ids = m_postings[key];
+        if (ids.isEmpty() || ids.last() != quint32(id))
+            ids.append(quint32(id));
+    };
+
+    const QVector<ushort> units = foldedUnits(text);
+    for (int i = 0; i < units.size(); ++i) {
+        post(unigramKey(units.at(i)));
+        if (i + 2 < units.size())
+            post(trigramKey(units.at(i), units.at(i + 1), units.at(i + 2)));
+    }
+}
+
+bool TableNgramIndex::candidates(const QString &needle, QVector<quint32> *ids) const
+{
+    ids->clear();
+    if (needle.isEmpty() || hasSurrogates(needle))
+        return false;
+
+    // 从最短的倒排表开始求交集，任一n-gram不存在时结果为空
+    QVector<const QVector<quint32> *> lists;
+    for (quint64 key : queryKeys(foldedUnits(needle))) {
+        auto it = m_postings.constFind(key);
+        if (it == m_postings.constEnd()) {
+            lists.clear();
+            break;
+        }
+        lists.append(&it.value());
+    }
+    std::sort(lists.begin(), lists.end(), [](const QVector<quint32> *a, const QVector<quint32> *b) {
+        return a->size() < b->size();
+    });
+
+    QVector<quint32> matched;
+    if (!lists.isEmpty()) {
+        matched = *lists.first();
+        QVector<quint32> next;
+        for (int i = 1; i < lists.size() && !matched.isEmpty(); ++i) {
+            next.clear();
+            std::set_intersection(matched.constBegin(),
+                                  matched.constEnd(),
+                                  lists.at(i)->constBegin(),
+                                  lists.at(i)->constEnd(),
+                                  std::back_inserter(next));
+            matched.swap(next);
+        }
+    }
+
+    ids->reserve(matched.size() + m_unindexed.size());
+    std::merge(matched.constBegin(),
+               matched.constEnd(),
+               m_unindexed.constBegin(),
+               m_unindexed.constEnd(),
+               std::back_inserter(*ids));
+    return true;
+}
+
+qint64 TableNgramIndex::memoryUsage() const
+{
+    // 倒排表内容加上哈希表节点的粗略估算
+    qint64 bytes = qint64(m_unindexed.capacity()) * sizeof(quint32);
+    for (auto it = m_postings.constBegin(); it != m_postings.constEnd(); ++it) {
+        bytes += qint64(sizeof(quint64) + sizeof(QVector<quint32>)) * 2
+                 + it.value().capacity() * qint64(sizeof(quint32));
+    }
+    bytes += qint64(m_postings.capacity()) * qint64(sizeof(void *));
+    return bytes;
+}
+
+bool TableNgramIndex::hasSurrogates(const QString &text)
+{
+    for (const QChar ch : text) {
+        if (ch.isSurrogate())
+            return true;
+    }
+    return false;
+}
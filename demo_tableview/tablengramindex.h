@@ -0,0 +1,41 @@
+#ifndef TABLENGRAMINDEX_H
+#define TABLENGRAMINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 字典条目上的倒排n-gram索引，用于不区分大小写的子串查询
+ *
+ * 每个条目按大小写折叠后的UTF-16码元切分为单字和三字组，倒排表记录包含该组的条目编号。
+ * 查询至少三个字时求所有三字组倒排表的交集，一到两个字时（中文里很常见）求单字倒排表的交集。
+ * 结果只是候选集合，调用方仍需用QString::contains确认。
+ * 条目只能追加，与TableColumnStore的字符串池一致：池中的字符串在清空前不会删除。
+ */
+class TableNgramIndex
+{
+public:
+    TableNgramIndex();
+
+    void clear();
+
+    // 追加条目，编号需要按0, 1, 2...递增
+    void add(int id, const QString &text);
+    int  count() const { return m_count; }
+
+    // 可能包含needle的条目编号（升序）；needle为空或含代理对时无法用索引查询，返回false
+    bool candidates(const QString &needle, QVector<quint32> *ids) const;
+
+    // 估算占用的堆内存（字节）
+    qint64 memoryUsage() const;
+
+private:
+    static bool hasSurrogates(const QString &text);
+
+    QHash<quint64, QVector<quint32>> m_postings;  // n-gram -> 条目编号（升序）
+    QVector<quint32>                 m_unindexed; // 含代理对、只能逐个确认的条目
+    int                              m_count;
+};
+
+#endif // TABLENGRAMINDEX_H
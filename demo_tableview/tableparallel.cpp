@@ -0,0 +1,206 @@
+#include "tableparallel.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace TableParallel {
+
+namespace {
+
+// 每个筛选分块的行数，保持为64的倍数以便直接写入结果位图
+const int FilterChunkRows = 64 * 1024;
+
+// 少于该行数的分段不再拆分排序
+const int MinSortChunkRows = 16 * 1024;
+
+// 对字典（名称池、类别表）排序，返回每个字典编号的稠密排名
+QVector<quint32> dictionaryRanks(int                                 count,
+                                 const std::function<QString(int)> &text,
+                                 Qt::CaseSensitivity                 caseSensitivity,
+                                 bool                                localeAware)
+{
+    QVector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return compareText(text(a), text(b), caseSensitivity, localeAware) < 0;
+    });
+
+    QVector<quint32> ranks(count);
+    quint32          rank = 0;
+    for (int i = 0; i < count; ++i) {
+        if (i > 0 && compareText(text(order.at(i - 1)), text(order.at(i)), caseSensitivity, localeAware) != 0)
+            ++rank;
+        ranks[order.at(i)] = rank;
+    }
+    return ranks;
+}
+
+// 排序键的比较，价格列需要单独处理NaN
+template <typename Key>
+bool keyLess(Key left, Key right)
+{
+    return left < right;
+}
+
+bool keyLess(double left, double right)
+{
+    return priceLessThan(left, right);
+}
+
+// 分段并行stable_sort，再逐轮两两归并
+template <typename Key>
+bool mergeSort(QThreadPool *pool, const Key *keys, QVector<int> *rows, const CancelCheck &isCancelled)
+{
+    const int count = rows->size();
+    const int parts = qBound(1, count / MinSortChunkRows, qMax(1, pool->maxThreadCount()));
+
+    QVector<int> bounds(parts + 1);
+    for (int part = 0; part <= parts; ++part)
+        bounds[part] = int(qint64(count) * part / parts);
+
+    auto less = [keys](int a, int b) { return keyLess(keys[a], keys[b]); };
+
+    int *data = rows->data();
+    parallelFor(pool, parts, [&](int part) {
+        std::stable_sort(data + bounds.at(part), data + bounds.at(part + 1), less);
+    });
+
+    QVector<int> buffer(count);
+    int         *target = buffer.data();
+    for (int width = 1; width < parts; width *= 2) {
+        if (isCancelled())
+            return false;
+        const int merges = (parts + 2 * width - 1) / (2 * width);
+        parallelFor(pool, merges, [&](int merge) {
+            const int first = bounds.at(merge * 2 * width);
+            const int middle = bounds.at(qMin(parts, merge * 2 * width + width));
+            const int last = bounds.at(qMin(parts, merge * 2 * width + 2 * width));
+            std::merge(data + first, data + middle, data + middle, data + last, target + first, less);
+        });
+        std::swap(data, target);
+    }
+
+    if (data != rows->data())
+        *rows = buffer;
+    return !isCancelled();
+}
+
+// 排序后把相同键的行归为同一排名
+template <typename Key>
+bool denseRanks(QThreadPool       *pool,
+                const Key         *keys,
+                int                count,
+                QVector<quint32>  *ranks,
+                const CancelCheck &isCancelled)
+{
+    QVector<int> rows(count);
+    std::iota(rows.begin(), rows.end(), 0);
+    if (!mergeSort(pool, keys, &rows, isCancelled))
+        return false;
+
+    ranks->resize(count);
+    quint32 rank = 0;
+    for (int i = 0; i < count; ++i) {
+        if (i > 0 && keyLess(keys[rows.at(i - 1)], keys[rows.at(i)]))
+            ++rank;
+        (*ranks)[rows.at(i)] = rank;
+    }
+    return true;
+}
+
+// 把字典编号映射为字典排名，得到每行的排序键
+template <typename Id>
+QVector<quint32> mapDictionary(QThreadPool *pool, const Id *ids, int count, const QVector<quint32> &dictionary)
+{
+    QVector<quint32> keys(count);
+    quint32         *data = keys.data();
+    const int        chunks = (count + FilterChunkRows - 1) / FilterChunkRows;
+    parallelFor(pool, chunks, [&](int chunk) {
+        const int first = chunk * FilterChunkRows;
+        const int last = qMin(count, first + FilterChunkRows);
+        for (int row = first; row < last; ++row)
+            data[row] = dictionary.at(int(ids[row]));
+    });
+    return keys;
+}
+
+} // namespace
+
+bool evaluateFilter(QThreadPool                     *pool,
+                    const TableFilterPredicate      &predicate,
+                    const TableColumnStore          &store,
+                    TableFilterPredicate::Refinement refinement,
+                    quint64                         *mask,
+                    const CancelCheck               &isCancelled)
+{
+    const int rows = store.rowCount();
+    const int chunks = (rows + FilterChunkRows - 1) / FilterChunkRows;
+    parallelFor(pool, chunks, [&](int chunk) {
+        if (isCancelled())
+            return;
+        const int first = chunk * FilterChunkRows;
+        predicate.refine(store, refinement, first, qMin(FilterChunkRows, rows - first), mask + first / 64);
+    });
+    return !isCancelled();
+}
+
+bool sortRanks(QThreadPool            *pool,
+               const TableColumnStore &store,
+               int                     column,
+               Qt::CaseSensitivity     caseSensitivity,
+               bool                    localeAware,
+               QVector<quint32>       *ranks,
+               const CancelCheck      &isCancelled)
+{
+    const int rows = store.rowCount();
+
+    switch (column) {
+    case TableItem::IdColumn:
+        return denseRanks(pool, store.idData(), rows, ranks, isCancelled);
+    case TableItem::NameColumn: {
+        const QVector<quint32> dictionary = dictionaryRanks(
+            store.nameCount(),
+            [&store](int nameId) { return store.poolName(nameId); },
+            caseSensitivity,
+            localeAware);
+        const QVector<quint32> keys = mapDictionary(pool, store.nameIdData(), rows, dictionary);
+        return denseRanks(pool, keys.constData(), rows, ranks, isCancelled);
+    }
+    case TableItem::CategoryColumn: {
+        const QVector<quint32> dictionary = dictionaryRanks(
+            store.categoryCount(),
+            [&store](int categoryId) { return store.categoryName(categoryId); },
+            caseSensitivity,
+            localeAware);
+        const QVector<quint32> keys = mapDictionary(pool, store.categoryIdData(), rows, dictionary);
+        return denseRanks(pool, keys.constData(), rows, ranks, isCancelled);
+    }
+    case TableItem::DateColumn:
+        return denseRanks(pool, store.julianDayData(), rows, ranks, isCancelled);
+    case TableItem::PriceColumn:
+        return denseRanks(pool, store.priceData(), rows, ranks, isCancelled);
+    case TableItem::AvailableColumn: {
+        QVector<quint8> keys(rows);
+        for (int row = 0; row < rows; ++row)
+            keys[row] = store.isAvailable(row);
+        return denseRanks(pool, keys.constData(), rows, ranks, isCancelled);
+    }
+    default:
+        return false;
+    }
+}
+
+int compareText(const QString &left, const QString &right, Qt::CaseSensitivity caseSensitivity, bool localeAware)
+{
+    return localeAware ? QString::localeAwareCompare(left, right)
+                       : QString::compare(left, right, caseSensitivity);
+}
+
+bool priceLessThan(double left, double right)
+{
+    if (std::isnan(right))
+        return !std::isnan(left);
+    return left < right;
+}
+
+} // namespace TableParallel
@@ -0,0 +1,64 @@
+#ifndef TABLEPARALLEL_H
+#define TABLEPARALLEL_H
+
+#include "tablecolumnstore.h"
+#include "tablefilterpredicate.h"
+#include <QSemaphore>
+#include <QThreadPool>
+#include <functional>
+
+/**
+ * @brief 表格筛选和排序的并行计算工具
+ *
+ * 所有函数都只读取传入的TableColumnStore（通常是隐式共享的快照），可以在工作线程中调用。
+ * isCancelled在分块之间检查，返回true时尽快结束，此时结果无效。
+ */
+namespace TableParallel {
+
+using CancelCheck = std::function<bool()>;
+
+// 把chunks个分块交给线程池执行，当前线程也参与计算，全部完成后返回
+template <typename Work>
+void parallelFor(QThreadPool *pool, int chunks, const Work &work)
+{
+    if (chunks <= 0)
+        return;
+
+    QSemaphore done;
+    for (int chunk = 1; chunk < chunks; ++chunk) {
+        pool->start([&work, &done, chunk] {
+            work(chunk);
+            done.release();
+        });
+    }
+    work(0);
+    done.acquire(chunks - 1);
+}
+
+// 并行求值筛选条件，mask至少需要(store.rowCount() + 63) / 64个字；
+// refinement为收窄或放宽时，mask需要预先填入上一次的结果
+bool evaluateFilter(QThreadPool                     *pool,
+                    const TableFilterPredicate      &predicate,
+                    const TableColumnStore          &store,
+                    TableFilterPredicate::Refinement refinement,
+                    quint64                         *mask,
+                    const CancelCheck               &isCancelled);
+
+// 按列的类型化排序键做并行归并排序，返回每行的稠密排名（键相同的行排名相同）
+bool sortRanks(QThreadPool            *pool,
+               const TableColumnStore &store,
+               int                     column,
+               Qt::CaseSensitivity     caseSensitivity,
+               bool                    localeAware,
+               QVector<quint32>       *ranks,
+               const CancelCheck      &isCancelled);
+
+// 与sortRanks一致的文本比较规则
+int compareText(const QString &left, const QString &right, Qt::CaseSensitivity caseSensitivity, bool localeAware);
+
+// 与sortRanks一致的价格比较规则：NaN大于所有价格，保证严格弱序
+bool priceLessThan(double left, double right);
+
+} // namespace TableParallel
+
+#endif // TABLEPARALLEL_H